@@ -0,0 +1,855 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#define OCTVM_INTERNAL 1
+
+#include "Headers/Analysis.hpp"
+#include "Headers/Decoder.hpp"
+#include "Headers/Functions.hpp"
+
+namespace Octane {
+
+    /// @brief The dataflow state on entry to an `Instruction`.
+    /// Both values are relative to the `Function`'s entry.
+    ////////////////////////////////////////
+    struct SiteState {
+        /// Bytes pushed (or popped, if negative) on the Stack
+        i32 Depth;
+        /// Bytes requested from the Local Frame
+        i32 Local;
+    };
+
+    /// A site which no path has reached yet
+    static constexpr const i32 UNVISITED   = INT_MIN;
+    /// A site reached with differing values, or after a barrier
+    static constexpr const i32 UNKNOWN     = INT_MAX;
+    /// Known values never drift further than this. No Stack or
+    /// Local Space could ever be reserved for more.
+    static constexpr const i32 VALUE_LIMIT = 0x00FFFFFF;
+
+    /// @brief Joins the value already known at a site
+    /// with the value arriving from another path
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    i32 MergeValue(i32 Old, i32 New) noexcept
+    {
+        if ( Old == UNVISITED || Old == New )
+            return New;
+        return UNKNOWN;
+    }
+
+    /// @brief Offsets a known value, turning
+    /// it UNKNOWN once it drifts too far
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    i32 OffsetValue(i32 Value, i32 By) noexcept
+    {
+        if ( Value == UNKNOWN || Value == UNVISITED )
+            return Value;
+        i32 Result = Value + By;
+        if ( Result > VALUE_LIMIT || Result < -VALUE_LIMIT )
+            return UNKNOWN;
+        return Result;
+    }
+
+    /// GETSTACKEFFECT:
+    ////////////////////////////////////////
+    bool GetStackEffect(const Instruction& Ins, i32& Effect) noexcept
+    {
+        i32 RegFile = sizeof(VPCore::Register) * VPCore::Register::COUNT;
+        i32 Mask    = 0;
+        for ( u16 Bits = Ins.Imm16.Imm; Bits; Bits &= (u16)( Bits - 1 ) )
+            Mask += sizeof(u64);
+
+        switch ( Ins.Any.Op ) {
+            case Instruction::pushreg: case Instruction::pusharg:
+                Effect = sizeof(u64);        return true;
+            case Instruction::pushgen:
+                Effect = Mask;               return true;
+            case Instruction::pushall:
+                Effect = RegFile;            return true;
+            case Instruction::pushmem:
+                Effect = Ins.Imm16.Imm;      return true;
+            case Instruction::popreg:  case Instruction::poparg:
+                Effect = -(i32)sizeof(u64);  return true;
+            case Instruction::popgen:
+                Effect = -Mask;              return true;
+            case Instruction::popall:
+                Effect = -RegFile;           return true;
+            case Instruction::popmem:
+                Effect = -(i32)Ins.Imm16.Imm; return true;
+            default:
+                return false;
+        }
+    }
+
+    /// @brief Returns true for `Instruction`s after
+    /// which neither the Stack nor the Local Space
+    /// can be reasoned about.
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    bool IsBarrier(u8 Op) noexcept
+    {
+        switch ( Op ) {
+            case Instruction::call:  case Instruction::corecall:
+            case Instruction::spawn: case Instruction::spawnanon:
+            case Instruction::merge: case Instruction::muop:
+            case Instruction::cvop:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /// @brief Applies an `Instruction` to the state
+    /// it is entered with
+    ////////////////////////////////////////
+    static SiteState Transfer(const Instruction& Ins, SiteState In) noexcept
+    {
+        if ( IsBarrier(Ins.Any.Op) )
+            return { UNKNOWN, UNKNOWN };
+
+        i32 Effect = 0;
+        if ( GetStackEffect(Ins, Effect) )
+            In.Depth = OffsetValue(In.Depth, Effect);
+        // An oversized `requestlocal` always raises instead.
+        // `droplocal` is ignored, keeping `Local` an upper bound.
+        else if ( Ins.Any.Op == Instruction::requestlocal ) {
+            u32 Size = GetLocalAllocationSize(Ins.Imm16.Imm);
+            if ( Size <= 0xFFFF )
+                In.Local = OffsetValue(In.Local, (i32)Size);
+        }
+        return In;
+    }
+
+    /// ANALYSEFRAMEDEMAND:
+    ////////////////////////////////////////
+    u32 AnalyseFrameDemand(const Function& Func, CoreAllocator& Allocator,
+                           FrameDemand& Demand, u64* Proven,
+                           u32* LocalOffsets) noexcept
+    {
+        const Instruction* Code  = Func.GetCodeSpace();
+        u32                Count = Func.GetInstructionCount();
+
+        Demand = { 0, 0, 0 };
+        for ( u32 i = 0; i < INSTRUCTION_BITSET_WORDS; i++ )
+            Proven[i] = 0;
+        if ( !Code || !Func.IsVerified() )
+            return 0;
+
+        SiteState* In       = Allocator.Request<SiteState>(Count, SYSTEM_ALLOC_FLAGS);
+        u16*       Worklist = Allocator.Request<u16>(Count, SYSTEM_ALLOC_FLAGS);
+        if ( !In || !Worklist ) {
+            Allocator.Release(In);
+            Allocator.Release(Worklist);
+            return 0;
+        }
+
+        // One bit per `Instruction` currently on the Worklist
+        u64 Queued[INSTRUCTION_BITSET_WORDS] = {};
+        u32 Pending = 0;
+
+        for ( u32 i = 0; i < Count; i++ )
+            In[i] = { UNVISITED, UNVISITED };
+
+        auto Propagate = [&](u32 Target, SiteState State) {
+            SiteState& Site = In[Target];
+            SiteState  Next = { MergeValue(Site.Depth, State.Depth),
+                                MergeValue(Site.Local, State.Local) };
+            if ( Next.Depth == Site.Depth && Next.Local == Site.Local )
+                return;
+            Site = Next;
+            if ( !( Queued[Target / 64] & ( (u64)1 << (Target % 64) ) ) ) {
+                Queued[Target / 64] |= ( (u64)1 << (Target % 64) );
+                Worklist[Pending++] = (u16)Target;
+            }
+        };
+
+        // Every site changes at most twice, from UNVISITED
+        // to a known value and from there to UNKNOWN, so
+        // the Worklist always drains.
+        Propagate(0, { 0, 0 });
+        while ( Pending ) {
+            u32 IDX = Worklist[--Pending];
+            Queued[IDX / 64] &= ~( (u64)1 << (IDX % 64) );
+
+            const Instruction& Ins = Code[IDX];
+            SiteState Out = Transfer(Ins, In[IDX]);
+            u32 Next = IDX + Instruction::GetWordCount(Ins.Any.Op);
+
+            i32 Target = 0;
+            if ( Instruction::GetJumpTarget(Ins, IDX, Target) ) {
+                Propagate((u32)Target, Out);
+                if ( Ins.Any.Op == Instruction::jmp
+                  || Ins.Any.Op == Instruction::seek )
+                    continue;
+            }
+            if ( Ins.Any.Op != Instruction::ret && Next < Count )
+                Propagate(Next, Out);
+        }
+
+        bool Drops = false;
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) )
+            if ( Code[i].Any.Op == Instruction::droplocal )
+                Drops = true;
+
+        // Collect every site whose effect is fully known
+        u32 Sites = 0;
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            const Instruction& Ins = Code[i];
+            SiteState Before = In[i];
+            SiteState After  = Transfer(Ins, Before);
+            i32       Effect = 0;
+
+            if ( GetStackEffect(Ins, Effect) ) {
+                if ( Before.Depth == UNVISITED || Before.Depth == UNKNOWN
+                  || After.Depth == UNKNOWN )
+                    continue;
+                if ( After.Depth > 0 && (u32)After.Depth > Demand.StackPush )
+                    Demand.StackPush = (u32)After.Depth;
+                if ( After.Depth < 0 && (u32)-After.Depth > Demand.StackPop )
+                    Demand.StackPop = (u32)-After.Depth;
+            }
+            else if ( Ins.Any.Op == Instruction::requestlocal ) {
+                if ( Drops
+                  || Before.Local == UNVISITED || Before.Local == UNKNOWN
+                  || After.Local == UNKNOWN
+                  || GetLocalAllocationSize(Ins.Imm16.Imm) > 0xFFFF )
+                    continue;
+                if ( (u32)After.Local > Demand.Local )
+                    Demand.Local = (u32)After.Local;
+                LocalOffsets[i] = (u32)Before.Local;
+            }
+            else
+                continue;
+
+            Proven[i / 64] |= ( (u64)1 << (i % 64) );
+            Sites++;
+        }
+
+        Allocator.Release(In);
+        Allocator.Release(Worklist);
+        return Sites;
+    }
+
+    /// ANALYSEHOTCODE:
+    ////////////////////////////////////////
+    u32 AnalyseHotCode(const Function& Func, CoreAllocator& Allocator,
+                       const DecodedInstruction* Decoded, u32 Entry,
+                       u64* Hot) noexcept
+    {
+        const Instruction* Code  = Func.GetCodeSpace();
+        u32                Count = Func.GetInstructionCount();
+
+        for ( u32 i = 0; i < INSTRUCTION_BITSET_WORDS; i++ )
+            Hot[i] = 0;
+        if ( !Code || !Decoded || Entry >= Count )
+            return 0;
+
+        u16* Worklist = Allocator.Request<u16>(Count, SYSTEM_ALLOC_FLAGS);
+        if ( !Worklist )
+            return 0;
+
+        // Sites only ever turn hot, and are queued as they do
+        u32 Pending = 0;
+        u32 Sites   = 0;
+        auto Reach = [&](i32 Target) {
+            if ( Target < 0 || (u32)Target >= Count
+                 || ( Hot[Target / 64] & ( (u64)1 << (Target % 64) ) ) )
+                return;
+            Hot[Target / 64] |= ( (u64)1 << (Target % 64) );
+            Worklist[Pending++] = (u16)Target;
+            Sites++;
+        };
+
+        Reach((i32)Entry);
+        while ( Pending ) {
+            u32 IDX = Worklist[--Pending];
+            const Instruction& Ins = Code[IDX];
+            u32 Next = IDX + Instruction::GetWordCount(Ins.Any.Op);
+
+            i32 Target = 0;
+            if ( Instruction::GetJumpTarget(Ins, IDX, Target) ) {
+                if ( Ins.Any.Op == Instruction::jmp
+                  || Ins.Any.Op == Instruction::seek ) {
+                    Reach(Target);
+                    continue;
+                }
+                BranchProfile Profile = GetBranchProfile(Decoded[IDX]);
+                u32 Runs = (u32)Profile.Taken + Profile.NotTaken;
+                bool Sampled = ( Runs >= MIN_BRANCH_SAMPLES );
+                if ( !Sampled || Profile.Taken * COLD_BRANCH_RATIO > Runs )
+                    Reach(Target);
+                if ( !Sampled || Profile.NotTaken * COLD_BRANCH_RATIO > Runs )
+                    Reach((i32)Next);
+                continue;
+            }
+            if ( Ins.Any.Op != Instruction::ret )
+                Reach((i32)Next);
+        }
+
+        Allocator.Release(Worklist);
+        return Sites;
+    }
+
+    /// REGISTERS:
+    ////////////////////////////////////////
+
+    /// GETOPCLASS:
+    ////////////////////////////////////////
+    OpClass GetOpClass(const Instruction& Ins) noexcept
+    {
+        u8 Op = Ins.Any.Op;
+        switch ( Op ) {
+            case Instruction::nop:      case Instruction::chrono:
+            case Instruction::clr:      case Instruction::mov:
+            case Instruction::movimm:   case Instruction::movimm32:
+            case Instruction::movimm64: case Instruction::movimmf:
+            case Instruction::movimmd:
+                return OpClass::PURE;
+
+            case Instruction::ret:
+                return OpClass::RET;
+
+            case Instruction::div:  case Instruction::mod:
+            case Instruction::idiv: case Instruction::imod:
+            case Instruction::powi:
+            case Instruction::fdiv: case Instruction::fmod:
+            case Instruction::ddiv: case Instruction::dmod:
+                return OpClass::FAULTING;
+
+            // A zero immediate raises every time
+            case Instruction::divimm:  case Instruction::modimm:
+            case Instruction::idivimm: case Instruction::imodimm:
+                return ( Ins.Imm16Alt.Imm ? OpClass::PURE : OpClass::BARRIER );
+
+            default:
+                if ( Op >= Instruction::seek && Op <= Instruction::jmpgteq )
+                    return OpClass::BRANCH;
+                if ( Op >= Instruction::cmpis0 && Op <= Instruction::shrimm )
+                    return OpClass::PURE;
+                return OpClass::BARRIER;
+        }
+    }
+
+    /// GETREGOPERANDS:
+    ////////////////////////////////////////
+    RegOperands GetRegOperands(const Instruction& Ins) noexcept
+    {
+        const u8 None = VPCore::Register::UNUSED;
+        switch ( Instruction::GetLayout(Ins.Any.Op) ) {
+            case Instruction::Layout::ONE:
+            case Instruction::Layout::IMM16:
+            case Instruction::Layout::IMM32:
+            case Instruction::Layout::IMM64:
+                return { Ins.OneParam.rX, None, None };
+            case Instruction::Layout::DUAL:
+                return { Ins.DualParam.rX, Ins.DualParam.rY, None };
+            case Instruction::Layout::TRI:
+                return { Ins.TriParam.rX, Ins.TriParam.rY, Ins.TriParam.rZ };
+            case Instruction::Layout::ALT:
+            case Instruction::Layout::ALT_SIGNED:
+                return { (u8)( Ins.Imm16Alt.rX_rY >> 4 ),
+                         (u8)( Ins.Imm16Alt.rX_rY & 0x0F ), None };
+            default:
+                return { None, None, None };
+        }
+    }
+
+    /// GETREGREADS:
+    ////////////////////////////////////////
+    RegMask GetRegReads(const Instruction& Ins) noexcept
+    {
+        RegOperands Ops = GetRegOperands(Ins);
+        switch ( Ins.Any.Op ) {
+            case Instruction::nop: case Instruction::chrono:
+            case Instruction::clr:
+            case Instruction::seek: case Instruction::jmp:
+                return 0;
+            case Instruction::inc: case Instruction::dec:
+            case Instruction::jmpis0: case Instruction::jmpnot0:
+                return GetRegBit(Ops.X);
+            default:
+                break;
+        }
+        // Two register jumps compare rX against rY
+        if ( Ins.Any.Op >= Instruction::jmpeq && Ins.Any.Op <= Instruction::jmpgteq )
+            return (RegMask)( GetRegBit(Ops.X) | GetRegBit(Ops.Y) );
+
+        RegMask Reads = 0;
+        if ( Ops.Y != VPCore::Register::UNUSED )
+            Reads |= GetRegBit(Ops.Y);
+        if ( Ops.Z != VPCore::Register::UNUSED )
+            Reads |= GetRegBit(Ops.Z);
+        return Reads;
+    }
+    /// ANALYSELIVENESS:
+    ////////////////////////////////////////
+    bool AnalyseLiveness(const Function& Func, CoreAllocator& Allocator,
+                         RegMask* LiveOut) noexcept
+    {
+        const Instruction* Code  = Func.GetCodeSpace();
+        u32                Count = Func.GetInstructionCount();
+        if ( !Code || !Func.IsVerified() )
+            return false;
+
+        // Live on entry, indexed up to and including
+        // Count, the end of the Code Space
+        RegMask* Live   = Allocator.Request<RegMask>(Count + 1, SYSTEM_ALLOC_FLAGS);
+        u16*     Starts = Allocator.Request<u16>(Count, SYSTEM_ALLOC_FLAGS);
+        if ( !Live || !Starts ) {
+            Allocator.Release(Live);
+            Allocator.Release(Starts);
+            return false;
+        }
+
+        u32 Sites = 0;
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) )
+            Starts[Sites++] = (u16)i;
+        for ( u32 i = 0; i < Count; i++ ) {
+            Live[i]    = 0;
+            LiveOut[i] = ALL_REGISTERS;
+        }
+        Live[Count] = ALL_REGISTERS;
+
+        // Registers only ever turn live, so sweeping
+        // backwards until nothing changes terminates
+        for ( bool Changed = true; Changed; ) {
+            Changed = false;
+            for ( u32 s = Sites; s-- > 0; ) {
+                u32                IDX  = Starts[s];
+                const Instruction& Ins  = Code[IDX];
+                u32                Next = IDX + Instruction::GetWordCount(Ins.Any.Op);
+                RegMask            Out  = Live[Next];
+                RegMask            Mask = ALL_REGISTERS;
+                i32                Target = 0;
+
+                switch ( GetOpClass(Ins) ) {
+                    case OpClass::BRANCH:
+                        Instruction::GetJumpTarget(Ins, IDX, Target);
+                        if ( Ins.Any.Op == Instruction::jmp
+                          || Ins.Any.Op == Instruction::seek )
+                            Out = Live[Target];
+                        else
+                            Out |= Live[Target];
+                        Mask = (RegMask)( Out | GetRegReads(Ins) );
+                        break;
+                    case OpClass::PURE:
+                        Mask = (RegMask)( ( Out & ~GetRegBit(GetRegOperands(Ins).X) )
+                                        | GetRegReads(Ins) );
+                        break;
+                    case OpClass::RET:
+                        Out = ALL_REGISTERS;
+                        break;
+                    default:
+                        break;
+                }
+                LiveOut[IDX] = Out;
+                if ( Mask != Live[IDX] ) {
+                    Live[IDX] = Mask;
+                    Changed   = true;
+                }
+            }
+        }
+
+        Allocator.Release(Live);
+        Allocator.Release(Starts);
+        return true;
+    }
+
+    /// BOUNDS: CHECKS:
+    ////////////////////////////////////////
+
+    /// @brief Returns true for the `pload`/`psave` family
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    bool IsPrivateAccess(u8 Op) noexcept
+        { return ( Op >= Instruction::pload8 && Op <= Instruction::psave64 ); }
+
+    /// @brief Returns true for superinstructions, whose
+    /// handler also runs the `Instruction` after them
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    bool IsFusedPair(u8 Op) noexcept
+    {
+        switch ( Op ) {
+            case FUSED_CMPLT_JMPNOT0:   case UNCHECKED_FUSED_CMPLT_JMPNOT0:
+            case FUSED_MOVIMM_ADD:
+            case FUSED_INC_JMPLT:       case UNCHECKED_FUSED_INC_JMPLT:
+            case FUSED_PUSHREG_POPREG:  case UNCHECKED_FUSED_PUSHREG_POPREG:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /// @brief Retrieves the registers an `Instruction` inside
+    /// of a loop writes
+    /// @return False if it may free memory, or hand the
+    /// register file to other code.
+    ////////////////////////////////////////
+    static bool GetLoopWrites(const Instruction& Ins, RegMask& Writes) noexcept
+    {
+        switch ( GetOpClass(Ins) ) {
+            case OpClass::PURE:
+            case OpClass::FAULTING:
+                Writes = GetRegBit(GetRegOperands(Ins).X);
+                return true;
+            case OpClass::BRANCH:
+            case OpClass::RET:
+                Writes = 0;
+                return true;
+            default:
+                break;
+        }
+
+        switch ( Ins.Any.Op ) {
+            case Instruction::pload8:  case Instruction::pload16:
+            case Instruction::pload32: case Instruction::pload64:
+                Writes = GetRegBit(Ins.MemAccessPriv.rX);
+                return true;
+            case Instruction::gload8:  case Instruction::gload16:
+            case Instruction::gload32: case Instruction::gload64:
+                Writes = GetRegBit((u8)( Ins.MemAccess.rX_rY >> 4 ));
+                return true;
+            case Instruction::popreg:  case Instruction::poparg:
+                Writes = GetRegBit(Ins.OneParam.rX);
+                return true;
+            case Instruction::psave8:  case Instruction::psave16:
+            case Instruction::psave32: case Instruction::psave64:
+            case Instruction::gsave8:  case Instruction::gsave16:
+            case Instruction::gsave32: case Instruction::gsave64:
+            case Instruction::pushreg: case Instruction::pusharg:
+                Writes = 0;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /// ANALYSEBOUNDSCHECKS:
+    ////////////////////////////////////////
+    u32 AnalyseBoundsChecks(const Function& Func, CoreAllocator& Allocator,
+                            const DecodedInstruction* Decoded,
+                            BoundsGuard* Guards, u64* Proven) noexcept
+    {
+        const Instruction* Code  = Func.GetCodeSpace();
+        u32                Count = Func.GetInstructionCount();
+
+        for ( u32 i = 0; i < INSTRUCTION_BITSET_WORDS; i++ )
+            Proven[i] = 0;
+        if ( !Code || !Decoded || !Func.IsVerified() )
+            return 0;
+
+        // The amount of jumps landing before each site, so that
+        // those landing in a range can be told in one subtraction
+        u32* Landing = Allocator.Request<u32>(Count + 1, SYSTEM_ALLOC_FLAGS);
+        if ( !Landing )
+            return 0;
+        u64 Heads[INSTRUCTION_BITSET_WORDS];
+        for ( u32 i = 0; i < INSTRUCTION_BITSET_WORDS; i++ )
+            Heads[i] = 0;
+        for ( u32 i = 0; i <= Count; i++ )
+            Landing[i] = 0;
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            Heads[i / 64] |= ( (u64)1 << (i % 64) );
+            i32 Target = 0;
+            if ( Instruction::GetJumpTarget(Code[i], i, Target)
+                 && Target >= 0 && (u32)Target < Count )
+                Landing[Target + 1]++;
+        }
+        for ( u32 i = 1; i <= Count; i++ )
+            Landing[i] += Landing[i - 1];
+
+        // The `Instruction` before IDX, or Count if there is none
+        auto GetPrevious = [&](u32 IDX) {
+            while ( IDX-- > 0 )
+                if ( Heads[IDX / 64] & ( (u64)1 << (IDX % 64) ) )
+                    return IDX;
+            return Count;
+        };
+
+        u32 Found = 0;
+        for ( u32 Edge = 0; Edge < Count;
+              Edge += Instruction::GetWordCount(Code[Edge].Any.Op) ) {
+            const Instruction& Back = Code[Edge];
+            i32 Target = 0;
+            if ( !Instruction::GetJumpTarget(Back, Edge, Target)
+                 || Target < 1 || (u32)Target > Edge )
+                continue;
+            u32 Header = (u32)Target;
+
+            // The exit test compares the induction variable
+            // against its limit, both unsigned
+            u8 Index, Limit;
+            if ( Back.Any.Op == Instruction::jmplt ) {
+                Index = (u8)( Back.Imm16Alt.rX_rY >> 4 );
+                Limit = (u8)( Back.Imm16Alt.rX_rY & 0x0F );
+            }
+            else if ( Back.Any.Op == Instruction::jmpnot0 ) {
+                u32 Test = GetPrevious(Edge);
+                if ( Test == Count || Test < Header
+                     || Code[Test].Any.Op != Instruction::cmplt
+                     || Code[Test].TriParam.rX != Back.Imm16.rX )
+                    continue;
+                Index = Code[Test].TriParam.rY;
+                Limit = Code[Test].TriParam.rZ;
+                if ( Back.Imm16.rX == Index || Back.Imm16.rX == Limit )
+                    continue;
+            }
+            else
+                continue;
+
+            // The guard takes the place of the Preheader, which must
+            // not be skipped over by a superinstruction before it
+            u32 Preheader = GetPrevious(Header);
+            if ( Preheader == Count
+                 || GetOpClass(Code[Preheader]) != OpClass::PURE )
+                continue;
+            u32 Before = GetPrevious(Preheader);
+            if ( Before != Count && IsFusedPair(Decoded[Before].Op) )
+                continue;
+
+            RegMask Written = 0;
+            u32     Step    = Count;
+            u32     Inside  = 0;
+            bool    Valid   = true;
+            for ( u32 i = Header; Valid && i <= Edge;
+                  i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+                const Instruction& Ins = Code[i];
+                RegMask Writes = 0;
+                if ( !GetLoopWrites(Ins, Writes) )
+                    Valid = false;
+                if ( Ins.Any.Op == Instruction::inc && Ins.OneParam.rX == Index ) {
+                    Valid  = Valid && ( Step == Count );
+                    Step   = i;
+                    Writes = 0;
+                }
+                Written |= Writes;
+                if ( Instruction::GetJumpTarget(Ins, i, Target)
+                     && Target >= (i32)Header && (u32)Target <= Edge ) {
+                    if ( i == Edge || (u32)Target > i )
+                        Inside++;
+                    else
+                        Valid = false;
+                }
+            }
+            if ( !Valid || Step == Count
+                 || ( Written & ( GetRegBit(Index) | GetRegBit(Limit) ) )
+                 || Landing[Edge + 1] - Landing[Header] != Inside )
+                continue;
+
+            u64 Checks   = (u64)Index | ( (u64)Limit << 4 );
+            u32 Patterns = 0;
+            for ( u32 i = Header; i <= Edge;
+                  i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+                const Instruction& Ins = Code[i];
+                if ( !IsPrivateAccess(Ins.Any.Op) || Decoded[i].Op != Ins.Any.Op )
+                    continue;
+                u8 Base = Ins.MemAccessPriv.rY;
+                if ( ( Ins.MemAccessPriv.Scale >> 4 ) != Index
+                     || Base == Index || ( Written & GetRegBit(Base) ) )
+                    continue;
+
+                u64 Pattern = (u64)Base
+                            | ( (u64)( Ins.MemAccessPriv.Scale & 0x0F ) << 4 )
+                            | ( (u64)( ( Ins.Any.Op - Instruction::pload8 ) & 3 ) << 8 )
+                            | ( (u64)( Step < i ) << 10 );
+                u32 k = 0;
+                while ( k < Patterns
+                        && ( ( Checks >> ( 16 + k * 12 ) ) & 0xFFF ) != Pattern )
+                    k++;
+                if ( k == BOUNDS_GUARD_CHECKS )
+                    continue;
+                if ( k == Patterns ) {
+                    Checks |= Pattern << ( 16 + k * 12 );
+                    Patterns++;
+                }
+                Proven[i / 64] |= ( (u64)1 << (i % 64) );
+            }
+            if ( !Patterns )
+                continue;
+
+            Checks |= (u64)Patterns << 8;
+            Guards[Found++] = { Preheader, Header, Checks };
+        }
+
+        Allocator.Release(Landing);
+        return Found;
+    }
+
+    /// PASSESBOUNDSGUARD:
+    ////////////////////////////////////////
+    bool PassesBoundsGuard(u64 Checks, const VPCore::Register* Reg) noexcept
+    {
+        u64 Index = Reg[Checks & 0x0F].AsU64;
+        u64 Limit = Reg[( Checks >> 4 ) & 0x0F].AsU64;
+        // The largest index reaching an access before the step
+        u64 Last  = ( Limit > Index ? Limit - 1 : Index );
+
+        u32 Patterns = (u32)( ( Checks >> 8 ) & 0x07 );
+        for ( u32 k = 0; k < Patterns; k++ ) {
+            u64 Pattern = ( Checks >> ( 16 + k * 12 ) ) & 0xFFF;
+            MemoryAddress Base = Reg[Pattern & 0x0F].AsPtr;
+            if ( !Base )
+                return false;
+            u32 Size  = Base.QueryAllocatedSize();
+            u32 Width = 1u << ( ( Pattern >> 8 ) & 3 );
+            u64 Most  = Last + ( ( Pattern >> 10 ) & 1 );
+            if ( Most < Last || Size < Width
+                 || Most > (u64)( ( Size - Width ) >> ( ( Pattern >> 4 ) & 0x0F ) ) )
+                return false;
+        }
+        return true;
+    }
+
+    /// ESCAPES:
+    ////////////////////////////////////////
+
+    /// @brief Returns true if an `Instruction` inside of a pair
+    /// neither writes Ptr nor lets the address it holds escape
+    ////////////////////////////////////////
+    static bool KeepsAddress(const Instruction& Ins, u8 Ptr) noexcept
+    {
+        switch ( Ins.Any.Op ) {
+            case Instruction::pload8:  case Instruction::pload16:
+            case Instruction::pload32: case Instruction::pload64:
+            case Instruction::psave8:  case Instruction::psave16:
+            case Instruction::psave32: case Instruction::psave64:
+                return ( Ins.MemAccessPriv.rX != Ptr
+                      && ( Ins.MemAccessPriv.Scale >> 4 ) != Ptr );
+            case Instruction::memset:
+                return ( Ins.TriParam.rY != Ptr && Ins.TriParam.rZ != Ptr );
+            case Instruction::memcpy:
+                return ( Ins.TriParam.rZ != Ptr );
+            case Instruction::requestlocal:
+            case Instruction::droplocal:
+                return false;
+            default:
+                break;
+        }
+
+        switch ( Instruction::GetLayout(Ins.Any.Op) ) {
+            // Calls, spawns, `ret` and the whole register
+            // file `Instruction`s all come without operands
+            case Instruction::Layout::NONE:
+                return ( Ins.Any.Op == Instruction::nop );
+            case Instruction::Layout::MEM:
+                return ( ( Ins.MemAccess.rX_rY >> 4 ) != Ptr
+                      && ( Ins.MemAccess.rX_rY & 0x0F ) != Ptr
+                      && Ins.MemAccess.rZ != Ptr );
+            default: {
+                RegOperands Ops = GetRegOperands(Ins);
+                return ( Ops.X != Ptr && Ops.Y != Ptr && Ops.Z != Ptr );
+            }
+        }
+    }
+
+    /// ANALYSEESCAPES:
+    ////////////////////////////////////////
+    u32 AnalyseEscapes(const Function& Func, CoreAllocator& Allocator,
+                       u64* Paired) noexcept
+    {
+        const Instruction* Code  = Func.GetCodeSpace();
+        u32                Count = Func.GetInstructionCount();
+
+        for ( u32 i = 0; i < INSTRUCTION_BITSET_WORDS; i++ )
+            Paired[i] = 0;
+        if ( !Code || !Func.IsVerified() )
+            return 0;
+
+        // The amount of jumps landing before each site, so that
+        // those landing in a range can be told in one subtraction
+        u32* Landing = Allocator.Request<u32>(Count + 1, SYSTEM_ALLOC_FLAGS);
+        if ( !Landing )
+            return 0;
+        for ( u32 i = 0; i <= Count; i++ )
+            Landing[i] = 0;
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            i32 Target = 0;
+            if ( Instruction::GetJumpTarget(Code[i], i, Target)
+                 && Target >= 0 && (u32)Target < Count )
+                Landing[Target + 1]++;
+        }
+        for ( u32 i = 1; i <= Count; i++ )
+            Landing[i] += Landing[i - 1];
+
+        // The releases of the pairs still open, innermost last.
+        // Each pair holds its address in a register the pairs
+        // around it never write, so they never nest any deeper.
+        u32 Open[VPCore::Register::COUNT];
+        u32 Depth = 0;
+
+        u32 Found = 0;
+        for ( u32 Request = 0; Request < Count;
+              Request += Instruction::GetWordCount(Code[Request].Any.Op) ) {
+            if ( Code[Request].Any.Op != Instruction::requestbytes )
+                continue;
+            u8 Ptr = Code[Request].DualParam.rX;
+
+            u32  Release = Count;
+            u32  Inside  = 0;
+            i32  Lowest  = (i32)Count;
+            i32  Highest = 0;
+            bool Valid   = true;
+            for ( u32 i = Request + 1; Valid && i < Count;
+                  i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+                const Instruction& Ins = Code[i];
+                if ( Ins.Any.Op == Instruction::releasebytes
+                     && Ins.OneParam.rX == Ptr ) {
+                    Release = i;
+                    break;
+                }
+                i32 Target = 0;
+                if ( Instruction::GetJumpTarget(Ins, i, Target) ) {
+                    Lowest  = ( Target < Lowest  ? Target : Lowest  );
+                    Highest = ( Target > Highest ? Target : Highest );
+                    Inside++;
+                }
+                Valid = KeepsAddress(Ins, Ptr);
+            }
+            if ( !Valid || Release == Count
+                 || Lowest <= (i32)Request || Highest > (i32)Release
+                 || Landing[Release + 1] - Landing[Request + 1] != Inside )
+                continue;
+
+            // A pair overlapping one still open would release
+            // its allocation before the open one's
+            while ( Depth && Open[Depth - 1] < Request )
+                Depth--;
+            if ( ( Depth && Release > Open[Depth - 1] )
+                 || Depth == VPCore::Register::COUNT )
+                continue;
+            Open[Depth++] = Release;
+
+            Paired[Request / 64] |= ( (u64)1 << (Request % 64) );
+            Paired[Release / 64] |= ( (u64)1 << (Release % 64) );
+            Found++;
+        }
+
+        Allocator.Release(Landing);
+        return Found;
+    }
+
+}
@@ -0,0 +1,791 @@
+#include "Headers/Common.hpp"
+#include "Headers/CoreMemory.hpp"
+#include "Headers/FlatStorage.hpp"
+#include "Headers/Instructions.hpp"
+#include "Headers/ThreadMemory.hpp"
+#include "Headers/Functions.hpp"
+#include "Headers/VPCore.hpp"
+#include "Headers/VM.hpp"
+#include "Headers/Executor.hpp"
+#include "Headers/TemplateJIT.hpp"
+#include "Headers/OptimizingJIT.hpp"
+#include "Headers/Inliner.hpp"
+#include <chrono>
+#include <iostream>
+
+using std::cout;
+using namespace Octane;
+
+/// The amount of loop iterations each benchmark runs for
+static constexpr u32 ITERATIONS = 50000000;
+
+/// @brief A tight counting loop, executing
+/// 4 `Instruction`s per iteration:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, ITERATIONS
+/// LOOP:
+///     addimm   r0, r0, 3
+///     bxor     r3, r0, r1
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     ret
+////////////////////////////////////////
+static const Instruction LoopKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::MakeImm16Alt(Instruction::addimm, 0, 0, 3),
+    Instruction::Make(Instruction::bxor, 3, 0, 1),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 4),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 LoopKernelCount = 4 + ( 4 * (u64)ITERATIONS ) + 1;
+
+/// @brief A loop built from the compare-then-branch,
+/// constant-then-add and push/pop idioms, executing
+/// 7 `Instruction`s per iteration:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, ITERATIONS
+/// LOOP:
+///     movimm   r4, 3
+///     add      r0, r0, r4
+///     pushreg  r0
+///     popreg   r5
+///     inc      r1
+///     cmplt    r6, r1, r2
+///     jmpnot0  r6, LOOP
+///     ret
+////////////////////////////////////////
+static const Instruction MixedKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::MakeImm16(Instruction::movimm, 4, 3),
+    Instruction::Make(Instruction::add, 0, 0, 4),
+    Instruction::Make(Instruction::pushreg, 0),
+    Instruction::Make(Instruction::popreg, 5),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::Make(Instruction::cmplt, 6, 1, 2),
+    Instruction::MakeImm16(Instruction::jmpnot0, 6, 4),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 MixedKernelCount = 4 + ( 7 * (u64)ITERATIONS ) + 1;
+
+/// @brief A loop dominated by Stack traffic, executing
+/// 9 `Instruction`s per iteration:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, ITERATIONS
+/// LOOP:
+///     pushreg  r0
+///     pushreg  r1
+///     pushall
+///     popall
+///     popreg   r4
+///     popreg   r3
+///     bxor     r0, r3, r4
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     ret
+////////////////////////////////////////
+static const Instruction StackKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::Make(Instruction::pushreg, 0),
+    Instruction::Make(Instruction::pushreg, 1),
+    Instruction::Make(Instruction::pushall),
+    Instruction::Make(Instruction::popall),
+    Instruction::Make(Instruction::popreg, 4),
+    Instruction::Make(Instruction::popreg, 3),
+    Instruction::Make(Instruction::bxor, 0, 3, 4),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 4),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 StackKernelCount = 4 + ( 9 * (u64)ITERATIONS ) + 1;
+
+/// @brief A loop evaluating an expression as a stack
+/// machine would, every operand passing through the Stack,
+/// executing 12 `Instruction`s per iteration:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, ITERATIONS
+/// LOOP:
+///     pushreg  r0
+///     pushreg  r1
+///     popreg   r4
+///     popreg   r3
+///     add      r5, r3, r4
+///     pushreg  r5
+///     pushreg  r1
+///     popreg   r4
+///     popreg   r3
+///     bxor     r0, r3, r4
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     ret
+////////////////////////////////////////
+static const Instruction EvalKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::Make(Instruction::pushreg, 0),
+    Instruction::Make(Instruction::pushreg, 1),
+    Instruction::Make(Instruction::popreg, 4),
+    Instruction::Make(Instruction::popreg, 3),
+    Instruction::Make(Instruction::add, 5, 3, 4),
+    Instruction::Make(Instruction::pushreg, 5),
+    Instruction::Make(Instruction::pushreg, 1),
+    Instruction::Make(Instruction::popreg, 4),
+    Instruction::Make(Instruction::popreg, 3),
+    Instruction::Make(Instruction::bxor, 0, 3, 4),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 4),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 EvalKernelCount = 4 + ( 12 * (u64)ITERATIONS ) + 1;
+
+/// @brief A loop calling a bytecode `Function` through
+/// the `RelocationTable`, executing 5 `Instruction`s
+/// per iteration:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, ITERATIONS
+/// LOOP:
+///     call     Leaf
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     ret
+///
+/// Leaf:
+///     inc      r0
+///     ret
+////////////////////////////////////////
+static const Instruction CallKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::MakeImm16(Instruction::call, 0, 0),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 4),
+    Instruction::Make(Instruction::ret),
+};
+static const Instruction LeafKernel[] = {
+    Instruction::Make(Instruction::inc, 0),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 CallKernelCount = 4 + ( 5 * (u64)ITERATIONS ) + 1;
+
+/// @brief A loop saving the whole register file around
+/// every call to Leaf, executing 9 `Instruction`s per
+/// iteration:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, ITERATIONS
+/// LOOP:
+///     pushall
+///     call     Leaf
+///     popall
+///     movimm   r3, 1
+///     add      r0, r0, r3
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     ret
+////////////////////////////////////////
+static const Instruction SaveKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::Make(Instruction::pushall),
+    Instruction::MakeImm16(Instruction::call, 0, 0),
+    Instruction::Make(Instruction::popall),
+    Instruction::MakeImm16(Instruction::movimm, 3, 1),
+    Instruction::Make(Instruction::add, 0, 0, 3),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 4),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 SaveKernelCount = 4 + ( 9 * (u64)ITERATIONS ) + 1;
+
+/// @brief A loop calling Chain, which tail calls itself
+/// CHAIN_DEPTH times through the `RelocationTable`, executing
+/// 4 `Instruction`s per iteration and 4 per link of the chain:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, TAIL_ITERATIONS
+/// LOOP:
+///     movimm   r3, CHAIN_DEPTH
+///     call     Chain
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     ret
+///
+/// Chain:
+///     inc      r0
+///     dec      r3
+///     jmpis0   r3, END
+///     call     Chain
+/// END:
+///     ret
+////////////////////////////////////////
+static constexpr u32 CHAIN_DEPTH     = 8;
+static constexpr u32 TAIL_ITERATIONS = ITERATIONS / CHAIN_DEPTH;
+static const Instruction TailKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(TAIL_ITERATIONS),
+    Instruction::MakeImm16(Instruction::movimm, 3, CHAIN_DEPTH),
+    Instruction::MakeImm16(Instruction::call, 0, 1),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 4),
+    Instruction::Make(Instruction::ret),
+};
+static const Instruction ChainKernel[] = {
+    Instruction::Make(Instruction::inc, 0),
+    Instruction::Make(Instruction::dec, 3),
+    Instruction::MakeImm16(Instruction::jmpis0, 3, 4),
+    Instruction::MakeImm16(Instruction::call, 0, 1),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 TailKernelCount =
+    4 + ( ( 4 + 4 * (u64)CHAIN_DEPTH ) * (u64)TAIL_ITERATIONS ) + 1;
+
+/// @brief A loop calling Frame, which makes three Local
+/// allocations, executing 8 `Instruction`s per iteration:
+///
+///     clr          r0
+///     clr          r1
+///     movimm32     r2, ITERATIONS
+/// LOOP:
+///     call         Frame
+///     inc          r1
+///     jmplt        r1, r2, LOOP
+///     ret
+///
+/// Frame:
+///     requestlocal r4, 16
+///     requestlocal r5, 32
+///     inc          r0
+///     requestlocal r6, 8
+///     ret
+////////////////////////////////////////
+static const Instruction LocalKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::MakeImm16(Instruction::call, 0, 2),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 4),
+    Instruction::Make(Instruction::ret),
+};
+static const Instruction FrameKernel[] = {
+    Instruction::MakeImm16(Instruction::requestlocal, 4, 16),
+    Instruction::MakeImm16(Instruction::requestlocal, 5, 32),
+    Instruction::Make(Instruction::inc, 0),
+    Instruction::MakeImm16(Instruction::requestlocal, 6, 8),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 LocalKernelCount = 4 + ( 8 * (u64)ITERATIONS ) + 1;
+
+/// @brief A loop incrementing a global DATA `Symbol`,
+/// whose key is in the Shared Space, executing 5
+/// `Instruction`s per iteration:
+///
+///     clr      r1
+///     movimm32 r2, ITERATIONS
+///     offset   r3, 0
+///     clr      r4
+/// LOOP:
+///     gload64  r0, [r3 + r4 * 8]
+///     addimm   r0, r0, 1
+///     gsave64  r0, [r3 + r4 * 8]
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     clr      r3
+///     ret
+////////////////////////////////////////
+static const Instruction GlobalKernel[] = {
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::MakeImm16(Instruction::offset, 3, 0),
+    Instruction::Make(Instruction::clr, 4),
+    Instruction::Make(Instruction::gload64, ( 0 << 4 ) | 3, 4, 8),
+    Instruction::MakeImm16Alt(Instruction::addimm, 0, 0, 1),
+    Instruction::Make(Instruction::gsave64, ( 0 << 4 ) | 3, 4, 8),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 5),
+    Instruction::Make(Instruction::clr, 3),
+    Instruction::Make(Instruction::ret),
+};
+static const char GlobalKey[] = "Counter";
+static constexpr u64 GlobalKernelCount = 4 + ( 5 * (u64)ITERATIONS ) + 2;
+
+/// @brief A floating point accumulation, executing
+/// 5 `Instruction`s per iteration:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, ITERATIONS
+///     movimmd  r5, 0.5
+/// LOOP:
+///     i2d      r3, r1
+///     dmul     r3, r3, r5
+///     dadd     r0, r0, r3
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     ret
+////////////////////////////////////////
+static const Instruction FloatKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::Make(Instruction::movimmd, 5),
+    Instruction::MakeWord(0x00000000),
+    Instruction::MakeWord(0x3FE00000),
+    Instruction::Make(Instruction::i2d, 3, 1),
+    Instruction::Make(Instruction::dmul, 3, 3, 5),
+    Instruction::Make(Instruction::dadd, 0, 0, 3),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 7),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 FloatKernelCount = 4 + ( 5 * (u64)ITERATIONS ) + 1;
+
+/// @brief A loop dividing by immediates, executing
+/// 8 `Instruction`s per iteration:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, ITERATIONS
+/// LOOP:
+///     divimm   r4, r1, 10
+///     modimm   r5, r1, 7
+///     idivimm  r6, r1, -3
+///     add      r0, r0, r4
+///     add      r0, r0, r5
+///     add      r0, r0, r6
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     ret
+////////////////////////////////////////
+static const Instruction DivideKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::MakeImm16Alt(Instruction::divimm, 4, 1, 10),
+    Instruction::MakeImm16Alt(Instruction::modimm, 5, 1, 7),
+    Instruction::MakeImm16Alt(Instruction::idivimm, 6, 1, (u16)-3),
+    Instruction::Make(Instruction::add, 0, 0, 4),
+    Instruction::Make(Instruction::add, 0, 0, 5),
+    Instruction::Make(Instruction::add, 0, 0, 6),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 4),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 DivideKernelCount = 4 + ( 8 * (u64)ITERATIONS ) + 1;
+
+/// @brief A loop as a naive front-end might emit it, full of
+/// constants built at runtime, copies and jumps to jumps,
+/// executing 9 `Instruction`s per iteration:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, ITERATIONS
+/// LOOP:
+///     movimm   r4, 1
+///     addimm   r4, r4, 2
+///     mov      r5, r4
+///     add      r0, r0, r5
+///     mov      r0, r0
+///     jmp      NEXT
+/// NEXT:
+///     inc      r1
+///     jmplt    r1, r2, BACK
+///     ret
+/// BACK:
+///     jmp      LOOP
+////////////////////////////////////////
+static const Instruction NaiveKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(ITERATIONS),
+    Instruction::MakeImm16(Instruction::movimm, 4, 1),
+    Instruction::MakeImm16Alt(Instruction::addimm, 4, 4, 2),
+    Instruction::Make(Instruction::mov, 5, 4),
+    Instruction::Make(Instruction::add, 0, 0, 5),
+    Instruction::Make(Instruction::mov, 0, 0),
+    Instruction::MakeImm16(Instruction::jmp, 0, 10),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 13),
+    Instruction::Make(Instruction::ret),
+    Instruction::MakeImm16(Instruction::jmp, 0, 4),
+};
+static constexpr u64 NaiveKernelCount = 4 + ( 9 * (u64)ITERATIONS );
+
+/// The amount of u64s `ArrayKernel` sums per pass
+static constexpr u32 ARRAY_LENGTH = 250;
+
+/// @brief Sums an array in Private memory over and over,
+/// executing 4 `Instruction`s per element, all of whose
+/// bounds checks are proven once per pass:
+///
+///     movimm   r3, ARRAY_LENGTH * 8
+///     requestbytes r4, r3
+///     clr      r1
+///     movimm   r2, ARRAY_LENGTH
+/// FILL:
+///     psave64  r1, r4, r1 * 8
+///     inc      r1
+///     jmplt    r1, r2, FILL
+///     clr      r0
+///     clr      r5
+///     movimm32 r6, ITERATIONS / ARRAY_LENGTH
+/// PASS:
+///     clr      r1
+///     movimm   r2, ARRAY_LENGTH
+/// LOOP:
+///     pload64  r7, r4, r1 * 8
+///     add      r0, r0, r7
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     inc      r5
+///     jmplt    r5, r6, PASS
+///     releasebytes r4
+///     clr      r4
+///     ret
+////////////////////////////////////////
+static const Instruction ArrayKernel[] = {
+    Instruction::MakeImm16(Instruction::movimm, 3, ARRAY_LENGTH * 8),
+    Instruction::Make(Instruction::requestbytes, 4, 3),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::MakeImm16(Instruction::movimm, 2, ARRAY_LENGTH),
+    Instruction::Make(Instruction::psave64, 1, 4, ( 1 << 4 ) | 3),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 4),
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 5),
+    Instruction::Make(Instruction::movimm32, 6),
+    Instruction::MakeWord(ITERATIONS / ARRAY_LENGTH),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::MakeImm16(Instruction::movimm, 2, ARRAY_LENGTH),
+    Instruction::Make(Instruction::pload64, 7, 4, ( 1 << 4 ) | 3),
+    Instruction::Make(Instruction::add, 0, 0, 7),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 13),
+    Instruction::Make(Instruction::inc, 5),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 5, 6, 11),
+    Instruction::Make(Instruction::releasebytes, 4),
+    Instruction::Make(Instruction::clr, 4),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 ArrayKernelCount =
+    7 + ( 3 * (u64)ARRAY_LENGTH ) +
+    ( 4 + 4 * (u64)ARRAY_LENGTH ) * ( ITERATIONS / ARRAY_LENGTH ) + 3;
+
+/// The amount of scratch buffers `ScratchKernel` goes through
+static constexpr u32 SCRATCH_ITERATIONS = ITERATIONS / 10;
+
+/// @brief Requests a scratch buffer, uses it and releases it
+/// again on every iteration, executing 7 `Instruction`s per
+/// iteration. The buffer never escapes, so WARM kernels take
+/// it from the Local Frame instead of the heap:
+///
+///     clr      r0
+///     clr      r1
+///     movimm32 r2, SCRATCH_ITERATIONS
+///     movimm   r3, 64
+///     clr      r5
+/// LOOP:
+///     requestbytes r4, r3
+///     psave64  r1, r4, r5 * 8
+///     pload64  r6, r4, r5 * 8
+///     add      r0, r0, r6
+///     releasebytes r4
+///     inc      r1
+///     jmplt    r1, r2, LOOP
+///     clr      r4
+///     ret
+////////////////////////////////////////
+static const Instruction ScratchKernel[] = {
+    Instruction::Make(Instruction::clr, 0),
+    Instruction::Make(Instruction::clr, 1),
+    Instruction::Make(Instruction::movimm32, 2),
+    Instruction::MakeWord(SCRATCH_ITERATIONS),
+    Instruction::MakeImm16(Instruction::movimm, 3, 64),
+    Instruction::Make(Instruction::clr, 5),
+    Instruction::Make(Instruction::requestbytes, 4, 3),
+    Instruction::Make(Instruction::psave64, 1, 4, ( 5 << 4 ) | 3),
+    Instruction::Make(Instruction::pload64, 6, 4, ( 5 << 4 ) | 3),
+    Instruction::Make(Instruction::add, 0, 0, 6),
+    Instruction::Make(Instruction::releasebytes, 4),
+    Instruction::Make(Instruction::inc, 1),
+    Instruction::MakeImm16Alt(Instruction::jmplt, 1, 2, 6),
+    Instruction::Make(Instruction::clr, 4),
+    Instruction::Make(Instruction::ret),
+};
+static constexpr u64 ScratchKernelCount = 6 + ( 7 * (u64)SCRATCH_ITERATIONS ) + 2;
+
+/// @brief A way of running the kernels
+////////////////////////////////////////
+struct BenchmarkPass {
+    const char*  Label;
+    DispatchMode Mode;
+    /// Kernels turn HOT on their first entry if set
+    TierCompiler Compiler;
+    /// Events before a kernel turns HOT. Past 1, kernels
+    /// turn HOT mid-loop, through on-stack replacement.
+    u32          HotThreshold;
+    /// Kernels are passed through `OptimiseBytecode` first.
+    /// Their MIPS still count the original `Instruction`s.
+    bool         Optimise;
+    /// Kernels are linked through `InlineModule` first,
+    /// with MIPS counting the original `Instruction`s.
+    bool         Inline;
+    /// Events a kernel spends COLD, collecting the profile
+    /// which splits its compiled code into hot and cold parts.
+    /// If 0, kernels start out WARM.
+    u32          WarmThreshold;
+};
+
+/// @brief The registers a kernel returned with
+/// on the first pass. Every later pass must
+/// return with the same registers, so kernels
+/// clear any register holding an address.
+////////////////////////////////////////
+struct BenchmarkResult {
+    bool Recorded;
+    u64  Reg[VPCore::Register::COUNT];
+};
+
+/// The amount of kernel runs which raised or
+/// disagreed with their `BenchmarkResult`
+static u32 FailedRuns = 0;
+
+/// @brief Loads a kernel into a fresh `Function`
+////////////////////////////////////////
+template <u32 N>
+static void InitKernel(Function& Func, CoreAllocator& Allocator,
+                       const Instruction (&Kernel)[N],
+                       RelocationTable* Reloc = nullptr, u16 SharedSize = 0)
+{
+    Func.Init(Allocator, Reloc, N, SharedSize);
+    QuickCopy(Kernel, Func.GetCodeSpace(), sizeof(Kernel));
+}
+
+static void RunBenchmark(const char* Name, const BenchmarkPass& Pass,
+                         Function& Func, u64 InstructionCount,
+                         BenchmarkResult& Expected, VM& Instance, VPCore& Thread,
+                         ThreadMemory& Memory, CoreAllocator& Allocator,
+                         StorageDevice& Storage)
+{
+    Instance.SetDispatchMode(Pass.Mode);
+    ExecState State = {
+        Instance, nullptr, {}, Thread, Memory, Allocator, Storage, &Func
+    };
+
+    auto Start = std::chrono::steady_clock::now();
+    Exception::HandlerResult Result = Execute(State);
+    auto End   = std::chrono::steady_clock::now();
+
+    bool Failed = ( Result != Exception::HandlerResult::NO_EXCEPTION );
+    for ( byte i = 0; !Failed && i < VPCore::Register::COUNT; i++ ) {
+        if ( !Expected.Recorded )
+            Expected.Reg[i] = State.Reg[i].AsU64;
+        else if ( Expected.Reg[i] != State.Reg[i].AsU64 )
+            Failed = true;
+    }
+    if ( !Failed )
+        Expected.Recorded = true;
+    else
+        FailedRuns++;
+
+    f64 Seconds = std::chrono::duration<f64>(End - Start).count();
+    cout << Name << Pass.Label
+         << ( Failed ? "(FAILED) " : "" )
+         << Seconds << "s, "
+         << ( (f64)InstructionCount / Seconds / 1000000.0 ) << " MIPS\n";
+}
+
+int main(void)
+{
+    CoreAllocator Allocator;
+    FlatStorage   Storage;
+    ThreadMemory  Memory;
+    VPCore        Thread;
+    VM            Instance;
+
+    Storage.Init(Allocator);
+    Memory.Init(Allocator, 1024, 4096);
+
+    RelocationTable Reloc;
+    Reloc.Init(Allocator, &Storage, 3);
+    Reloc.AssignIDX(0, "Leaf");
+    Reloc.AssignIDX(1, "Chain");
+    Reloc.AssignIDX(2, "Frame");
+
+    Function Loop, Mixed, Stack, Eval, Leaf, Call, Save, Chain, Tail, Frame, Local,
+             Global, Float, Divide, Naive, Array, Scratch;
+    StorageRequest LeafRequest = {
+        SymbolType::FUNC, 0, "Leaf", &Leaf, sizeof(Function)
+    };
+    Storage.AssignSymbol(LeafRequest);
+    StorageRequest ChainRequest = {
+        SymbolType::FUNC, 0, "Chain", &Chain, sizeof(Function)
+    };
+    Storage.AssignSymbol(ChainRequest);
+    StorageRequest FrameRequest = {
+        SymbolType::FUNC, 0, "Frame", &Frame, sizeof(Function)
+    };
+    Storage.AssignSymbol(FrameRequest);
+
+    u64 Counter = 0;
+    StorageRequest CounterRequest = {
+        SymbolType::DATA, 0, GlobalKey, &Counter, sizeof(Counter)
+    };
+    Storage.AssignSymbol(CounterRequest);
+
+    // The JIT passes measure the same bytecode after compiling it
+    const BenchmarkPass Passes[] = {
+        { " [THREADED] ", DispatchMode::THREADED, nullptr,              1, false, false, 0 },
+        { " [SWITCH]   ", DispatchMode::SWITCH,   nullptr,              1, false, false, 0 },
+        { " [JIT]      ", DispatchMode::THREADED, CompileTemplateJIT,   1, false, false, 0 },
+        { " [OPT]      ", DispatchMode::THREADED, CompileOptimizingJIT, 1, false, false, 0 },
+        { " [OSR]      ", DispatchMode::THREADED, CompileOptimizingJIT,
+          1000, false, false, 0 },
+        { " [PEEPHOLE] ", DispatchMode::THREADED, nullptr,              1, true, false, 0 },
+        { " [INLINE]   ", DispatchMode::THREADED, nullptr,              1, false, true, 0 },
+        { " [SPLIT]    ", DispatchMode::THREADED, CompileTemplateJIT,
+          1000, false, false, 64 },
+    };
+
+    // Filled in by the first pass, then checked by every other
+    BenchmarkResult Results[14] = {};
+
+    for ( const BenchmarkPass& Pass : Passes ) {
+        // Every kernel is entered only once, so start them out
+        // WARM rather than measuring their COLD form, unless
+        // the pass profiles them first
+        TierPolicy Policy;
+        Policy.WarmThreshold = Pass.WarmThreshold;
+        Policy.HotThreshold  = Pass.HotThreshold;
+        Instance.SetTierPolicy(Policy);
+        Instance.SetTierCompiler(Pass.Compiler);
+        Instance.SetBytecodeOptimisation(Pass.Optimise);
+
+        // Each pass tiers up a fresh copy of every kernel
+        InitKernel(Loop,  Allocator, LoopKernel);
+        InitKernel(Mixed, Allocator, MixedKernel);
+        InitKernel(Stack, Allocator, StackKernel);
+        InitKernel(Eval,  Allocator, EvalKernel);
+        InitKernel(Leaf,  Allocator, LeafKernel);
+        InitKernel(Call,  Allocator, CallKernel, &Reloc);
+        InitKernel(Save,  Allocator, SaveKernel, &Reloc);
+        InitKernel(Chain, Allocator, ChainKernel, &Reloc);
+        InitKernel(Tail,  Allocator, TailKernel, &Reloc);
+        InitKernel(Frame, Allocator, FrameKernel);
+        InitKernel(Local, Allocator, LocalKernel, &Reloc);
+        InitKernel(Global, Allocator, GlobalKernel, nullptr, sizeof(GlobalKey));
+        InitKernel(Float, Allocator, FloatKernel);
+        InitKernel(Divide, Allocator, DivideKernel);
+        InitKernel(Naive, Allocator, NaiveKernel);
+        InitKernel(Array, Allocator, ArrayKernel);
+        InitKernel(Scratch, Allocator, ScratchKernel);
+        QuickCopy(GlobalKey, Global.GetSharedSpace(), sizeof(GlobalKey));
+        Storage.AdvanceGeneration();
+        Counter = 0;
+        if ( Pass.Inline ) {
+            Function* const Module[] = {
+                &Loop, &Mixed, &Stack, &Eval, &Leaf, &Call, &Save, &Chain,
+                &Tail, &Frame, &Local, &Global, &Float, &Divide, &Naive,
+                &Array, &Scratch
+            };
+            InlineModule(Module, sizeof(Module) / sizeof(Module[0]), Allocator);
+        }
+
+        RunBenchmark("Loop ", Pass, Loop, LoopKernelCount,
+                     Results[0], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Mixed", Pass, Mixed, MixedKernelCount,
+                     Results[1], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Stack", Pass, Stack, StackKernelCount,
+                     Results[2], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Eval ", Pass, Eval, EvalKernelCount,
+                     Results[3], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Call ", Pass, Call, CallKernelCount,
+                     Results[4], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Save ", Pass, Save, SaveKernelCount,
+                     Results[5], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Tail ", Pass, Tail, TailKernelCount,
+                     Results[6], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Local", Pass, Local, LocalKernelCount,
+                     Results[7], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Global", Pass, Global, GlobalKernelCount,
+                     Results[8], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Float", Pass, Float, FloatKernelCount,
+                     Results[9], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Divide", Pass, Divide, DivideKernelCount,
+                     Results[10], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Naive", Pass, Naive, NaiveKernelCount,
+                     Results[11], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Array", Pass, Array, ArrayKernelCount,
+                     Results[12], Instance, Thread, Memory, Allocator, Storage);
+        RunBenchmark("Scratch", Pass, Scratch, ScratchKernelCount,
+                     Results[13], Instance, Thread, Memory, Allocator, Storage);
+        if ( Pass.WarmThreshold ) {
+            const CodeCacheStats& Split = Instance.GetCodeCache().GetStats();
+            cout << "Hot code: " << ( Split.BytesResident - Split.BytesCold )
+                 << " bytes, cold code: " << Split.BytesCold << " bytes\n";
+        }
+
+        Loop.Free(Allocator);
+        Mixed.Free(Allocator);
+        Stack.Free(Allocator);
+        Eval.Free(Allocator);
+        Leaf.Free(Allocator);
+        Call.Free(Allocator);
+        Save.Free(Allocator);
+        Chain.Free(Allocator);
+        Tail.Free(Allocator);
+        Frame.Free(Allocator);
+        Local.Free(Allocator);
+        Global.Free(Allocator);
+        Float.Free(Allocator);
+        Divide.Free(Allocator);
+        Naive.Free(Allocator);
+        Array.Free(Allocator);
+        Scratch.Free(Allocator);
+    }
+
+    const CodeCacheStats& Code = Instance.GetCodeCache().GetStats();
+    std::cout << "Code cache: " << Code.Hits << " hits, "
+              << Code.Misses << " misses, "
+              << Code.Evictions << " evictions\n";
+
+    Reloc.Free(Allocator);
+    Storage.Free();
+    Memory.Free(Allocator);
+
+    return ( FailedRuns ? 1 : 0 );
+}
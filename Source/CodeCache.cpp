@@ -0,0 +1,275 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#define OCTVM_INTERNAL 1
+
+#include "Headers/CodeCache.hpp"
+#include "Headers/TemplateJIT.hpp"
+#include "Headers/VM.hpp"
+
+namespace Octane {
+
+    /// @brief Rounds Size up to `CodeCache::CODE_ALIGNMENT`
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    u64 GetAlignedSize(u64 Size) noexcept
+    {
+        return ( Size + CodeCache::CODE_ALIGNMENT - 1 )
+             / CodeCache::CODE_ALIGNMENT * CodeCache::CODE_ALIGNMENT;
+    }
+
+    /// DESTRUCTOR:
+    ////////////////////////////////////////
+    CodeCache::~CodeCache(void) noexcept
+    {
+        // Functions outliving the VM are compiled again
+        // by the next one to run them
+        while ( m_Stats.Resident ) {
+            Function& Owner = *m_Regions[0].Owner;
+            Owner.DropCompiled(1);
+            Release(Owner);
+        }
+        if ( m_Regions )
+            m_Allocator->Release(m_Regions);
+        if ( m_Free )
+            m_Allocator->Release(m_Free);
+    #if OCTVM_TEMPLATE_JIT
+        if ( m_Arena )
+            UnmapJITArena(m_Arena, m_ArenaSize);
+    #endif
+    }
+
+    /// ARENA:
+    ////////////////////////////////////////
+    bool CodeCache::Grow(void) noexcept
+    {
+    #if OCTVM_TEMPLATE_JIT
+        if ( !m_Arena ) {
+            m_ArenaSize = ( m_Limit && m_Limit < MAX_ARENA_SIZE
+                            ? GetAlignedSize(m_Limit) : MAX_ARENA_SIZE );
+            m_Arena = MapJITArena(m_ArenaSize);
+            if ( !m_Arena )
+                return false;
+        }
+    #else
+        return false;
+    #endif
+
+        if ( m_Stats.Resident == m_Capacity ) {
+            u32 Capacity = ( m_Capacity ? m_Capacity * 2 : 16 );
+            Region* Regions = m_Allocator->Request<Region>(Capacity,
+                                                           SYSTEM_ALLOC_FLAGS);
+            if ( !Regions )
+                return false;
+            if ( m_Regions ) {
+                QuickCopy(m_Regions, Regions, m_Stats.Resident * sizeof(Region));
+                m_Allocator->Release(m_Regions);
+            }
+            m_Regions  = Regions;
+            m_Capacity = Capacity;
+        }
+
+        // Each region holds at most two pieces, and carving never
+        // splits a Span, so the free list holds at most one more
+        // Span than there are pieces, including the two of the
+        // region being compiled
+        u32 Needed = m_Capacity * 2 + 3;
+        if ( m_FreeCapacity < Needed ) {
+            Span* Free = m_Allocator->Request<Span>(Needed, SYSTEM_ALLOC_FLAGS);
+            if ( !Free )
+                return false;
+            if ( m_Free ) {
+                QuickCopy(m_Free, Free, m_FreeCount * sizeof(Span));
+                m_Allocator->Release(m_Free);
+            }
+            else
+                Free[m_FreeCount++] = { 0, m_ArenaSize };
+            m_Free         = Free;
+            m_FreeCapacity = Needed;
+        }
+        return true;
+    }
+
+    byte* CodeCache::Carve(u64 Size, bool Cold) noexcept
+    {
+        // Hot code takes the lowest Span it fits in,
+        // cold code the highest one
+        for ( u32 n = 0; n < m_FreeCount; n++ ) {
+            u32   IDX  = ( Cold ? m_FreeCount - 1 - n : n );
+            Span& Free = m_Free[IDX];
+            if ( Free.Size < Size )
+                continue;
+            u64 Offset = ( Cold ? Free.Offset + Free.Size - Size
+                                : Free.Offset );
+            if ( !Cold )
+                Free.Offset += Size;
+            Free.Size -= Size;
+            if ( !Free.Size ) {
+                m_FreeCount--;
+                for ( u32 i = IDX; i < m_FreeCount; i++ )
+                    m_Free[i] = m_Free[i + 1];
+            }
+            return m_Arena + Offset;
+        }
+        return nullptr;
+    }
+
+    void CodeCache::Uncarve(byte* Code, u64 Size) noexcept
+    {
+        u64 Offset = (u64)( Code - m_Arena );
+        u32 IDX = 0;
+        while ( IDX < m_FreeCount && m_Free[IDX].Offset < Offset )
+            IDX++;
+
+        bool Before = ( IDX > 0 && m_Free[IDX - 1].Offset
+                                   + m_Free[IDX - 1].Size == Offset );
+        bool After  = ( IDX < m_FreeCount
+                        && Offset + Size == m_Free[IDX].Offset );
+        if ( Before && After ) {
+            m_Free[IDX - 1].Size += Size + m_Free[IDX].Size;
+            m_FreeCount--;
+            for ( u32 i = IDX; i < m_FreeCount; i++ )
+                m_Free[i] = m_Free[i + 1];
+        }
+        else if ( Before )
+            m_Free[IDX - 1].Size += Size;
+        else if ( After )
+            m_Free[IDX] = { Offset, Size + m_Free[IDX].Size };
+        else {
+            for ( u32 i = m_FreeCount; i > IDX; i-- )
+                m_Free[i] = m_Free[i - 1];
+            m_Free[IDX] = { Offset, Size };
+            m_FreeCount++;
+        }
+    }
+
+    /// REGIONS:
+    ////////////////////////////////////////
+    void CodeCache::ReleaseRegion(u32 IDX) noexcept
+    {
+        Region& Target = m_Regions[IDX];
+        byte* Code;
+        QuickCopy(&Target.Code, &Code, sizeof(Code));
+        Unreserve(Code, Target.Size);
+        if ( Target.Cold )
+            Unreserve(Target.Cold, Target.ColdSize);
+        if ( Target.Data )
+            m_Allocator->Release(MemoryAddress(Target.Data));
+        m_Stats.BytesResident -= GetAlignedSize(Target.Size)
+                               + GetAlignedSize(Target.ColdSize);
+        m_Stats.BytesCold     -= GetAlignedSize(Target.ColdSize);
+        Target = m_Regions[--m_Stats.Resident];
+    }
+
+    void CodeCache::Insert(Function& Owner, ExposedFunc Code, u64 Size,
+                           void* Data, byte* Cold, u64 ColdSize) noexcept
+    {
+        m_Regions[m_Stats.Resident++] = { Code, Size, &Owner, Data,
+                                          Cold, ( Cold ? ColdSize : 0 ) };
+        m_Stats.BytesResident += GetAlignedSize(Size)
+                               + ( Cold ? GetAlignedSize(ColdSize) : 0 );
+        m_Stats.BytesCold     += ( Cold ? GetAlignedSize(ColdSize) : 0 );
+        Owner.AssignCodeCache(this);
+        // New code starts out as the most recently used
+        Owner.MarkCodeUse(m_Stats.Hits);
+    }
+
+    void CodeCache::Release(Function& Owner, ExposedFunc Code) noexcept
+    {
+        if ( !Code )
+            return;
+        bool Owned = false;
+        for ( u32 i = 0; i < m_Stats.Resident; i++ ) {
+            if ( m_Regions[i].Owner != &Owner )
+                continue;
+            if ( m_Regions[i].Code == Code )
+                ReleaseRegion(i--);
+            else
+                Owned = true;
+        }
+        if ( !Owned )
+            Owner.AssignCodeCache(nullptr);
+    }
+
+    void CodeCache::Release(Function& Owner) noexcept
+    {
+        for ( u32 i = 0; i < m_Stats.Resident; i++ )
+            if ( m_Regions[i].Owner == &Owner )
+                ReleaseRegion(i--);
+        Owner.AssignCodeCache(nullptr);
+    }
+
+    /// EVICTION:
+    ////////////////////////////////////////
+    bool CodeCache::EvictColdest(ExecState& State,
+                                 const Function& Keep) noexcept
+    {
+        Function* Coldest = nullptr;
+        for ( u32 i = 0; i < m_Stats.Resident; i++ ) {
+            Function* Owner = m_Regions[i].Owner;
+            if ( Owner != &Keep
+                 && ( !Coldest || Owner->GetCodeUse() < Coldest->GetCodeUse() ) )
+                Coldest = Owner;
+        }
+        if ( !Coldest )
+            return false;
+
+        Coldest->DropCompiled(State.VMInstance.GetTierPolicy().HotThreshold);
+        Release(*Coldest);
+        m_Stats.Evictions++;
+        // Call sites caching its native entry point re-resolve
+        State.Storage.AdvanceGeneration();
+        return true;
+    }
+
+    byte* CodeCache::Reserve(ExecState& State, const Function& For,
+                             u64 Size, bool Cold) noexcept
+    {
+        m_Allocator = &State.Allocator;
+        if ( !Grow() )
+            return nullptr;
+
+        Size = GetAlignedSize(Size);
+        for (;;) {
+            if ( ( !m_Limit || m_Stats.BytesResident + Size <= m_Limit )
+                 && m_Allocator->RequestExternal(Size) == MEMORY_OK ) {
+                byte* Code = Carve(Size, Cold);
+                if ( Code )
+                    return Code;
+                // Too fragmented, or the arena is full
+                m_Allocator->ReleaseExternal(Size);
+            }
+            if ( !EvictColdest(State, For) )
+                return nullptr;
+        }
+    }
+
+    void CodeCache::Unreserve(byte* Code, u64 Size) noexcept
+    {
+        Size = GetAlignedSize(Size);
+        Uncarve(Code, Size);
+        m_Allocator->ReleaseExternal(Size);
+    }
+
+}
@@ -72,6 +72,17 @@ namespace Octane {
         return true;
     }
 
+    bool QuickStrCmp(const char* A, const char* B) noexcept
+    {
+        while ( *A == *B ) {
+            if ( *A == 0 )
+                return true;
+            A++;
+            B++;
+        }
+        return false;
+    }
+
     //////////////// TODO: /////////////////
     /// Probably just replace this with a
     /// direct call to memcpy(), as it would
@@ -0,0 +1,333 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#define OCTVM_INTERNAL 1
+
+#include "Headers/Compressed.hpp"
+#include "Headers/Functions.hpp"
+
+namespace Octane {
+
+    /// @brief How the operand byte of a compressed
+    /// parcel unpacks into the bytes of a word
+    ////////////////////////////////////////
+    enum class FormKind : u8 {
+        /// Op, b, 0, 0
+        BYTE,
+        /// Op, lo nibble, hi nibble, 0
+        NIBBLES,
+        /// Op, x, x, z from x in the lo and z in the hi nibble,
+        /// the two-address form of a three register Opcode
+        TWO_ADDRESS,
+        /// Op, x:x, Imm from x in the lo and Imm in the hi nibble,
+        /// an `ALT` Opcode updating a register in place
+        SAME_ALT,
+        /// Op, 0, Imm from an i8 Imm, a short `seek`
+        SHORT_SEEK,
+    };
+
+    struct CompressedForm
+    {
+        Instruction::Opcode Op;
+        FormKind            Kind;
+    };
+
+    /// The compressed forms, indexed by their tag less
+    /// `COMPRESSED_TAG_BASE`. Only the first form of an
+    /// Opcode which reproduces a word is ever used.
+    ////////////////////////////////////////
+    static const CompressedForm COMPRESSED_FORMS[] = {
+        { Instruction::nop,          FormKind::BYTE        },
+        { Instruction::ret,          FormKind::BYTE        },
+        { Instruction::chrono,       FormKind::BYTE        },
+        { Instruction::clr,          FormKind::BYTE        },
+        { Instruction::inc,          FormKind::BYTE        },
+        { Instruction::dec,          FormKind::BYTE        },
+        { Instruction::pushreg,      FormKind::BYTE        },
+        { Instruction::popreg,       FormKind::BYTE        },
+        { Instruction::pusharg,      FormKind::BYTE        },
+        { Instruction::poparg,       FormKind::BYTE        },
+        { Instruction::pushall,      FormKind::BYTE        },
+        { Instruction::popall,       FormKind::BYTE        },
+        { Instruction::releasebytes, FormKind::BYTE        },
+        { Instruction::droplocal,    FormKind::BYTE        },
+        { Instruction::movimm32,     FormKind::BYTE        },
+        { Instruction::movimm64,     FormKind::BYTE        },
+        { Instruction::movimmf,      FormKind::BYTE        },
+        { Instruction::movimmd,      FormKind::BYTE        },
+
+        { Instruction::mov,          FormKind::NIBBLES     },
+        { Instruction::movimm,       FormKind::NIBBLES     },
+        { Instruction::lnot,         FormKind::NIBBLES     },
+        { Instruction::bnot,         FormKind::NIBBLES     },
+        { Instruction::cmpis0,       FormKind::NIBBLES     },
+        { Instruction::cmpnot0,      FormKind::NIBBLES     },
+        { Instruction::offset,       FormKind::NIBBLES     },
+        { Instruction::p2g,          FormKind::NIBBLES     },
+        { Instruction::requestbytes, FormKind::NIBBLES     },
+        { Instruction::i2f,          FormKind::NIBBLES     },
+        { Instruction::i2d,          FormKind::NIBBLES     },
+
+        { Instruction::add,          FormKind::TWO_ADDRESS },
+        { Instruction::sub,          FormKind::TWO_ADDRESS },
+        { Instruction::mul,          FormKind::TWO_ADDRESS },
+        { Instruction::div,          FormKind::TWO_ADDRESS },
+        { Instruction::mod,          FormKind::TWO_ADDRESS },
+        { Instruction::band,         FormKind::TWO_ADDRESS },
+        { Instruction::bor,          FormKind::TWO_ADDRESS },
+        { Instruction::bxor,         FormKind::TWO_ADDRESS },
+        { Instruction::shl,          FormKind::TWO_ADDRESS },
+        { Instruction::shr,          FormKind::TWO_ADDRESS },
+        { Instruction::land,         FormKind::TWO_ADDRESS },
+        { Instruction::lor,          FormKind::TWO_ADDRESS },
+        { Instruction::fadd,         FormKind::TWO_ADDRESS },
+        { Instruction::fsub,         FormKind::TWO_ADDRESS },
+        { Instruction::fmul,         FormKind::TWO_ADDRESS },
+        { Instruction::dadd,         FormKind::TWO_ADDRESS },
+        { Instruction::dsub,         FormKind::TWO_ADDRESS },
+        { Instruction::dmul,         FormKind::TWO_ADDRESS },
+
+        { Instruction::addimm,       FormKind::SAME_ALT    },
+        { Instruction::subimm,       FormKind::SAME_ALT    },
+        { Instruction::mulimm,       FormKind::SAME_ALT    },
+        { Instruction::bandimm,      FormKind::SAME_ALT    },
+        { Instruction::shlimm,       FormKind::SAME_ALT    },
+        { Instruction::shrimm,       FormKind::SAME_ALT    },
+
+        { Instruction::seek,         FormKind::SHORT_SEEK  },
+    };
+
+    constexpr const u32 COMPRESSED_FORM_COUNT =
+        sizeof(COMPRESSED_FORMS) / sizeof(COMPRESSED_FORMS[0]);
+
+    static_assert(COMPRESSED_TAG_BASE + COMPRESSED_FORM_COUNT
+                      <= COMPRESSED_ESCAPE,
+                  "Compressed forms must not collide with the escape");
+
+    /// @brief Unpacks the operand byte of a compressed parcel
+    ////////////////////////////////////////
+    static Instruction ExpandForm(const CompressedForm& Form,
+                                  u8 Operands) noexcept
+    {
+        u8 Lo = Operands & 0x0F;
+        u8 Hi = Operands >> 4;
+        switch ( Form.Kind ) {
+            case FormKind::BYTE:
+                return Instruction::Make(Form.Op, Operands);
+            case FormKind::NIBBLES:
+                return Instruction::Make(Form.Op, Lo, Hi);
+            case FormKind::TWO_ADDRESS:
+                return Instruction::Make(Form.Op, Lo, Lo, Hi);
+            case FormKind::SAME_ALT:
+                return Instruction::MakeImm16Alt(Form.Op, Lo, Lo, Hi);
+            case FormKind::SHORT_SEEK:
+            default:
+                return Instruction::MakeImm16(Form.Op, 0,
+                                              (u16)(i16)(i8)Operands);
+        }
+    }
+
+    /// @brief Packs a word into the operand byte of a form.
+    /// The result is only meaningful if it expands back
+    /// into the very same word.
+    ////////////////////////////////////////
+    static u8 PackForm(const CompressedForm& Form,
+                       const Instruction& Ins) noexcept
+    {
+        switch ( Form.Kind ) {
+            case FormKind::BYTE:
+                return Ins.RawBytes[1];
+            case FormKind::NIBBLES:
+                return (u8)( (Ins.RawBytes[1] & 0x0F)
+                           | (Ins.RawBytes[2] << 4) );
+            case FormKind::TWO_ADDRESS:
+                return (u8)( (Ins.RawBytes[1] & 0x0F)
+                           | (Ins.RawBytes[3] << 4) );
+            case FormKind::SAME_ALT:
+                return (u8)( (Ins.Imm16Alt.rX_rY & 0x0F)
+                           | (Ins.Imm16Alt.Imm << 4) );
+            case FormKind::SHORT_SEEK:
+            default:
+                return (u8)Ins.Imm16.Imm;
+        }
+    }
+
+    /// @brief Finds the compressed parcel of a word
+    /// @return False if the word has no compressed form.
+    ////////////////////////////////////////
+    static bool FindForm(const Instruction& Ins, u16& Parcel) noexcept
+    {
+        for ( u32 Tag = 0; Tag < COMPRESSED_FORM_COUNT; Tag++ ) {
+            const CompressedForm& Form = COMPRESSED_FORMS[Tag];
+            if ( Form.Op != Ins.Any.Op )
+                continue;
+
+            u8 Operands = PackForm(Form, Ins);
+            if ( ExpandForm(Form, Operands).RawInt == Ins.RawInt ) {
+                Parcel = (u16)( (COMPRESSED_TAG_BASE + Tag) | (Operands << 8) );
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Returns the amount of trailing immediate
+    /// words following a head word
+    ////////////////////////////////////////
+    static OctVM_SternInline u32 GetTrailCount(const Instruction& Ins) noexcept
+    {
+        return Instruction::GetWordCount(Ins.Any.Op) - 1u;
+    }
+
+    static OctVM_SternInline void PutWord(const Instruction& Ins,
+                                          u16* Out) noexcept
+    {
+        QuickCopy(&Ins, Out, sizeof(Instruction));
+    }
+
+    static OctVM_SternInline Instruction GetWord(const u16* In) noexcept
+    {
+        Instruction Ins;
+        QuickCopy(In, &Ins, sizeof(Instruction));
+        return Ins;
+    }
+
+    /// @brief Compresses a Code Space, or only counts its
+    /// parcels if Out is null
+    ////////////////////////////////////////
+    static u32 Compress(const Instruction* Code, u32 Count, u16* Out) noexcept
+    {
+        u32 Parcels = 0;
+        u32 IDX     = 0;
+        while ( IDX < Count ) {
+            const Instruction& Head = Code[IDX++];
+            u16                Parcel;
+
+            if ( FindForm(Head, Parcel) ) {
+                if ( Out ) Out[Parcels] = Parcel;
+                Parcels += 1;
+            } else {
+                if ( Head.Any.Op >= COMPRESSED_TAG_BASE ) {
+                    if ( Out ) Out[Parcels] = COMPRESSED_ESCAPE;
+                    Parcels += 1;
+                }
+                if ( Out ) PutWord(Head, Out + Parcels);
+                Parcels += 2;
+            }
+
+            // Trailing immediates are raw data, so they
+            // are never read as a compressed parcel
+            for ( u32 Trail = GetTrailCount(Head);
+                  Trail && IDX < Count; Trail--, IDX++ ) {
+                if ( Out ) PutWord(Code[IDX], Out + Parcels);
+                Parcels += 2;
+            }
+        }
+        return Parcels;
+    }
+
+    /// @brief Expands a compressed stream, or only counts its
+    /// words if Out is null
+    /// @return 0 if the stream ends in the middle of a word.
+    ////////////////////////////////////////
+    static u32 Expand(const u16* Stream, u32 Parcels, Instruction* Out) noexcept
+    {
+        u32 Count = 0;
+        u32 IDX   = 0;
+        while ( IDX < Parcels ) {
+            u16         Parcel = Stream[IDX];
+            u8          Tag    = (u8)Parcel;
+            Instruction Head;
+
+            if ( Tag >= COMPRESSED_TAG_BASE && Tag != COMPRESSED_ESCAPE ) {
+                if ( Tag >= COMPRESSED_TAG_BASE + COMPRESSED_FORM_COUNT )
+                    return 0;
+                Head = ExpandForm(COMPRESSED_FORMS[Tag - COMPRESSED_TAG_BASE],
+                                  (u8)( Parcel >> 8 ));
+                IDX += 1;
+            } else {
+                if ( Tag == COMPRESSED_ESCAPE )
+                    IDX += 1;
+                if ( Parcels - IDX < 2 )
+                    return 0;
+                Head = GetWord(Stream + IDX);
+                IDX += 2;
+            }
+            if ( Out ) Out[Count] = Head;
+            Count += 1;
+
+            for ( u32 Trail = GetTrailCount(Head);
+                  Trail && IDX < Parcels; Trail-- ) {
+                if ( Parcels - IDX < 2 )
+                    return 0;
+                if ( Out ) Out[Count] = GetWord(Stream + IDX);
+                Count += 1;
+                IDX   += 2;
+            }
+        }
+        return Count;
+    }
+
+    u32 GetCompressedSize(const Instruction* Code, u32 Count) noexcept
+    {
+        return Compress(Code, Count, nullptr);
+    }
+
+    u32 CompressCode(const Instruction* Code, u32 Count, u16* Out) noexcept
+    {
+        return Compress(Code, Count, Out);
+    }
+
+    u32 GetExpandedCount(const u16* Stream, u32 Parcels) noexcept
+    {
+        return Expand(Stream, Parcels, nullptr);
+    }
+
+    u32 ExpandCode(const u16* Stream, u32 Parcels, Instruction* Out) noexcept
+    {
+        return Expand(Stream, Parcels, Out);
+    }
+
+    MemoryError LoadCompressedFunction(Function& Func,
+                                       CoreAllocator& Allocator,
+                                       RelocationTable* Reloc,
+                                       const u16* Stream, u32 Parcels,
+                                       u16 SharedSize) noexcept
+    {
+        u32 Count = GetExpandedCount(Stream, Parcels);
+        if ( Count == 0 )
+            return MEMORY_SIZE_IS_ZERO;
+        if ( Count > UINT16_MAX )
+            return MEMORY_SIZE_TOO_LARGE;
+
+        MemoryError Error = Func.Init(Allocator, Reloc, (u16)Count,
+                                      SharedSize);
+        if ( Error != MEMORY_OK )
+            return Error;
+
+        ExpandCode(Stream, Parcels, Func.GetCodeSpace());
+        return MEMORY_OK;
+    }
+
+}
@@ -189,6 +189,23 @@ namespace Octane {
         ::operator delete( (void*)(&Address.As._HeaderPtr[-1]) );
     }
 
+    /// FUNC: External Accounting
+    ////////////////////////////////////////
+    MemoryError CoreAllocator::RequestExternal(const u64 Size) noexcept {
+        RAIIMutex Locker(m_AllocLock);
+        if ( m_MaxAllocations
+             && GetTotalAllocations() + Size > m_MaxAllocations )
+        { m_LastError = MEMORY_HIT_VM_MAXIMUM;
+          return m_LastError; }
+        m_SystemAllocations += Size;
+        return MEMORY_OK;
+    }
+
+    void CoreAllocator::ReleaseExternal(const u64 Size) noexcept {
+        RAIIMutex Locker(m_AllocLock);
+        m_SystemAllocations -= Size;
+    }
+
     /// FUNC: Reallocate
     ////////////////////////////////////////
     MemoryError 
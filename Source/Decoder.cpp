@@ -0,0 +1,938 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#define OCTVM_INTERNAL 1
+
+#include "Headers/Analysis.hpp"
+#include "Headers/Decoder.hpp"
+#include "Headers/Exceptions.hpp"
+#include "Headers/Functions.hpp"
+
+namespace Octane {
+
+    /// @brief Validates a u8 register index, returning
+    /// the `Exception` it would raise or `Exception::None`.
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    Exception::ID CheckRegister(u8 Index) noexcept
+    {
+        if ( Index < VPCore::Register::COUNT )
+            return Exception::None;
+        return ( Index == Instruction::UNUSED_REG ?
+                 Exception::InvalidUnusedRegister :
+                 Exception::InvalidRegisterAccess );
+    }
+
+    /// @brief Decodes a single `Instruction`
+    /// @param Code The Code Space being decoded
+    /// @param IDX The index of the `Instruction` to decode
+    /// @param Count The amount of `Instruction`s in the Code Space
+    ////////////////////////////////////////
+    static DecodedInstruction DecodeOne(const Instruction* Code,
+                                        u32 IDX, u32 Count) noexcept
+    {
+        const Instruction& Ins = Code[IDX];
+        DecodedInstruction Out = {};
+        Exception::ID      Fault = Exception::None;
+
+        Out.Op = Ins.Any.Op;
+
+        switch ( Instruction::GetLayout(Ins.Any.Op) ) {
+            case Instruction::Layout::NONE:
+                Out.Imm = Ins.Imm16.Imm;
+                if ( Ins.Any.Op >= Instruction::COUNT_OF_INSTRUCTIONS )
+                    Fault = Exception::InvalidOpcode;
+                break;
+
+            case Instruction::Layout::JUMP:
+                Out.Imm = Ins.Imm16.Imm;
+                if ( Out.Imm >= Count )
+                    Fault = Exception::InstructionOverflow;
+                break;
+
+            case Instruction::Layout::SEEK: {
+                i32 Target = (i32)IDX + (i16)Ins.Imm16.Imm;
+                Out.Imm = (u64)Target;
+                if ( Target < 0 )
+                    Fault = Exception::InstructionUnderflow;
+                else if ( (u32)Target >= Count )
+                    Fault = Exception::InstructionOverflow;
+                break;
+            }
+
+            case Instruction::Layout::ONE:
+                Out.rX = Ins.OneParam.rX;
+                Fault  = CheckRegister(Out.rX);
+                break;
+
+            case Instruction::Layout::IMM16:
+                Out.rX  = Ins.Imm16.rX;
+                Out.Imm = Ins.Imm16.Imm;
+                if ( Ins.Any.Op == Instruction::bnotimm )
+                    Out.Imm = ~Out.Imm;
+                Fault   = CheckRegister(Out.rX);
+                break;
+
+            // Trailing words must lie inside the Code Space
+            case Instruction::Layout::IMM32:
+                Out.rX  = Ins.Imm32.rX;
+                if ( IDX + 2 > Count )
+                    { Fault = Exception::InstructionOverflow; break; }
+                Out.Imm = Code[IDX + 1].RawInt;
+                Fault   = CheckRegister(Out.rX);
+                break;
+
+            case Instruction::Layout::IMM64:
+                Out.rX  = Ins.Imm64.rX;
+                if ( IDX + 3 > Count )
+                    { Fault = Exception::InstructionOverflow; break; }
+                Out.Imm = (u64)Code[IDX + 1].RawInt
+                        | ( (u64)Code[IDX + 2].RawInt << 32 );
+                Fault   = CheckRegister(Out.rX);
+                break;
+
+            case Instruction::Layout::DUAL:
+                Out.rX = Ins.DualParam.rX;
+                Out.rY = Ins.DualParam.rY;
+                if ( (Fault = CheckRegister(Out.rX)) == Exception::None )
+                    Fault = CheckRegister(Out.rY);
+                break;
+
+            case Instruction::Layout::TRI:
+                Out.rX = Ins.TriParam.rX;
+                Out.rY = Ins.TriParam.rY;
+                Out.rZ = Ins.TriParam.rZ;
+                if ( (Fault = CheckRegister(Out.rX)) == Exception::None
+                  && (Fault = CheckRegister(Out.rY)) == Exception::None )
+                    Fault = CheckRegister(Out.rZ);
+                break;
+
+            case Instruction::Layout::ALT:
+                Out.rX  = Ins.Imm16Alt.rX_rY >> 4;
+                Out.rY  = Ins.Imm16Alt.rX_rY & 0x0F;
+                Out.Imm = Ins.Imm16Alt.Imm;
+                break;
+
+            case Instruction::Layout::ALT_SIGNED:
+                Out.rX  = Ins.Imm16Alt.rX_rY >> 4;
+                Out.rY  = Ins.Imm16Alt.rX_rY & 0x0F;
+                Out.Imm = (u64)(i64)(i16)Ins.Imm16Alt.Imm;
+                break;
+
+            case Instruction::Layout::MEM:
+                Out.rX  = Ins.MemAccess.rX_rY >> 4;
+                Out.rY  = Ins.MemAccess.rX_rY & 0x0F;
+                Out.rZ  = Ins.MemAccess.rZ;
+                Out.Imm = Ins.MemAccess.Scale;
+                Fault   = CheckRegister(Out.rZ);
+                break;
+
+            case Instruction::Layout::PRIV:
+                Out.rX  = Ins.MemAccessPriv.rX;
+                Out.rY  = Ins.MemAccessPriv.rY;
+                Out.rZ  = Ins.MemAccessPriv.Scale >> 4;
+                Out.Imm = Ins.MemAccessPriv.Scale & 0x0F;
+                if ( (Fault = CheckRegister(Out.rX)) == Exception::None )
+                    Fault = CheckRegister(Out.rY);
+                break;
+        }
+
+        if ( Fault != Exception::None ) {
+            Out     = {};
+            Out.Op  = DECODED_FAULT;
+            Out.Imm = Fault;
+        }
+        return Out;
+    }
+
+    /// @brief Divides the 128-bit High:Low by Divisor one bit
+    /// at a time, as High < Divisor leaves a 64-bit quotient
+    ////////////////////////////////////////
+    static u64 DivideWide(u64 High, u64 Low, u64 Divisor, u64& Rem) noexcept
+    {
+        u64 Quotient = 0;
+        for ( u32 i = 0; i < 64; i++ ) {
+            bool Carry = ( High >> 63 );
+            High       = ( High << 1 ) | ( Low >> 63 );
+            Low      <<= 1;
+            Quotient <<= 1;
+            if ( Carry || High >= Divisor ) {
+                High     -= Divisor;
+                Quotient |= 1;
+            }
+        }
+        Rem = High;
+        return Quotient;
+    }
+
+    /// @brief Returns the index of the highest set bit of Value
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    u8 GetLog2(u64 Value) noexcept
+    {
+        u8 Log = 0;
+        while ( Value >>= 1 )
+            Log++;
+        return Log;
+    }
+
+    /// @brief Returns true if Value is a power of two
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    bool IsPowerOfTwo(u64 Value) noexcept
+        { return ( Value && !( Value & ( Value - 1 ) ) ); }
+
+    /// GETUNSIGNEDMAGIC:
+    ////////////////////////////////////////
+    DivisionMagic GetUnsignedMagic(u64 Divisor) noexcept
+    {
+        // floor(2^(64 + Log) / Divisor) + 1 is exact for every
+        // dividend if its rounding error is small enough, and
+        // otherwise one more bit of precision always is
+        u8  Log = GetLog2(Divisor);
+        u64 Rem;
+        u64 Magic = DivideWide((u64)1 << Log, 0, Divisor, Rem);
+        if ( Divisor - Rem < ( (u64)1 << Log ) )
+            return { Magic + 1, Log };
+
+        u64 Twice = Rem + Rem;
+        Magic += Magic;
+        if ( Twice >= Divisor || Twice < Rem )
+            Magic++;
+        return { Magic + 1, (u8)( Log | REDUCED_ADD ) };
+    }
+
+    /// GETSIGNEDMAGIC:
+    ////////////////////////////////////////
+    DivisionMagic GetSignedMagic(i64 Divisor) noexcept
+    {
+        // Warren, Hacker's Delight, 10-1
+        const u64 TWO63 = (u64)1 << 63;
+        u64 Abs  = ( Divisor < 0 ? 0 - (u64)Divisor : (u64)Divisor );
+        u64 T    = TWO63 + ( (u64)Divisor >> 63 );
+        u64 ANC  = T - 1 - T % Abs;
+        u64 Q1   = TWO63 / ANC, R1 = TWO63 - Q1 * ANC;
+        u64 Q2   = TWO63 / Abs, R2 = TWO63 - Q2 * Abs;
+        u64 Delta;
+        u32 P    = 63;
+        do {
+            P++;
+            Q1 *= 2; R1 *= 2;
+            if ( R1 >= ANC ) { Q1++; R1 -= ANC; }
+            Q2 *= 2; R2 *= 2;
+            if ( R2 >= Abs ) { Q2++; R2 -= Abs; }
+            Delta = Abs - R2;
+        } while ( Q1 < Delta || ( Q1 == Delta && R1 == 0 ) );
+
+        u64 Magic = Q2 + 1;
+        if ( Divisor < 0 )
+            Magic = 0 - Magic;
+        u8 Shift = (u8)( P - 64 );
+        if ( Divisor > 0 && (i64)Magic < 0 )
+            Shift |= REDUCED_ADD;
+        else if ( Divisor < 0 && (i64)Magic > 0 )
+            Shift |= REDUCED_SUB;
+        return { Magic, Shift };
+    }
+
+    /// @brief Rewrites D into an equivalent `movimm`
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    void ReduceToConstant(DecodedInstruction& D, u64 Value) noexcept
+    {
+        D.Op  = Instruction::movimm;
+        D.rY  = 0;
+        D.Imm = Value;
+    }
+
+    /// @brief Rewrites D into an equivalent `mov`
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    void ReduceToMove(DecodedInstruction& D) noexcept
+    {
+        D.Op  = Instruction::mov;
+        D.Imm = 0;
+    }
+
+    /// @brief Rewrites D into a `REDUCED_` division
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    void ReduceToMagic(DecodedInstruction& D, u8 Op,
+                       DivisionMagic Magic) noexcept
+    {
+        D.Aux = (u32)D.Imm;
+        D.Op  = Op;
+        D.Imm = Magic.Magic;
+        D.rZ  = Magic.Shift;
+    }
+
+    /// @brief Strength reduces a multiplication, division or
+    /// remainder by an immediate. Divisors which raise are
+    /// left alone, and so is the signed division by -1,
+    /// which the executor defines for INT64_MIN.
+    ////////////////////////////////////////
+    static void ReduceStrength(DecodedInstruction& D) noexcept
+    {
+        u64 Imm = D.Imm;
+        switch ( D.Op ) {
+            case Instruction::mulimm:
+                if ( Imm == 0 )
+                    ReduceToConstant(D, 0);
+                else if ( Imm == 1 )
+                    ReduceToMove(D);
+                else if ( IsPowerOfTwo(Imm) )
+                    { D.Op = Instruction::shlimm; D.Imm = GetLog2(Imm); }
+                return;
+
+            case Instruction::divimm:
+                if ( Imm == 1 )
+                    ReduceToMove(D);
+                else if ( IsPowerOfTwo(Imm) )
+                    { D.Op = Instruction::shrimm; D.Imm = GetLog2(Imm); }
+                else if ( Imm )
+                    ReduceToMagic(D, REDUCED_DIVIMM, GetUnsignedMagic(Imm));
+                return;
+
+            case Instruction::modimm:
+                if ( Imm == 1 )
+                    ReduceToConstant(D, 0);
+                else if ( IsPowerOfTwo(Imm) )
+                    { D.Op = Instruction::bandimm; D.Imm = Imm - 1; }
+                else if ( Imm )
+                    ReduceToMagic(D, REDUCED_MODIMM, GetUnsignedMagic(Imm));
+                return;
+
+            // Immediates are sign extended 16-bit values
+            case Instruction::idivimm:
+                if ( Imm == 1 )
+                    ReduceToMove(D);
+                else if ( Imm && (i64)Imm != -1 )
+                    ReduceToMagic(D, REDUCED_IDIVIMM, GetSignedMagic((i64)Imm));
+                return;
+
+            case Instruction::imodimm:
+                if ( Imm == 1 || (i64)Imm == -1 )
+                    ReduceToConstant(D, 0);
+                else if ( Imm )
+                    ReduceToMagic(D, REDUCED_IMODIMM, GetSignedMagic((i64)Imm));
+                return;
+        }
+    }
+
+    /// @brief Returns true for the `gload`/`gsave` family
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    bool IsGlobalAccess(u8 Op) noexcept
+        { return ( Op >= Instruction::gload8 && Op <= Instruction::gsave64 ); }
+
+    /// @brief Returns the superinstruction replacing
+    /// the given pair, or `DECODED_FAULT` if the pair
+    /// cannot be fused.
+    ////////////////////////////////////////
+    static u8 GetFusedOpcode(const DecodedInstruction& First,
+                             const DecodedInstruction& Second) noexcept
+    {
+        switch ( First.Op ) {
+            case Instruction::cmplt:
+                if ( Second.Op == Instruction::jmpnot0 )
+                    return FUSED_CMPLT_JMPNOT0;
+                break;
+            case Instruction::movimm:
+                if ( Second.Op == Instruction::add )
+                    return FUSED_MOVIMM_ADD;
+                break;
+            // Only loop tails which test the incremented register
+            case Instruction::inc:
+                if ( Second.Op == Instruction::jmplt && Second.rX == First.rX )
+                    return FUSED_INC_JMPLT;
+                break;
+            case Instruction::pushreg:
+                if ( Second.Op == Instruction::popreg )
+                    return FUSED_PUSHREG_POPREG;
+                break;
+        }
+        return DECODED_FAULT;
+    }
+
+    /// @brief Fuses adjacent pairs of `DecodedInstruction`s
+    /// into superinstructions, walking the Code Space one
+    /// `Instruction` at a time. Pairs never overlap, so the
+    /// second entry of a fused pair is always executed
+    /// unfused when it is reached through a jump.
+    ////////////////////////////////////////
+    static void FuseSuperinstructions(const Instruction* Code,
+                                      DecodedInstruction* Decoded,
+                                      u32 Count) noexcept
+    {
+        for ( u32 i = 0; i + 1 < Count; ) {
+            u8 Fused = GetFusedOpcode(Decoded[i], Decoded[i + 1]);
+            if ( Fused == DECODED_FAULT ) {
+                i += Instruction::GetWordCount(Code[i].Any.Op);
+                continue;
+            }
+            // Every fusable `Instruction` is a single word
+            Decoded[i].Op = Fused;
+            i += 2;
+        }
+    }
+
+    /// @brief Fills a bitset of `INSTRUCTION_BITSET_WORDS`
+    /// with one set bit per `Instruction` some jump targets
+    ////////////////////////////////////////
+    static void MarkJumpTargets(const Instruction* Code, u32 Count,
+                                u64* Targets) noexcept
+    {
+        for ( u32 i = 0; i < INSTRUCTION_BITSET_WORDS; i++ )
+            Targets[i] = 0;
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            i32 Target = 0;
+            if ( Instruction::GetJumpTarget(Code[i], i, Target)
+              && Target >= 0 && (u32)Target < Count )
+                Targets[Target / 64] |= ( (u64)1 << (Target % 64) );
+        }
+    }
+
+    /// @brief Rewrites `pushall`s and `popall`s into their
+    /// MASKED_ forms from the registers `AnalyseLiveness`
+    /// finds live. A `popall` only restores the registers
+    /// read after it.
+    ///
+    /// A `pushall` followed by a `popall`, with only PURE
+    /// `Instruction`s and no jump target between them, forms
+    /// a pair whose slots nothing else can observe. Its
+    /// `pushall` then only saves what the `popall` restores.
+    /// The `popall` is rewritten first, so that a full save
+    /// may still meet a masked restore, but never the reverse.
+    ////////////////////////////////////////
+    static void MaskRegisterSaves(const Function& Func, CoreAllocator& Allocator,
+                                  const Instruction* Code,
+                                  DecodedInstruction* Decoded, u32 Count,
+                                  const void* const* Handlers) noexcept
+    {
+        RegMask* LiveOut = Allocator.Request<RegMask>(Count, SYSTEM_ALLOC_FLAGS);
+        if ( !LiveOut || !AnalyseLiveness(Func, Allocator, LiveOut) ) {
+            Allocator.Release(LiveOut);
+            return;
+        }
+
+        u64 Targets[INSTRUCTION_BITSET_WORDS];
+        MarkJumpTargets(Code, Count, Targets);
+        auto IsTarget = [&](u32 IDX) {
+            return ( Targets[IDX / 64] & ( (u64)1 << (IDX % 64) ) ) != 0;
+        };
+        auto Mask = [&](DecodedInstruction& D, u8 Op, RegMask Live) {
+            D.Imm     = Live;
+            D.Op      = Op;
+            D.Handler = ( Handlers ? Handlers[Op] : nullptr );
+        };
+
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            if ( Decoded[i].Op == Instruction::popall && LiveOut[i] != ALL_REGISTERS )
+                Mask(Decoded[i], MASKED_POPALL, LiveOut[i]);
+            if ( Decoded[i].Op != Instruction::pushall )
+                continue;
+
+            u32 Pop = i + 1;
+            while ( Pop < Count && !IsTarget(Pop)
+                 && GetOpClass(Code[Pop]) == OpClass::PURE )
+                Pop += Instruction::GetWordCount(Code[Pop].Any.Op);
+            if ( Pop >= Count || IsTarget(Pop)
+              || Decoded[Pop].Op != Instruction::popall )
+                continue;
+
+            Mask(Decoded[Pop], MASKED_POPALL, LiveOut[Pop]);
+            Mask(Decoded[i], MASKED_PUSHALL, LiveOut[Pop]);
+        }
+
+        Allocator.Release(LiveOut);
+    }
+
+    /// @brief Pairs `pushreg`s and `pusharg`s with the `popreg`
+    /// or `poparg` taking their value back off the Stack, and
+    /// rewrites both into `TOP_` forms keeping the value in
+    /// one of `TOP_SLOT_COUNT` slots of the executor instead.
+    ///
+    /// A pair only spans straight-line code. Jump targets,
+    /// branches, calls and anything else which may hand the
+    /// Stack to other code end every pending push, which then
+    /// stays a plain push. Stack `Instruction`s in between must
+    /// be balanced within the pair, and `Instruction`s which may
+    /// raise are only allowed where nothing has been pushed
+    /// above the cached slots, so that spilling the slots in
+    /// order always rebuilds the Stack the plain pushes would
+    /// have left. Each push records the most Stack its pair
+    /// uses in `Aux`, and only caches its value with that much
+    /// room left, so nothing inside of the pair can overflow
+    /// where it would not have before.
+    ///
+    /// Pops are rewritten before their push, which keeps a
+    /// pair safe to rewrite while the form is being executed.
+    ////////////////////////////////////////
+    static void CacheStackTop(const Instruction* Code,
+                              DecodedInstruction* Decoded, u32 Count,
+                              const void* const* Handlers) noexcept
+    {
+        u64 Targets[INSTRUCTION_BITSET_WORDS];
+        MarkJumpTargets(Code, Count, Targets);
+
+        // Pushes awaiting their pop, and the most bytes
+        // pushed above each since. Inner is the current
+        // amount, relative to the innermost pending push.
+        struct Pending { u32 Push; i32 MostInner; };
+        Pending Slots[TOP_SLOT_COUNT];
+        u32     Depth = 0;
+        i32     Inner = 0;
+
+        auto Rewrite = [&](DecodedInstruction& D, u8 Op) {
+            D.Op      = Op;
+            D.Handler = ( Handlers ? Handlers[Op] : nullptr );
+        };
+
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            if ( Targets[i / 64] & ( (u64)1 << (i % 64) ) )
+                Depth = Inner = 0;
+
+            u8  Op     = Decoded[i].Op;
+            i32 Effect = 0;
+            if ( ( Op == Instruction::pushreg || Op == Instruction::pusharg )
+                 && Inner == 0 ) {
+                // Without a free slot, the pending pushes stay plain
+                if ( Depth == TOP_SLOT_COUNT )
+                    Depth = 0;
+                Slots[Depth++] = { i, 0 };
+            }
+            else if ( ( Op == Instruction::popreg || Op == Instruction::poparg )
+                      && Inner == 0 && Depth ) {
+                Pending& Push = Slots[--Depth];
+                Rewrite(Decoded[i], (u8)( TOP_POPREG0 + Depth ));
+                Decoded[Push.Push].Aux = (u32)( sizeof(u64) * ( Depth + 1 )
+                                                + Push.MostInner );
+                Rewrite(Decoded[Push.Push], (u8)( TOP_PUSHREG0 + Depth ));
+            }
+            else if ( Depth && GetStackEffect(Code[i], Effect) ) {
+                Inner += Effect;
+                // Popping what the slots hold, or more than
+                // any pop could check for, ends every pair
+                if ( Inner < 0 || Inner > 0xFFFF )
+                    Depth = Inner = 0;
+                for ( u32 k = 0; k < Depth; k++ )
+                    if ( Slots[k].MostInner < Inner )
+                        Slots[k].MostInner = Inner;
+            }
+            else switch ( GetOpClass(Code[i]) ) {
+                case OpClass::PURE:
+                    break;
+                case OpClass::FAULTING:
+                    if ( Inner == 0 )
+                        break;
+                    [[fallthrough]];
+                default:
+                    Depth = Inner = 0;
+                    break;
+            }
+        }
+    }
+
+    /// @brief Rewrites the pairs `AnalyseEscapes` finds into
+    /// `LOCALISED_` forms, which serve their allocation from
+    /// the Local Frame whenever it fits.
+    ///
+    /// Releases are rewritten before any request, so that a
+    /// release may still meet a heap allocation, which it hands
+    /// back to the heap, but a Local one never meets a plain
+    /// `releasebytes`. This keeps the pairs safe to rewrite
+    /// while the form is being executed.
+    ////////////////////////////////////////
+    static void LocaliseScratch(const Function& Func, CoreAllocator& Allocator,
+                                const Instruction* Code,
+                                DecodedInstruction* Decoded, u32 Count,
+                                const void* const* Handlers) noexcept
+    {
+        u64 Paired[INSTRUCTION_BITSET_WORDS];
+        if ( !AnalyseEscapes(Func, Allocator, Paired) )
+            return;
+
+        auto Rewrite = [&](u8 From, u8 To) {
+            for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+                if ( !( Paired[i / 64] & ( (u64)1 << (i % 64) ) )
+                     || Decoded[i].Op != From )
+                    continue;
+                Decoded[i].Op      = To;
+                Decoded[i].Handler = ( Handlers ? Handlers[To] : nullptr );
+            }
+        };
+        Rewrite(Instruction::releasebytes, LOCALISED_RELEASEBYTES);
+        Rewrite(Instruction::requestbytes, LOCALISED_REQUESTBYTES);
+    }
+
+    /// @brief Narrows the pairs found by `MaskRegisterSaves`
+    /// in a copy whose proven sites are check-free. Once its
+    /// `pushall` cannot fail, the `popall` of a pair always
+    /// restores what it saved, so only registers written in
+    /// between still need to be.
+    ////////////////////////////////////////
+    static void NarrowRegisterSaves(const Instruction* Code,
+                                    DecodedInstruction* Decoded,
+                                    u32 Count) noexcept
+    {
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            if ( Decoded[i].Op != UNCHECKED_MASKED_PUSHALL )
+                continue;
+
+            RegMask Written = 0;
+            u32     Pop     = i + 1;
+            while ( Pop < Count && GetOpClass(Code[Pop]) == OpClass::PURE ) {
+                Written |= GetRegBit(GetRegOperands(Code[Pop]).X);
+                Pop     += Instruction::GetWordCount(Code[Pop].Any.Op);
+            }
+            if ( Pop >= Count || Decoded[Pop].Op != UNCHECKED_MASKED_POPALL )
+                continue;
+
+            Decoded[i].Imm   &= Written;
+            Decoded[Pop].Imm &= Written;
+        }
+    }
+
+    /// @brief Returns the check-free variant of
+    /// a `pload`/`psave` proven in bounds
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    u8 GetBoundedOpcode(u8 Op) noexcept
+        { return (u8)( UNCHECKED_PLOAD8 + ( Op - Instruction::pload8 ) ); }
+
+    /// @brief Returns the check-free variant of a
+    /// conditional jump, or the given Opcode if none.
+    ////////////////////////////////////////
+    static u8 GetUncheckedOpcode(u8 Op) noexcept
+    {
+        switch ( Op ) {
+            case Instruction::jmpis0:     return UNCHECKED_JMPIS0;
+            case Instruction::jmpnot0:    return UNCHECKED_JMPNOT0;
+            case Instruction::jmpeq:      return UNCHECKED_JMPEQ;
+            case Instruction::jmpneq:     return UNCHECKED_JMPNEQ;
+            case Instruction::jmplt:      return UNCHECKED_JMPLT;
+            case Instruction::jmpgt:      return UNCHECKED_JMPGT;
+            case Instruction::jmplteq:    return UNCHECKED_JMPLTEQ;
+            case Instruction::jmpgteq:    return UNCHECKED_JMPGTEQ;
+            case FUSED_CMPLT_JMPNOT0:     return UNCHECKED_FUSED_CMPLT_JMPNOT0;
+            case FUSED_INC_JMPLT:         return UNCHECKED_FUSED_INC_JMPLT;
+            default:                      return Op;
+        }
+    }
+
+    /// @brief Returns the check-free variant of a
+    /// proven Stack or Local site, or the given
+    /// Opcode if none.
+    ////////////////////////////////////////
+    static u8 GetReservedOpcode(u8 Op) noexcept
+    {
+        switch ( Op ) {
+            case Instruction::pushreg:
+            case Instruction::pusharg:      return UNCHECKED_PUSHREG;
+            case Instruction::pushgen:      return UNCHECKED_PUSHGEN;
+            case Instruction::pushall:      return UNCHECKED_PUSHALL;
+            case Instruction::pushmem:      return UNCHECKED_PUSHMEM;
+            case Instruction::popreg:
+            case Instruction::poparg:       return UNCHECKED_POPREG;
+            case Instruction::popgen:       return UNCHECKED_POPGEN;
+            case Instruction::popall:       return UNCHECKED_POPALL;
+            case Instruction::popmem:       return UNCHECKED_POPMEM;
+            case Instruction::requestlocal: return UNCHECKED_REQUESTLOCAL;
+            case FUSED_PUSHREG_POPREG:      return UNCHECKED_FUSED_PUSHREG_POPREG;
+            case MASKED_PUSHALL:            return UNCHECKED_MASKED_PUSHALL;
+            case MASKED_POPALL:             return UNCHECKED_MASKED_POPALL;
+            default:                        return Op;
+        }
+    }
+
+    /// FILLGLOBALCACHE:
+    ////////////////////////////////////////
+    bool FillGlobalCache(GlobalCache& Cache, StorageDevice& Storage,
+                         const void* Key) noexcept
+    {
+        Symbol* Sym = Storage.LookupSymbol((const char*)Key);
+        if ( !Sym || Sym->Type != SymbolType::DATA )
+            return false;
+        u32 Len = QuickStrLen((const char*)Key) + 1;
+        Cache.Key        = Key;
+        Cache.Value      = Sym->CastValue<byte>();
+        Cache.Generation = 0;
+        Cache.KeyLength  = 0;
+        if ( Len <= GLOBAL_CACHE_KEY_SIZE ) {
+            QuickCopy(Key, Cache.KeyCopy, Len);
+            Cache.KeyLength  = Len;
+            Cache.Generation = Storage.GetGeneration();
+        }
+        return true;
+    }
+
+    /// GETBASEOPCODE:
+    ////////////////////////////////////////
+    u8 GetBaseOpcode(u8 Op) noexcept
+    {
+        switch ( Op ) {
+            case FUSED_CMPLT_JMPNOT0:
+            case UNCHECKED_FUSED_CMPLT_JMPNOT0:  return Instruction::cmplt;
+            case FUSED_MOVIMM_ADD:               return Instruction::movimm;
+            case FUSED_INC_JMPLT:
+            case UNCHECKED_FUSED_INC_JMPLT:      return Instruction::inc;
+            case FUSED_PUSHREG_POPREG:
+            case UNCHECKED_FUSED_PUSHREG_POPREG:
+            case UNCHECKED_PUSHREG:
+            case TOP_PUSHREG0:
+            case TOP_PUSHREG1:                   return Instruction::pushreg;
+            case UNCHECKED_JMPIS0:               return Instruction::jmpis0;
+            case UNCHECKED_JMPNOT0:              return Instruction::jmpnot0;
+            case UNCHECKED_JMPEQ:                return Instruction::jmpeq;
+            case UNCHECKED_JMPNEQ:               return Instruction::jmpneq;
+            case UNCHECKED_JMPLT:                return Instruction::jmplt;
+            case UNCHECKED_JMPGT:                return Instruction::jmpgt;
+            case UNCHECKED_JMPLTEQ:              return Instruction::jmplteq;
+            case UNCHECKED_JMPGTEQ:              return Instruction::jmpgteq;
+            case UNCHECKED_PUSHGEN:              return Instruction::pushgen;
+            case MASKED_PUSHALL:
+            case UNCHECKED_MASKED_PUSHALL:
+            case UNCHECKED_PUSHALL:              return Instruction::pushall;
+            case UNCHECKED_PUSHMEM:              return Instruction::pushmem;
+            case UNCHECKED_POPREG:
+            case TOP_POPREG0:
+            case TOP_POPREG1:                    return Instruction::popreg;
+            case UNCHECKED_POPGEN:               return Instruction::popgen;
+            case MASKED_POPALL:
+            case UNCHECKED_MASKED_POPALL:
+            case UNCHECKED_POPALL:               return Instruction::popall;
+            case UNCHECKED_POPMEM:               return Instruction::popmem;
+            case UNCHECKED_REQUESTLOCAL:         return Instruction::requestlocal;
+            case REDUCED_DIVIMM:                 return Instruction::divimm;
+            case REDUCED_MODIMM:                 return Instruction::modimm;
+            case REDUCED_IDIVIMM:                return Instruction::idivimm;
+            case REDUCED_IMODIMM:                return Instruction::imodimm;
+            case CACHED_CALL_VM:
+            case CACHED_CALL_C:
+            case CACHED_CALL_JIT:
+            case CACHED_TAIL_CALL_VM:            return Instruction::call;
+            case UNCHECKED_PLOAD8:               return Instruction::pload8;
+            case UNCHECKED_PLOAD16:              return Instruction::pload16;
+            case UNCHECKED_PLOAD32:              return Instruction::pload32;
+            case UNCHECKED_PLOAD64:              return Instruction::pload64;
+            case UNCHECKED_PSAVE8:               return Instruction::psave8;
+            case UNCHECKED_PSAVE16:              return Instruction::psave16;
+            case UNCHECKED_PSAVE32:              return Instruction::psave32;
+            case UNCHECKED_PSAVE64:              return Instruction::psave64;
+            case LOCALISED_REQUESTBYTES:         return Instruction::requestbytes;
+            case LOCALISED_RELEASEBYTES:         return Instruction::releasebytes;
+            default:
+                return ( Op < Instruction::COUNT_OF_INSTRUCTIONS ? Op
+                                                                 : (u8)DECODED_FAULT );
+        }
+    }
+
+    /// DECODEFUNCTION:
+    ////////////////////////////////////////
+    MemoryError DecodeFunction(Function& Func, CoreAllocator& Allocator,
+                               const void* const* Handlers) noexcept
+    {
+        const Instruction* Code  = Func.GetCodeSpace();
+        u32                Count = Func.GetInstructionCount();
+        if ( !Code )
+            return MEMORY_SIZE_IS_ZERO;
+
+        u32 Total = Count + DECODED_TAIL_COUNT;
+        DecodedInstruction* Decoded =
+            Allocator.Request<DecodedInstruction>(Total);
+        if ( !Decoded )
+            return Allocator.GetLastError();
+
+        for ( u32 i = 0; i < Count; i++ )
+            Decoded[i] = DecodeOne(Code, i, Count);
+        for ( u32 i = Count; i < Total; i++ ) {
+            Decoded[i]    = {};
+            Decoded[i].Op = Instruction::ret;
+        }
+
+        // Each `gload`/`gsave` swaps its Scale for a GlobalCache
+        u32 CacheCount = 0;
+        for ( u32 i = 0; i < Count; i++ )
+            if ( IsGlobalAccess(Decoded[i].Op) )
+                CacheCount++;
+        GlobalCache* Caches = nullptr;
+        if ( CacheCount ) {
+            Caches = Allocator.Request<GlobalCache>(CacheCount);
+            if ( !Caches ) {
+                Allocator.Release(Decoded);
+                return Allocator.GetLastError();
+            }
+            for ( u32 i = 0, k = 0; i < Count; i++ ) {
+                if ( !IsGlobalAccess(Decoded[i].Op) )
+                    continue;
+                Caches[k]       = { nullptr, nullptr, 0, (u32)Decoded[i].Imm, 0, {} };
+                Decoded[i].Imm  = (u64)&Caches[k++];
+            }
+        }
+
+        for ( u32 i = 0; i < Total; i++ )
+            Decoded[i].Handler = ( Handlers ? Handlers[Decoded[i].Op]
+                                            : nullptr );
+
+        Func.AssignDecoded(Decoded, nullptr, FrameDemand{}, Caches);
+        return MEMORY_OK;
+    }
+
+    /// OPTIMISEFUNCTION:
+    ////////////////////////////////////////
+    MemoryError OptimiseFunction(Function& Func, CoreAllocator& Allocator,
+                                 const void* const* Handlers) noexcept
+    {
+        const Instruction*  Code    = Func.GetCodeSpace();
+        DecodedInstruction* Decoded = Func.GetDecoded();
+        u32                 Count   = Func.GetInstructionCount();
+        if ( !Code || !Decoded )
+            return MEMORY_SIZE_IS_ZERO;
+        u32 Total = Count + DECODED_TAIL_COUNT;
+
+        // Every rewrite below keeps each entry equivalent to what
+        // it replaces, so they are safe to make in place even while
+        // the plain form is being executed.
+        for ( u32 i = 0; i < Count;
+              i += Instruction::GetWordCount(Code[i].Any.Op) )
+            ReduceStrength(Decoded[i]);
+
+        FuseSuperinstructions(Code, Decoded, Count);
+        MaskRegisterSaves(Func, Allocator, Code, Decoded, Count, Handlers);
+        CacheStackTop(Code, Decoded, Count, Handlers);
+        LocaliseScratch(Func, Allocator, Code, Decoded, Count, Handlers);
+
+        if ( Func.IsVerified() )
+            for ( u32 i = 0; i < Count; i++ )
+                Decoded[i].Op = GetUncheckedOpcode(Decoded[i].Op);
+
+        for ( u32 i = 0; i < Count; i++ )
+            Decoded[i].Handler = ( Handlers ? Handlers[Decoded[i].Op]
+                                            : nullptr );
+
+        // Proven Stack and Local sites drop their checks in a copy,
+        // while the current form keeps them for entries lacking the
+        // demand. Without memory for the copy, every check is kept.
+        FrameDemand Demand = {};
+        u64 Proven[INSTRUCTION_BITSET_WORDS];
+        u32* LocalOffsets = Allocator.Request<u32>(Count, SYSTEM_ALLOC_FLAGS);
+        if ( !LocalOffsets )
+            return Allocator.GetLastError();
+        bool Reserved = AnalyseFrameDemand(Func, Allocator, Demand,
+                                           Proven, LocalOffsets) != 0;
+
+        // So do private accesses of loops whose bounds are proven
+        // up front, by a guard the copy runs before each such loop
+        u64 Bounded[INSTRUCTION_BITSET_WORDS];
+        u32 GuardCount = 0;
+        BoundsGuard* Guards =
+            Allocator.Request<BoundsGuard>(Count / 2 + 1, SYSTEM_ALLOC_FLAGS);
+        if ( Guards )
+            GuardCount = AnalyseBoundsChecks(Func, Allocator, Decoded,
+                                             Guards, Bounded);
+        if ( !Reserved && !GuardCount ) {
+            if ( Guards )
+                Allocator.Release(Guards);
+            Allocator.Release(LocalOffsets);
+            return MEMORY_OK;
+        }
+
+        // Each guard keeps a copy of the `Instruction` it replaces
+        // past the Code Space, followed by a `GUARD_BOUNDS`
+        u32 GuardedTotal = Total;
+        for ( u32 k = 0; k < GuardCount; k++ )
+            GuardedTotal += 1 + Instruction::GetWordCount(
+                                    Code[Guards[k].Preheader].Any.Op );
+
+        DecodedInstruction* Optimised =
+            Allocator.Request<DecodedInstruction>(GuardedTotal);
+        if ( !Optimised ) {
+            if ( Guards )
+                Allocator.Release(Guards);
+            Allocator.Release(LocalOffsets);
+            return Allocator.GetLastError();
+        }
+        for ( u32 i = 0; i < Total; i++ ) {
+            Optimised[i] = Decoded[i];
+            if ( i < Count && ( Proven[i / 64] & ( (u64)1 << (i % 64) ) ) ) {
+                Optimised[i].Op      = GetReservedOpcode(Optimised[i].Op);
+                Optimised[i].Handler = ( Handlers ? Handlers[Optimised[i].Op]
+                                                  : nullptr );
+                // Proven allocations sit at a fixed offset into
+                // the Frame, whose demand is reserved on entry
+                if ( Optimised[i].Op == UNCHECKED_REQUESTLOCAL )
+                    Optimised[i].Aux = LocalOffsets[i];
+            }
+        }
+        Allocator.Release(LocalOffsets);
+
+        for ( u32 i = 0; i < Count; i++ ) {
+            if ( !GuardCount || !( Bounded[i / 64] & ( (u64)1 << (i % 64) ) ) )
+                continue;
+            Optimised[i].Op      = GetBoundedOpcode(Optimised[i].Op);
+            Optimised[i].Handler = ( Handlers ? Handlers[Optimised[i].Op]
+                                              : nullptr );
+        }
+        for ( u32 k = 0, Side = Total; k < GuardCount; k++ ) {
+            const BoundsGuard& Guard = Guards[k];
+            u32 Words = Instruction::GetWordCount(Code[Guard.Preheader].Any.Op);
+            for ( u32 w = 0; w < Words; w++ )
+                Optimised[Side + w] = Decoded[Guard.Preheader + w];
+
+            // A superinstruction would run the loop header
+            // along with it, so only its first half is kept
+            DecodedInstruction& Copy = Optimised[Side];
+            switch ( Copy.Op ) {
+                case FUSED_CMPLT_JMPNOT0: case UNCHECKED_FUSED_CMPLT_JMPNOT0:
+                case FUSED_MOVIMM_ADD:
+                case FUSED_INC_JMPLT:     case UNCHECKED_FUSED_INC_JMPLT:
+                    Copy.Op = GetBaseOpcode(Copy.Op);
+                    break;
+                default:
+                    break;
+            }
+            Copy.Handler = ( Handlers ? Handlers[Copy.Op] : nullptr );
+
+            DecodedInstruction& Check = Optimised[Side + Words];
+            Check         = {};
+            Check.Op      = GUARD_BOUNDS;
+            Check.Imm     = Guard.Checks;
+            Check.Aux     = Guard.Header;
+            Check.Handler = ( Handlers ? Handlers[GUARD_BOUNDS] : nullptr );
+
+            DecodedInstruction& Entry = Optimised[Guard.Preheader];
+            Entry.Op      = GUARDED_ENTRY;
+            Entry.Imm     = Side;
+            Entry.Handler = ( Handlers ? Handlers[GUARDED_ENTRY] : nullptr );
+            Side += Words + 1;
+        }
+        if ( Guards )
+            Allocator.Release(Guards);
+        NarrowRegisterSaves(Code, Optimised, Count);
+
+        Func.AssignOptimised(Optimised, Demand);
+        return MEMORY_OK;
+    }
+
+}
@@ -0,0 +1,1646 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#define OCTVM_INTERNAL 1
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include "Headers/Analysis.hpp"
+#include "Headers/Decoder.hpp"
+#include "Headers/Executor.hpp"
+#include "Headers/Peephole.hpp"
+#include "Headers/Verifier.hpp"
+#include "Headers/Functions.hpp"
+#include "Headers/VM.hpp"
+
+namespace Octane {
+
+    using Register      = VPCore::Register;
+    using HandlerResult = Exception::HandlerResult;
+
+    /// HELPERS:
+    ////////////////////////////////////////
+
+    /// @brief Writes a 32-bit float into a Register,
+    /// clearing the upper half first so the full
+    /// 64-bit value stays deterministic.
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    void SetF32(Register& Reg, f32 Value) noexcept
+        { Reg.AsU64 = 0; Reg.AsF32 = Value; }
+
+    /// @brief Converts a floating point to an integer,
+    /// saturating out-of-range values and mapping NaN to 0.
+    ////////////////////////////////////////
+    template <typename Int>
+    static OctVM_SternInline
+    Int FloatToInt(f64 Value) noexcept
+    {
+        if ( Value != Value )
+            return 0;
+        if ( Value <= (f64)std::numeric_limits<Int>::min() )
+            return std::numeric_limits<Int>::min();
+        if ( Value >= (f64)std::numeric_limits<Int>::max() )
+            return std::numeric_limits<Int>::max();
+        return (Int)Value;
+    }
+
+    /// @brief Unsigned integer exponentiation. Wraps on overflow.
+    ////////////////////////////////////////
+    static u64 PowU(u64 Base, u64 Exp) noexcept
+    {
+        u64 Result = 1;
+        while ( Exp ) {
+            if ( Exp & 1 )
+                Result *= Base;
+            Base *= Base;
+            Exp >>= 1;
+        }
+        return Result;
+    }
+
+    /// @brief Signed integer exponentiation. Negative exponents
+    /// truncate towards zero, as integer division would.
+    /// @return False if the result is a division by zero.
+    ////////////////////////////////////////
+    static bool PowI(i64 Base, i64 Exp, i64& Result) noexcept
+    {
+        if ( Exp >= 0 ) {
+            Result = (i64)PowU((u64)Base, (u64)Exp);
+            return true;
+        }
+        if ( Base == 0 )
+            return false;
+        if ( Base == 1 )
+            Result = 1;
+        else if ( Base == -1 )
+            Result = ( Exp & 1 ) ? -1 : 1;
+        else
+            Result = 0;
+        return true;
+    }
+
+    /// @brief Integer square root, rounded down.
+    ////////////////////////////////////////
+    static u64 SqrtU(u64 Value) noexcept
+    {
+        u64 Root = (u64)std::sqrt((f64)Value);
+        // Correct for the rounding of the floating point estimate
+        while ( Root > 0 && Root > Value / Root )
+            Root--;
+        while ( (Root + 1) <= Value / (Root + 1) )
+            Root++;
+        return Root;
+    }
+
+    /// @brief Signed division which defines INT64_MIN / -1
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    i64 DivI(i64 A, i64 B) noexcept
+        { return ( B == -1 ? (i64)( 0 - (u64)A ) : A / B ); }
+
+    /// @brief Signed modulo which defines INT64_MIN % -1
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    i64 ModI(i64 A, i64 B) noexcept
+        { return ( B == -1 ? 0 : A % B ); }
+
+    /// @brief Counts the registers named in a `pushgen`/`popgen` mask
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    u32 MaskCount(u16 Mask) noexcept
+    {
+        u32 Count = 0;
+        for ( ; Mask; Mask &= (u16)( Mask - 1 ) )
+            Count++;
+        return Count;
+    }
+
+    /// @brief Hands an `Exception` to the VM's handler.
+    /// Without a handler, every `Exception` is fatal.
+    ////////////////////////////////////////
+    static HandlerResult Raise(ExecState& State, Exception::ID ID,
+                               Instruction* Offender,
+                               bool StaticEval = false) noexcept
+    {
+        Exception::HandlerFunc Handler = State.VMInstance.GetExceptionHandler();
+        if ( !Handler )
+            return HandlerResult::FATAL;
+        return Handler(Exception(ID, *Offender, StaticEval), State);
+    }
+
+    static HandlerResult PrepareFunction(Function& Func,
+                                         ExecState& State) noexcept;
+    static const void* const* GetThreadedHandlers(void) noexcept;
+    static bool TierUp(Function& Func, ExecState& State) noexcept;
+    static ExposedFunc GetOSREntry(Function& Func, ExecState& State,
+                                   u32 IDX) noexcept;
+
+    /// @brief Drops every Local Frame created since
+    /// the executor was entered, including its entry Frame.
+    ////////////////////////////////////////
+    static void UnwindFrames(ThreadMemory& Memory) noexcept
+    {
+        while ( Memory.LocalValid() ) {
+            bool IsEntry = ( Memory.LocalFrameCaller() == nullptr );
+            Memory.LocalFrameDrop();
+            if ( IsEntry )
+                break;
+        }
+    }
+
+    //////////////// NOTE: /////////////////
+    /// Both dispatch strategies share the
+    /// same handler bodies below. Every
+    /// handler is a `case` label AND a
+    /// named label; SWITCH mode returns to
+    /// the top of the loop with `continue`,
+    /// while THREADED mode jumps directly to
+    /// the handler address stored in each
+    /// `DecodedInstruction`.
+    ///
+    /// Handlers never touch the packed
+    /// `Instruction` encoding. Operands come
+    /// pre-decoded from `DecodeFunction`,
+    /// which has also validated every
+    /// register index, so `D->rX` etc. can
+    /// index the register file unchecked.
+    ///
+    /// The register file and IP are kept in
+    /// locals for the whole run, and are only
+    /// written back to the `ExecState` when
+    /// control leaves the executor.
+    ////////////////////////////////////////
+
+    #define OCT_CASE(Name) case Instruction::Name: L_##Name:
+
+    #if OCTVM_COMPUTED_GOTO
+        #define OCT_DISPATCH()                                              \
+            { if constexpr ( Mode == DispatchMode::THREADED )               \
+                  goto *D->Handler;                                         \
+              else                                                          \
+                  continue; }
+    #else
+        #define OCT_DISPATCH() { continue; }
+    #endif
+
+    #define OCT_NEXT(Words) { D += (Words); OCT_DISPATCH(); }
+
+    #define OCT_RAISE_ID(Value) { Fault = (Value); goto L_Raise; }
+    #define OCT_RAISE(ID) OCT_RAISE_ID(Exception::ID)
+
+    /// The `Instruction` that `D` was decoded from
+    #define OCT_ORIGIN() ( Code + ( D - Decoded ) )
+
+    /// Moves `D` onto Next, counting backward jumps
+    /// towards the next tier of `Func`. The jump which hands
+    /// `Func` to the compiler tier may move into native code.
+    #define OCT_MOVE_TO(Next) {                                             \
+            DecodedInstruction* Next_ = (Next);                             \
+            if ( Next_ <= D && --Budget == 0 ) {                            \
+                Func->StoreTierBudget(0);                                   \
+                bool Compiled_ = TierUp(*Func, State);                      \
+                Budget = Func->GetTierBudget();                             \
+                if ( Compiled_ ) {                                          \
+                    D = Next_;                                              \
+                    goto L_Replace;                                         \
+                }                                                           \
+            }                                                               \
+            D = Next_;                                                      \
+        }
+
+    #define OCT_JUMP(Target) {                                              \
+            u64 Target_ = (Target);                                         \
+            if ( Target_ >= Count )                                         \
+                OCT_RAISE(InstructionOverflow);                             \
+            OCT_MOVE_TO(Decoded + Target_);                                 \
+            OCT_DISPATCH();                                                 \
+        }
+
+    /// Only used by verified `Function`s, whose targets
+    /// are known to lie inside the Code Space
+    #define OCT_JUMP_UNCHECKED(Target) {                                    \
+            OCT_MOVE_TO(Decoded + (Target));                                \
+            OCT_DISPATCH();                                                 \
+        }
+
+    /// Counts an entry into Target, which may
+    /// move it up a tier before it is entered
+    #define OCT_INVOKE(Target) {                                            \
+            if ( (Target)->CountInvocation() )                              \
+                TierUp(*(Target), State);                                   \
+            (Target)->MarkUsed();                                           \
+        }
+
+    /// Switches execution over to another decoded `Function`.
+    /// `Stream` picks which of its decoded forms to run, and
+    /// may refer to the new `Func`. The tier budget of the
+    /// previous `Func` must have been stored beforehand.
+    #define OCT_ENTER(Target, Stream, Index) {                              \
+            Func    = (Target);                                             \
+            Code    = Func->GetCodeSpace();                                 \
+            Decoded = (Stream);                                             \
+            Count   = Func->GetInstructionCount();                          \
+            D       = Decoded + (Index);                                    \
+            Budget  = Func->GetTierBudget();                                \
+        }
+
+    /// Backward jumps are counted in `Budget`, which
+    /// is stored back whenever `Func` is left
+    #define OCT_STORE_BUDGET() Func->StoreTierBudget(Budget)
+
+    /// Rewrites the current site into the pseudo-op Name,
+    /// filling it with the given Imm and Aux. The handler
+    /// is taken from the THREADED table, as in `DecodeFunction`.
+    #define OCT_FILL_SITE(Name, Value, AuxValue) {                          \
+            const void* const* Handlers_ = GetThreadedHandlers();           \
+            D->Imm     = (u64)(Value);                                      \
+            D->Aux     = (AuxValue);                                        \
+            D->Op      = Name;                                              \
+            D->Handler = ( Handlers_ ? Handlers_[Name] : nullptr );         \
+        }
+
+    #define OCT_STACK_FAULT(ID) {                                           \
+            Fault = ( Memory.StackValid() ? Exception::ID                   \
+                                          : Exception::StackUnset );        \
+            goto L_Raise;                                                   \
+        }
+
+    /// Pushes the Stack slots cached by the `TOP_` handlers,
+    /// deepest first, which leaves the Stack as the plain
+    /// pushes would have. Their room was checked when cached.
+    #define OCT_SPILL_TOP() {                                               \
+            if ( TopLive & 1 )                                              \
+                Memory.StackPush64Unchecked(Top0);                          \
+            if ( TopLive & 2 )                                              \
+                Memory.StackPush64Unchecked(Top1);                          \
+            TopLive = 0;                                                    \
+        }
+
+    #define OCT_SYNC_OUT() {                                                \
+            OCT_SPILL_TOP();                                                \
+            OCT_STORE_BUDGET();                                             \
+            State.IP          = OCT_ORIGIN();                               \
+            State.CurrentFunc = Func;                                       \
+            for ( u8 i = 0; i < Register::COUNT; i++ )                      \
+                State.Reg[i] = R[i];                                        \
+        }
+
+    #define OCT_SYNC_IN() {                                                 \
+            for ( u8 i = 0; i < Register::COUNT; i++ )                      \
+                R[i] = State.Reg[i];                                        \
+            Budget = Func->GetTierBudget();                                 \
+        }
+
+    /// Register shorthands for the current `DecodedInstruction`
+    #define RX R[D->rX]
+    #define RY R[D->rY]
+    #define RZ R[D->rZ]
+
+    /// A handler which only ever performs a single expression
+    #define OCT_OP(Name, Expr) OCT_CASE(Name) {                             \
+            Expr;                                                           \
+            OCT_NEXT(1);                                                    \
+        }
+
+    /// if ( Cond ) jump to Imm, both with and without
+    /// a runtime check of the target. The checked form
+    /// profiles which way the jump goes.
+    #define OCT_BRANCH(Name, Unchecked, Cond)                               \
+        OCT_CASE(Name) {                                                    \
+            bool Taken_ = (Cond);                                           \
+            CountBranch(*D, Taken_);                                        \
+            if ( Taken_ )                                                   \
+                OCT_JUMP(D->Imm);                                           \
+            OCT_NEXT(1);                                                    \
+        }                                                                   \
+        case Unchecked: L_##Unchecked: {                                    \
+            if ( Cond )                                                     \
+                OCT_JUMP_UNCHECKED(D->Imm);                                 \
+            OCT_NEXT(1);                                                    \
+        }
+
+    /// Writes the `AllocationHeader` of a `requestlocal`
+    /// allocation at Raw, and points rX past it
+    #define OCT_LOCAL_HEADER(Raw, Size) {                                   \
+            AllocationHeader* Header = (AllocationHeader*)(Raw);            \
+            Header->Size            = (Size);                               \
+            Header->Padding         = MemoryAddress::ComputePaddingBytes(Size); \
+            Header->Flags           = DEFAULT_ALLOC_FLAGS;                  \
+            Header->Flags.IsLiAlloc = 1;                                    \
+            RX.AsPtr = (void*)( Header + 1 );                               \
+        }
+
+    /// Resolves the address of a `gload`/`gsave`.
+    /// rY holds a pointer to the key of a DATA `Symbol`, which
+    /// is only looked up when the site's `GlobalCache` misses.
+    #define OCT_GLOBAL_ADDR(T)                                              \
+            GlobalCache* Cache = (GlobalCache*)D->Imm;                      \
+            if ( !HitsGlobalCache(*Cache, RY.AsPtr.As.VoidPtr,              \
+                                  State.Storage.GetGeneration())            \
+                 && !FillGlobalCache(*Cache, State.Storage,                 \
+                                     RY.AsPtr.As.VoidPtr) )                 \
+                OCT_RAISE(InvalidSymbol);                                   \
+            T* Addr = (T*)( Cache->Value + RZ.AsU64 * Cache->Scale );
+
+    #define OCT_GLOAD(Name, T) OCT_CASE(Name) {                             \
+            OCT_GLOBAL_ADDR(T)                                              \
+            RX.AsU64 = *Addr;                                               \
+            OCT_NEXT(1);                                                    \
+        }
+
+    #define OCT_GSAVE(Name, T) OCT_CASE(Name) {                             \
+            OCT_GLOBAL_ADDR(T)                                              \
+            *Addr = (T)RX.AsU64;                                            \
+            OCT_NEXT(1);                                                    \
+        }
+
+    /// Resolves the bounds-checked address of a `pload`/`psave`.
+    /// The index register is `rZ`, and `Imm` holds the log2
+    /// of the element stride.
+    #define OCT_PRIV_ADDR(T)                                                \
+            MemoryAddress Base = RY.AsPtr;                                  \
+            if ( !Base )                                                    \
+                OCT_RAISE(PrivateAccessOverflow);                           \
+            u32 Size = Base.QueryAllocatedSize();                           \
+            if ( Size < sizeof(T)                                           \
+                 || RZ.AsU64 > (u64)( (Size - sizeof(T)) >> D->Imm ) )      \
+                OCT_RAISE(PrivateAccessOverflow);                           \
+            T* Addr = (T*)( Base.As.BytePtr + ( RZ.AsU64 << D->Imm ) );
+
+    #define OCT_PLOAD(Name, T) OCT_CASE(Name) {                             \
+            OCT_PRIV_ADDR(T)                                                \
+            RX.AsU64 = *Addr;                                               \
+            OCT_NEXT(1);                                                    \
+        }
+
+    #define OCT_PSAVE(Name, T) OCT_CASE(Name) {                             \
+            OCT_PRIV_ADDR(T)                                                \
+            *Addr = (T)RX.AsU64;                                            \
+            OCT_NEXT(1);                                                    \
+        }
+
+    /// The address of a `pload`/`psave` whose bounds a
+    /// `GUARD_BOUNDS` has proven for every index its loop reaches
+    #define OCT_BOUNDED_ADDR(T)                                             \
+            (T*)( RY.AsPtr.As.BytePtr + ( RZ.AsU64 << D->Imm ) )
+
+    #define OCT_BOUNDED_PLOAD(Name, T) case Name: L_##Name: {               \
+            RX.AsU64 = *OCT_BOUNDED_ADDR(T);                                \
+            OCT_NEXT(1);                                                    \
+        }
+
+    #define OCT_BOUNDED_PSAVE(Name, T) case Name: L_##Name: {               \
+            *OCT_BOUNDED_ADDR(T) = (T)RX.AsU64;                             \
+            OCT_NEXT(1);                                                    \
+        }
+
+    #if OCTVM_COMPUTED_GOTO
+        // Labels-as-values are a GNU extension
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wpedantic"
+    #endif
+    // SWITCH mode never takes the handler labels
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wunused-label"
+
+    /// DISPATCH:
+    /// If `TableQuery` is set, no code is executed.
+    /// Instead the THREADED handler table is returned
+    /// through it, for use with `DecodeFunction`.
+    ////////////////////////////////////////
+    template <DispatchMode Mode>
+    static HandlerResult Dispatch(ExecState* StatePtr,
+                                  const void* const** TableQuery = nullptr)
+                                  noexcept
+    {
+    #if OCTVM_COMPUTED_GOTO
+        if constexpr ( Mode == DispatchMode::THREADED ) {
+            //////////////// NOTE: /////////////////
+            /// This table MUST follow the exact
+            /// order of `Instruction::Opcode`.
+            ////////////////////////////////////////
+            static const void* const Table[] = {
+                &&L_nop, &&L_chrono,
+                &&L_seek, &&L_jmp, &&L_jmpis0, &&L_jmpnot0, &&L_jmpeq,
+                &&L_jmpneq, &&L_jmplt, &&L_jmpgt, &&L_jmplteq, &&L_jmpgteq,
+                &&L_call, &&L_corecall, &&L_spawn, &&L_spawnanon, &&L_merge,
+                &&L_muop, &&L_cvop, &&L_ret,
+                &&L_clr, &&L_mov, &&L_movimm, &&L_movimm32, &&L_movimm64,
+                &&L_movimmf, &&L_movimmd,
+                &&L_pushreg, &&L_pushgen, &&L_pusharg, &&L_pushall,
+                &&L_pushmem, &&L_popreg, &&L_popgen, &&L_poparg, &&L_popall,
+                &&L_popmem,
+                &&L_memset, &&L_memcpy, &&L_offset, &&L_requestbytes,
+                &&L_releasebytes, &&L_requestlocal, &&L_droplocal, &&L_eload,
+                &&L_p2g,
+                &&L_gload8, &&L_gload16, &&L_gload32, &&L_gload64,
+                &&L_gsave8, &&L_gsave16, &&L_gsave32, &&L_gsave64,
+                &&L_pload8, &&L_pload16, &&L_pload32, &&L_pload64,
+                &&L_psave8, &&L_psave16, &&L_psave32, &&L_psave64,
+                &&L_cmpis0, &&L_cmpnot0, &&L_cmpeq, &&L_cmpneq, &&L_cmplt,
+                &&L_cmpgt, &&L_cmplteq, &&L_cmpgteq, &&L_cmplti, &&L_cmpgti,
+                &&L_cmplteqi, &&L_cmpgteqi, &&L_cmpltf, &&L_cmpgtf,
+                &&L_cmplteqf, &&L_cmpgteqf, &&L_cmpltd, &&L_cmpgtd,
+                &&L_cmplteqd, &&L_cmpgteqd,
+                &&L_land, &&L_lor, &&L_lnot,
+                &&L_inc, &&L_dec, &&L_i2f, &&L_u2f, &&L_i2d, &&L_u2d, &&L_f2i,
+                &&L_f2u, &&L_f2d, &&L_d2i, &&L_d2u, &&L_d2f, &&L_pow, &&L_powi,
+                &&L_powf, &&L_powd, &&L_sqrt, &&L_sqrtf, &&L_sqrtd, &&L_add,
+                &&L_sub, &&L_mul, &&L_div, &&L_mod, &&L_addimm, &&L_subimm,
+                &&L_mulimm, &&L_divimm, &&L_modimm, &&L_idiv, &&L_imod,
+                &&L_idivimm, &&L_imodimm, &&L_fadd, &&L_fsub, &&L_fmul,
+                &&L_fdiv, &&L_fmod, &&L_dadd, &&L_dsub, &&L_dmul, &&L_ddiv,
+                &&L_dmod,
+                &&L_band, &&L_bor, &&L_bxor, &&L_bnot, &&L_shl, &&L_shr,
+                &&L_bandimm, &&L_borimm, &&L_bxorimm, &&L_bnotimm,
+                &&L_shlimm, &&L_shrimm,
+                &&L_FAULT,
+                &&L_FUSED_CMPLT_JMPNOT0, &&L_FUSED_MOVIMM_ADD,
+                &&L_FUSED_INC_JMPLT, &&L_FUSED_PUSHREG_POPREG,
+                &&L_UNCHECKED_JMPIS0, &&L_UNCHECKED_JMPNOT0,
+                &&L_UNCHECKED_JMPEQ, &&L_UNCHECKED_JMPNEQ,
+                &&L_UNCHECKED_JMPLT, &&L_UNCHECKED_JMPGT,
+                &&L_UNCHECKED_JMPLTEQ, &&L_UNCHECKED_JMPGTEQ,
+                &&L_UNCHECKED_FUSED_CMPLT_JMPNOT0,
+                &&L_UNCHECKED_FUSED_INC_JMPLT,
+                &&L_UNCHECKED_PUSHREG, &&L_UNCHECKED_PUSHGEN,
+                &&L_UNCHECKED_PUSHALL, &&L_UNCHECKED_PUSHMEM,
+                &&L_UNCHECKED_POPREG, &&L_UNCHECKED_POPGEN,
+                &&L_UNCHECKED_POPALL, &&L_UNCHECKED_POPMEM,
+                &&L_UNCHECKED_REQUESTLOCAL,
+                &&L_UNCHECKED_FUSED_PUSHREG_POPREG,
+                &&L_UNCHECKED_MASKED_PUSHALL, &&L_UNCHECKED_MASKED_POPALL,
+                &&L_REDUCED_DIVIMM, &&L_REDUCED_MODIMM,
+                &&L_REDUCED_IDIVIMM, &&L_REDUCED_IMODIMM,
+                &&L_MASKED_PUSHALL, &&L_MASKED_POPALL,
+                &&L_TOP_PUSHREG0, &&L_TOP_PUSHREG1,
+                &&L_TOP_POPREG0, &&L_TOP_POPREG1,
+                &&L_CACHED_CALL_VM, &&L_CACHED_CALL_C,
+                &&L_CACHED_CALL_JIT, &&L_CACHED_TAIL_CALL_VM,
+                &&L_UNCHECKED_PLOAD8, &&L_UNCHECKED_PLOAD16,
+                &&L_UNCHECKED_PLOAD32, &&L_UNCHECKED_PLOAD64,
+                &&L_UNCHECKED_PSAVE8, &&L_UNCHECKED_PSAVE16,
+                &&L_UNCHECKED_PSAVE32, &&L_UNCHECKED_PSAVE64,
+                &&L_GUARDED_ENTRY, &&L_GUARD_BOUNDS,
+                &&L_LOCALISED_REQUESTBYTES, &&L_LOCALISED_RELEASEBYTES
+            };
+            static_assert( sizeof(Table) / sizeof(*Table)
+                           == DECODED_HANDLER_COUNT,
+                           "Every decoded Opcode needs a handler" );
+            if ( TableQuery ) {
+                *TableQuery = Table;
+                return HandlerResult::NO_EXCEPTION;
+            }
+        }
+    #endif
+        if ( TableQuery ) {
+            *TableQuery = nullptr;
+            return HandlerResult::NO_EXCEPTION;
+        }
+
+        ExecState&    State  = *StatePtr;
+        ThreadMemory& Memory = State.ThreadMemory;
+        Function*     Func   = State.CurrentFunc;
+
+        // Native routines need no dispatch at all
+        if ( !Func )
+            return HandlerResult::FATAL;
+        if ( Func->IsCFunc() )
+            return ( Func->GetCFunc() ? Func->GetCFunc()(State)
+                                      : HandlerResult::FATAL );
+        // As do HOT ones entered at their start
+        if ( Func->GetCompiled() && !State.IP ) {
+            State.VMInstance.GetCodeCache().CountHit(*Func);
+            return Func->GetCompiled()(State);
+        }
+
+        Instruction*        Code    = Func->GetCodeSpace();
+        DecodedInstruction* Decoded = nullptr;
+        DecodedInstruction* D       = nullptr;
+        u32                 Count   = Func->GetInstructionCount();
+        u32                 Budget  = 0;
+        Exception::ID       Fault   = Exception::None;
+        Register            R[Register::COUNT];
+        // The Stack slots cached by the `TOP_` handlers,
+        // with one bit per slot whose value they hold
+        u64                 Top0    = 0;
+        u64                 Top1    = 0;
+        u8                  TopLive = 0;
+
+        if ( !Code )
+            return HandlerResult::NO_EXCEPTION;
+        if ( PrepareFunction(*Func, State) == HandlerResult::FATAL )
+            return HandlerResult::FATAL;
+        u32 Entry = ( State.IP ? State.IP - Code : 0 );
+
+        // The entry Frame has no Caller; returning from it
+        // returns from the executor. Native code resuming Func
+        // after on-stack replacement hands back the Frame of the
+        // activation it replaced instead.
+        if ( Entry && Memory.LocalFrameHandedTo() == Func )
+            Memory.LocalFrameTakeOver();
+        else if ( !Memory.LocalFrameNew() ) {
+            Raise(State, Exception::LocalOutOfMemory, Code + Entry);
+            return HandlerResult::FATAL;
+        }
+
+        // Resuming is not a new invocation, and the
+        // `FrameDemand` only describes entries at the start.
+        // A Function turning HOT here runs compiled right away.
+        if ( Entry == 0 ) {
+            OCT_INVOKE(Func);
+            if ( Func->GetCompiled() ) {
+                Memory.LocalFrameDrop();
+                State.VMInstance.GetCodeCache().CountHit(*Func);
+                return Func->GetCompiled()(State);
+            }
+        }
+        OCT_ENTER(Func, ( Entry ? Func->GetDecodedChecked()
+                                : Func->SelectDecoded(Memory) ), Entry);
+
+        OCT_SYNC_IN();
+
+    #if OCTVM_COMPUTED_GOTO
+        if constexpr ( Mode == DispatchMode::THREADED )
+            goto *D->Handler;
+    #endif
+
+        for (;;) {
+            switch ( D->Op ) {
+            /// GENERIC:
+            ////////////////////////////////////////
+            OCT_CASE(nop)
+                OCT_NEXT(1);
+
+            OCT_OP(chrono,
+                RX.AsU64 = (u64)std::chrono::duration_cast
+                    <std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()
+                    ).count())
+
+            /// CONTROLFLOW:
+            /// Jump targets have been resolved into absolute
+            /// indices by `DecodeFunction`, which also turns
+            /// out of range `seek`/`jmp` targets into faults.
+            ////////////////////////////////////////
+            OCT_CASE(seek)
+            OCT_CASE(jmp) {
+                OCT_MOVE_TO(Decoded + D->Imm);
+                OCT_DISPATCH();
+            }
+
+            OCT_BRANCH(jmpis0,  UNCHECKED_JMPIS0,  RX.AsU64 == 0)
+            OCT_BRANCH(jmpnot0, UNCHECKED_JMPNOT0, RX.AsU64 != 0)
+            OCT_BRANCH(jmpeq,   UNCHECKED_JMPEQ,   RX.AsU64 == RY.AsU64)
+            OCT_BRANCH(jmpneq,  UNCHECKED_JMPNEQ,  RX.AsU64 != RY.AsU64)
+            OCT_BRANCH(jmplt,   UNCHECKED_JMPLT,   RX.AsU64 <  RY.AsU64)
+            OCT_BRANCH(jmpgt,   UNCHECKED_JMPGT,   RX.AsU64 >  RY.AsU64)
+            OCT_BRANCH(jmplteq, UNCHECKED_JMPLTEQ, RX.AsU64 <= RY.AsU64)
+            OCT_BRANCH(jmpgteq, UNCHECKED_JMPGTEQ, RX.AsU64 >= RY.AsU64)
+
+            // Resolves the callee, then fills the site so that
+            // every later call through it skips straight to a
+            // CACHED_CALL_* handler. Those fall back here once
+            // their `Symbol` may have been reassigned or deleted.
+            // The index is read from the Code Space, as `Imm`
+            // is overwritten once the site has been filled.
+            OCT_CASE(call) {
+                RelocationTable* Reloc = Func->GetRelocTable();
+                Symbol* Sym = ( Reloc
+                                ? Reloc->RetrieveIDX(OCT_ORIGIN()->Imm16.Imm)
+                                : nullptr );
+                if ( !Sym || Sym->Type != SymbolType::FUNC || !Sym->Value )
+                    OCT_RAISE(InvalidSymbol);
+                Function* Callee = Sym->CastValue<Function>();
+                // Linking the site requires both ends to
+                // agree on how arguments are passed
+                if ( Callee->GetCallingConvention()
+                     != Reloc->RetrieveIDXConvention(OCT_ORIGIN()->Imm16.Imm) )
+                    OCT_RAISE(InvalidSymbol);
+                Callee->MarkLinked();
+
+                // HOT Functions are called just like native ones
+                ExposedFunc CFunc = ( Callee->IsCFunc() ? Callee->GetCFunc()
+                                                        : Callee->GetCompiled() );
+                if ( Callee->IsCFunc() || CFunc ) {
+                    if ( !CFunc )
+                        OCT_RAISE(InvalidSymbol);
+                    if ( Callee->IsCFunc() ) {
+                        OCT_FILL_SITE(CACHED_CALL_C, CFunc,
+                                      Reloc->GetGeneration());
+                    }
+                    else {
+                        OCT_FILL_SITE(CACHED_CALL_JIT, Callee,
+                                      Reloc->GetGeneration());
+                        State.VMInstance.GetCodeCache().CountHit(*Callee);
+                    }
+                    OCT_SYNC_OUT();
+                    if ( CFunc(State) == HandlerResult::FATAL ) {
+                        UnwindFrames(Memory);
+                        return HandlerResult::FATAL;
+                    }
+                    OCT_SYNC_IN();
+                    OCT_NEXT(1);
+                }
+
+                // Empty bytecode Functions return immediately
+                if ( !Callee->GetCodeSpace() )
+                    OCT_NEXT(1);
+                if ( !Callee->GetDecoded() ) {
+                    OCT_SYNC_OUT();
+                    if ( PrepareFunction(*Callee, State) == HandlerResult::FATAL ) {
+                        UnwindFrames(Memory);
+                        return HandlerResult::FATAL;
+                    }
+                }
+                // The Code Space is padded with `ret`s, so
+                // the word after the last `call` can be read
+                bool Tail = ( OCT_ORIGIN()[1].Any.Op == Instruction::ret );
+                OCT_FILL_SITE( Tail ? CACHED_TAIL_CALL_VM : CACHED_CALL_VM,
+                               Callee, Reloc->GetGeneration() );
+                if ( !Tail || Memory.LocalFrameUsage() != 0 ) {
+                    if ( !Memory.LocalFrameNew(Func, OCT_ORIGIN() + 1) )
+                        OCT_RAISE(LocalOutOfMemory);
+                }
+                OCT_STORE_BUDGET();
+                OCT_INVOKE(Callee);
+                OCT_ENTER(Callee, Func->SelectDecoded(Memory), 0);
+                OCT_DISPATCH();
+            }
+
+            OCT_CASE(corecall) {
+                ExposedFunc CFunc =
+                    State.VMInstance.GetCoreCall((u16)D->Imm);
+                if ( !CFunc )
+                    OCT_RAISE(InvalidSymbol);
+                OCT_SYNC_OUT();
+                if ( CFunc(State) == HandlerResult::FATAL ) {
+                    UnwindFrames(Memory);
+                    return HandlerResult::FATAL;
+                }
+                OCT_SYNC_IN();
+                OCT_NEXT(1);
+            }
+
+            /// Threading `Instruction`s need `VPCore`
+            /// scheduling, which the VM does not have,
+            /// so every executor and compiler tier
+            /// raises `UnsupportedInstruction` on them.
+            ////////////////////////////////////////
+            OCT_CASE(spawn)
+            OCT_CASE(spawnanon)
+            OCT_CASE(merge)
+            OCT_CASE(muop)
+            OCT_CASE(cvop)
+                OCT_RAISE(UnsupportedInstruction);
+
+            OCT_CASE(ret) {
+                Function*    Caller   = Memory.LocalFrameCaller();
+                Instruction* ReturnIP = Memory.LocalFrameReturnIP();
+                Memory.LocalFrameDrop();
+
+                // Returning from the entry Frame leaves the executor
+                if ( !Caller ) {
+                    OCT_SYNC_OUT();
+                    return HandlerResult::NO_EXCEPTION;
+                }
+                // No site reachable after a `call` is ever proven,
+                // so both decoded forms agree from here on
+                OCT_STORE_BUDGET();
+                OCT_ENTER(Caller, Func->GetDecoded(),
+                          ReturnIP - Caller->GetCodeSpace());
+                OCT_DISPATCH();
+            }
+
+            /// REGISTERS:
+            /// Every `movimm` variant has been widened to
+            /// its final 64-bit register value.
+            ////////////////////////////////////////
+            OCT_OP(clr, RX.AsU64 = 0)
+            OCT_OP(mov, RX = RY)
+            OCT_OP(movimm, RX.AsU64 = D->Imm)
+
+            OCT_CASE(movimm32)
+            OCT_CASE(movimmf) {
+                RX.AsU64 = D->Imm;
+                OCT_NEXT(2);
+            }
+
+            OCT_CASE(movimm64)
+            OCT_CASE(movimmd) {
+                RX.AsU64 = D->Imm;
+                OCT_NEXT(3);
+            }
+
+            /// STACK:
+            /// `pushgen`/`popgen` take a 16-bit register
+            /// mask; registers are pushed in ascending
+            /// order and popped in descending order.
+            ////////////////////////////////////////
+            OCT_CASE(pushreg)
+            OCT_CASE(pusharg) {
+                if ( Memory.StackPush64(RX.AsU64) < 0 )
+                    OCT_STACK_FAULT(StackOverflow);
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(pushgen) {
+                u16 Mask = (u16)D->Imm;
+                if ( Memory.GetStackRemaining() < MaskCount(Mask) * sizeof(u64) )
+                    OCT_STACK_FAULT(StackOverflow);
+                for ( u8 i = 0; i < Register::COUNT; i++ )
+                    if ( Mask & (1 << i) )
+                        Memory.StackPush64(R[i].AsU64);
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(pushall) {
+                if ( Memory.GetStackRemaining() < sizeof(R) )
+                    OCT_STACK_FAULT(StackOverflow);
+                Memory.StackPushMemUnchecked(R, sizeof(R));
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(pushmem) {
+                if ( Memory.StackPushMem(RX.AsPtr.As.VoidPtr, (u16)D->Imm) < 0 )
+                    OCT_STACK_FAULT(StackOverflow);
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(popreg)
+            OCT_CASE(poparg) {
+                ThreadMemory::PopOpt Pop = Memory.StackPop64();
+                if ( !Pop.Valid )
+                    OCT_STACK_FAULT(StackUnderflow);
+                RX.AsU64 = Pop.Value;
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(popgen) {
+                u16 Mask = (u16)D->Imm;
+                if ( Memory.GetStackUsage() < MaskCount(Mask) * sizeof(u64) )
+                    OCT_STACK_FAULT(StackUnderflow);
+                for ( i8 i = Register::COUNT - 1; i >= 0; i-- )
+                    if ( Mask & (1 << i) )
+                        R[i].AsU64 = Memory.StackPop64().Value;
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(popall) {
+                if ( Memory.GetStackUsage() < sizeof(R) )
+                    OCT_STACK_FAULT(StackUnderflow);
+                Memory.StackPopMemUnchecked((byte*)R, sizeof(R));
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(popmem) {
+                if ( !Memory.StackPopMem(RX.AsPtr.As.BytePtr,
+                                         (u16)D->Imm).Valid )
+                    OCT_STACK_FAULT(StackUnderflow);
+                OCT_NEXT(1);
+            }
+
+            /// MEMORY: - GENERIC:
+            /// `requestlocal` allocations carry a regular
+            /// `AllocationHeader` (flagged `IsLiAlloc`) so
+            /// that private accesses can bounds-check them
+            /// exactly like `requestbytes` allocations.
+            ////////////////////////////////////////
+            OCT_OP(memset,
+                QuickSet((u8)RY.AsU64, RX.AsPtr.As.VoidPtr, (u32)RZ.AsU64))
+
+            OCT_OP(memcpy,
+                QuickCopy(RY.AsPtr.As.VoidPtr, RX.AsPtr.As.VoidPtr,
+                          (u32)RZ.AsU64))
+
+            OCT_CASE(offset) {
+                if ( D->Imm >= Func->GetSharedSize() )
+                    OCT_RAISE(SharedAccessOverflow);
+                RX.AsPtr = Func->GetSharedSpace() + D->Imm;
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(requestbytes) {
+                if ( RY.AsU64 > CoreAllocator::MAX_ALLOC_SIZE )
+                    OCT_RAISE(HeapOutOfMemory);
+                MemoryAddress Addr =
+                    State.Allocator.Request((AddressSizeSpecificer)RY.AsU64);
+                if ( !Addr )
+                    OCT_RAISE(HeapOutOfMemory);
+                RX.AsPtr = Addr;
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(releasebytes) {
+                if ( RX.AsPtr )
+                    State.Allocator.Release(RX.AsPtr);
+                RX.AsU64 = 0;
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(requestlocal) {
+                u16 Size  = (u16)D->Imm;
+                u32 Total = GetLocalAllocationSize(Size);
+                if ( Total > 0xFFFF )
+                    OCT_RAISE(LocalOutOfMemory);
+                byte* Raw = Memory.LocalRequestBytes((u16)Total);
+                if ( !Raw )
+                    OCT_RAISE_ID( Memory.LocalValid() ? Exception::LocalOutOfMemory
+                                                      : Exception::LocalUnset );
+                OCT_LOCAL_HEADER(Raw, Size);
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(droplocal) {
+                MemoryAddress Addr = RX.AsPtr;
+                if ( !Addr || !Memory.LocalValid() )
+                    OCT_RAISE(LocalUnset);
+                // Only the most recent Local allocation can be dropped
+                if ( Addr.As.BytePtr + Addr.QueryContiguousSize()
+                     != Memory.GetLocalStart() + Memory.GetLocalUsage() )
+                    OCT_RAISE(LocalAccessUnderflow);
+                if ( Memory.LocalDropBytes( (u16)( Addr.QueryTotalAllocatedSize() ) ) < 0 )
+                    OCT_RAISE(LocalAccessUnderflow);
+                RX.AsU64 = 0;
+                OCT_NEXT(1);
+            }
+
+            OCT_CASE(eload) {
+                RelocationTable* Reloc = Func->GetRelocTable();
+                Symbol* Sym = ( Reloc ? Reloc->RetrieveIDX((u32)D->Imm)
+                                      : nullptr );
+                if ( !Sym || Sym->Type != SymbolType::DATA )
+                    OCT_RAISE(InvalidSymbol);
+                RX.AsPtr = Sym->Value;
+                OCT_NEXT(1);
+            }
+
+            /// Publishes the pointer in rX as a global DATA
+            /// `Symbol` keyed by the string in rY, replacing
+            /// any `Symbol` already stored under that key.
+            OCT_CASE(p2g) {
+                StorageRequest Request;
+                Request.Type         = SymbolType::DATA;
+                Request.ExtendedType = 0;
+                Request.Key          = (const char*)RY.AsPtr.As.VoidPtr;
+                Request.Value        = RX.AsPtr.As.VoidPtr;
+                Request.ValueSize    = 0;
+                if ( !Request.Key )
+                    OCT_RAISE(InvalidSymbol);
+                State.Storage.DeleteSymbol(Request.Key);
+                if ( !State.Storage.AssignSymbol(Request) )
+                    OCT_RAISE(InvalidSymbol);
+                OCT_NEXT(1);
+            }
+
+            /// MEMORY: - GLOBAL:
+            ////////////////////////////////////////
+            OCT_GLOAD(gload8,  u8 )
+            OCT_GLOAD(gload16, u16)
+            OCT_GLOAD(gload32, u32)
+            OCT_GLOAD(gload64, u64)
+            OCT_GSAVE(gsave8,  u8 )
+            OCT_GSAVE(gsave16, u16)
+            OCT_GSAVE(gsave32, u32)
+            OCT_GSAVE(gsave64, u64)
+
+            /// MEMORY: - PRIVATE:
+            ////////////////////////////////////////
+            OCT_PLOAD(pload8,  u8 )
+            OCT_PLOAD(pload16, u16)
+            OCT_PLOAD(pload32, u32)
+            OCT_PLOAD(pload64, u64)
+            OCT_PSAVE(psave8,  u8 )
+            OCT_PSAVE(psave16, u16)
+            OCT_PSAVE(psave32, u32)
+            OCT_PSAVE(psave64, u64)
+
+            /// COMPARISON:
+            ////////////////////////////////////////
+            OCT_OP(cmpis0,   RX.AsU64 = ( RY.AsU64 == 0 ))
+            OCT_OP(cmpnot0,  RX.AsU64 = ( RY.AsU64 != 0 ))
+            OCT_OP(cmpeq,    RX.AsU64 = ( RY.AsU64 == RZ.AsU64 ))
+            OCT_OP(cmpneq,   RX.AsU64 = ( RY.AsU64 != RZ.AsU64 ))
+            OCT_OP(cmplt,    RX.AsU64 = ( RY.AsU64 <  RZ.AsU64 ))
+            OCT_OP(cmpgt,    RX.AsU64 = ( RY.AsU64 >  RZ.AsU64 ))
+            OCT_OP(cmplteq,  RX.AsU64 = ( RY.AsU64 <= RZ.AsU64 ))
+            OCT_OP(cmpgteq,  RX.AsU64 = ( RY.AsU64 >= RZ.AsU64 ))
+            OCT_OP(cmplti,   RX.AsU64 = ( RY.AsI64 <  RZ.AsI64 ))
+            OCT_OP(cmpgti,   RX.AsU64 = ( RY.AsI64 >  RZ.AsI64 ))
+            OCT_OP(cmplteqi, RX.AsU64 = ( RY.AsI64 <= RZ.AsI64 ))
+            OCT_OP(cmpgteqi, RX.AsU64 = ( RY.AsI64 >= RZ.AsI64 ))
+            OCT_OP(cmpltf,   RX.AsU64 = ( RY.AsF32 <  RZ.AsF32 ))
+            OCT_OP(cmpgtf,   RX.AsU64 = ( RY.AsF32 >  RZ.AsF32 ))
+            OCT_OP(cmplteqf, RX.AsU64 = ( RY.AsF32 <= RZ.AsF32 ))
+            OCT_OP(cmpgteqf, RX.AsU64 = ( RY.AsF32 >= RZ.AsF32 ))
+            OCT_OP(cmpltd,   RX.AsU64 = ( RY.AsF64 <  RZ.AsF64 ))
+            OCT_OP(cmpgtd,   RX.AsU64 = ( RY.AsF64 >  RZ.AsF64 ))
+            OCT_OP(cmplteqd, RX.AsU64 = ( RY.AsF64 <= RZ.AsF64 ))
+            OCT_OP(cmpgteqd, RX.AsU64 = ( RY.AsF64 >= RZ.AsF64 ))
+
+            /// LOGICAL:
+            ////////////////////////////////////////
+            OCT_OP(land, RX.AsU64 = ( RY.AsU64 && RZ.AsU64 ))
+            OCT_OP(lor,  RX.AsU64 = ( RY.AsU64 || RZ.AsU64 ))
+            OCT_OP(lnot, RX.AsU64 = !RY.AsU64)
+
+            /// ARITHMETIC:
+            ////////////////////////////////////////
+            OCT_OP(inc, RX.AsU64++)
+            OCT_OP(dec, RX.AsU64--)
+
+            OCT_OP(i2f, SetF32(RX, (f32)RY.AsI64))
+            OCT_OP(u2f, SetF32(RX, (f32)RY.AsU64))
+            OCT_OP(i2d, RX.AsF64 = (f64)RY.AsI64)
+            OCT_OP(u2d, RX.AsF64 = (f64)RY.AsU64)
+            OCT_OP(f2i, RX.AsI64 = FloatToInt<i64>(RY.AsF32))
+            OCT_OP(f2u, RX.AsU64 = FloatToInt<u64>(RY.AsF32))
+            OCT_OP(f2d, RX.AsF64 = (f64)RY.AsF32)
+            OCT_OP(d2i, RX.AsI64 = FloatToInt<i64>(RY.AsF64))
+            OCT_OP(d2u, RX.AsU64 = FloatToInt<u64>(RY.AsF64))
+            OCT_OP(d2f, SetF32(RX, (f32)RY.AsF64))
+
+            OCT_OP(pow, RX.AsU64 = PowU(RY.AsU64, RZ.AsU64))
+            OCT_OP(powi,
+                if ( !PowI(RY.AsI64, RZ.AsI64, RX.AsI64) )
+                    OCT_RAISE(DivideByZeroI))
+            OCT_OP(powf,  SetF32(RX, std::pow(RY.AsF32, RZ.AsF32)))
+            OCT_OP(powd,  RX.AsF64 = std::pow(RY.AsF64, RZ.AsF64))
+            OCT_OP(sqrt,  RX.AsU64 = SqrtU(RY.AsU64))
+            OCT_OP(sqrtf, SetF32(RX, std::sqrt(RY.AsF32)))
+            OCT_OP(sqrtd, RX.AsF64 = std::sqrt(RY.AsF64))
+
+            OCT_OP(add, RX.AsU64 = RY.AsU64 + RZ.AsU64)
+            OCT_OP(sub, RX.AsU64 = RY.AsU64 - RZ.AsU64)
+            OCT_OP(mul, RX.AsU64 = RY.AsU64 * RZ.AsU64)
+            OCT_OP(div,
+                if ( !RZ.AsU64 )
+                    OCT_RAISE(DivideByZeroU);
+                RX.AsU64 = RY.AsU64 / RZ.AsU64)
+            OCT_OP(mod,
+                if ( !RZ.AsU64 )
+                    OCT_RAISE(DivideByZeroU);
+                RX.AsU64 = RY.AsU64 % RZ.AsU64)
+
+            OCT_OP(addimm, RX.AsU64 = RY.AsU64 + D->Imm)
+            OCT_OP(subimm, RX.AsU64 = RY.AsU64 - D->Imm)
+            OCT_OP(mulimm, RX.AsU64 = RY.AsU64 * D->Imm)
+            OCT_OP(divimm,
+                if ( !D->Imm )
+                    OCT_RAISE(DivideByZeroU);
+                RX.AsU64 = RY.AsU64 / D->Imm)
+            OCT_OP(modimm,
+                if ( !D->Imm )
+                    OCT_RAISE(DivideByZeroU);
+                RX.AsU64 = RY.AsU64 % D->Imm)
+
+            OCT_OP(idiv,
+                if ( !RZ.AsI64 )
+                    OCT_RAISE(DivideByZeroI);
+                RX.AsI64 = DivI(RY.AsI64, RZ.AsI64))
+            OCT_OP(imod,
+                if ( !RZ.AsI64 )
+                    OCT_RAISE(DivideByZeroI);
+                RX.AsI64 = ModI(RY.AsI64, RZ.AsI64))
+            OCT_OP(idivimm,
+                if ( !D->Imm )
+                    OCT_RAISE(DivideByZeroI);
+                RX.AsI64 = DivI(RY.AsI64, (i64)D->Imm))
+            OCT_OP(imodimm,
+                if ( !D->Imm )
+                    OCT_RAISE(DivideByZeroI);
+                RX.AsI64 = ModI(RY.AsI64, (i64)D->Imm))
+
+            OCT_OP(fadd, SetF32(RX, RY.AsF32 + RZ.AsF32))
+            OCT_OP(fsub, SetF32(RX, RY.AsF32 - RZ.AsF32))
+            OCT_OP(fmul, SetF32(RX, RY.AsF32 * RZ.AsF32))
+            OCT_OP(fdiv,
+                if ( RZ.AsF32 == 0.0f )
+                    OCT_RAISE(DivideByZeroF);
+                SetF32(RX, RY.AsF32 / RZ.AsF32))
+            OCT_OP(fmod,
+                if ( RZ.AsF32 == 0.0f )
+                    OCT_RAISE(DivideByZeroF);
+                SetF32(RX, std::fmod(RY.AsF32, RZ.AsF32)))
+
+            OCT_OP(dadd, RX.AsF64 = RY.AsF64 + RZ.AsF64)
+            OCT_OP(dsub, RX.AsF64 = RY.AsF64 - RZ.AsF64)
+            OCT_OP(dmul, RX.AsF64 = RY.AsF64 * RZ.AsF64)
+            OCT_OP(ddiv,
+                if ( RZ.AsF64 == 0.0 )
+                    OCT_RAISE(DivideByZeroD);
+                RX.AsF64 = RY.AsF64 / RZ.AsF64)
+            OCT_OP(dmod,
+                if ( RZ.AsF64 == 0.0 )
+                    OCT_RAISE(DivideByZeroD);
+                RX.AsF64 = std::fmod(RY.AsF64, RZ.AsF64))
+
+            /// BITWISE:
+            /// `bnotimm` has been pre-inverted, so it
+            /// shares the body of `movimm`.
+            ////////////////////////////////////////
+            OCT_OP(band, RX.AsU64 = RY.AsU64 & RZ.AsU64)
+            OCT_OP(bor,  RX.AsU64 = RY.AsU64 | RZ.AsU64)
+            OCT_OP(bxor, RX.AsU64 = RY.AsU64 ^ RZ.AsU64)
+            OCT_OP(bnot, RX.AsU64 = ~RY.AsU64)
+            OCT_OP(shl,  RX.AsU64 = RY.AsU64 << ( RZ.AsU64 & 63 ))
+            OCT_OP(shr,  RX.AsU64 = RY.AsU64 >> ( RZ.AsU64 & 63 ))
+            OCT_OP(bandimm, RX.AsU64 = RY.AsU64 & D->Imm)
+            OCT_OP(borimm,  RX.AsU64 = RY.AsU64 | D->Imm)
+            OCT_OP(bxorimm, RX.AsU64 = RY.AsU64 ^ D->Imm)
+            OCT_OP(bnotimm, RX.AsU64 = D->Imm)
+            OCT_OP(shlimm,  RX.AsU64 = RY.AsU64 << ( D->Imm & 63 ))
+            OCT_OP(shrimm,  RX.AsU64 = RY.AsU64 >> ( D->Imm & 63 ))
+
+            /// An `Instruction` that can only ever raise
+            /// the `Exception` stored in `Imm`
+            case DECODED_FAULT: L_FAULT:
+                OCT_RAISE_ID((Exception::ID)D->Imm);
+
+            /// SUPERINSTRUCTIONS:
+            /// The second half reads its operands from
+            /// `D[1]`. Any `Exception` raised by the second
+            /// half first moves `D` onto it, so that the
+            /// offender is exactly what the unfused stream
+            /// would have reported.
+            ////////////////////////////////////////
+            case FUSED_CMPLT_JMPNOT0: L_FUSED_CMPLT_JMPNOT0: {
+                RX.AsU64 = ( RY.AsU64 < RZ.AsU64 );
+                D++;
+                CountBranch(*D, RX.AsU64 != 0);
+                if ( RX.AsU64 != 0 )
+                    OCT_JUMP(D->Imm);
+                OCT_NEXT(1);
+            }
+
+            case UNCHECKED_FUSED_CMPLT_JMPNOT0:
+            L_UNCHECKED_FUSED_CMPLT_JMPNOT0: {
+                RX.AsU64 = ( RY.AsU64 < RZ.AsU64 );
+                D++;
+                if ( RX.AsU64 != 0 )
+                    OCT_JUMP_UNCHECKED(D->Imm);
+                OCT_NEXT(1);
+            }
+
+            case FUSED_MOVIMM_ADD: L_FUSED_MOVIMM_ADD: {
+                RX.AsU64 = D->Imm;
+                D++;
+                RX.AsU64 = RY.AsU64 + RZ.AsU64;
+                OCT_NEXT(1);
+            }
+
+            // Only fused when both halves share rX
+            case FUSED_INC_JMPLT: L_FUSED_INC_JMPLT: {
+                u64 Value = ++RX.AsU64;
+                D++;
+                CountBranch(*D, Value < RY.AsU64);
+                if ( Value < RY.AsU64 )
+                    OCT_JUMP(D->Imm);
+                OCT_NEXT(1);
+            }
+
+            case UNCHECKED_FUSED_INC_JMPLT: L_UNCHECKED_FUSED_INC_JMPLT: {
+                u64 Value = ++RX.AsU64;
+                D++;
+                if ( Value < RY.AsU64 )
+                    OCT_JUMP_UNCHECKED(D->Imm);
+                OCT_NEXT(1);
+            }
+
+            // Stack memory above the top is never observable,
+            // so the value only needs to pass through a register.
+            // Without room for the push, the unfused path raises.
+            case FUSED_PUSHREG_POPREG: L_FUSED_PUSHREG_POPREG: {
+                if ( Memory.GetStackRemaining() < sizeof(u64) )
+                    goto L_pushreg;
+                u64 Value = RX.AsU64;
+                D++;
+                RX.AsU64 = Value;
+                OCT_NEXT(1);
+            }
+
+            /// RESERVED:
+            /// Sites proven by `AnalyseFrameDemand`. They only
+            /// run once `Function::SelectDecoded` has found the
+            /// full `FrameDemand` available on entry, so none of
+            /// them can overflow or underflow.
+            ////////////////////////////////////////
+            case UNCHECKED_PUSHREG: L_UNCHECKED_PUSHREG:
+                Memory.StackPush64Unchecked(RX.AsU64);
+                OCT_NEXT(1);
+
+            case UNCHECKED_PUSHGEN: L_UNCHECKED_PUSHGEN: {
+                u16 Mask = (u16)D->Imm;
+                for ( u8 i = 0; i < Register::COUNT; i++ )
+                    if ( Mask & (1 << i) )
+                        Memory.StackPush64Unchecked(R[i].AsU64);
+                OCT_NEXT(1);
+            }
+
+            case UNCHECKED_PUSHALL: L_UNCHECKED_PUSHALL:
+                Memory.StackPushMemUnchecked(R, sizeof(R));
+                OCT_NEXT(1);
+
+            case UNCHECKED_PUSHMEM: L_UNCHECKED_PUSHMEM:
+                Memory.StackPushMemUnchecked(RX.AsPtr.As.VoidPtr, (u16)D->Imm);
+                OCT_NEXT(1);
+
+            case UNCHECKED_POPREG: L_UNCHECKED_POPREG:
+                RX.AsU64 = Memory.StackPop64Unchecked();
+                OCT_NEXT(1);
+
+            case UNCHECKED_POPGEN: L_UNCHECKED_POPGEN: {
+                u16 Mask = (u16)D->Imm;
+                for ( i8 i = Register::COUNT - 1; i >= 0; i-- )
+                    if ( Mask & (1 << i) )
+                        R[i].AsU64 = Memory.StackPop64Unchecked();
+                OCT_NEXT(1);
+            }
+
+            case UNCHECKED_POPALL: L_UNCHECKED_POPALL:
+                Memory.StackPopMemUnchecked((byte*)R, sizeof(R));
+                OCT_NEXT(1);
+
+            case UNCHECKED_POPMEM: L_UNCHECKED_POPMEM:
+                Memory.StackPopMemUnchecked(RX.AsPtr.As.BytePtr, (u16)D->Imm);
+                OCT_NEXT(1);
+
+            // Already allocated on entry, along with every
+            // other proven request. Oversized ones are never proven.
+            case UNCHECKED_REQUESTLOCAL: L_UNCHECKED_REQUESTLOCAL: {
+                u16 Size = (u16)D->Imm;
+                OCT_LOCAL_HEADER(Memory.LocalFrameData() + D->Aux, Size);
+                OCT_NEXT(1);
+            }
+
+            case UNCHECKED_FUSED_PUSHREG_POPREG:
+            L_UNCHECKED_FUSED_PUSHREG_POPREG: {
+                u64 Value = RX.AsU64;
+                D++;
+                RX.AsU64 = Value;
+                OCT_NEXT(1);
+            }
+
+            case UNCHECKED_MASKED_PUSHALL: L_UNCHECKED_MASKED_PUSHALL:
+                Memory.StackPushMaskedUnchecked(R, sizeof(R), (u16)D->Imm);
+                OCT_NEXT(1);
+
+            case UNCHECKED_MASKED_POPALL: L_UNCHECKED_MASKED_POPALL:
+                Memory.StackPopMaskedUnchecked((byte*)R, sizeof(R), (u16)D->Imm);
+                OCT_NEXT(1);
+
+            /// REDUCED:
+            /// Immediate divisions strength reduced by
+            /// `OptimiseFunction`, whose divisor is in `Aux`.
+            ////////////////////////////////////////
+            case REDUCED_DIVIMM: L_REDUCED_DIVIMM:
+                RX.AsU64 = ApplyUnsignedMagic(RY.AsU64, D->Imm, D->rZ);
+                OCT_NEXT(1);
+
+            case REDUCED_MODIMM: L_REDUCED_MODIMM: {
+                u64 Value = RY.AsU64;
+                RX.AsU64  = Value - ApplyUnsignedMagic(Value, D->Imm, D->rZ)
+                                    * D->Aux;
+                OCT_NEXT(1);
+            }
+
+            case REDUCED_IDIVIMM: L_REDUCED_IDIVIMM:
+                RX.AsI64 = ApplySignedMagic(RY.AsI64, D->Imm, D->rZ);
+                OCT_NEXT(1);
+
+            case REDUCED_IMODIMM: L_REDUCED_IMODIMM: {
+                i64 Value = RY.AsI64;
+                RX.AsU64  = (u64)Value
+                          - (u64)ApplySignedMagic(Value, D->Imm, D->rZ)
+                            * (u64)(i64)(i32)D->Aux;
+                OCT_NEXT(1);
+            }
+
+            /// MASKED:
+            /// The Stack moves by the whole register file,
+            /// but only the registers in `Imm` are copied.
+            ////////////////////////////////////////
+            case MASKED_PUSHALL: L_MASKED_PUSHALL:
+                if ( Memory.GetStackRemaining() < sizeof(R) )
+                    OCT_STACK_FAULT(StackOverflow);
+                Memory.StackPushMaskedUnchecked(R, sizeof(R), (u16)D->Imm);
+                OCT_NEXT(1);
+
+            case MASKED_POPALL: L_MASKED_POPALL:
+                if ( Memory.GetStackUsage() < sizeof(R) )
+                    OCT_STACK_FAULT(StackUnderflow);
+                Memory.StackPopMaskedUnchecked((byte*)R, sizeof(R), (u16)D->Imm);
+                OCT_NEXT(1);
+
+            /// STACKTOP:
+            /// Pairs found by `CacheStackTop`, between which
+            /// nothing else reaches the Stack below the slots.
+            /// A push without the room its pair relies on spills
+            /// the slots and pushes, raising where it would have.
+            ////////////////////////////////////////
+            case TOP_PUSHREG0: L_TOP_PUSHREG0:
+                if ( Memory.GetStackRemaining() < D->Aux )
+                    goto L_pushreg;
+                Top0     = RX.AsU64;
+                TopLive |= 1;
+                OCT_NEXT(1);
+
+            case TOP_PUSHREG1: L_TOP_PUSHREG1:
+                if ( Memory.GetStackRemaining() < D->Aux ) {
+                    OCT_SPILL_TOP();
+                    goto L_pushreg;
+                }
+                Top1     = RX.AsU64;
+                TopLive |= 2;
+                OCT_NEXT(1);
+
+            case TOP_POPREG0: L_TOP_POPREG0:
+                if ( !( TopLive & 1 ) )
+                    goto L_popreg;
+                RX.AsU64 = Top0;
+                TopLive &= (u8)~1;
+                OCT_NEXT(1);
+
+            case TOP_POPREG1: L_TOP_POPREG1:
+                if ( !( TopLive & 2 ) )
+                    goto L_popreg;
+                RX.AsU64 = Top1;
+                TopLive &= (u8)~2;
+                OCT_NEXT(1);
+
+            /// CACHED:
+            /// `call` sites filled by the `call` handler. Each
+            /// only holds while no `Symbol` has been assigned or
+            /// deleted since, and otherwise resolves again. So does
+            /// a compiled callee which has lost its code since.
+            ////////////////////////////////////////
+            case CACHED_CALL_VM: L_CACHED_CALL_VM: {
+                if ( D->Aux != Func->GetRelocTable()->GetGeneration() )
+                    goto L_call;
+                Function* Callee = (Function*)D->Imm;
+                if ( !Memory.LocalFrameNew(Func, OCT_ORIGIN() + 1) )
+                    OCT_RAISE(LocalOutOfMemory);
+                OCT_STORE_BUDGET();
+                OCT_INVOKE(Callee);
+                OCT_ENTER(Callee, Func->SelectDecoded(Memory), 0);
+                OCT_DISPATCH();
+            }
+
+            /// Where the `ret` would only drop this Frame and
+            /// return to its caller, the callee takes the Frame over
+            /// instead, which keeps tail recursion in constant Local
+            /// Space. Allocations still held by the Frame may be
+            /// referred to from the registers, so such calls create
+            /// a Frame of their own after all.
+            case CACHED_TAIL_CALL_VM: L_CACHED_TAIL_CALL_VM: {
+                if ( Memory.LocalFrameUsage() != 0 )
+                    goto L_CACHED_CALL_VM;
+                if ( D->Aux != Func->GetRelocTable()->GetGeneration() )
+                    goto L_call;
+                Function* Callee = (Function*)D->Imm;
+                OCT_STORE_BUDGET();
+                OCT_INVOKE(Callee);
+                OCT_ENTER(Callee, Func->SelectDecoded(Memory), 0);
+                OCT_DISPATCH();
+            }
+
+            case CACHED_CALL_C: L_CACHED_CALL_C: {
+                if ( D->Aux != Func->GetRelocTable()->GetGeneration() )
+                    goto L_call;
+                OCT_SYNC_OUT();
+                if ( ((ExposedFunc)D->Imm)(State) == HandlerResult::FATAL ) {
+                    UnwindFrames(Memory);
+                    return HandlerResult::FATAL;
+                }
+                OCT_SYNC_IN();
+                OCT_NEXT(1);
+            }
+
+            case CACHED_CALL_JIT: L_CACHED_CALL_JIT: {
+                if ( D->Aux != Func->GetRelocTable()->GetGeneration() )
+                    goto L_call;
+                Function* Callee = (Function*)D->Imm;
+                State.VMInstance.GetCodeCache().CountHit(*Callee);
+                OCT_SYNC_OUT();
+                if ( Callee->GetCompiled()(State) == HandlerResult::FATAL ) {
+                    UnwindFrames(Memory);
+                    return HandlerResult::FATAL;
+                }
+                OCT_SYNC_IN();
+                OCT_NEXT(1);
+            }
+
+            /// BOUNDED:
+            /// Loops whose private accesses are proven in
+            /// bounds by a guard ahead of their header.
+            ////////////////////////////////////////
+            OCT_BOUNDED_PLOAD(UNCHECKED_PLOAD8,  u8 )
+            OCT_BOUNDED_PLOAD(UNCHECKED_PLOAD16, u16)
+            OCT_BOUNDED_PLOAD(UNCHECKED_PLOAD32, u32)
+            OCT_BOUNDED_PLOAD(UNCHECKED_PLOAD64, u64)
+            OCT_BOUNDED_PSAVE(UNCHECKED_PSAVE8,  u8 )
+            OCT_BOUNDED_PSAVE(UNCHECKED_PSAVE16, u16)
+            OCT_BOUNDED_PSAVE(UNCHECKED_PSAVE32, u32)
+            OCT_BOUNDED_PSAVE(UNCHECKED_PSAVE64, u64)
+
+            case GUARDED_ENTRY: L_GUARDED_ENTRY:
+                D = Decoded + D->Imm;
+                OCT_DISPATCH();
+
+            // Falling into the header is not a backward
+            // jump, so it is never counted
+            case GUARD_BOUNDS: L_GUARD_BOUNDS:
+                if ( !PassesBoundsGuard(D->Imm, R) )
+                    Decoded = Func->GetDecodedChecked();
+                D = Decoded + D->Aux;
+                OCT_DISPATCH();
+
+            /// LOCALISED:
+            /// Scratch buffers which never escape the `Function`,
+            /// taken from its Local Frame when it has room, and
+            /// from the heap otherwise. Zero sized requests always
+            /// go to the heap, so that they still raise.
+            ////////////////////////////////////////
+            case LOCALISED_REQUESTBYTES: L_LOCALISED_REQUESTBYTES: {
+                if ( !RY.AsU64 || RY.AsU64 > LOCALISED_MAX_SIZE )
+                    goto L_requestbytes;
+                u16   Size = (u16)RY.AsU64;
+                byte* Raw  = Memory.LocalRequestBytes(
+                                 (u16)GetLocalAllocationSize(Size) );
+                if ( !Raw )
+                    goto L_requestbytes;
+                OCT_LOCAL_HEADER(Raw, Size);
+                OCT_NEXT(1);
+            }
+
+            // Nothing between a pair's request and its release
+            // allocates from the Local Frame without dropping it
+            // again, so a Local allocation is always the most recent
+            case LOCALISED_RELEASEBYTES: L_LOCALISED_RELEASEBYTES: {
+                MemoryAddress Addr = RX.AsPtr;
+                if ( !Addr || !Addr.Header()->Flags.IsLiAlloc )
+                    goto L_releasebytes;
+                if ( Addr.As.BytePtr + Addr.QueryContiguousSize()
+                     != Memory.GetLocalStart() + Memory.GetLocalUsage()
+                     || Memory.LocalDropBytes(
+                            (u16)Addr.QueryTotalAllocatedSize() ) < 0 )
+                    OCT_RAISE(LocalAccessUnderflow);
+                RX.AsU64 = 0;
+                OCT_NEXT(1);
+            }
+
+            default:
+                OCT_RAISE(InvalidOpcode);
+            }
+
+            /// Only reachable through OCT_RAISE
+        L_Raise:
+            {
+                OCT_SYNC_OUT();
+                // Inlined `Instruction`s are reported as
+                // part of the callee they were copied from
+                Instruction*        Offender = OCT_ORIGIN();
+                const InlineOrigin* Origin   =
+                    Func->GetInlineOrigin((u32)( D - Decoded ));
+                if ( Origin ) {
+                    Offender          = Origin->Callee->GetCodeSpace()
+                                      + Origin->Index;
+                    State.IP          = Offender;
+                    State.CurrentFunc = Origin->Callee;
+                }
+                HandlerResult Result = Raise(State, Fault, Offender);
+                if ( Result == HandlerResult::FATAL ) {
+                    UnwindFrames(Memory);
+                    return HandlerResult::FATAL;
+                }
+                // Both HANDLED and IGNORED resume after the offender,
+                // keeping any corrections the handler made to `Reg`.
+                // Those may undo what a bounds guard has proven, so
+                // the rest of the activation runs the checked form.
+                OCT_SYNC_IN();
+                D       = Func->GetDecodedChecked() + ( D - Decoded );
+                Decoded = Func->GetDecodedChecked();
+                OCT_NEXT(Instruction::GetWordCount(OCT_ORIGIN()->Any.Op));
+            }
+
+            /// On-stack replacement. Only reachable through
+            /// OCT_MOVE_TO, with `D` on the target of the backward
+            /// jump which handed `Func` to the compiler tier.
+        L_Replace:
+            {
+                ExposedFunc Native = GetOSREntry(*Func, State,
+                                                 (u32)( D - Decoded ));
+                if ( !Native )
+                    OCT_DISPATCH();
+
+                // The native code runs in this activation's Frame
+                Function*    Caller   = Memory.LocalFrameCaller();
+                Instruction* ReturnIP = Memory.LocalFrameReturnIP();
+                OCT_SYNC_OUT();
+                Memory.LocalFrameHandOver(Func);
+                State.VMInstance.GetCodeCache().CountHit(*Func);
+                HandlerResult Result = Native(State);
+                // Unless resumed by an executor, which has
+                // taken the Frame over and dropped it since
+                if ( Memory.LocalFrameHandedTo() == Func )
+                    Memory.LocalFrameDrop();
+
+                if ( Result == HandlerResult::FATAL ) {
+                    if ( Caller )
+                        UnwindFrames(Memory);
+                    return HandlerResult::FATAL;
+                }
+                if ( !Caller )
+                    return Result;
+                // Func has returned, just as through `ret`
+                OCT_ENTER(Caller, Caller->GetDecoded(),
+                          ReturnIP - Caller->GetCodeSpace());
+                OCT_SYNC_IN();
+                OCT_DISPATCH();
+            }
+        }
+    }
+
+    #pragma GCC diagnostic pop
+    #if OCTVM_COMPUTED_GOTO
+        #pragma GCC diagnostic pop
+    #endif
+
+    /// @brief Returns the handler table of the THREADED
+    /// executor, or nullptr if computed gotos are unavailable.
+    ////////////////////////////////////////
+    static const void* const* GetThreadedHandlers(void) noexcept
+    {
+        static const void* const* Handlers = [](){
+            const void* const* Table = nullptr;
+            Dispatch<DispatchMode::THREADED>(nullptr, &Table);
+            return Table;
+        }();
+        return Handlers;
+    }
+
+    /// @brief Verifies and decodes the given `Function` into
+    /// its COLD form on its first run, and starts counting it
+    /// towards WARM. Both dispatch modes decode against
+    /// the THREADED handler table, so a decoded `Function`
+    /// can be run by either of them.
+    ///
+    /// A `Function` failing verification has the first
+    /// `Exception` found raised with `IsStaticEval()` set. Unless the
+    /// handler deems it FATAL, the `Function` still runs, with
+    /// every runtime check in place.
+    /// @return FATAL if the `Function` must not be executed.
+    ////////////////////////////////////////
+    static HandlerResult PrepareFunction(Function& Func,
+                                         ExecState& State) noexcept
+    {
+        if ( Func.GetDecoded() )
+            return HandlerResult::NO_EXCEPTION;
+
+        VerifyResult Result = VerifyFunction(Func);
+        if ( Result.Fault == Exception::None ) {
+            Func.MarkVerified();
+            // Unless an activation is entering it part-way,
+            // relying on the Code Space as it is
+            if ( State.VMInstance.GetBytecodeOptimisation()
+              && !( State.IP && State.CurrentFunc == &Func ) )
+                OptimiseBytecode(Func, State.Allocator);
+        }
+        else if ( Raise(State, Result.Fault,
+                        Func.GetCodeSpace() + Result.Offset, true)
+                  == HandlerResult::FATAL )
+            return HandlerResult::FATAL;
+
+        // A Function cannot run undecoded, so running
+        // out of memory here is always FATAL
+        if ( DecodeFunction(Func, State.Allocator, GetThreadedHandlers())
+             != MEMORY_OK ) {
+            Raise(State, Exception::HeapOutOfMemory, Func.GetCodeSpace());
+            return HandlerResult::FATAL;
+        }
+
+        const TierPolicy& Policy = State.VMInstance.GetTierPolicy();
+        Func.SetTier(FunctionTier::COLD, Policy.WarmThreshold);
+        if ( !Policy.WarmThreshold )
+            TierUp(Func, State);
+        return HandlerResult::NO_EXCEPTION;
+    }
+
+    /// @brief Moves a `Function` whose tier budget has run
+    /// out up a tier, as configured by the VM's `TierPolicy`.
+    /// Activations already running the `Function` carry on
+    /// in the form they entered, unless moved into native
+    /// code through `GetOSREntry`.
+    /// @return True if the `Function` was handed to the
+    /// VM's `TierCompiler`, whether or not it turned HOT.
+    ////////////////////////////////////////
+    static bool TierUp(Function& Func, ExecState& State) noexcept
+    {
+        const TierPolicy& Policy = State.VMInstance.GetTierPolicy();
+        switch ( Func.GetTier() ) {
+            case FunctionTier::COLD:
+                // Running out of memory here only costs the proven
+                // sites, so the Function is WARM regardless
+                OptimiseFunction(Func, State.Allocator, GetThreadedHandlers());
+                Func.SetTier(FunctionTier::WARM,
+                             ( Policy.HotThreshold > Policy.WarmThreshold
+                               ? Policy.HotThreshold - Policy.WarmThreshold
+                               : 1 ));
+                return false;
+
+            case FunctionTier::WARM: {
+                TierCompiler Compiler = State.VMInstance.GetTierCompiler();
+                if ( Compiler )
+                    State.VMInstance.GetCodeCache().CountMiss();
+                ExposedFunc Compiled = ( Compiler ? Compiler(Func, State, 0)
+                                                  : nullptr );
+                // Declined, so retry once it has been as hot again,
+                // backing off so that a low threshold cannot turn
+                // every backward jump into a compile attempt
+                if ( !Compiled ) {
+                    u64 Events = Func.GetInvocationCount()
+                               + Func.GetBackEdgeCount();
+                    if ( Events < Policy.HotThreshold )
+                        Events = Policy.HotThreshold;
+                    Func.SetTier(FunctionTier::WARM,
+                                 (u32)( Events < UINT32_MAX ? Events
+                                                            : UINT32_MAX ));
+                    return ( Compiler != nullptr );
+                }
+                Func.AssignCompiled(Compiled);
+                // Call sites still holding the bytecode form
+                // re-resolve into the compiled one
+                State.Storage.AdvanceGeneration();
+                return true;
+            }
+
+            case FunctionTier::HOT:
+                Func.SetTier(FunctionTier::HOT, UINT32_MAX);
+                return false;
+        }
+        return false;
+    }
+
+    /// @brief Returns the native entry point of Func starting at
+    /// the `Instruction` at IDX, compiling it on first use. Loops
+    /// which only ever run once per call, such as the main loop of
+    /// a script, never see Func entered again once it turns HOT.
+    /// @return nullptr if the VM's `TierCompiler` declined.
+    ////////////////////////////////////////
+    static ExposedFunc GetOSREntry(Function& Func, ExecState& State,
+                                   u32 IDX) noexcept
+    {
+        if ( !IDX )
+            return Func.GetCompiled();
+        ExposedFunc Entry = Func.GetOSREntry(IDX);
+        TierCompiler Compiler = State.VMInstance.GetTierCompiler();
+        if ( !Entry && Compiler ) {
+            CodeCache& Cache = State.VMInstance.GetCodeCache();
+            Cache.CountMiss();
+            Entry = Compiler(Func, State, IDX);
+            // Only one loop keeps its entry point
+            if ( Entry )
+                Cache.Release(Func, Func.AssignOSREntry(IDX, Entry));
+        }
+        return Entry;
+    }
+
+    /// EXECUTE:
+    ////////////////////////////////////////
+    HandlerResult Execute(ExecState& State) noexcept
+    {
+        if ( State.VMInstance.GetDispatchMode() == DispatchMode::SWITCH )
+            return Dispatch<DispatchMode::SWITCH>(&State);
+        return Dispatch<DispatchMode::THREADED>(&State);
+    }
+
+    HandlerResult ExecuteThreaded(ExecState& State) noexcept
+        { return Dispatch<DispatchMode::THREADED>(&State); }
+
+    HandlerResult ExecuteSwitch(ExecState& State) noexcept
+        { return Dispatch<DispatchMode::SWITCH>(&State); }
+
+}
@@ -241,6 +241,7 @@ Symbol* FlatStorage::AssignSymbol(StorageRequest& Request)  noexcept
     
     // All clear!
     m_MapUsage++;
+    AdvanceGeneration();
     m_LastError = SRError::OK;
     return Symbol;
 }
@@ -276,15 +277,17 @@ Symbol* FlatStorage::LookupSymbol(const char* Key) noexcept
 bool    FlatStorage::DeleteSymbol(const char* Key) noexcept
 {
     // Sanity check inputs
-    if ( !Key || !m_Map  || m_MapUsage )
+    if ( !Key || !m_Map  || !m_MapUsage )
         return false;
 
     u32 KeyLen  = QuickStrLen(Key);
-    u32 KeyHash = QuickSDBM(Key, KeyLen);
+    u64 KeyHash = QuickSDBM(Key, KeyLen);
     u32 IDX = KeyHash % m_MapSize;
 
     FSSymbol* Root = m_Map[IDX];
     FSSymbol* DeletionSymbol = Root;
+    if ( !Root )
+        return false;
     // If its the very first one, replace [IDX] with its
     // CollisionNext, then delete it.
     if ( Root->KeyHash == KeyHash 
@@ -315,6 +318,7 @@ bool    FlatStorage::DeleteSymbol(const char* Key) noexcept
     m_Allocator->Release<FSSymbol>(DeletionSymbol);
 
     m_MapUsage--;
+    AdvanceGeneration();
     return true;
 }
 
@@ -25,6 +25,7 @@
 #define OCTVM_INTERNAL 1
 
 #include "Headers/Functions.hpp"
+#include "Headers/CodeCache.hpp"
 #include <iostream>
 
 namespace Octane {
@@ -56,11 +57,11 @@ namespace Octane {
 
     /// ASSIGNIDX:
     ////////////////////////////////////////
-    bool RelocationTable::AssignIDX(u32 IDX, const char* Key, bool Resolve)
-    noexcept
+    bool RelocationTable::AssignIDX(u32 IDX, const char* Key, bool Resolve,
+                                    CallingConvention Convention) noexcept
     {
         // Sanity check
-        if ( IDX > m_ArrayLen || !Key )
+        if ( IDX >= m_ArrayLen || !Key )
             return false;
         
         Entry& Slot = m_Array[IDX];
@@ -68,10 +69,12 @@ namespace Octane {
         if ( Slot.Key )
             return false;
 
-        Slot.Key = Key;
-        if ( Resolve && m_Storage )
+        Slot.Key        = Key;
+        Slot.Convention = Convention;
+        if ( Resolve && m_Storage ) {
             Slot.ResolvedSymbol = m_Storage->LookupSymbol(Key);
-        else
+            Slot.Generation     = m_Storage->GetGeneration();
+        } else
             Slot.ResolvedSymbol = nullptr;
 
         
@@ -83,17 +86,20 @@ namespace Octane {
     Symbol* RelocationTable::RetrieveIDX(u32 IDX) noexcept
     {
         // Sanity Check
-        if ( IDX > m_ArrayLen || !m_Storage )
+        if ( IDX >= m_ArrayLen || !m_Storage )
             return nullptr;
         
         Entry& Slot = m_Array[IDX];
 
-        // If already resolved, just return that
-        if ( Slot.ResolvedSymbol )
+        // If already resolved, and nothing has been assigned
+        // or deleted since, just return that
+        u32 Generation = m_Storage->GetGeneration();
+        if ( Slot.ResolvedSymbol && Slot.Generation == Generation )
             return Slot.ResolvedSymbol;
         
         // Perform a lookup and store result
         Slot.ResolvedSymbol = m_Storage->LookupSymbol(Slot.Key);
+        Slot.Generation     = Generation;
 
         // Note: This can be null in the event the Key doesn't refer to
         // any defined Symbol
@@ -105,11 +111,37 @@ namespace Octane {
     const char* RelocationTable::RetrieveIDXKey(u32 IDX) noexcept
     {
         // Sanity Check
-        if ( IDX > m_ArrayLen )
+        if ( IDX >= m_ArrayLen )
             return nullptr;
         
         return m_Array[IDX].Key;
     }
+
+    /// RETRIEVEIDXCONVENTION:
+    ////////////////////////////////////////
+    CallingConvention RelocationTable::RetrieveIDXConvention(u32 IDX)
+    const noexcept
+    {
+        // Sanity Check
+        if ( IDX >= m_ArrayLen )
+            return {};
+
+        return m_Array[IDX].Convention;
+    }
+
+    /// RETRIEVEIDXBOUND:
+    ////////////////////////////////////////
+    Symbol* RelocationTable::RetrieveIDXBound(u32 IDX) const noexcept
+    {
+        // Sanity Check
+        if ( IDX >= m_ArrayLen || !m_Storage )
+            return nullptr;
+
+        const Entry& Slot = m_Array[IDX];
+        if ( Slot.Generation != m_Storage->GetGeneration() )
+            return nullptr;
+        return Slot.ResolvedSymbol;
+    }
     
                                       
 
@@ -127,12 +159,27 @@ namespace Octane {
     ////////////////////////////////////////
     void Function::InitExposed(ExposedFunc CFunc) noexcept
     {
+        if ( m_CodeCache )
+            m_CodeCache->Release(*this);
         m_InstructionCount = 0;
         m_SharedSize       = 0;
         m_SharedPadding    = 0;
         m_SharedOffset     = 0;
         m_IsVMFunc         = false;
         m_FirstRun         = true;
+        m_Verified         = false;
+        m_Tier             = FunctionTier::COLD;
+        m_Convention       = {};
+        m_Linked           = false;
+        m_Invocations      = 0;
+        m_TierEvents       = 0;
+        m_TierBudget       = 0;
+        m_TierTarget       = 0;
+        m_Compiled         = nullptr;
+        m_OSREntry         = nullptr;
+        m_OSRIndex         = 0;
+        m_DeoptCount       = 0;
+        m_CodeUse          = 0;
         m_Raw.CFunc        = CFunc; 
     }
 
@@ -179,13 +226,43 @@ namespace Octane {
         if ( !m_Raw.VMBytes ) // Failed!
             return Allocator.GetLastError();
         
+        /// Any previously decoded Code Space is now stale
+        if ( m_CodeCache )
+            m_CodeCache->Release(*this);
+        if ( m_Decoded )
+            Allocator.Release(MemoryAddress(m_Decoded));
+        if ( m_DecodedChecked )
+            Allocator.Release(MemoryAddress(m_DecodedChecked));
+        if ( m_GlobalCaches )
+            Allocator.Release(MemoryAddress(m_GlobalCaches));
+        if ( m_InlineOrigins )
+            Allocator.Release(MemoryAddress(m_InlineOrigins));
+        m_Decoded        = nullptr;
+        m_DecodedChecked = nullptr;
+        m_GlobalCaches   = nullptr;
+        m_InlineOrigins  = nullptr;
+
         /// Store all the other variables
+        m_RelocTable       = Reloc;
         m_InstructionCount = INSCount;
         m_SharedSize       = SharedSize;
         m_SharedPadding    = Padding;
         m_SharedOffset     = Offset;
         m_IsVMFunc         = true;
         m_FirstRun         = true;
+        m_Verified         = false;
+        m_Tier             = FunctionTier::COLD;
+        m_Convention       = {};
+        m_Linked           = false;
+        m_Invocations      = 0;
+        m_TierEvents       = 0;
+        m_TierBudget       = 0;
+        m_TierTarget       = 0;
+        m_Compiled         = nullptr;
+        m_OSREntry         = nullptr;
+        m_OSRIndex         = 0;
+        m_DeoptCount       = 0;
+        m_CodeUse          = 0;
 
         return MEMORY_OK;
     }
@@ -196,8 +273,91 @@ namespace Octane {
     {
         /// Better performance this way. TODO: WTF
         Allocator.Release(MemoryAddress(m_Raw.VMBytes));
+        if ( m_Decoded )
+            Allocator.Release(MemoryAddress(m_Decoded));
+        if ( m_DecodedChecked )
+            Allocator.Release(MemoryAddress(m_DecodedChecked));
+        if ( m_GlobalCaches )
+            Allocator.Release(MemoryAddress(m_GlobalCaches));
+        if ( m_InlineOrigins )
+            Allocator.Release(MemoryAddress(m_InlineOrigins));
+        if ( m_CodeCache )
+            m_CodeCache->Release(*this);
+        m_Decoded        = nullptr;
+        m_DecodedChecked = nullptr;
+        m_GlobalCaches   = nullptr;
+        m_InlineOrigins  = nullptr;
+        m_Compiled       = nullptr;
+        m_OSREntry       = nullptr;
+        m_OSRIndex       = 0;
+    }
+
+    /// TRUNCATECODESPACE:
+    ////////////////////////////////////////
+    bool Function::TruncateCodeSpace(u16 Count) noexcept
+    {
+        if ( !m_IsVMFunc || m_Decoded || !Count || Count > m_InstructionCount )
+            return false;
+
+        Instruction* Code = (Instruction*)m_Raw.VMBytes;
+        for ( u32 i = Count; i < m_InstructionCount; i++ )
+            Code[i] = Instruction::Make(Instruction::ret, Instruction::ret,
+                                        Instruction::ret, Instruction::ret);
+        m_SharedPadding   += ( m_InstructionCount - Count ) * sizeof(Instruction);
+        m_InstructionCount = Count;
+        return true;
     }
 
 
 
-}
\ No newline at end of file
+
+    /// REPLACECODESPACE:
+    ////////////////////////////////////////
+    MemoryError Function::ReplaceCodeSpace(CoreAllocator& Allocator,
+                                           const Instruction* Code, u16 Count,
+                                           InlineOrigin* Origins) noexcept
+    {
+        if ( !m_IsVMFunc || m_Decoded || !Count ) {
+            Allocator.Release(Origins);
+            return MEMORY_SIZE_IS_ZERO;
+        }
+
+        /// The same layout as `Init`, around the new Code Space
+        int Padding =
+        (
+            BASE_PADDING_BYTES +
+            MemoryAddress::ComputePaddingBytes
+                ( (sizeof(Instruction) * Count) + BASE_PADDING_BYTES )
+        );
+        int Offset = ( (sizeof(Instruction) * Count) + Padding );
+
+        byte* Bytes = Allocator.Request<byte>(
+            (sizeof(Instruction) * Count) + Padding + m_SharedSize,
+            DEFAULT_ALLOC_FLAGS,
+            (byte)Instruction::ret
+        );
+        if ( !Bytes ) {
+            Allocator.Release(Origins);
+            return Allocator.GetLastError();
+        }
+        QuickCopy(Code, Bytes, sizeof(Instruction) * Count);
+        if ( m_SharedSize )
+            QuickCopy(m_Raw.VMBytes + m_SharedOffset, Bytes + Offset,
+                      m_SharedSize);
+
+        if ( m_CodeCache )
+            m_CodeCache->Release(*this);
+        Allocator.Release(MemoryAddress(m_Raw.VMBytes));
+        if ( m_InlineOrigins )
+            Allocator.Release(MemoryAddress(m_InlineOrigins));
+
+        m_Raw.VMBytes      = Bytes;
+        m_InlineOrigins    = Origins;
+        m_InstructionCount = Count;
+        m_SharedPadding    = Padding;
+        m_SharedOffset     = Offset;
+        m_Verified         = false;
+        return MEMORY_OK;
+    }
+
+}
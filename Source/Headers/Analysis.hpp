@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_ANALYSIS_HPP
+#define OCTVM_ANALYSIS_HPP 1
+
+#include "Common.hpp"
+#include "CoreMemory.hpp"
+#include "VPCore.hpp"
+
+namespace Octane {
+
+    class Function;
+    struct DecodedInstruction;
+
+    /// @brief The most Stack and Local Space a `Function`
+    /// can use, relative to the state it was entered with.
+    ////////////////////////////////////////
+    struct FrameDemand {
+        /// The most bytes pushed above the Stack usage at entry
+        u32 StackPush;
+        /// The most bytes popped below the Stack usage at
+        /// entry, such as arguments pushed by the caller
+        u32 StackPop;
+        /// The most bytes requested through `requestlocal`
+        u32 Local;
+    };
+
+    /// @brief Returns the amount of Local Space taken by a
+    /// `requestlocal` of the given size, including its
+    /// `AllocationHeader` and padding.
+    ////////////////////////////////////////
+    constexpr OctVM_SternInline
+    u32 GetLocalAllocationSize(u16 Size) noexcept
+        { return sizeof(AllocationHeader) + Size
+               + MemoryAddress::ComputePaddingBytes(Size); }
+
+    /// @brief Retrieves the amount of bytes an
+    /// `Instruction` pushes (positive) or pops
+    /// (negative) on the Stack
+    /// @return False if the `Instruction` does
+    /// not use the Stack.
+    ////////////////////////////////////////
+    extern bool GetStackEffect(const Instruction& Ins, i32& Effect) noexcept;
+
+    /// @brief The amount of u64 words in a bitset
+    /// holding one bit per possible `Instruction`
+    ////////////////////////////////////////
+    constexpr const u32 INSTRUCTION_BITSET_WORDS = ( 0xFFFF / 64 ) + 1;
+
+    /// @brief Computes the `FrameDemand` of a verified
+    /// `Function` through a dataflow pass over its control
+    /// flow graph, tracking the Stack depth and Local usage
+    /// at every `Instruction` relative to the `Function`'s
+    /// entry.
+    ///
+    /// A site is proven if its depth (or usage) is the same
+    /// on every path reaching it. If the full demand is
+    /// available at entry, proven sites can never overflow
+    /// or underflow, and may skip their runtime checks.
+    ///
+    /// Any `call`, `corecall` or threading `Instruction`
+    /// may use the Stack arbitrarily, so no site reachable
+    /// after one is ever proven. Sites whose depth differs
+    /// between paths, such as pushes inside of a loop, are
+    /// never proven either.
+    ///
+    /// A proven `requestlocal` runs at most once per entry,
+    /// always at the same offset into the Frame, so the whole
+    /// Local demand can be reserved on entry. A `droplocal`
+    /// only drops the most recent allocation of a Frame, which
+    /// a reserved one is not, so no `requestlocal` is proven
+    /// in a `Function` containing one.
+    /// @param Func The verified `Function` to analyse
+    /// @param Allocator The VM's `CoreAllocator`, used
+    /// for temporary storage
+    /// @param Demand Receives the demand of every proven site
+    /// @param Proven A bitset of `INSTRUCTION_BITSET_WORDS`,
+    /// receiving one set bit per proven push, pop or
+    /// `requestlocal` site
+    /// @param LocalOffsets One entry per `Instruction`. Each
+    /// proven `requestlocal` receives the offset of its
+    /// allocation from the start of the Frame's Address Space.
+    /// @return The amount of proven sites. 0 if there are
+    /// none, or if temporary storage could not be allocated.
+    ////////////////////////////////////////
+    extern u32 AnalyseFrameDemand(const Function& Func,
+                                  CoreAllocator& Allocator,
+                                  FrameDemand& Demand,
+                                  u64* Proven,
+                                  u32* LocalOffsets) noexcept;
+
+    /// HOT: CODE:
+    ////////////////////////////////////////
+
+    /// @brief The least runs of a conditional jump whose
+    /// `BranchProfile` `AnalyseHotCode` relies upon
+    ////////////////////////////////////////
+    constexpr const u32 MIN_BRANCH_SAMPLES = 16;
+
+    /// @brief A way taken at most once in this many
+    /// runs of a conditional jump is cold
+    ////////////////////////////////////////
+    constexpr const u32 COLD_BRANCH_RATIO  = 64;
+
+    /// @brief Splits a `Function` into the `Instruction`s a
+    /// compiler tier should keep together from Entry, and those
+    /// rarely or never run, by the `BranchProfile`s its checked
+    /// form collected.
+    ///
+    /// Once a conditional jump has run `MIN_BRANCH_SAMPLES`
+    /// times, a way it went at most once in `COLD_BRANCH_RATIO`
+    /// runs is cold. Every `Instruction` reached from Entry
+    /// without going a cold way is hot. Everything else, such
+    /// as error paths and code before the loop of an on-stack
+    /// replacement, is cold. Without a profile, only code
+    /// unreachable from Entry is cold.
+    /// @param Func The `Function` to analyse
+    /// @param Allocator The VM's `CoreAllocator`, used
+    /// for temporary storage
+    /// @param Decoded The checked decoded form of Func
+    /// @param Entry The `Instruction` the code starts at
+    /// @param Hot A bitset of `INSTRUCTION_BITSET_WORDS`,
+    /// receiving one set bit per hot `Instruction`
+    /// @return The amount of hot `Instruction`s. 0 if
+    /// temporary storage could not be allocated.
+    ////////////////////////////////////////
+    extern u32 AnalyseHotCode(const Function& Func,
+                              CoreAllocator& Allocator,
+                              const DecodedInstruction* Decoded,
+                              u32 Entry, u64* Hot) noexcept;
+
+    /// REGISTERS:
+    ////////////////////////////////////////
+
+    /// @brief One bit per register
+    ////////////////////////////////////////
+    using RegMask = u16;
+    constexpr const RegMask ALL_REGISTERS =
+        (RegMask)( ( 1u << VPCore::Register::COUNT ) - 1 );
+
+    /// @brief How an `Instruction` affects the register file
+    ////////////////////////////////////////
+    enum class OpClass : u8 {
+        /// Writes rX from its operands, if any, and nothing else
+        PURE,
+        /// As PURE, unless its operands make it raise
+        FAULTING,
+        /// `seek`, `jmp` and every conditional jump
+        BRANCH,
+        /// `ret`, after which every register is observed
+        RET,
+        /// May raise, or hand the register file to other code
+        BARRIER,
+    };
+
+    /// @brief The register operands of an `Instruction`,
+    /// `VPCore::Register::UNUSED` where its `Layout` has none
+    ////////////////////////////////////////
+    struct RegOperands {
+        u8 X, Y, Z;
+    };
+
+    extern OpClass     GetOpClass    (const Instruction& Ins) noexcept;
+    extern RegOperands GetRegOperands(const Instruction& Ins) noexcept;
+
+    /// @return The bit of Reg, or none for `VPCore::Register::UNUSED`
+    ////////////////////////////////////////
+    constexpr OctVM_SternInline
+    RegMask GetRegBit(u8 Reg) noexcept
+        { return ( Reg < VPCore::Register::COUNT ? (RegMask)( 1u << Reg ) : 0 ); }
+
+    /// @brief Returns the registers a PURE, FAULTING
+    /// or BRANCH `Instruction` reads
+    ////////////////////////////////////////
+    extern RegMask GetRegReads(const Instruction& Ins) noexcept;
+
+    /// @brief Computes which registers may still be read after
+    /// every `Instruction` of a verified `Function`, through a
+    /// backward dataflow pass over its control flow graph.
+    ///
+    /// As callers share the register file, `ret` and running
+    /// off the end read every register. So does anything which
+    /// may raise an `Exception`, whose handler may inspect them,
+    /// and every `call`, `corecall` or threading `Instruction`.
+    /// Only PURE `Instruction`s, which write rX, and jumps
+    /// leave any register dead.
+    /// @param Func The verified `Function` to analyse
+    /// @param Allocator The VM's `CoreAllocator`, used
+    /// for temporary storage
+    /// @param LiveOut Receives one `RegMask` per word of the
+    /// Code Space, holding the registers live after the
+    /// `Instruction` starting there. Trailing immediate
+    /// words receive `ALL_REGISTERS`.
+    /// @return False if `Func` is unverified, or temporary
+    /// storage could not be allocated.
+    ////////////////////////////////////////
+    extern bool AnalyseLiveness(const Function& Func,
+                                CoreAllocator& Allocator,
+                                RegMask* LiveOut) noexcept;
+
+    /// BOUNDS: CHECKS:
+    ////////////////////////////////////////
+
+    /// @brief The most access patterns one `BoundsGuard` checks
+    ////////////////////////////////////////
+    constexpr const u32 BOUNDS_GUARD_CHECKS = 4;
+
+    /// @brief A check of every `pload`/`psave` a loop indexes
+    /// by its induction variable, hoisted out of the loop.
+    ///
+    /// Checks packs the induction variable into bits 0-3, its
+    /// limit into bits 4-7 and the amount of access patterns
+    /// into bits 8-10. From bit 16 on, each pattern takes 12 bits:
+    /// the base register, the log2 stride, the log2 width of the
+    /// access, and whether it follows the step of the variable.
+    ////////////////////////////////////////
+    struct BoundsGuard {
+        /// The `Instruction` falling through into the loop
+        u32 Preheader;
+        /// The first `Instruction` of the loop
+        u32 Header;
+        /// The packed checks, as evaluated by `PassesBoundsGuard`
+        u64 Checks;
+    };
+
+    /// @brief Finds the innermost loops of a verified `Function`
+    /// which step an induction variable towards a limit, and
+    /// proves their `pload`/`psave`s indexed by it in bounds
+    /// for as long as their `BoundsGuard` passes on entry.
+    ///
+    /// A loop runs from a header, which a PURE `Instruction`
+    /// falls through into, to a back edge of `jmplt rI, rN` or
+    /// of `cmplt rC, rI, rN` and `jmpnot0 rC`, which is the only
+    /// jump to its header. Nothing outside of the loop jumps
+    /// inside, and jumps inside only go forward or leave it.
+    /// rI is only written by a single `inc`, while rN and the
+    /// base of every proven access are never written. Calls,
+    /// `releasebytes` and anything else which may free memory or
+    /// hand the register file to other code rule a loop out.
+    ///
+    /// rI then never exceeds the larger of its value on entry
+    /// and rN - 1 before its `inc`, or that plus 1 after it, so
+    /// a single check of each access at that index, made on
+    /// every entry, proves all of the loop's accesses.
+    /// @param Func The verified `Function` to analyse
+    /// @param Allocator The VM's `CoreAllocator`, used
+    /// for temporary storage
+    /// @param Decoded The checked decoded form of Func
+    /// @param Guards Room for Count / 2 + 1 `BoundsGuard`s,
+    /// receiving one per proven loop in Code Space order
+    /// @param Proven A bitset of `INSTRUCTION_BITSET_WORDS`,
+    /// receiving one set bit per proven `pload`/`psave`
+    /// @return The amount of `BoundsGuard`s. 0 if there are
+    /// none, or if temporary storage could not be allocated.
+    ////////////////////////////////////////
+    extern u32 AnalyseBoundsChecks(const Function& Func,
+                                   CoreAllocator& Allocator,
+                                   const DecodedInstruction* Decoded,
+                                   BoundsGuard* Guards,
+                                   u64* Proven) noexcept;
+
+    /// @brief Evaluates the packed checks of a `BoundsGuard`
+    /// against a register file, as the `pload`s and `psave`s
+    /// it covers would check their largest index.
+    /// @return True if none of them can go out of bounds.
+    ////////////////////////////////////////
+    extern bool PassesBoundsGuard(u64 Checks,
+                                  const VPCore::Register* Reg) noexcept;
+
+    /// ESCAPES:
+    ////////////////////////////////////////
+
+    /// @brief Finds the `requestbytes` of a verified `Function`
+    /// whose allocation never escapes it, each paired with the
+    /// `releasebytes` freeing it again further down.
+    ///
+    /// A pair runs from a `requestbytes rP` to the first
+    /// `releasebytes rP` after it. Nothing outside of the pair
+    /// jumps inside, and jumps inside neither leave it nor go
+    /// back to the request, and there is no `ret`, so every
+    /// path through the pair ends in its release. In between,
+    /// rP is never written, and is only read as the base of a
+    /// `pload`/`psave` or a pointer of `memset`/`memcpy`, so the
+    /// address is never copied, stored through `gsave` or `psave`,
+    /// pushed, or published through `p2g`. Calls, spawns and
+    /// anything else handing the register file to other code,
+    /// as well as `requestlocal` and `droplocal`, rule a pair
+    /// out. Pairs are either disjoint or nested, so that their
+    /// allocations are always released in reverse order.
+    /// @param Func The verified `Function` to analyse
+    /// @param Allocator The VM's `CoreAllocator`, used
+    /// for temporary storage
+    /// @param Paired A bitset of `INSTRUCTION_BITSET_WORDS`,
+    /// receiving one set bit per paired `requestbytes`
+    /// and `releasebytes`
+    /// @return The amount of pairs. 0 if there are none,
+    /// or if temporary storage could not be allocated.
+    ////////////////////////////////////////
+    extern u32 AnalyseEscapes(const Function& Func,
+                              CoreAllocator& Allocator,
+                              u64* Paired) noexcept;
+
+}
+
+#endif /* !OCTVM_ANALYSIS_HPP */
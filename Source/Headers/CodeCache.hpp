@@ -0,0 +1,220 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_CODECACHE_HPP
+#define OCTVM_CODECACHE_HPP 1
+
+#include "Common.hpp"
+#include "CoreMemory.hpp"
+#include "Functions.hpp"
+
+namespace Octane {
+
+    /// @brief The counters kept by a `CodeCache`
+    ////////////////////////////////////////
+    struct CodeCacheStats {
+        /// Entries into compiled code by an executor
+        u64 Hits          = 0;
+        /// `Function`s handed to the compiler tier
+        /// because there was no code to enter
+        u64 Misses        = 0;
+        /// `Function`s whose code was released
+        /// to make room for another's
+        u64 Evictions     = 0;
+        /// The executable memory currently held, in bytes
+        u64 BytesResident = 0;
+        /// The part of `BytesResident` holding cold code
+        u64 BytesCold     = 0;
+        /// The amount of held code regions
+        u32 Resident      = 0;
+    };
+
+    /// @brief Holds the executable memory of every `Function`
+    /// compiled under a VM. Held code is accounted against
+    /// the VM's `CoreAllocator` as system allocations, and
+    /// may be bounded further through `SetLimit`.
+    ///
+    /// All code is carved out of a single mapping, at
+    /// `CODE_ALIGNMENT`. It is sized from the limit set when
+    /// code is first compiled, up to `MAX_ARENA_SIZE`, and
+    /// does not grow if the limit is raised later. Hot code is
+    /// packed upwards from its start, while code the compiler
+    /// tiers split off as cold is packed downwards from its
+    /// end, so that the hot code of every `Function` shares
+    /// as few cache lines and pages as possible.
+    ///
+    /// Once either bound would be surpassed, the code of the
+    /// `Function` least recently entered is released, moving it
+    /// back into WARM to be compiled again once it is as hot
+    /// again, until the new code fits. Compiled code never calls
+    /// back into the interpreter other than by tail calling
+    /// `JITResume`, so no code can be released while it runs.
+    ///
+    /// A `CodeCache` is not synchronised. As the pages being
+    /// written are shared with other code, which stops being
+    /// executable meanwhile, compiling a `Function` and running
+    /// compiled code under the same VM must never overlap, so
+    /// only one thread may execute under a VM at a time.
+    ///
+    /// The VM must be destroyed before its `CoreAllocator`.
+    ////////////////////////////////////////
+    class CodeCache {
+        public:
+            /// The largest mapping all code is carved out of,
+            /// which keeps every jump between hot and cold
+            /// code within reach of a 32-bit displacement
+            static constexpr const u64 MAX_ARENA_SIZE = (u64)256 << 20;
+            /// The alignment of every piece of code, in bytes
+            static constexpr const u64 CODE_ALIGNMENT = 64;
+        private:
+            struct Region {
+                /// The entry point at the start of the hot code
+                ExposedFunc Code;
+                /// The size of the hot code in bytes
+                u64         Size;
+                /// The `Function` it was compiled for
+                Function*   Owner;
+                /// An allocation the code refers to, released
+                /// along with it. May be nullptr.
+                void*       Data;
+                /// The cold code split off, or nullptr
+                byte*       Cold;
+                /// The size of the cold code in bytes
+                u64         ColdSize;
+            };
+
+            /// A free range of the arena, relative to its start
+            struct Span {
+                u64 Offset;
+                u64 Size;
+            };
+
+            /// Every region is released through this Allocator
+            CoreAllocator* m_Allocator = nullptr;
+            Region*        m_Regions   = nullptr;
+            u32            m_Capacity  = 0;
+            /// The mapping all code is carved out of
+            byte*          m_Arena     = nullptr;
+            u64            m_ArenaSize = 0;
+            /// The free ranges of the arena, sorted by Offset
+            Span*          m_Free      = nullptr;
+            u32            m_FreeCount = 0;
+            u32            m_FreeCapacity = 0;
+            /// The most executable memory to hold, in bytes
+            u64            m_Limit     = 0;
+            CodeCacheStats m_Stats     = {};
+
+            bool  Grow(void) noexcept;
+            byte* Carve(u64 Size, bool Cold) noexcept;
+            void  Uncarve(byte* Code, u64 Size) noexcept;
+            void  ReleaseRegion(u32 IDX) noexcept;
+            bool  EvictColdest(ExecState& State, const Function& Keep) noexcept;
+        public:
+            ~CodeCache(void) noexcept;
+
+            /// @brief Bounds the executable memory held for
+            /// compiled code. Code already held beyond it is
+            /// only evicted once more has to be held.
+            /// @param Bytes The bound, or 0 to only be bounded
+            /// by the maximum of the `CoreAllocator` and by
+            /// `MAX_ARENA_SIZE`
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void SetLimit(u64 Bytes) noexcept
+                { m_Limit = Bytes; }
+
+            /// @return The bound on executable memory,
+            /// or 0 if there is none of its own.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            u64 GetLimit(void) const noexcept
+                { return m_Limit; }
+
+            /// @return The counters kept so far
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            const CodeCacheStats& GetStats(void) const noexcept
+                { return m_Stats; }
+
+            /// @brief Counts an entry into compiled code of Func,
+            /// marking it as the most recently used.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void CountHit(Function& Func) noexcept
+                { Func.MarkCodeUse(++m_Stats.Hits); }
+
+            /// @brief Counts a `Function` handed to the compiler
+            /// tier because there was no code to enter.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void CountMiss(void) noexcept
+                { m_Stats.Misses++; }
+
+            /// @brief Carves room for Size bytes of code compiled
+            /// for For out of the arena, evicting the code of other
+            /// `Function`s as needed, and accounts for it against
+            /// the `CoreAllocator`. The room is not yet writable.
+            /// @param Cold Whether the code is rarely run, and
+            /// belongs at the cold end of the arena
+            /// @return The room, or nullptr if it cannot fit even
+            /// once every other `Function` has been evicted, or
+            /// the platform cannot map executable memory.
+            ////////////////////////////////////////
+            byte* Reserve(ExecState& State, const Function& For,
+                          u64 Size, bool Cold = false) noexcept;
+
+            /// @brief Returns room made by `Reserve`
+            /// for code which was never inserted.
+            ////////////////////////////////////////
+            void Unreserve(byte* Code, u64 Size) noexcept;
+
+            /// @brief Takes over code written into room made by
+            /// `Reserve`, which is released along with Owner's code.
+            /// @param Owner The `Function` the code was compiled for
+            /// @param Code The entry point at the start of its hot code
+            /// @param Size The size of the hot code in bytes
+            /// @param Data An allocation from the `CoreAllocator`
+            /// which the code refers to, or nullptr
+            /// @param Cold The cold code split off, or nullptr
+            /// @param ColdSize The size of the cold code in bytes
+            ////////////////////////////////////////
+            void Insert(Function& Owner, ExposedFunc Code, u64 Size,
+                        void* Data, byte* Cold = nullptr,
+                        u64 ColdSize = 0) noexcept;
+
+            /// @brief Releases the region entered at Code, once
+            /// Owner no longer refers to it. Does nothing if nullptr.
+            ////////////////////////////////////////
+            void Release(Function& Owner, ExposedFunc Code) noexcept;
+
+            /// @brief Releases every region of Owner, once it no
+            /// longer refers to any of them. Neither counted as an
+            /// eviction, nor does it move Owner out of its tier.
+            ////////////////////////////////////////
+            void Release(Function& Owner) noexcept;
+    };
+
+}
+
+#endif /* !OCTVM_CODECACHE_HPP */
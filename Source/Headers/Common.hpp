@@ -270,6 +270,13 @@ namespace Octane {
     ////////////////////////////////////////
     extern bool QuickCmp    (const void* A, const void* B,
                              u32 ALen = 0) noexcept;
+
+    /// @brief Compares two null-terminated Strings,
+    /// including their terminators.
+    /// @return True if both Strings are equal,
+    /// otherwise false.
+    ////////////////////////////////////////
+    extern bool QuickStrCmp (const char* A, const char* B)           noexcept;
     
     /// @brief Copies N-Bytes from Src to Dest
     /// @param Src The Source Address
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_COMPRESSED_HPP
+#define OCTVM_COMPRESSED_HPP 1
+
+#include "Common.hpp"
+#include "CoreMemory.hpp"
+#include "Instructions.hpp"
+
+namespace Octane {
+
+    class Function;
+    class RelocationTable;
+
+    /// @brief The compressed code format, a stream of
+    /// 16-bit parcels in host byte order, just as a Code
+    /// Space is a stream of host order `Instruction` words.
+    ///
+    /// A parcel whose low byte is at least `COMPRESSED_TAG_BASE`
+    /// is a whole `Instruction` on its own: the low byte picks
+    /// one of the most frequent forms, such as `ret`, `inc r3`,
+    /// `mov r1, r2` or `add r4, r4, r5`, and the high byte holds
+    /// its operands. No `Instruction::Opcode` reaches that range,
+    /// so any other parcel is the low half of a plain word, whose
+    /// high half follows. Trailing immediate words are always
+    /// stored as two plain parcels, and words whose Opcode byte
+    /// does reach the range are escaped by `COMPRESSED_ESCAPE`.
+    ///
+    /// Every word expands back to exactly the word it was
+    /// compressed from, so jump targets, which index words,
+    /// need no fixing up, and any Code Space round-trips.
+    ////////////////////////////////////////
+    constexpr const u8 COMPRESSED_TAG_BASE = 0xC0;
+    /// The parcel preceding a plain word whose
+    /// Opcode byte reaches `COMPRESSED_TAG_BASE`
+    constexpr const u8 COMPRESSED_ESCAPE   = 0xFF;
+
+    static_assert(Instruction::COUNT_OF_INSTRUCTIONS <= COMPRESSED_TAG_BASE,
+                  "Opcodes must not collide with compressed forms");
+
+    /// @brief Returns the amount of parcels
+    /// `CompressCode` writes for a Code Space.
+    /// @param Code The Code Space to compress
+    /// @param Count The amount of words in Code
+    ////////////////////////////////////////
+    extern u32 GetCompressedSize(const Instruction* Code, u32 Count) noexcept;
+
+    /// @brief Compresses a Code Space into Out, which must hold
+    /// `GetCompressedSize` parcels.
+    /// @return The amount of parcels written.
+    ////////////////////////////////////////
+    extern u32 CompressCode(const Instruction* Code, u32 Count,
+                            u16* Out) noexcept;
+
+    /// @brief Returns the amount of words a compressed stream
+    /// expands into, or 0 if it ends in the middle of a word
+    /// or holds a tag which is not a compressed form.
+    ////////////////////////////////////////
+    extern u32 GetExpandedCount(const u16* Stream, u32 Parcels) noexcept;
+
+    /// @brief Expands a compressed stream into Out, which
+    /// must hold `GetExpandedCount` words.
+    /// @return The amount of words written.
+    ////////////////////////////////////////
+    extern u32 ExpandCode(const u16* Stream, u32 Parcels,
+                          Instruction* Out) noexcept;
+
+    /// @brief Initialises a VM `Function` from a compressed
+    /// stream, expanding it into the Code Space which
+    /// `Function::Init` allocates. The `Function` is then
+    /// verified, decoded and run just like any other.
+    /// @param Func The `Function` to initialise
+    /// @param Allocator The VM's `CoreAllocator`
+    /// @param Reloc As for `Function::Init`
+    /// @param Stream The parcels produced by `CompressCode`
+    /// @param Parcels The amount of parcels in Stream
+    /// @param SharedSize As for `Function::Init`
+    /// @return `MEMORY_OK` on success. `MEMORY_SIZE_IS_ZERO`
+    /// if the stream is empty or malformed (see `GetExpandedCount`),
+    /// `MEMORY_SIZE_TOO_LARGE` if it expands past the 0xFFFF
+    /// words of a Code Space. Otherwise the `MemoryError`
+    /// of `Function::Init`.
+    ////////////////////////////////////////
+    extern MemoryError LoadCompressedFunction(Function& Func,
+                                              CoreAllocator& Allocator,
+                                              RelocationTable* Reloc,
+                                              const u16* Stream,
+                                              u32 Parcels,
+                                              u16 SharedSize) noexcept;
+
+}
+
+#endif /* !OCTVM_COMPRESSED_HPP */
@@ -551,6 +551,23 @@ namespace Octane {
             OctVM_WarnDiscard
             MemoryError   Resize(MemoryAddress& Address, 
                    const AddressSizeSpecificer  NewSize)          noexcept;
+
+            ////////////////////////////////////////
+            /// @brief Counts Size bytes of memory mapped outside
+            /// of this Allocator, such as executable code, as
+            /// system allocations, so that it is held to the
+            /// same maximum as everything else the VM allocates.
+            /// @param Size The amount in bytes to account for
+            /// @return MEMORY_OK if it was accounted for, or
+            /// MEMORY_HIT_VM_MAXIMUM if it would surpass the maximum.
+            ////////////////////////////////////////
+            OctVM_WarnDiscard
+            MemoryError   RequestExternal(const u64 Size)         noexcept;
+
+            /// @brief Stops counting Size bytes previously
+            /// accounted for with RequestExternal().
+            ////////////////////////////////////////
+            void          ReleaseExternal(const u64 Size)         noexcept;
             
             /// @brief Returns the last error thrown
             /// by this Allocator. Note that this
@@ -169,7 +169,36 @@ namespace Octane {
     class StorageDevice {
         protected:
             SRError m_LastError;
+            /// Advanced every time a `Symbol` is assigned or
+            /// deleted. Never 0, so that 0 can mark an empty cache.
+            u32     m_Generation = 1;
         public:
+            /// @brief Invalidates every cache filled from this
+            /// `StorageDevice`. Implementations call this whenever a
+            /// `Symbol` is successfully assigned or deleted, and so
+            /// must anyone changing the Type or Value of a stored
+            /// `Symbol` in place.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void AdvanceGeneration(void) noexcept
+                { if ( ++m_Generation == 0 ) m_Generation = 1; }
+
+            /// @return The current generation of this `StorageDevice`.
+            /// A `Symbol` resolved at one generation is only known to
+            /// still be stored at its Key for as long as the
+            /// generation is unchanged.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            u32 GetGeneration(void) const noexcept
+                { return m_Generation; }
+
+            /// @return Where the generation is kept, for native
+            /// code comparing against it without a call.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            const u32* GetGenerationAddress(void) const noexcept
+                { return &m_Generation; }
+
             /// @return An `SRError` value denoting whether the assignment
             /// was successful, and if not, why it failed. Review the
             /// documentation for `SRError` for more information.
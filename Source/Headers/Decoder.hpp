@@ -0,0 +1,488 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_DECODER_HPP
+#define OCTVM_DECODER_HPP 1
+
+#include <cstring>
+#include "Common.hpp"
+#include "CoreMemory.hpp"
+#include "Instructions.hpp"
+
+namespace Octane {
+
+    class Function;
+    class StorageDevice;
+
+    /// @brief Pseudo-opcodes which only exist in
+    /// decoded form, numbered after the last
+    /// `Instruction::Opcode`.
+    ////////////////////////////////////////
+    enum DecodedOpcode : u8 {
+        /// Used for `DecodedInstruction`s which can only
+        /// ever raise an `Exception`, such as an unknown
+        /// opcode or an out of range register index.
+        /// The `Exception::ID` to raise is stored in `Imm`.
+        DECODED_FAULT = Instruction::COUNT_OF_INSTRUCTIONS,
+
+        /*** SUPERINSTRUCTIONS: ***/
+        /// A fused pair executes the `DecodedInstruction`
+        /// it replaces AND the one following it. The second
+        /// entry is left untouched, both to supply its own
+        /// operands and to remain a valid jump target.
+        FUSED_CMPLT_JMPNOT0,
+        FUSED_MOVIMM_ADD,
+        FUSED_INC_JMPLT,
+        FUSED_PUSHREG_POPREG,
+
+        /*** VERIFIED: ***/
+        /// Conditional jumps of verified `Function`s,
+        /// whose targets are known to be in range.
+        UNCHECKED_JMPIS0,
+        UNCHECKED_JMPNOT0,
+        UNCHECKED_JMPEQ,
+        UNCHECKED_JMPNEQ,
+        UNCHECKED_JMPLT,
+        UNCHECKED_JMPGT,
+        UNCHECKED_JMPLTEQ,
+        UNCHECKED_JMPGTEQ,
+        UNCHECKED_FUSED_CMPLT_JMPNOT0,
+        UNCHECKED_FUSED_INC_JMPLT,
+
+        /*** RESERVED: ***/
+        /// Stack and Local sites proven by `AnalyseFrameDemand`,
+        /// which never overflow or underflow once the
+        /// `Function`'s `FrameDemand` has been reserved.
+        /// `UNCHECKED_REQUESTLOCAL` holds the offset of its
+        /// allocation into the reserved Frame in `Aux`.
+        UNCHECKED_PUSHREG,
+        UNCHECKED_PUSHGEN,
+        UNCHECKED_PUSHALL,
+        UNCHECKED_PUSHMEM,
+        UNCHECKED_POPREG,
+        UNCHECKED_POPGEN,
+        UNCHECKED_POPALL,
+        UNCHECKED_POPMEM,
+        UNCHECKED_REQUESTLOCAL,
+        UNCHECKED_FUSED_PUSHREG_POPREG,
+        UNCHECKED_MASKED_PUSHALL,
+        UNCHECKED_MASKED_POPALL,
+
+        /*** REDUCED: ***/
+        /// Immediate divisions and remainders strength reduced
+        /// into a multiplication by a magic number. `Imm` holds
+        /// the `DivisionMagic::Magic`, `rZ` its `Shift`, and
+        /// `Aux` the divisor. None of them can raise.
+        REDUCED_DIVIMM,
+        REDUCED_MODIMM,
+        REDUCED_IDIVIMM,
+        REDUCED_IMODIMM,
+
+        /*** MASKED: ***/
+        /// `pushall`s and `popall`s which still move the Stack
+        /// by the whole register file, but only save or restore
+        /// the registers in the `RegMask` held by `Imm`. Slots
+        /// of the other registers are left as they were.
+        MASKED_PUSHALL,
+        MASKED_POPALL,
+
+        /*** STACKTOP: ***/
+        /// `pushreg`/`popreg` pairs found by `CacheStackTop`,
+        /// keeping their value in slot 0 or 1 of the executor
+        /// instead of the Stack. `Aux` of a push holds the Stack
+        /// room its pair relies on, without which it pushes as
+        /// usual. A pop whose slot is not live pops as usual.
+        TOP_PUSHREG0,
+        TOP_PUSHREG1,
+        TOP_POPREG0,
+        TOP_POPREG1,
+
+        /*** CACHED: ***/
+        /// `call` sites which have been filled with their resolved
+        /// callee at runtime. `Imm` holds the `Function*` of a
+        /// VM callee, compiled or not, or the `ExposedFunc` of a
+        /// native one, and `Aux` the `RelocationTable` generation
+        /// it was resolved at. Never produced by `DecodeFunction`
+        /// itself.
+        CACHED_CALL_VM,
+        CACHED_CALL_C,
+        CACHED_CALL_JIT,
+        /// A `CACHED_CALL_VM` site directly followed by `ret`.
+        /// The callee is entered in the caller's own Local
+        /// Frame, and returns straight to the caller's caller.
+        CACHED_TAIL_CALL_VM,
+
+        /*** BOUNDED: ***/
+        /// `pload`/`psave` sites inside of a loop whose bounds
+        /// `AnalyseBoundsChecks` proves once, before the loop is
+        /// entered. They only ever appear in the copy whose
+        /// loops are guarded, and access memory unchecked.
+        UNCHECKED_PLOAD8,
+        UNCHECKED_PLOAD16,
+        UNCHECKED_PLOAD32,
+        UNCHECKED_PLOAD64,
+        UNCHECKED_PSAVE8,
+        UNCHECKED_PSAVE16,
+        UNCHECKED_PSAVE32,
+        UNCHECKED_PSAVE64,
+        /// Takes the place of the `Instruction` before a guarded
+        /// loop, and moves on to index `Imm` past the Code Space,
+        /// which holds a copy of that `Instruction` followed
+        /// by its `GUARD_BOUNDS`.
+        GUARDED_ENTRY,
+        /// Enters the loop header at index `Aux` if the
+        /// `BoundsGuard::Checks` held by `Imm` pass. Otherwise
+        /// the header is entered in the checked form instead.
+        GUARD_BOUNDS,
+
+        /*** LOCALISED: ***/
+        /// `requestbytes`/`releasebytes` pairs whose allocation
+        /// `AnalyseEscapes` proves never escapes the `Function`.
+        /// Requests of up to `LOCALISED_MAX_SIZE` bytes are served
+        /// by the Local Frame where it has room, and any other by
+        /// the heap just as before. Releases tell the two apart
+        /// by the `IsLiAlloc` flag of the `AllocationHeader`.
+        LOCALISED_REQUESTBYTES,
+        LOCALISED_RELEASEBYTES,
+
+        /*** METADATA: ***/
+        COUNT_OF_DECODED
+    };
+
+    /// @brief The amount of handlers an executor must
+    /// supply to `DecodeFunction`, including pseudo-opcodes.
+    ////////////////////////////////////////
+    constexpr const u16 DECODED_HANDLER_COUNT = COUNT_OF_DECODED;
+
+    /// @brief The amount of Stack slots an executor
+    /// caches through the `TOP_` pseudo-opcodes
+    ////////////////////////////////////////
+    constexpr const u32 TOP_SLOT_COUNT = 2;
+
+    /// @brief The most bytes a `LOCALISED_REQUESTBYTES` takes
+    /// from the Local Frame. Larger scratch buffers stay on the
+    /// heap, leaving the Local Space to `requestlocal` and calls.
+    ////////////////////////////////////////
+    constexpr const u32 LOCALISED_MAX_SIZE = 0x400;
+
+    /// @brief The amount of `ret` entries appended after a
+    /// decoded Code Space. Mirroring the `ret` padding of
+    /// the Code Space, these catch executors running off
+    /// the end, even from the last word of a triple-width
+    /// `Instruction`.
+    ////////////////////////////////////////
+    constexpr const u8 DECODED_TAIL_COUNT = 3;
+
+    /// @brief A wider form of an `Instruction` with every
+    /// operand already unpacked, built once per `Function`
+    /// so that executors never need to decode the packed
+    /// 32-bit encoding at runtime.
+    ///
+    /// A Code Space of N `Instruction`s decodes into exactly
+    /// N `DecodedInstruction`s (followed by `DECODED_TAIL_COUNT`
+    /// `ret`s), so that indices (and as such jump targets)
+    /// are shared between both forms. The
+    /// trailing immediate words of multi-word `Instruction`s
+    /// are decoded as if they were `Instruction`s themselves.
+    ////////////////////////////////////////
+    struct DecodedInstruction {
+        /// The address of the executor's handler for `Op`,
+        /// or nullptr if the executor does not dispatch
+        /// through handler addresses.
+        const void* Handler;
+        /// The unpacked immediate, if applicable:
+        ///   - Absolute jump targets for control flow
+        ///   - The full value of `movimm*` instructions,
+        ///     including `movimmf`, whose upper 32 bits are 0
+        ///   - Sign extended immediates for `idivimm`/`imodimm`
+        ///   - The pre-inverted immediate of `bnotimm`
+        ///   - The `GlobalCache*` of `gload`/`gsave`
+        ///   - The log2 stride of `pload`/`psave`
+        ///   - The `Exception::ID` of a `DECODED_FAULT`
+        ///   - The resolved callee of a `CACHED_CALL_*`
+        ///   - The `BoundsGuard::Checks` of a `GUARD_BOUNDS`
+        u64         Imm;
+        /// Either an `Instruction::Opcode` or a `DecodedOpcode`
+        u8          Op;
+        /// Register indices, each guaranteed to be
+        /// less than `VPCore::Register::COUNT` if used.
+        /// For `pload`/`psave`, rZ is the index register,
+        /// and for `REDUCED_` divisions the shift.
+        u8          rX, rY, rZ;
+        /// Per-site state the executor fills in at runtime,
+        /// such as the `StorageDevice` generation of an inline
+        /// cache, or the `BranchProfile` of a conditional jump.
+        /// Always 0 when decoded. `REDUCED_` divisions
+        /// keep their divisor here instead.
+        u32         Aux;
+    };
+
+    /// @brief How often a conditional jump was taken, and how
+    /// often it fell through, while it ran in a checked form.
+    /// Collected by the COLD tier for the compiler tiers.
+    ////////////////////////////////////////
+    struct BranchProfile {
+        u16 Taken;
+        u16 NotTaken;
+    };
+
+    /// @brief Counts a run of the conditional jump D into its
+    /// `Aux`, which holds the taken count in its upper half.
+    /// Both counts are halved once either reaches 2^15,
+    /// so that they keep their ratio.
+    ////////////////////////////////////////
+    OctVM_SternInline
+    void CountBranch(DecodedInstruction& D, bool Taken) noexcept
+    {
+        u32 Aux = D.Aux + ( Taken ? 0x10000u : 1u );
+        if ( Aux & 0x80008000u )
+            Aux = ( Aux >> 1 ) & 0x7FFF7FFFu;
+        D.Aux = Aux;
+    }
+
+    /// @return The counts `CountBranch` kept for the
+    /// conditional jump D
+    ////////////////////////////////////////
+    OctVM_SternInline
+    BranchProfile GetBranchProfile(const DecodedInstruction& D) noexcept
+        { return { (u16)( D.Aux >> 16 ), (u16)D.Aux }; }
+
+    /// @brief The longest key, including its terminator,
+    /// a `GlobalCache` keeps a copy of. Longer keys are
+    /// looked up on every access.
+    ////////////////////////////////////////
+    constexpr u32 GLOBAL_CACHE_KEY_SIZE = 32;
+
+    /// @brief The inline cache of a `gload`/`gsave` site,
+    /// whose `DecodedInstruction` points to it through `Imm`.
+    /// Filled by the executor the first time the site runs.
+    ////////////////////////////////////////
+    struct GlobalCache {
+        /// The key pointer the `Symbol` was resolved from
+        const void* Key;
+        /// The resolved `Symbol::Value`
+        byte*       Value;
+        /// The `StorageDevice` generation `Value` was
+        /// resolved at, or 0 if the cache is empty
+        u32         Generation;
+        /// The Scale of the `gload`/`gsave`
+        u32         Scale;
+        /// The length of KeyCopy, including its terminator
+        u32         KeyLength;
+        /// The contents of Key when it was resolved, as the
+        /// memory behind a key may be reused for another one
+        char        KeyCopy[GLOBAL_CACHE_KEY_SIZE];
+    };
+
+    /// @return True if Cache still holds the `Symbol` Key
+    /// names at the given `StorageDevice` generation
+    ////////////////////////////////////////
+    OctVM_SternInline
+    bool HitsGlobalCache(const GlobalCache& Cache, const void* Key,
+                         u32 Generation) noexcept
+    {
+        if ( Cache.Key != Key || Cache.Generation != Generation )
+            return false;
+        // Key held KeyLength bytes when the cache was filled,
+        // so it is compared a word at a time up to that length
+        const byte* Bytes = (const byte*)Key;
+        u32 i = 0;
+        for ( ; i + sizeof(u64) <= Cache.KeyLength; i += sizeof(u64) ) {
+            u64 Actual, Expected;
+            std::memcpy(&Actual, Bytes + i, sizeof(u64));
+            std::memcpy(&Expected, Cache.KeyCopy + i, sizeof(u64));
+            if ( Actual != Expected )
+                return false;
+        }
+        for ( ; i < Cache.KeyLength; i++ )
+            if ( Bytes[i] != (byte)Cache.KeyCopy[i] )
+                return false;
+        return true;
+    }
+
+    /// @brief The multiplier and shift which replace a
+    /// division by a constant divisor.
+    ////////////////////////////////////////
+    struct DivisionMagic {
+        u64 Magic;
+        /// The shift, along with one of the fixups below
+        u8  Shift;
+    };
+
+    enum : u8 {
+        REDUCED_SHIFT_MASK = 0x3F,
+        /// The dividend is added to the high product, which
+        /// stands for a magic number of 65 bits when unsigned
+        REDUCED_ADD        = 0x40,
+        /// The dividend is subtracted from the high product
+        REDUCED_SUB        = 0x80,
+    };
+
+    /// @brief Computes the magic number of an unsigned division,
+    /// as applied by `ApplyUnsignedMagic`.
+    /// @param Divisor Any divisor which is not a power of two
+    ////////////////////////////////////////
+    extern DivisionMagic GetUnsignedMagic(u64 Divisor) noexcept;
+
+    /// @brief Computes the magic number of a signed division,
+    /// rounding towards 0, as applied by `ApplySignedMagic`.
+    /// @param Divisor Any divisor whose magnitude is at
+    /// least 2 and less than 2^63
+    ////////////////////////////////////////
+    extern DivisionMagic GetSignedMagic(i64 Divisor) noexcept;
+
+    /// @brief Returns the upper 64 bits of A * B
+    ////////////////////////////////////////
+    OctVM_SternInline
+    u64 MulHigh(u64 A, u64 B) noexcept
+    {
+    #if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 u128;
+        return (u64)( ( (u128)A * B ) >> 64 );
+    #else
+        u64 Low   = ( A & UINT32_MAX ) * ( B & UINT32_MAX );
+        u64 Mid1  = ( A >> 32 ) * ( B & UINT32_MAX ) + ( Low >> 32 );
+        u64 Mid2  = ( A & UINT32_MAX ) * ( B >> 32 ) + ( Mid1 & UINT32_MAX );
+        return ( A >> 32 ) * ( B >> 32 ) + ( Mid1 >> 32 ) + ( Mid2 >> 32 );
+    #endif
+    }
+
+    /// @return X / Divisor, given the `GetUnsignedMagic` of Divisor
+    ////////////////////////////////////////
+    OctVM_SternInline
+    u64 ApplyUnsignedMagic(u64 X, u64 Magic, u8 Shift) noexcept
+    {
+        u64 High = MulHigh(X, Magic);
+        if ( Shift & REDUCED_ADD )
+            High += ( X - High ) >> 1;
+        return High >> ( Shift & REDUCED_SHIFT_MASK );
+    }
+
+    /// @return X / Divisor, given the `GetSignedMagic` of Divisor
+    ////////////////////////////////////////
+    OctVM_SternInline
+    i64 ApplySignedMagic(i64 X, u64 Magic, u8 Shift) noexcept
+    {
+        // The signed high product, from the unsigned one
+        u64 High = MulHigh((u64)X, Magic)
+                 - ( X < 0 ? Magic : 0 )
+                 - ( (i64)Magic < 0 ? (u64)X : 0 );
+        if ( Shift & REDUCED_ADD )
+            High += (u64)X;
+        else if ( Shift & REDUCED_SUB )
+            High -= (u64)X;
+        i64 Quotient = (i64)High >> ( Shift & REDUCED_SHIFT_MASK );
+        return Quotient + (i64)( (u64)Quotient >> 63 );
+    }
+
+    /// @brief Returns the immediate divisor of a `divimm`,
+    /// `modimm`, `idivimm` or `imodimm`, whether or not it
+    /// has been strength reduced.
+    ////////////////////////////////////////
+    OctVM_SternInline
+    u64 GetImmediateDivisor(const DecodedInstruction& D) noexcept
+    {
+        if ( D.Op >= REDUCED_DIVIMM && D.Op <= REDUCED_IMODIMM )
+            return (u64)(i64)(i32)D.Aux;
+        return D.Imm;
+    }
+
+    /// @brief Looks up the DATA `Symbol` at Key and
+    /// caches its Value for a `gload`/`gsave` site.
+    /// Keys too long to copy leave the cache empty,
+    /// though Value is still filled.
+    /// @return False if there is no such `Symbol`.
+    ////////////////////////////////////////
+    extern bool FillGlobalCache(GlobalCache& Cache, StorageDevice& Storage,
+                                const void* Key) noexcept;
+
+    /// @brief Decodes the Code Space of a VM `Function`
+    /// into its plain COLD form, and caches the result inside
+    /// of the `Function`. Every register index is validated
+    /// here, and any `Instruction` which can only ever raise
+    /// an `Exception` is decoded into a `DECODED_FAULT`.
+    /// Every `gload`/`gsave` site is given an empty `GlobalCache`.
+    ///
+    /// Note that the Code Space must not be modified after
+    /// the `Function` has been decoded.
+    /// @param Func The `Function` to decode
+    /// @param Allocator The VM's `CoreAllocator`
+    /// @param Handlers An array of `DECODED_HANDLER_COUNT`
+    /// handler addresses indexed by `DecodedInstruction::Op`,
+    /// or nullptr.
+    /// @return On success, returns `MEMORY_OK`.
+    /// Otherwise returns an `Octane::MemoryError` denoting why the
+    /// Allocator failed to request sufficient memory.
+    ////////////////////////////////////////
+    extern MemoryError DecodeFunction(Function& Func,
+                                      CoreAllocator& Allocator,
+                                      const void* const* Handlers) noexcept;
+
+    /// @brief Maps a `DecodedInstruction::Op` back onto the
+    /// `Instruction::Opcode` it executes. Fused pairs map onto
+    /// their first `Instruction`, whose partner is still
+    /// decoded in the following entry.
+    /// @return The original Opcode, or `DECODED_FAULT`.
+    ////////////////////////////////////////
+    extern u8 GetBaseOpcode(u8 Op) noexcept;
+
+    /// @brief Optimises the decoded form of a `Function`
+    /// for the WARM tier. Multiplications, divisions and
+    /// remainders by an immediate are strength reduced into
+    /// shifts, masks or `REDUCED_` multiplications, except
+    /// for divisors which raise, or define INT64_MIN / -1.
+    /// Common pairs of `Instruction`s are
+    /// fused into superinstructions and, if the `Function`
+    /// has passed `VerifyFunction`, conditional jumps are
+    /// turned into `UNCHECKED_` variants, and `pushall`s
+    /// and `popall`s into `MASKED_` ones saving only the
+    /// registers `AnalyseLiveness` finds live. Values pushed
+    /// and popped again within straight-line code are kept
+    /// out of the Stack through the `TOP_` pseudo-opcodes,
+    /// and scratch buffers which never escape the `Function`
+    /// are taken from its Local Frame through the `LOCALISED_`
+    /// ones. All of this happens in place,
+    /// as every rewritten entry stays equivalent to the original.
+    /// Stack and Local sites proven by `AnalyseFrameDemand`,
+    /// and `pload`/`psave` sites proven by `AnalyseBoundsChecks`,
+    /// are rewritten in a copy, which becomes the `Function`'s
+    /// decoded form, while the current one is kept as its
+    /// checked copy for entries where the `FrameDemand` is
+    /// not available, and for loops whose guard fails.
+    ///
+    /// Must be called at most once after `DecodeFunction`.
+    /// @param Func The decoded `Function` to optimise
+    /// @param Allocator The VM's `CoreAllocator`
+    /// @param Handlers The handler table given to `DecodeFunction`
+    /// @return `MEMORY_OK` on success. Otherwise the `MemoryError`
+    /// of the failed allocation, in which case the `Function`
+    /// remains fully executable in its in-place optimised form.
+    ////////////////////////////////////////
+    extern MemoryError OptimiseFunction(Function& Func,
+                                        CoreAllocator& Allocator,
+                                        const void* const* Handlers) noexcept;
+
+}
+
+#endif /* !OCTVM_DECODER_HPP */
@@ -64,6 +64,13 @@ namespace Octane {
 
                 HeapOutOfMemory,
                 LocalOutOfMemory,
+
+                InvalidOpcode,
+                SharedAccessOverflow,
+                PrivateAccessOverflow,
+                InvalidSymbol,
+                UnsupportedInstruction,
+                InvalidJumpTarget,
             };
 
             /// @brief An explicit enumeration
@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_EXECUTOR_HPP
+#define OCTVM_EXECUTOR_HPP 1
+
+#include "Common.hpp"
+#include "VPCore.hpp"
+#include "Exceptions.hpp"
+
+// If the compiler does not support GNU labels-as-values
+#ifndef OCTVM_NO_COMPUTED_GOTO
+    #if defined(__GNUC__) || defined(__clang__)
+        /// Direct-threaded dispatch is available. Each handler
+        /// jumps straight to the next handler through a table
+        /// of label addresses instead of returning to a switch.
+        #define OCTVM_COMPUTED_GOTO 1
+    #endif
+#endif /* !OCTVM_NO_COMPUTED_GOTO */
+
+namespace Octane {
+
+    /// @brief The strategy an executor uses to
+    /// move from one `Instruction` handler to
+    /// the next.
+    ////////////////////////////////////////
+    enum class DispatchMode : u8 {
+        /// Computed-goto dispatch. Every handler ends with
+        /// its own indirect jump to the next handler.
+        /// Falls back to `SWITCH` if the compiler does not
+        /// support labels-as-values.
+        THREADED,
+        /// A portable `switch` inside a loop. Kept as the
+        /// reference implementation and for comparison.
+        SWITCH,
+    };
+
+    /// @brief Executes `State.CurrentFunc` from `State.IP`
+    /// (or from the start of its Code Space if `State.IP`
+    /// is null) until it returns, using the `DispatchMode`
+    /// configured on `State.VMInstance`.
+    ///
+    /// Entering at the start of a `Function` reserves its
+    /// `FrameDemand` once, after which its proven Stack and
+    /// Local sites run unchecked. `Exception` handlers must
+    /// therefore leave the Stack and Local Space as they
+    /// found them when resuming execution.
+    ///
+    /// `call`, `gload` and `gsave` sites cache the `Symbol`s
+    /// they resolve until `State.Storage` advances its
+    /// generation. `gload`/`gsave` keys are matched by address
+    /// and contents, so the memory of a key may be reused to
+    /// name a different `Symbol`.
+    ///
+    /// `spawn`, `spawnanon`, `merge`, `muop` and `cvop` always
+    /// raise `UnsupportedInstruction`, as `VPCore` has no
+    /// scheduler to run them on.
+    /// @param State The state to execute. The caller must
+    /// supply a valid `ThreadMemory` with room for at least
+    /// one Local Frame.
+    /// @return `NO_EXCEPTION` if the `Function` returned
+    /// normally, or `FATAL` if an `Exception` halted
+    /// execution. On `FATAL`, every Local Frame created
+    /// during execution has been dropped.
+    ////////////////////////////////////////
+    extern Exception::HandlerResult Execute        (ExecState& State) noexcept;
+
+    /// @brief Same as `Execute`, but always uses
+    /// `DispatchMode::THREADED`.
+    ////////////////////////////////////////
+    extern Exception::HandlerResult ExecuteThreaded(ExecState& State) noexcept;
+
+    /// @brief Same as `Execute`, but always uses
+    /// `DispatchMode::SWITCH`.
+    ////////////////////////////////////////
+    extern Exception::HandlerResult ExecuteSwitch  (ExecState& State) noexcept;
+
+}
+
+#endif /* !OCTVM_EXECUTOR_HPP */
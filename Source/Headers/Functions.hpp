@@ -29,6 +29,8 @@
 #include "CoreStorage.hpp"
 #include "VPCore.hpp"
 #include "Exceptions.hpp"
+#include "Decoder.hpp"
+#include "Analysis.hpp"
 
 //////////////// NOTE: /////////////////
 /// @markredmann :
@@ -44,6 +46,38 @@
 
 namespace Octane {
 
+/// CALLINGCONVENTION:
+////////////////////////////////////////
+
+    /// @brief How the arguments and return value of a `Function`
+    /// travel across `call` and `ret`. By default, every argument
+    /// is pushed with `pusharg` and popped with `poparg`, and so
+    /// is the return value. Arguments and a return value kept in
+    /// registers skip both copies through the Stack.
+    ///
+    /// Each `Function` declares the convention it is called with,
+    /// and each `RelocationTable` entry the convention its callers
+    /// expect. A `call` site is only linked to its callee if both
+    /// agree, and otherwise raises `InvalidSymbol`.
+    ////////////////////////////////////////
+    struct CallingConvention {
+        /// The amount of leading arguments passed in r0 onward.
+        /// Any further arguments are passed on the Stack.
+        u8   RegisterArgs   = 0;
+        /// If set, the return value is left in r0 by `ret`,
+        /// rather than pushed onto the Stack.
+        bool RegisterResult = false;
+
+        constexpr OctVM_SternInline
+        bool operator==(const CallingConvention& Other) const noexcept
+            { return ( RegisterArgs   == Other.RegisterArgs
+                    && RegisterResult == Other.RegisterResult ); }
+
+        constexpr OctVM_SternInline
+        bool operator!=(const CallingConvention& Other) const noexcept
+            { return !( *this == Other ); }
+    };
+
 /// RELOCTABLE:
 ////////////////////////////////////////
 
@@ -61,6 +95,12 @@ namespace Octane {
                 Symbol*     ResolvedSymbol = nullptr;
                 /// The key used to perform the lookup at runtime
                 const char* Key            = nullptr;
+                /// The generation of `m_Storage` at which
+                /// `ResolvedSymbol` was looked up
+                u32         Generation     = 0;
+                /// The convention callers through this entry
+                /// expect of the `Function` it resolves to
+                CallingConvention Convention = {};
             };
 
             /// The `StorageDevice` to perform runtime lookups
@@ -98,6 +138,15 @@ namespace Octane {
             ////////////////////////////////////////
             void AssignDevice(StorageDevice* Device) noexcept
                 { m_Storage = Device; }
+
+            /// @return The current generation of the internal
+            /// `StorageDevice`, which must have been assigned.
+            /// Anything resolved through this table is only
+            /// valid for as long as this value is unchanged.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            u32 GetGeneration(void) const noexcept
+                { return m_Storage->GetGeneration(); }
             
             /// @brief Assigns an index in the internal table to
             /// a `Symbol` key that will be resolved upon retrieval
@@ -107,11 +156,14 @@ namespace Octane {
             /// @param Resolve Should the `Symbol` be resolved immediately?
             /// If false, the lookup will occur when the key is first
             /// retrieved
+            /// @param Convention The `CallingConvention` that `call`s
+            /// through this index expect of the `Function` it resolves to
             /// @return Returns true if the index does not correspond
             /// to an already existing entry. Otherwise false
             ////////////////////////////////////////
             bool        AssignIDX(u32 IDX, const char* Key,
-                                  bool Resolve = false)     noexcept;
+                                  bool Resolve = false,
+                                  CallingConvention Convention = {}) noexcept;
             /// @brief Retrieves a `Symbol` from a static index
             /// @param IDX The index into the internal table to
             /// perform a one-time `Symbol` lookup
@@ -119,7 +171,9 @@ namespace Octane {
             /// that correctly points to a `Symbol` in the stored
             /// `StorageDevice`, a one-time lookup is performed
             /// and the `Symbol` is returned. Further calls will
-            /// immediately return the resolved `Symbol` at no cost.
+            /// immediately return the resolved `Symbol` at no cost,
+            /// until a `Symbol` is assigned to or deleted from
+            /// the `StorageDevice`, after which it is looked up again.
             ///
             /// If the index is invalid or contains a malformed or
             /// incorrect key, a nullptr is returned
@@ -132,11 +186,28 @@ namespace Octane {
             /// stored key. Otherwise returns nullptr.
             ////////////////////////////////////////
             const char* RetrieveIDXKey(u32 IDX)             noexcept;
+            /// @brief Retrieves the `CallingConvention` expected of
+            /// the `Function` stored at the given index
+            /// @param IDX The index into the internal table
+            /// @return The convention assigned with the index,
+            /// or the default convention if the index is invalid.
+            ////////////////////////////////////////
+            CallingConvention RetrieveIDXConvention(u32 IDX) const noexcept;
+            /// @brief Retrieves the `Symbol` an index is bound to,
+            /// without performing a lookup
+            /// @param IDX The index into the internal table
+            /// @return The `Symbol` the index was resolved to, or
+            /// nullptr if the index is invalid, or has not been
+            /// resolved since a `Symbol` was last assigned or deleted.
+            ////////////////////////////////////////
+            Symbol*     RetrieveIDXBound(u32 IDX)     const noexcept;
     };
 
 /// FUNCTION:
 ////////////////////////////////////////
 
+    class CodeCache;
+
     /// @brief A function pointer to a native
     /// C++ function that can be passed to a 
     /// VM `Function` instance to be executed
@@ -144,6 +215,34 @@ namespace Octane {
     ////////////////////////////////////////
     using ExposedFunc = Exception::HandlerResult(*)(ExecState&);
 
+    /// @brief Where an `Instruction` inlined from
+    /// another `Function` came from. See `InlineModule`.
+    ////////////////////////////////////////
+    struct InlineOrigin {
+        /// The `Function` the `Instruction` was copied
+        /// from, or nullptr if it was not inlined
+        Function* Callee;
+        /// Its index in the Code Space of `Callee`,
+        /// as it was when inlined
+        u16       Index;
+    };
+
+    /// @brief The execution tiers a VM `Function`
+    /// moves through as it gets hotter. See `TierPolicy`.
+    ////////////////////////////////////////
+    enum class FunctionTier : u8 {
+        /// Runs its plain decoded form, in which every
+        /// `Instruction` keeps all of its runtime checks.
+        COLD,
+        /// Runs its optimised decoded form, with
+        /// superinstructions and, if verified, check-free
+        /// jumps and proven Stack and Local sites.
+        WARM,
+        /// Runs the native entry point produced
+        /// by the VM's compiler tier.
+        HOT,
+    };
+
     /// @brief An encapsulation of an executable
     /// routine that can be evaluated by the VM
     ////////////////////////////////////////
@@ -161,7 +260,7 @@ namespace Octane {
             /// 
             /// The internal structure of the raw bytes:
             /// [CODE ... ...][PADDING][SHARED ... ...]
-            u8   m_SharedPadding    = 0;
+            u32  m_SharedPadding    = 0;
             /// The offset in bytes to where the Shared
             /// address space begins from the start of the raw
             /// aggregate byte array.
@@ -173,11 +272,69 @@ namespace Octane {
             /// If true, this Function has not been ran by the VM yet,
             /// and *should* be tested and validated prior to execution.
             bool m_FirstRun         = true;
+            /// If true, `VerifyFunction` has proven that this
+            /// Function cannot raise any STATIC `Exception`s,
+            /// and it may be executed without runtime checks.
+            bool m_Verified         = false;
+            /// The tier this Function currently executes in
+            FunctionTier m_Tier     = FunctionTier::COLD;
+            /// How this Function is called. See `CallingConvention`.
+            CallingConvention m_Convention = {};
+            /// If true, a `call` site has been linked to this
+            /// Function, fixing its `CallingConvention`
+            bool m_Linked           = false;
             
             /// A pointer to the `RelocationTable` to lookup all
             /// encoded relocatable indicies stored in `call`,
             /// `spawn`, `spawnanon`, and `eload` instructions.
             RelocationTable* m_RelocTable = nullptr;
+            /// The pre-decoded form of the Code Space, built
+            /// by `DecodeFunction` the first time this
+            /// Function is executed, and replaced by its
+            /// optimised form once it turns WARM.
+            DecodedInstruction* m_Decoded = nullptr;
+            /// A copy of `m_Decoded` in which every Stack and
+            /// Local site keeps its runtime checks. Only built
+            /// if `m_Decoded` contains sites proven against
+            /// `m_Demand`, and used whenever that demand is
+            /// not available on entry.
+            DecodedInstruction* m_DecodedChecked = nullptr;
+            /// The Stack and Local Space that must be available
+            /// on entry for `m_Decoded` to run without checks
+            FrameDemand         m_Demand         = {};
+            /// The inline caches of every `gload`/`gsave` site,
+            /// shared by both decoded forms
+            GlobalCache*        m_GlobalCaches   = nullptr;
+            /// One entry per `Instruction`, recording the callee
+            /// of every `Instruction` inlined by `InlineModule`.
+            /// nullptr if nothing has been inlined.
+            InlineOrigin*       m_InlineOrigins  = nullptr;
+            /// The amount of times this Function has been entered
+            u64         m_Invocations = 0;
+            /// The amount of invocations and taken backward jumps
+            /// counted before `m_TierBudget` was last reset
+            u64         m_TierEvents  = 0;
+            /// Counted down by every invocation and taken backward
+            /// jump. Once it reaches 0, the executor considers
+            /// moving this Function up a tier.
+            u32         m_TierBudget  = 0;
+            /// The value `m_TierBudget` was last reset to
+            u32         m_TierTarget  = 0;
+            /// The native entry point of a HOT Function
+            ExposedFunc m_Compiled    = nullptr;
+            /// The native entry point at `m_OSRIndex`, which
+            /// activations still inside its loop move into
+            ExposedFunc m_OSREntry    = nullptr;
+            u32         m_OSRIndex    = 0;
+            /// The amount of times compiled code of this Function
+            /// has been discarded because a speculation failed
+            u32         m_DeoptCount  = 0;
+            /// When compiled code of this Function was last
+            /// entered, as counted by `m_CodeCache`
+            u64         m_CodeUse     = 0;
+            /// The `CodeCache` holding the compiled code of
+            /// this Function, or nullptr if it has none
+            CodeCache*  m_CodeCache   = nullptr;
             union {
                 /// If `m_IsVMFunc` is true, this is set to an
                 /// aggregate byte array containing both bytecode
@@ -301,6 +458,228 @@ namespace Octane {
             void MarkUsed(void) noexcept
                 { m_FirstRun = false; }
 
+            constexpr OctVM_SternInline
+            /// @brief Returns true if this Function
+            /// has passed static verification.
+            ////////////////////////////////////////
+            bool IsVerified(void) const noexcept
+                { return m_Verified; }
+
+            OctVM_SternInline
+            /// @brief Denotes that this Function has
+            /// passed static verification.
+            ////////////////////////////////////////
+            void MarkVerified(void) noexcept
+                { m_Verified = true; }
+
+            /// @return The `CallingConvention` this Function
+            /// is called with
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            const CallingConvention& GetCallingConvention(void) const noexcept
+                { return m_Convention; }
+
+            /// @brief Declares how this Function is called. Reset
+            /// to the default convention by `Init` and `InitExposed`,
+            /// and must be declared before any `call` site is linked
+            /// to this Function, as linked sites no longer check it.
+            /// @return False if Convention passes more arguments
+            /// than there are registers, or a `call` site has
+            /// already been linked to this Function, otherwise true.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            bool SetCallingConvention(CallingConvention Convention) noexcept
+                {
+                    if ( Convention.RegisterArgs > VPCore::Register::COUNT
+                         || m_Linked )
+                        return false;
+                    m_Convention = Convention;
+                    return true;
+                }
+
+            /// @return True if a `call` site has been linked
+            /// to this Function
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            bool IsLinked(void) const noexcept
+                { return m_Linked; }
+
+            /// @brief Denotes that a `call` site has been linked
+            /// to this Function, after agreeing with its
+            /// `CallingConvention`
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void MarkLinked(void) noexcept
+                { m_Linked = true; }
+
+        /// TIERING:
+        ////////////////////////////////////////
+
+            /// @return The tier this Function currently executes in
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            FunctionTier GetTier(void) const noexcept
+                { return m_Tier; }
+
+            /// @return The amount of times this Function
+            /// has been entered by an executor
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            u64 GetInvocationCount(void) const noexcept
+                { return m_Invocations; }
+
+            /// @return The amount of backward jumps this Function
+            /// has taken while COLD or WARM, as of the last time
+            /// an executor running it stored its tier budget
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            u64 GetBackEdgeCount(void) const noexcept
+                {
+                    return m_TierEvents + ( m_TierTarget - m_TierBudget )
+                         - m_Invocations;
+                }
+
+            /// @return The native entry point produced by the
+            /// VM's compiler tier, or nullptr if not HOT.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            ExposedFunc GetCompiled(void) const noexcept
+                { return m_Compiled; }
+
+            /// @return The native entry point compiled to start at
+            /// the `Instruction` at IDX, or nullptr if there is none.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            ExposedFunc GetOSREntry(u32 IDX) const noexcept
+                { return ( m_OSRIndex == IDX ? m_OSREntry : nullptr ); }
+
+            /// @return The amount of times this Function has
+            /// been moved out of the HOT tier by `Deoptimize`
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            u32 GetDeoptCount(void) const noexcept
+                { return m_DeoptCount; }
+
+            /// @brief Counts one entry into this Function.
+            /// @return True once the tier budget runs out.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            bool CountInvocation(void) noexcept
+                { m_Invocations++; return ( --m_TierBudget == 0 ); }
+
+            /// @return The invocations and backward jumps left to
+            /// count before the executor reconsiders the tier.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            u32 GetTierBudget(void) const noexcept
+                { return m_TierBudget; }
+
+            /// @brief Stores a tier budget counted down elsewhere.
+            /// Executors count backward jumps in a local copy of the
+            /// budget, which `GetBackEdgeCount` then derives its count
+            /// from once stored back.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void StoreTierBudget(u32 Budget) noexcept
+                { m_TierBudget = Budget; }
+
+            /// @brief Moves this Function into the given tier.
+            /// @param Tier The new tier
+            /// @param Budget The amount of invocations and backward
+            /// jumps to count before the executor reconsiders the
+            /// tier. At least 1.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void SetTier(FunctionTier Tier, u32 Budget) noexcept
+                {
+                    m_TierEvents += m_TierTarget - m_TierBudget;
+                    m_Tier        = Tier;
+                    m_TierTarget  = ( Budget ? Budget : 1 );
+                    m_TierBudget  = m_TierTarget;
+                }
+
+            /// @brief Moves this Function into the HOT tier.
+            /// @param Compiled The native entry point, which
+            /// executes the whole Function from its start
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void AssignCompiled(ExposedFunc Compiled) noexcept
+                {
+                    m_Compiled = Compiled;
+                    SetTier(FunctionTier::HOT, UINT32_MAX);
+                }
+
+            /// @brief Assigns the entry point for on-stack replacement,
+            /// replacing the one of any other loop. The tier is unchanged.
+            /// @param IDX The target of the backward jump it starts at
+            /// @param Entry The native entry point, which executes
+            /// the rest of the Function from IDX
+            /// @return The entry point replaced, if any
+            ////////////////////////////////////////
+            OctVM_SternInline
+            ExposedFunc AssignOSREntry(u32 IDX, ExposedFunc Entry) noexcept
+                {
+                    ExposedFunc Replaced = m_OSREntry;
+                    m_OSRIndex = IDX;
+                    m_OSREntry = Entry;
+                    return Replaced;
+                }
+
+            /// @brief Discards every native entry point of this
+            /// Function, moving it back into WARM. The code itself
+            /// is released by its `CodeCache`.
+            /// @param Budget The amount of invocations and backward
+            /// jumps to count before it is compiled again
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void DropCompiled(u32 Budget) noexcept
+                {
+                    m_Compiled = nullptr;
+                    m_OSREntry = nullptr;
+                    m_OSRIndex = 0;
+                    SetTier(FunctionTier::WARM, Budget);
+                }
+
+            /// @brief Discards every native entry point of this
+            /// Function after a speculation it was compiled under
+            /// failed, just as `DropCompiled` does.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void Deoptimize(u32 Budget) noexcept
+                {
+                    m_DeoptCount++;
+                    DropCompiled(Budget);
+                }
+
+            /// @return When compiled code of this Function was
+            /// last entered, as counted by its `CodeCache`. The
+            /// least recently entered code is released first.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            u64 GetCodeUse(void) const noexcept
+                { return m_CodeUse; }
+
+            /// @brief Records an entry into compiled
+            /// code of this Function. See `GetCodeUse`.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void MarkCodeUse(u64 Tick) noexcept
+                { m_CodeUse = Tick; }
+
+            /// @return The `CodeCache` holding the compiled code
+            /// of this Function, or nullptr if it has none.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            CodeCache* GetCodeCache(void) const noexcept
+                { return m_CodeCache; }
+
+            /// @brief Assigns the `CodeCache` holding the compiled
+            /// code of this Function. Only called by the cache itself.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void AssignCodeCache(CodeCache* Cache) noexcept
+                { m_CodeCache = Cache; }
+
         /// GETTERS:
         /// --- PISSED OFF NOTE --- @markredmann
         /// Hey, see how *THESE* functions have their
@@ -382,8 +761,142 @@ namespace Octane {
             /// and the Shared Address Space.
             ///////////////////////////////////////
             constexpr OctVM_SternInline
-            u8 GetPaddingBytes(void) const noexcept
+            u32 GetPaddingBytes(void) const noexcept
                 { return m_SharedPadding; }
+
+            /// @brief Returns the pre-decoded form of the
+            /// Code Space, or nullptr if this Function has
+            /// not been decoded yet.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            DecodedInstruction* GetDecoded(void) const noexcept
+                { return m_Decoded; }
+
+            /// @brief Returns the pre-decoded form of the
+            /// Code Space in which every Stack and Local
+            /// site keeps its runtime checks. Safe to enter
+            /// at any `Instruction`.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            DecodedInstruction* GetDecodedChecked(void) const noexcept
+                { return ( m_DecodedChecked ? m_DecodedChecked : m_Decoded ); }
+
+            /// @brief Returns the Stack and Local Space this
+            /// Function's proven sites rely on.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            const FrameDemand& GetFrameDemand(void) const noexcept
+                { return m_Demand; }
+
+            /// @brief Reserves this Function's `FrameDemand`
+            /// against the given `ThreadMemory`, which must
+            /// already hold the new, empty Local Frame. If the
+            /// full demand is available, its Local demand is
+            /// allocated from the Frame up front, with a single
+            /// `ThreadMemory::LocalFrameReserve`.
+            /// @return The pre-decoded form to run from the
+            /// first `Instruction`: the check-free form if
+            /// the full demand is available, otherwise the
+            /// checked form.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            DecodedInstruction* SelectDecoded(ThreadMemory& Memory)
+            const noexcept
+                {
+                    if ( !m_DecodedChecked
+                      || ( Memory.GetStackRemaining() >= m_Demand.StackPush
+                        && Memory.GetStackUsage()     >= m_Demand.StackPop
+                        && Memory.LocalFrameReserve(m_Demand.Local) ) )
+                        return m_Decoded;
+                    return m_DecodedChecked;
+                }
+
+            /// @brief Returns where the `Instruction` at IDX
+            /// was inlined from, or nullptr if it was not.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            const InlineOrigin* GetInlineOrigin(u32 IDX) const noexcept
+                {
+                    if ( !m_InlineOrigins || !m_InlineOrigins[IDX].Callee )
+                        return nullptr;
+                    return &m_InlineOrigins[IDX];
+                }
+
+            /// @brief Returns the `InlineOrigin` of every
+            /// `Instruction`, or nullptr if none was inlined.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            InlineOrigin* GetInlineOrigins(void) const noexcept
+                { return m_InlineOrigins; }
+
+        /// MODIFIERS:
+        ////////////////////////////////////////
+
+            /// @brief Caches the pre-decoded form of the
+            /// Code Space. Ownership is transferred to this
+            /// Function, and it is released by `Free()`.
+            /// @param Decoded The pre-decoded form
+            /// @param Checked The checked copy of `Decoded`,
+            /// or nullptr if `Decoded` has no proven sites
+            /// @param Demand The demand proven sites rely on
+            /// @param Caches The `GlobalCache`s referenced by
+            /// both forms, or nullptr if there are none
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void AssignDecoded(DecodedInstruction* Decoded,
+                               DecodedInstruction* Checked = nullptr,
+                               FrameDemand Demand = {},
+                               GlobalCache* Caches = nullptr) noexcept
+                {
+                    m_Decoded        = Decoded;
+                    m_DecodedChecked = Checked;
+                    m_Demand         = Demand;
+                    m_GlobalCaches   = Caches;
+                }
+
+            /// @brief Replaces the pre-decoded form with an
+            /// optimised copy containing sites proven against
+            /// `Demand`. The current form is kept as the checked
+            /// copy, so that activations still running it stay
+            /// valid. Ownership is transferred to this Function.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void AssignOptimised(DecodedInstruction* Optimised,
+                                 FrameDemand Demand) noexcept
+                {
+                    m_DecodedChecked = m_Decoded;
+                    m_Decoded        = Optimised;
+                    m_Demand         = Demand;
+                }
+
+            /// @brief Shrinks the Code Space to its first Count
+            /// `Instruction`s, once a pass such as `OptimiseBytecode`
+            /// has compacted it. The words given up are filled with
+            /// `ret` and become part of the padding.
+            /// @return False if this Function has already been
+            /// decoded, or if Count is 0 or larger than the
+            /// Code Space.
+            ////////////////////////////////////////
+            bool TruncateCodeSpace(u16 Count) noexcept;
+
+            /// @brief Replaces the Code Space with a copy of Code,
+            /// keeping the Shared Address Space and everything else
+            /// `Init` was given. The Function has to pass
+            /// verification again before it runs.
+            /// @param Allocator The VM's `CoreAllocator`
+            /// @param Code The new Code Space
+            /// @param Count The amount of `Instruction`s in Code
+            /// @param Origins One `InlineOrigin` per `Instruction`,
+            /// or nullptr. Ownership is transferred to this Function,
+            /// whether or not the Code Space could be replaced.
+            /// @return `MEMORY_OK` on success. `MEMORY_SIZE_IS_ZERO`
+            /// if this Function has already been decoded or Count
+            /// is 0, otherwise a `MemoryError` denoting why the
+            /// Allocator failed, leaving the Code Space unchanged.
+            ////////////////////////////////////////
+            MemoryError ReplaceCodeSpace(CoreAllocator& Allocator,
+                                         const Instruction* Code, u16 Count,
+                                         InlineOrigin* Origins) noexcept;
         
 
     };
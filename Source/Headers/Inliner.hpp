@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_INLINER_HPP
+#define OCTVM_INLINER_HPP 1
+
+#include "Common.hpp"
+#include "CoreMemory.hpp"
+
+namespace Octane {
+
+    class Function;
+
+    /// @brief Limits how much `InlineModule` inlines
+    ////////////////////////////////////////
+    struct InlinePolicy {
+        /// The most `Instruction`s a callee may have
+        /// to be inlined, not counting a final `ret`
+        u16 MaxCalleeCount = 16;
+        /// The most `Instruction`s a caller may grow to
+        /// through inlining. Never more than the 0xFFFF
+        /// `Function::GetInstructionCount` can hold.
+        u16 MaxCallerCount = 4096;
+    };
+
+    /// @brief Links the `call` sites of a module of `Function`s
+    /// ahead of time, replacing each `call` of a small bytecode
+    /// callee with a copy of its body. Callees are resolved
+    /// through the caller's `RelocationTable`, as the `call`
+    /// would have resolved them now, and need not be part of
+    /// the module themselves. Later assigning another `Function`
+    /// to the same `Symbol` does not reach inlined bodies.
+    ///
+    /// As callers and callees share the register file, no
+    /// register needs to be remapped. Every `ret` of a callee
+    /// becomes a `jmp` past its body, a final `ret` is dropped,
+    /// and every jump of both caller and callee is pointed at
+    /// where its target has moved.
+    ///
+    /// A callee is only inlined if:
+    ///
+    /// **A:** Both caller and callee pass `VerifyFunction`, the
+    ///    caller has not been decoded yet, and the callee is
+    ///    not the caller itself.
+    ///
+    /// **B:** The callee's `CallingConvention` is the one the
+    ///    caller's `RelocationTable` entry expects, as the `call`
+    ///    would otherwise raise `InvalidSymbol`.
+    ///
+    /// **C:** The callee has no `call`, `corecall`, threading,
+    ///    `eload` or `offset` `Instruction`s, which depend on the
+    ///    `Function` they run in, and no `requestlocal` or
+    ///    `droplocal`, which depend on its own Local Frame.
+    ///
+    /// **D:** The caller has no `requestlocal`, which could fill
+    ///    the Local Space that the callee's Local Frame would
+    ///    have been created in.
+    ///
+    /// Inlined calls no longer count towards the callee's tier,
+    /// and no longer create a Local Frame, so they never raise
+    /// `LocalOutOfMemory`, even where the Frames below the caller
+    /// have filled the Local Space. Every other `Exception` an
+    /// inlined `Instruction` raises is reported with the callee
+    /// as `ExecState::CurrentFunc` and the `Instruction` it was
+    /// copied from as the offender, through the caller's
+    /// `Function::GetInlineOrigin`. Callees must therefore
+    /// outlive their callers.
+    ///
+    /// The caller's own `Instruction`s are reported where they
+    /// now sit in its new Code Space, as the old one is freed.
+    /// An `Exception` raised past an inlined call is therefore
+    /// reported at a later index than before inlining, shifted
+    /// by the size of every body inlined ahead of it, less the
+    /// `call`s they replaced.
+    ///
+    /// Callees whose own calls were inlined may become small
+    /// enough to be inlined in turn, so the module is revisited
+    /// until nothing more is inlined.
+    /// @param Module The `Function`s whose `call` sites are linked
+    /// @param Count The amount of `Function`s in Module
+    /// @param Allocator The VM's `CoreAllocator`, used for the new
+    /// Code Spaces and for temporary storage
+    /// @param Policy Limits how much is inlined
+    /// @return The amount of `call` sites inlined. Callers for
+    /// which memory runs out are left unchanged.
+    ////////////////////////////////////////
+    extern u32 InlineModule(Function* const* Module, u32 Count,
+                            CoreAllocator& Allocator,
+                            const InlinePolicy& Policy = {}) noexcept;
+
+}
+
+#endif /* !OCTVM_INLINER_HPP */
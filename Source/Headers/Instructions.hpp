@@ -33,9 +33,94 @@ namespace Octane {
     /// INTERNALS: AND: METHODS:
     ////////////////////////////////////////
         enum Opcode : u8;
+        enum class Layout : u8;
         using Width = u32;
         static const char* GetStringName(Opcode ID);
+
+        /// @brief Returns how the operands of the given
+        /// Opcode are packed. Unknown Opcodes have no operands.
+        ////////////////////////////////////////
+        static Layout GetLayout(u8 ID) noexcept;
+
+        /// @brief Retrieves the absolute jump target of
+        /// a `seek`, `jmp` or conditional jump.
+        /// @param Ins The `Instruction` to inspect
+        /// @param IDX The index of `Ins` in its Code Space
+        /// @param Target Receives the target index, which
+        /// may lie outside of the Code Space
+        /// @return False if the `Instruction` does not jump.
+        ////////////////////////////////////////
+        static bool GetJumpTarget(const Instruction& Ins, u32 IDX,
+                                  i32& Target) noexcept;
+
+        /// @brief Points a `seek`, `jmp` or conditional jump
+        /// at the absolute index Target. A `seek` too far
+        /// away becomes a `jmp`.
+        /// @param Ins The jump to rewrite
+        /// @param IDX The index of `Ins` in its Code Space
+        /// @param Target The new target index
+        ////////////////////////////////////////
+        static void SetJumpTarget(Instruction& Ins, u32 IDX,
+                                  u32 Target) noexcept;
+
         constexpr static const u8 UNUSED_REG = 0xFF;
+
+        /// @brief Returns how many `Instruction::Width` words
+        /// the given Opcode occupies in a Code Space, including
+        /// any trailing immediate words.
+        ////////////////////////////////////////
+        constexpr static OctVM_SternInline
+        u8 GetWordCount(Opcode ID) noexcept;
+
+        /// @brief Encodes an `Instruction` from its raw bytes.
+        ////////////////////////////////////////
+        static OctVM_SternInline
+        Instruction Make(Opcode Op, u8 A = 0, u8 B = 0, u8 C = 0) noexcept
+            {
+                Instruction Ins;
+                Ins.RawBytes[0] = Op;
+                Ins.RawBytes[1] = A;
+                Ins.RawBytes[2] = B;
+                Ins.RawBytes[3] = C;
+                return Ins;
+            }
+
+        /// @brief Encodes an `Instruction` using the `Imm16` layout.
+        ////////////////////////////////////////
+        static OctVM_SternInline
+        Instruction MakeImm16(Opcode Op, u8 rX, u16 Imm) noexcept
+            {
+                Instruction Ins;
+                Ins.Imm16.Op  = Op;
+                Ins.Imm16.rX  = rX;
+                Ins.Imm16.Imm = Imm;
+                return Ins;
+            }
+
+        /// @brief Encodes an `Instruction` using the `Imm16Alt`
+        /// layout, packing rX into the high nibble and rY into
+        /// the low nibble.
+        ////////////////////////////////////////
+        static OctVM_SternInline
+        Instruction MakeImm16Alt(Opcode Op, u8 rX, u8 rY, u16 Imm) noexcept
+            {
+                Instruction Ins;
+                Ins.Imm16Alt.Op    = Op;
+                Ins.Imm16Alt.rX_rY = (u8)( (rX << 4) | (rY & 0x0F) );
+                Ins.Imm16Alt.Imm   = Imm;
+                return Ins;
+            }
+
+        /// @brief Encodes a raw immediate word which trails
+        /// a multi-word `Instruction` such as `movimm32`.
+        ////////////////////////////////////////
+        static OctVM_SternInline
+        Instruction MakeWord(Width Raw) noexcept
+            {
+                Instruction Ins;
+                Ins.RawInt = Raw;
+                return Ins;
+            }
     /// INSTRUCTION: VARIANTS:
     ////////////////////////////////////////
         struct _any
@@ -150,8 +235,54 @@ namespace Octane {
             /*** METADATA: ***/
             COUNT_OF_INSTRUCTIONS
         };
+
+        /// @brief How the operands of an `Instruction`
+        /// are packed. u8 register fields must be validated,
+        /// while nibble register fields are always valid.
+        ////////////////////////////////////////
+        enum class Layout : u8 {
+            /// No register operands. Imm16 is kept as-is.
+            NONE,
+            /// Imm16 is an absolute jump target
+            JUMP,
+            /// Imm16 is a signed jump relative to the `Instruction`
+            SEEK,
+            /// One u8 register: rX
+            ONE,
+            /// One u8 register and an Imm16: rX, Imm
+            IMM16,
+            /// One u8 register and one trailing word
+            IMM32,
+            /// One u8 register and two trailing words
+            IMM64,
+            /// Two u8 registers: rX, rY
+            DUAL,
+            /// Three u8 registers: rX, rY, rZ
+            TRI,
+            /// Two nibble registers and an Imm16: rX_rY, Imm
+            ALT,
+            /// As `ALT`, but Imm is sign extended
+            ALT_SIGNED,
+            /// Two nibble registers, a u8 register and a Scale
+            MEM,
+            /// Two u8 registers and a packed index/stride Scale
+            PRIV,
+        };
     };
 
+    constexpr OctVM_SternInline
+    u8 Instruction::GetWordCount(Opcode ID) noexcept
+    {
+        switch ( ID ) {
+            case movimm32: case movimmf:
+                return 2;
+            case movimm64: case movimmd:
+                return 3;
+            default:
+                return 1;
+        }
+    }
+
 }
 
 #endif /* !OCTVM_INSTRUCTIONS_HPP */
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_OPTIMIZINGJIT_HPP
+#define OCTVM_OPTIMIZINGJIT_HPP 1
+
+#include "Common.hpp"
+#include "Functions.hpp"
+#include "TemplateJIT.hpp"
+
+namespace Octane {
+
+    /// @brief An optimising `TierCompiler`, selected per VM
+    /// through `VM::SetTierCompiler`. The `Function` is lifted
+    /// into an `SSAGraph`, whose constants are propagated, dead
+    /// values removed, register types inferred and loop invariants
+    /// hoisted. Its values are then assigned host registers by a
+    /// linear scan over their live ranges, and emitted as x86-64.
+    ///
+    /// VM registers only live in `ExecState::Reg` at the entry
+    /// and exits of compiled code. Every check which would raise
+    /// an `Exception`, such as a zero divisor, writes the
+    /// register file back as it was before its `Instruction`,
+    /// and exits to the interpreter there, which raises it
+    /// precisely. So do `Instruction`s the graph cannot express.
+    ///
+    /// `gload`/`gsave` sites are compiled for the key they
+    /// have seen, with the Value of its `Symbol` baked in. The
+    /// code checks on entry that the `StorageDevice` still holds
+    /// those Values, and each site that its key is unchanged.
+    /// If either fails, the code is discarded through
+    /// `JITDeoptimize`, and the `Function` recompiled once it
+    /// is hot again. One deoptimised too often, or accessing
+    /// a global which does not resolve, is compiled without
+    /// speculating, by `CompileTemplateJIT`.
+    ///
+    /// Functions too large, or without a loop the graph reaches
+    /// before its first unsupported `Instruction`, are handed
+    /// to `CompileTemplateJIT` instead.
+    /// @param Func The WARM `Function` to compile
+    /// @param State The `ExecState` whose executor tiered up `Func`
+    /// @param Entry The `Instruction` the native entry point
+    /// starts at. See `TierCompiler`.
+    /// @return The native entry point, or nullptr if neither
+    /// tier could compile `Func`.
+    ////////////////////////////////////////
+    extern ExposedFunc CompileOptimizingJIT(Function& Func,
+                                            ExecState& State,
+                                            u32 Entry) noexcept;
+
+}
+
+#endif /* !OCTVM_OPTIMIZINGJIT_HPP */
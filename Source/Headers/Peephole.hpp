@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_PEEPHOLE_HPP
+#define OCTVM_PEEPHOLE_HPP 1
+
+#include "Common.hpp"
+#include "CoreMemory.hpp"
+
+namespace Octane {
+
+    class Function;
+
+    /// @brief Rewrites the Code Space of a verified `Function`
+    /// in place, before it is first decoded. A dataflow pass
+    /// over its control flow graph tracks which registers hold
+    /// a known constant, or a copy of another register, at
+    /// every `Instruction`. From that:
+    ///
+    /// **A:** Integer `Instruction`s with known operands are
+    ///    folded into the shortest `movimm` variant, or `clr`,
+    ///    which fits into the words they already occupy.
+    ///
+    /// **B:** Copies are propagated into the operands which
+    ///    read them, and `mov`s or constant loads leaving a
+    ///    register unchanged are removed.
+    ///
+    /// **C:** Conditional jumps with a known outcome become
+    ///    `jmp`s or are removed, jumps to a `jmp` are threaded
+    ///    through to its target, `jmp`s to a `ret` become one,
+    ///    and jumps to the next `Instruction` are removed.
+    ///
+    /// **D:** Unreachable `Instruction`s are removed, as are
+    ///    pure `Instruction`s whose result is never read.
+    ///
+    /// The remaining `Instruction`s are compacted to the start
+    /// of the Code Space, shrinking it through
+    /// `Function::TruncateCodeSpace`. The output uses the same
+    /// `Instruction` encoding, and still passes `VerifyFunction`,
+    /// so it runs on every executor and compiler tier.
+    ///
+    /// Any `Instruction` which may raise an `Exception` is
+    /// treated as reading every register, and, as the handler
+    /// may correct them before execution resumes, as leaving
+    /// every register unknown. The same holds for `call`,
+    /// `corecall` and threading `Instruction`s.
+    /// Only the index an `Exception` is reported at may differ.
+    /// @param Func The verified, undecoded `Function`
+    /// @param Allocator The VM's `CoreAllocator`, used
+    /// for temporary storage
+    /// @return The amount of `Instruction`s rewritten or
+    /// removed. 0 if there are none, or if `Func` was left
+    /// unchanged because it is decoded, unverified, or
+    /// temporary storage could not be allocated.
+    ////////////////////////////////////////
+    extern u32 OptimiseBytecode(Function& Func,
+                                CoreAllocator& Allocator) noexcept;
+
+}
+
+#endif /* !OCTVM_PEEPHOLE_HPP */
@@ -0,0 +1,268 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_SSA_HPP
+#define OCTVM_SSA_HPP 1
+
+#include "Common.hpp"
+#include "CoreMemory.hpp"
+#include "Decoder.hpp"
+#include "VPCore.hpp"
+
+namespace Octane {
+
+    class Function;
+
+    /// @brief Marks a missing value, block or snapshot
+    ////////////////////////////////////////
+    constexpr const u32 SSA_NONE = UINT32_MAX;
+
+    /// @brief The operations of an `SSAValue`. Integer
+    /// operations work on the full 64 bits of their operands,
+    /// as `Register::AsU64` does, while F-prefixed ones only
+    /// read the low 32 bits, as `Register::AsF32` does.
+    ////////////////////////////////////////
+    enum SSAOp : u8 {
+        /// The register `Imm` as the `Function` was entered with
+        SSA_PARAM,
+        /// The 64-bit pattern in `Imm`. Never placed in a
+        /// register, as every use can rematerialise it.
+        SSA_CONST,
+        /// One operand per predecessor of its block, in the
+        /// order of `SSABlock::Preds`, starting at `Imm`
+        /// inside of `SSAGraph::PhiArgs`
+        SSA_PHI,
+
+        /*** INTEGER: ***/
+        SSA_ADD, SSA_SUB, SSA_MUL, SSA_AND, SSA_OR, SSA_XOR,
+        SSA_SHL, SSA_SHR, SSA_NOT, SSA_LAND, SSA_LOR,
+        /// 1 if `Cond` holds between both operands, otherwise 0
+        SSA_CMP,
+        /// Exit through their `Snapshot` if the divisor is 0,
+        /// or -1 for the signed forms
+        SSA_DIV, SSA_MOD, SSA_IDIV, SSA_IMOD,
+
+        /*** FLOATING POINT: ***/
+        /// FDIV and DDIV exit through their `Snapshot` if the divisor is 0
+        SSA_FADD, SSA_FSUB, SSA_FMUL, SSA_FDIV, SSA_FSQRT,
+        SSA_DADD, SSA_DSUB, SSA_DMUL, SSA_DDIV, SSA_DSQRT,
+        SSA_FCMP, SSA_DCMP,
+        SSA_I2F, SSA_I2D, SSA_F2D, SSA_D2F,
+
+        /*** MEMORY: ***/
+        /// The address of element Args[1] of the DATA `Symbol`
+        /// keyed by Args[0], with the `GlobalCache*` of its site
+        /// in `Imm`. Compiled for the key the site has seen, and
+        /// exits through its `Snapshot`, if it has one, whenever
+        /// Args[0] points to any other key.
+        SSA_GADDR,
+        /// Zero-extends the `Imm` bytes at the address Args[0]
+        SSA_LOAD,
+        /// Writes the low `Imm` bytes of Args[1] to the address
+        /// Args[0]. Never removed, and never moved.
+        SSA_STORE,
+    };
+
+    /// @brief How the bits of an `SSAValue` are used, which
+    /// decides the class of host register it is kept in.
+    /// F32 results keep their upper 32 bits at 0, as
+    /// the interpreter writes them.
+    ////////////////////////////////////////
+    enum class SSAType : u8 { I64, F32, F64 };
+
+    /// @brief The conditions of `SSA_CMP`, `SSA_FCMP`,
+    /// `SSA_DCMP` and branches. Floating point compares
+    /// only use EQ through GE, and are false for NaN.
+    ////////////////////////////////////////
+    enum SSACond : u8 {
+        COND_EQ, COND_NE,
+        /// Unsigned, or ordered for floating point
+        COND_LT, COND_GT, COND_LE, COND_GE,
+        /// Signed
+        COND_ILT, COND_IGT, COND_ILE, COND_IGE,
+    };
+
+    /// @brief How control leaves an `SSABlock`
+    ////////////////////////////////////////
+    enum class SSAExit : u8 {
+        /// To `Succ[0]`
+        JUMP,
+        /// To `Succ[0]` if `Cond` holds between `Args`,
+        /// otherwise to `Succ[1]`
+        BRANCH,
+        /// Returns from the `Function`, writing its `Snapshot`
+        /// back into the register file
+        RETURN,
+        /// Resumes the interpreter at the `Snapshot`'s `Instruction`
+        EXIT,
+    };
+
+    /// @brief A single value of an `SSAGraph`,
+    /// assigned exactly once by its operation
+    ////////////////////////////////////////
+    struct SSAValue {
+        /// See `SSAOp`
+        u64 Imm;
+        u32 Args[2];
+        u32 Block;
+        /// Neighbours in the order of its block
+        u32 Prev, Next;
+        /// The state to resume the interpreter with if this
+        /// value's check fails, or `SSA_NONE` if it cannot fail
+        u32 Snapshot;
+        /// The value this one has been found to equal,
+        /// or `SSA_NONE`. See `ResolveSSA`.
+        u32 Alias;
+        u8  Op;
+        SSAType Type;
+        u8  Cond;
+        /// Set while the value is reachable from a root
+        bool Live;
+    };
+
+    /// @brief The value of every VM register at an
+    /// `Instruction` where compiled code leaves for
+    /// the interpreter, or returns
+    ////////////////////////////////////////
+    struct SSASnapshot {
+        /// The `Instruction` to resume at, or
+        /// `SSA_NONE` for a return
+        u32 IDX;
+        u32 Values[VPCore::Register::COUNT];
+    };
+
+    /// @brief A basic block of an `SSAGraph`
+    ////////////////////////////////////////
+    struct SSABlock {
+        /// Its values, in execution order
+        u32 First, Last;
+        /// Its predecessors, as `SSAGraph::PredList[Preds]` onwards
+        u32 Preds, PredCount;
+        u32 Succ[2];
+        /// The operands of a BRANCH
+        u32 Args[2];
+        /// The state written back by a RETURN or EXIT
+        u32 Snapshot;
+        /// The first `Instruction` lifted into the block, and
+        /// the one its terminator comes from. `SSA_NONE` for
+        /// blocks which only exist in the graph.
+        u32 Start, Site;
+        /// Its immediate dominator, and position in `SSAGraph::Order`
+        u32 IDom, Order;
+        /// The header of the innermost loop containing the block
+        u32 Loop;
+        /// For loop headers only: the header of the enclosing
+        /// loop, and the single block entering the loop
+        u32 LoopParent, Preheader;
+        SSAExit Exit;
+        u8      Cond;
+    };
+
+    /// @brief A `Function` lifted into static single
+    /// assignment form, along with its control flow graph.
+    ///
+    /// Every loop header has a preheader, and no edge
+    /// leads from a block with two successors into one
+    /// with two predecessors, so that values can be
+    /// hoisted out of loops and `SSA_PHI` operands can
+    /// be moved at the end of their predecessor.
+    ////////////////////////////////////////
+    struct SSAGraph {
+        SSAValue*    Values;
+        u32          ValueCount, ValueCapacity;
+        SSABlock*    Blocks;
+        u32          BlockCount, BlockCapacity;
+        /// Reachable blocks in reverse postorder, starting with Entry
+        u32*         Order;
+        u32          OrderCount;
+        u32*         PredList;
+        u32*         PhiArgs;
+        SSASnapshot* Snapshots;
+        u32          SnapshotCount, SnapshotCapacity;
+        /// Holds an `SSA_PARAM` for every register
+        u32          Entry;
+        /// Temporary storage for the passes of `OptimiseSSA`,
+        /// holding `ValueCapacity` entries
+        u32*         Scratch;
+    };
+
+    /// @brief Returns true if the `Instruction` decoded
+    /// into D can be lifted into an `SSAGraph`. Any other
+    /// `Instruction` ends its block with an EXIT.
+    ////////////////////////////////////////
+    extern bool IsSSASupported(const DecodedInstruction& D,
+                               const Function& Func) noexcept;
+
+    /// @brief Lifts the checked decoded form of a
+    /// `Function` into an `SSAGraph`, entered at the
+    /// `Instruction` at Entry. Code only reachable from
+    /// before Entry is left out.
+    /// @return False if temporary storage could not be
+    /// allocated, or a jump targets the middle of a
+    /// multi-word `Instruction`.
+    ////////////////////////////////////////
+    extern bool BuildSSA(const Function& Func, CoreAllocator& Allocator,
+                         SSAGraph& Graph, u32 Entry) noexcept;
+
+    /// @brief Optimises an `SSAGraph` in place. Constants are
+    /// propagated and folded, values which no root depends on
+    /// are removed, the `SSAType` of each `SSA_PHI` and
+    /// `SSA_PARAM` is inferred from its uses, and values which
+    /// cannot fail are hoisted out of the loops they are
+    /// invariant in.
+    ///
+    /// Afterwards, every operand refers to a live value
+    /// directly, and no longer needs `ResolveSSA`.
+    ////////////////////////////////////////
+    extern void OptimiseSSA(SSAGraph& Graph) noexcept;
+
+    /// @brief Releases the storage of an `SSAGraph`
+    ////////////////////////////////////////
+    extern void ReleaseSSA(SSAGraph& Graph, CoreAllocator& Allocator) noexcept;
+
+    /// @brief Follows the `Alias` of a value to the one
+    /// it has been replaced with.
+    ////////////////////////////////////////
+    OctVM_SternInline
+    u32 ResolveSSA(const SSAGraph& Graph, u32 Value) noexcept
+    {
+        while ( Graph.Values[Value].Alias != SSA_NONE )
+            Value = Graph.Values[Value].Alias;
+        return Value;
+    }
+
+    /// @brief Returns true if the `SSA_PARAM` of Register
+    /// would be written back into Register itself, which
+    /// the register file still holds.
+    ////////////////////////////////////////
+    OctVM_SternInline
+    bool IsUnchangedSSA(const SSAGraph& Graph, u32 Value, u32 Register) noexcept
+    {
+        return ( Graph.Values[Value].Op == SSA_PARAM
+              && Graph.Values[Value].Imm == Register );
+    }
+
+}
+
+#endif /* !OCTVM_SSA_HPP */
@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_TEMPLATEJIT_HPP
+#define OCTVM_TEMPLATEJIT_HPP 1
+
+#include "Common.hpp"
+#include "Functions.hpp"
+
+// The stencils are x86-64 machine code for the System V calling convention
+#ifndef OCTVM_NO_TEMPLATE_JIT
+    #if defined(__x86_64__) && ( defined(__linux__) || defined(__APPLE__) )
+        /// The template JIT can emit native code on this platform.
+        /// Elsewhere `CompileTemplateJIT` declines every `Function`.
+        #define OCTVM_TEMPLATE_JIT 1
+    #endif
+#endif /* !OCTVM_NO_TEMPLATE_JIT */
+
+namespace Octane {
+
+    /// @brief A baseline `TierCompiler`, selected per VM
+    /// through `VM::SetTierCompiler`. Each `DecodedInstruction`
+    /// of the `Function` is translated by copying a pre-assembled
+    /// machine code stencil for its Opcode into executable
+    /// memory, and patching its registers, immediate and jump
+    /// targets into the stencil's holes.
+    ///
+    /// The register file stays in `ExecState::Reg` throughout.
+    /// `Instruction`s without a stencil, and any stencil
+    /// which would raise an `Exception`, exit to the interpreter,
+    /// which resumes the `Function` from that `Instruction` in
+    /// a Local Frame of its own and raises as usual.
+    ///
+    /// Sites `AnalyseHotCode` finds cold, and every exit, are
+    /// split off into cold memory, so that only the code which
+    /// runs is packed along with that of other `Function`s.
+    /// Compiled code is held by the VM's `CodeCache`, and
+    /// stays valid until it is evicted or the `Function` freed.
+    /// @param Func The WARM `Function` to compile
+    /// @param State The `ExecState` whose executor tiered up `Func`
+    /// @param Entry The `Instruction` the native entry point
+    /// starts at. See `TierCompiler`.
+    /// @return The native entry point, or nullptr if the
+    /// platform is unsupported, memory ran out, or `Func`
+    /// has no loop it reaches from Entry without exiting.
+    ////////////////////////////////////////
+    extern ExposedFunc CompileTemplateJIT(Function& Func, ExecState& State,
+                                          u32 Entry) noexcept;
+
+#if OCTVM_TEMPLATE_JIT
+
+    /// NATIVE CODE:
+    /// Shared by every compiler tier.
+    ////////////////////////////////////////
+
+    /// @brief Maps writable memory for Size bytes of machine
+    /// code compiled for Func, making room for it in the VM's
+    /// `CodeCache` by evicting the code of other `Function`s.
+    /// @return The start of the memory, or nullptr on failure.
+    ////////////////////////////////////////
+    extern byte* MapJITCode(ExecState& State, const Function& Func,
+                            u32 Size) noexcept;
+
+    /// @brief As above, along with ColdSize bytes for the code
+    /// split off as cold, which the `CodeCache` keeps apart from
+    /// the hot code of every `Function`, within reach of a rel32
+    /// jump. Both are released together.
+    /// @param Cold Receives the start of the cold memory
+    ////////////////////////////////////////
+    extern byte* MapJITCode(ExecState& State, const Function& Func,
+                            u32 Size, u32 ColdSize, byte*& Cold) noexcept;
+
+    /// @brief Turns memory returned by `MapJITCode` executable,
+    /// handing it to the VM's `CodeCache`, or releases it on failure.
+    /// @param Data An allocation the code refers to, released
+    /// along with it once sealed. May be nullptr.
+    /// @return The entry point at the start of
+    /// the memory, or nullptr on failure.
+    ////////////////////////////////////////
+    extern ExposedFunc SealJITCode(ExecState& State, Function& Func,
+                                   byte* Code, u32 Size,
+                                   void* Data = nullptr) noexcept;
+
+    /// @brief As above, for code mapped along with cold memory
+    ////////////////////////////////////////
+    extern ExposedFunc SealJITCode(ExecState& State, Function& Func,
+                                   byte* Code, u32 Size,
+                                   byte* Cold, u32 ColdSize,
+                                   void* Data = nullptr) noexcept;
+
+    /// @brief Reserves Size bytes of address space for a
+    /// `CodeCache` to carve code out of. Neither readable
+    /// nor writable until `MapJITCode` hands it out.
+    /// @return The start of the arena, or nullptr on failure.
+    ////////////////////////////////////////
+    extern byte* MapJITArena(u64 Size) noexcept;
+
+    /// @brief Unmaps an arena returned by `MapJITArena`.
+    /// Only called by the `CodeCache`.
+    ////////////////////////////////////////
+    extern void UnmapJITArena(byte* Arena, u64 Size) noexcept;
+
+    /// @brief Resumes Func in the interpreter from IDX, as
+    /// its own executor entry. Tail called by compiled code
+    /// once it has written the register file back to `State`.
+    /// Compiled code never creates a Local Frame, so the
+    /// interpreter's entry Frame is the only one Func ever has,
+    /// unless the code was entered through on-stack replacement
+    /// in the Frame of an interpreted activation.
+    ////////////////////////////////////////
+    extern Exception::HandlerResult JITResume(ExecState* State, u32 IDX,
+                                              Function* Func) noexcept;
+
+    /// @brief Leaves compiled code whose speculation no longer
+    /// holds. Func is moved back into WARM through
+    /// `Function::Deoptimize`, to be compiled again once it has
+    /// been as hot again, its code is released, and every call
+    /// site caching its native entry point re-resolves. It then resumes from IDX just as
+    /// `JITResume` does, once the register file has been written
+    /// back as of that `Instruction`.
+    ////////////////////////////////////////
+    extern Exception::HandlerResult JITDeoptimize(ExecState* State, u32 IDX,
+                                                  Function* Func) noexcept;
+
+#endif /* OCTVM_TEMPLATE_JIT */
+
+}
+
+#endif /* !OCTVM_TEMPLATEJIT_HPP */
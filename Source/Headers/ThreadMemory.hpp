@@ -25,26 +25,40 @@
 #ifndef OCTVM_THREADMEMORY_HPP
 #define OCTVM_THREADMEMORY_HPP 1
 
+#include <cstddef>
+#include <cstring>
 #include "CoreMemory.hpp"
+#include "Instructions.hpp"
 
 namespace Octane {
 
+    // Forward Decl
+
+    class Function;
+
     /// @brief An encapsulation of and handler for
     /// the LocalSpace and Stack of a specific `IThread`
     ////////////////////////////////////////
     class ThreadMemory {
         private:
-            //////////////// TODO: /////////////////
-            /// Add Function trace information
-            ////////////////////////////////////////
-            
             /// @brief A small struct containing
             /// metadata about a given call frame
             ////////////////////////////////////////
             struct Frame {
-                u16    Offset;
-                u16    Usage;
-                Frame* LastFrame;
+                u32          Offset;
+                u32          Usage;
+                Frame*       LastFrame;
+                /// The `Function` which issued the `call` that
+                /// created this Frame. nullptr for an entry Frame
+                /// created directly by the executor.
+                Function*    Caller;
+                /// The `Instruction` in `Caller` where execution
+                /// resumes once this Frame is dropped.
+                Instruction* ReturnIP;
+                /// The `Function` whose native code this Frame has
+                /// been handed over to by on-stack replacement, or
+                /// nullptr. See `LocalFrameHandOver`.
+                Function*    HandedTo;
             };
 
             /// The size in bytes allocated for the Stack.
@@ -295,6 +309,99 @@ namespace Octane {
             ////////////////////////////////////////
             PopOpt StackPopMem (byte* Out, u16 Size) noexcept;
 
+            //////////////// NOTE: /////////////////
+            /// The unchecked variants below perform
+            /// no bounds checks at all. They are only
+            /// for callers which have already proven
+            /// that the Stack has room for the push,
+            /// or holds enough bytes for the pop,
+            /// such as an executor running a Function
+            /// whose Stack demand has been reserved.
+            /// Being inline, constant sized copies
+            /// compile down to a few moves.
+            ////////////////////////////////////////
+
+            /// @brief Pushes a 64-bit value to the Stack
+            /// without checking for overflow
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void   StackPush64Unchecked (u64 Data) noexcept
+                {
+                    *(u64*)( GetStackStart() + m_StackIDX ) = Data;
+                    m_StackIDX += sizeof(Data);
+                }
+            /// @brief Pushes an arbitrary amount of memory
+            /// to the Stack without checking for overflow
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void   StackPushMemUnchecked(const void* Data, u16 Size) noexcept
+                {
+                    std::memcpy(GetStackStart() + m_StackIDX, Data, Size);
+                    m_StackIDX += Size;
+                }
+            /// @brief Pops off a 64-bit value from the
+            /// Stack without checking for underflow
+            ////////////////////////////////////////
+            OctVM_SternInline
+            u64    StackPop64Unchecked  (void) noexcept
+                {
+                    m_StackIDX -= sizeof(u64);
+                    return *(u64*)( GetStackStart() + m_StackIDX );
+                }
+            /// @brief Pops off an arbitrary amount of memory
+            /// from the Stack without checking for underflow
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void   StackPopMemUnchecked (byte* Out, u16 Size) noexcept
+                {
+                    m_StackIDX -= Size;
+                    std::memcpy(Out, GetStackStart() + m_StackIDX, Size);
+                }
+            /// @brief Pushes Size bytes of memory to the Stack
+            /// without checking for overflow, but only copies the
+            /// 64-bit words whose bit is set in Mask. The others
+            /// are left as they were.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void   StackPushMaskedUnchecked(const void* Data, u16 Size,
+                                            u16 Mask) noexcept
+                {
+                    byte* Slots = GetStackStart() + m_StackIDX;
+                    for ( ; Mask; Mask &= (u16)( Mask - 1 ) ) {
+                        u32 i = (u32)__builtin_ctz(Mask) * sizeof(u64);
+                        std::memcpy(Slots + i, (const byte*)Data + i, sizeof(u64));
+                    }
+                    m_StackIDX += Size;
+                }
+            /// @brief Pops off Size bytes of memory from the Stack
+            /// without checking for underflow, but only copies the
+            /// 64-bit words whose bit is set in Mask into Out
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void   StackPopMaskedUnchecked (byte* Out, u16 Size,
+                                            u16 Mask) noexcept
+                {
+                    m_StackIDX -= Size;
+                    const byte* Slots = GetStackStart() + m_StackIDX;
+                    for ( ; Mask; Mask &= (u16)( Mask - 1 ) ) {
+                        u32 i = (u32)__builtin_ctz(Mask) * sizeof(u64);
+                        std::memcpy(Out + i, Slots + i, sizeof(u64));
+                    }
+                }
+
+            /// @return The byte offsets of the Stack's size, index
+            /// and address space within a `ThreadMemory`, for native
+            /// code pushing and popping without calling out
+            ////////////////////////////////////////
+            constexpr static OctVM_SternInline
+            u32 GetStackSizeOffset(void) noexcept
+                { return offsetof(ThreadMemory, m_StackSize); }
+            constexpr static OctVM_SternInline
+            u32 GetStackIDXOffset(void) noexcept
+                { return offsetof(ThreadMemory, m_StackIDX); }
+            constexpr static OctVM_SternInline
+            u32 GetRawSpaceOffset(void) noexcept
+                { return offsetof(ThreadMemory, m_RawSpace); }
 
             /// @return True if the Stack is valid
             /// and initialised
@@ -309,11 +416,16 @@ namespace Octane {
             /// and sets the current Frame to the newly
             /// allocated Frame. All subsequent 
             /// Local operations will act upon this Frame
+            /// @param Caller The `Function` performing the call,
+            /// or nullptr if this Frame is an entry Frame
+            /// @param ReturnIP The `Instruction` to resume at
+            /// in `Caller` once this Frame is dropped
             /// @return True if the Frame was created,
             /// otherwise False on failure due to
             /// insufficient memory in the Local Space
             ////////////////////////////////////////
-            bool LocalFrameNew      (void) noexcept;
+            bool LocalFrameNew      (Function*    Caller   = nullptr,
+                                     Instruction* ReturnIP = nullptr) noexcept;
             /// @brief Drops the current Local Frame,
             /// freeing all Local allocations from it,
             /// and setting the current Frame to the
@@ -344,6 +456,32 @@ namespace Octane {
             /// currently defined, a `nullptr` is returned.
             ////////////////////////////////////////
             byte*  LocalRequestBytes (u16 Size)   noexcept;
+            /// @brief Allocates Size bytes from the current
+            /// Frame at once, with a single bounds check, so that
+            /// a `Function` whose Local demand is known up front
+            /// can place its allocations at fixed offsets from
+            /// `LocalFrameData` without any further checks.
+            /// @param Size The amount of bytes to reserve
+            /// @return True if the bytes were reserved, otherwise
+            /// False if they would overflow the Local Space, in
+            /// which case nothing is reserved.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            bool  LocalFrameReserve(u32 Size) noexcept
+                {
+                    if ( GetLocalRemaining() < Size )
+                        return false;
+                    m_LocalIDX += Size;
+                    m_CurrentLocalFrame->Usage += Size;
+                    return true;
+                }
+            /// @return The start of the current Frame's
+            /// Address Space, just past its header. A
+            /// Frame must be defined.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            byte* LocalFrameData(void) const noexcept
+                { return (byte*)( m_CurrentLocalFrame + 1 ); }
             /// @brief Releases N-bytes from the Local
             /// Frame's Address Space
             /// @param Size The amount of bytes to free
@@ -373,6 +511,62 @@ namespace Octane {
             bool LocalValid(void) const noexcept
                 { return ( m_RawSpace && m_LocalSize > 0 
                            && m_CurrentLocalFrame ); }
+
+            /// @return The `Function` which created the current
+            /// Frame with a `call`, or nullptr if the current
+            /// Frame is an entry Frame or no Frame is defined.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            Function* LocalFrameCaller(void) const noexcept
+                { return ( m_CurrentLocalFrame ? 
+                           m_CurrentLocalFrame->Caller : nullptr ); }
+
+            /// @return The `Instruction` at which the caller
+            /// resumes once the current Frame is dropped, or
+            /// nullptr if no Frame is defined.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            Instruction* LocalFrameReturnIP(void) const noexcept
+                { return ( m_CurrentLocalFrame ? 
+                           m_CurrentLocalFrame->ReturnIP : nullptr ); }
+
+            /// @return The amount of bytes allocated from the
+            /// current Frame, or 0 if no Frame is defined.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            u32 LocalFrameUsage(void) const noexcept
+                { return ( m_CurrentLocalFrame ?
+                           m_CurrentLocalFrame->Usage : 0 ); }
+
+            /// @brief Hands the current Frame over to the native code
+            /// of Func, which never creates a Frame of its own. An
+            /// executor resuming Func from that code takes the Frame
+            /// over with `LocalFrameTakeOver` instead of creating one.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void LocalFrameHandOver(Function* Func) noexcept
+                { m_CurrentLocalFrame->HandedTo = Func; }
+
+            /// @return The `Function` the current Frame has been
+            /// handed over to, or nullptr if it has not been, or
+            /// no Frame is defined.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            Function* LocalFrameHandedTo(void) const noexcept
+                { return ( m_CurrentLocalFrame ?
+                           m_CurrentLocalFrame->HandedTo : nullptr ); }
+
+            /// @brief Turns a Frame which has been handed over into an
+            /// entry Frame of the executor taking it over, keeping all
+            /// of its Local allocations
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void LocalFrameTakeOver(void) noexcept
+                {
+                    m_CurrentLocalFrame->HandedTo = nullptr;
+                    m_CurrentLocalFrame->Caller   = nullptr;
+                    m_CurrentLocalFrame->ReturnIP = nullptr;
+                }
         /// CLEARING:
         ////////////////////////////////////////
             /// @brief Resets the Stack and clears
@@ -409,7 +603,7 @@ namespace Octane {
             /// bytes left in the Local Space
             ////////////////////////////////////////
             constexpr OctVM_SternInline
-            u16 GetLocalRemaining(void) const noexcept
+            u32 GetLocalRemaining(void) const noexcept
                 { return m_LocalSize - m_LocalIDX; }
 
             /// @return Returns the total size in bytes
@@ -423,7 +617,7 @@ namespace Octane {
             /// of the Local Space's reserved allocation
             ////////////////////////////////////////
             constexpr OctVM_SternInline
-            u16 GetLocalSize(void) const noexcept
+            u32 GetLocalSize(void) const noexcept
                 { return m_LocalSize; }
 
             /// @return Returns the amount of bytes
@@ -445,7 +639,7 @@ namespace Octane {
             /// last requested byte is stored
             ////////////////////////////////////////
             constexpr OctVM_SternInline
-            u16 GetLocalUsage(void) const noexcept
+            u32 GetLocalUsage(void) const noexcept
                 { return m_LocalIDX; }
 
             /// @return Returns a pointer denoting
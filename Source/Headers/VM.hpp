@@ -0,0 +1,221 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_VM_HPP
+#define OCTVM_VM_HPP 1
+
+#include "Common.hpp"
+#include "CodeCache.hpp"
+#include "Exceptions.hpp"
+#include "Executor.hpp"
+#include "Functions.hpp"
+
+namespace Octane {
+
+    /// @brief Decides when a VM `Function` moves up a
+    /// `FunctionTier`. Every invocation of a `Function`,
+    /// and every backward jump it takes, counts as one event.
+    ////////////////////////////////////////
+    struct TierPolicy {
+        /// The events after which a COLD `Function` is optimised
+        /// into WARM. If 0, every `Function` starts out WARM.
+        u32 WarmThreshold = 64;
+        /// The events after which a WARM `Function` is handed
+        /// to the VM's `TierCompiler`, counted from its first run.
+        u32 HotThreshold  = 100000;
+    };
+
+    /// @brief A compiler tier for HOT `Function`s. Called by
+    /// the executor mid-run, so only the VM, Allocator and
+    /// Storage of the `ExecState` may be relied upon.
+    ///
+    /// The third parameter is the `Instruction` the native
+    /// code starts at: 0 for the `Function`'s entry point, or
+    /// the target of a backward jump, when the executor moves
+    /// an activation still inside that loop into native code
+    /// through on-stack replacement. Code entered there reads
+    /// the register file from `ExecState::Reg`, as it would at
+    /// the start, and runs in the Local Frame of the activation.
+    ///
+    /// Code mapped through `MapJITCode` is held by the VM's
+    /// `CodeCache`, which may evict it whenever another
+    /// `Function` is compiled, moving its `Function` back
+    /// into WARM.
+    /// @return A native entry point which executes the whole
+    /// `Function` from that `Instruction`, managing its own
+    /// Local Frame, or nullptr to keep the `Function` WARM
+    /// for now.
+    ////////////////////////////////////////
+    using TierCompiler = ExposedFunc(*)(Function&, ExecState&, u32);
+
+    /// @brief The per-instance configuration of
+    /// an OctaneVM. Every `ExecState` refers back
+    /// to the VM it runs under, which decides how
+    /// `Exception`s are handled and how bytecode
+    /// is dispatched.
+    ////////////////////////////////////////
+    class VM {
+        public:
+            /// The amount of native routines that can be
+            /// registered for use with `corecall`.
+            static constexpr const u16 CORECALL_COUNT = 64;
+        private:
+            /// Called whenever an executor raises an `Exception`.
+            /// If nullptr, every `Exception` is treated as `FATAL`.
+            Exception::HandlerFunc m_ExceptionHandler = nullptr;
+            /// The dispatch strategy used by `Octane::Execute`
+            DispatchMode           m_DispatchMode     = DispatchMode::THREADED;
+            /// Whether `OptimiseBytecode` runs on newly verified `Function`s
+            bool                   m_OptimiseBytecode = false;
+            /// Native routines reachable through `corecall`
+            ExposedFunc            m_CoreCalls[CORECALL_COUNT] = {};
+            /// When `Function`s move up a tier
+            TierPolicy             m_TierPolicy       = {};
+            /// Compiles HOT `Function`s, if assigned
+            TierCompiler           m_TierCompiler     = nullptr;
+            /// Holds the code of every compiled `Function`
+            CodeCache              m_CodeCache;
+        public:
+        /// EXCEPTIONS:
+        ////////////////////////////////////////
+
+            /// @brief Assigns the handler which is called
+            /// whenever an executor raises an `Exception`.
+            /// @param Handler The handler, or nullptr to treat
+            /// every `Exception` as `FATAL`.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void SetExceptionHandler(Exception::HandlerFunc Handler) noexcept
+                { m_ExceptionHandler = Handler; }
+
+            /// @return The current `Exception` handler, or
+            /// nullptr if none has been assigned.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            Exception::HandlerFunc GetExceptionHandler(void) const noexcept
+                { return m_ExceptionHandler; }
+
+        /// EXECUTION:
+        ////////////////////////////////////////
+
+            /// @brief Selects the dispatch strategy used
+            /// by `Octane::Execute`.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void SetDispatchMode(DispatchMode Mode) noexcept
+                { m_DispatchMode = Mode; }
+
+            /// @return The dispatch strategy used by
+            /// `Octane::Execute`.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            DispatchMode GetDispatchMode(void) const noexcept
+                { return m_DispatchMode; }
+
+            /// @brief Runs `OptimiseBytecode` on every `Function`
+            /// once it has passed verification, before its first
+            /// run decodes it. `Function`s which have already run
+            /// keep their Code Space as it is.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void SetBytecodeOptimisation(bool Enabled) noexcept
+                { m_OptimiseBytecode = Enabled; }
+
+            /// @return True if `Function`s are passed through
+            /// `OptimiseBytecode` before their first run.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            bool GetBytecodeOptimisation(void) const noexcept
+                { return m_OptimiseBytecode; }
+
+            /// @brief Registers a native routine for use
+            /// with the `corecall` instruction.
+            /// @param IDX The immediate used by `corecall`
+            /// @param CFunc The routine, or nullptr to unassign
+            /// @return False if the index is out of range.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            bool AssignCoreCall(u16 IDX, ExposedFunc CFunc) noexcept
+                {
+                    if ( IDX >= CORECALL_COUNT )
+                        return false;
+                    m_CoreCalls[IDX] = CFunc;
+                    return true;
+                }
+
+            /// @return The native routine registered at the given
+            /// index, or nullptr if none is assigned.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            ExposedFunc GetCoreCall(u16 IDX) const noexcept
+                { return ( IDX < CORECALL_COUNT ? m_CoreCalls[IDX] : nullptr ); }
+
+        /// TIERING:
+        ////////////////////////////////////////
+
+            /// @brief Assigns the thresholds at which `Function`s
+            /// move up a tier. Only `Function`s which have not run
+            /// yet, or which reach their next tier, see the change.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void SetTierPolicy(const TierPolicy& Policy) noexcept
+                { m_TierPolicy = Policy; }
+
+            /// @return The thresholds at which `Function`s
+            /// move up a tier.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            const TierPolicy& GetTierPolicy(void) const noexcept
+                { return m_TierPolicy; }
+
+            /// @brief Assigns the compiler tier which HOT
+            /// `Function`s are handed to.
+            /// @param Compiler The compiler, or nullptr to
+            /// keep every `Function` at most WARM.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            void SetTierCompiler(TierCompiler Compiler) noexcept
+                { m_TierCompiler = Compiler; }
+
+            /// @return The compiler tier, or nullptr
+            /// if none has been assigned.
+            ////////////////////////////////////////
+            constexpr OctVM_SternInline
+            TierCompiler GetTierCompiler(void) const noexcept
+                { return m_TierCompiler; }
+
+            /// @return The `CodeCache` holding the code of every
+            /// `Function` compiled under this VM, which bounds
+            /// its size and keeps its statistics. It is not
+            /// synchronised, so only one thread may execute
+            /// under this VM at a time.
+            ////////////////////////////////////////
+            OctVM_SternInline
+            CodeCache& GetCodeCache(void) noexcept
+                { return m_CodeCache; }
+    };
+
+}
+
+#endif /* !OCTVM_VM_HPP */
@@ -47,7 +47,7 @@ namespace Octane {
                 static constexpr byte UNUSED = 0xFF;
                 MemoryAddress AsPtr;
                 u64           AsU64;
-                u64           AsI64;
+                i64           AsI64;
                 f32           AsF32;
                 f64           AsF64;
             };
@@ -63,6 +63,14 @@ namespace Octane {
 
 /// EXECSTATE:
 ////////////////////////////////////////
+    /// @brief The architectural state of a
+    /// running `Function`. Executors only
+    /// guarantee that `IP`, `Reg` and
+    /// `CurrentFunc` are up to date when
+    /// control leaves them, such as when
+    /// raising an `Exception` or entering
+    /// an `ExposedFunc`.
+    ////////////////////////////////////////
     struct ExecState {
         VM&              VMInstance;
         Instruction*     IP; 
@@ -71,7 +79,7 @@ namespace Octane {
         ThreadMemory&    ThreadMemory;
         CoreAllocator&   Allocator;
         StorageDevice&   Storage;
-        Function&        CurrentFunc;
+        Function*        CurrentFunc;
     };
 
 }
@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCTVM_VERIFIER_HPP
+#define OCTVM_VERIFIER_HPP 1
+
+#include "Common.hpp"
+#include "Exceptions.hpp"
+
+namespace Octane {
+
+    class Function;
+
+    /// @brief The result of `VerifyFunction`
+    ////////////////////////////////////////
+    struct VerifyResult {
+        /// The first `Exception` found,
+        /// or `Exception::None` if verified.
+        Exception::ID Fault;
+        /// The index of the offending `Instruction`
+        u32           Offset;
+    };
+
+    /// @brief Statically evaluates the Code Space of a VM
+    /// `Function`, walking it `Instruction` by `Instruction`.
+    /// A Function passes verification if:
+    ///
+    /// **A:** Every Opcode is known, and every multi-word
+    ///    `Instruction` fits inside the Code Space.
+    ///
+    /// **B:** Every u8 register index is below
+    ///    `VPCore::Register::COUNT`.
+    ///
+    /// **C:** Every `jmp`, `seek` and conditional jump
+    ///    target lies inside the Code Space, on the first
+    ///    word of an `Instruction`.
+    ///
+    /// **D:** Every `call` whose `RelocationTable` entry is
+    ///    already bound to a `Function` agrees with its
+    ///    `CallingConvention`. Otherwise the `call` would
+    ///    raise `InvalidSymbol` when its site links.
+    ///
+    /// Verified Functions are decoded into handlers that
+    /// perform none of the checks of A to C at runtime.
+    /// @param Func The `Function` to verify
+    /// @return The first `Exception` found, if any.
+    ////////////////////////////////////////
+    extern VerifyResult VerifyFunction(const Function& Func) noexcept;
+
+}
+
+#endif /* !OCTVM_VERIFIER_HPP */
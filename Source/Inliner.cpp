@@ -0,0 +1,238 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#define OCTVM_INTERNAL 1
+
+#include "Headers/Inliner.hpp"
+#include "Headers/Verifier.hpp"
+#include "Headers/Functions.hpp"
+
+namespace Octane {
+
+    /// @brief Returns true if an `Instruction` behaves the
+    /// same in any `Function` and any Local Frame
+    ////////////////////////////////////////
+    static bool IsInlinable(const Instruction& Ins) noexcept
+    {
+        switch ( Ins.Any.Op ) {
+            case Instruction::call:      case Instruction::corecall:
+            case Instruction::spawn:     case Instruction::spawnanon:
+            case Instruction::merge:     case Instruction::muop:
+            case Instruction::cvop:      case Instruction::eload:
+            case Instruction::offset:    case Instruction::requestlocal:
+            case Instruction::droplocal:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    /// @brief Returns the amount of words of Callee copied into
+    /// a caller, which is all of them bar a final `ret`
+    /// @return False if Callee cannot be inlined.
+    ////////////////////////////////////////
+    static bool GetInlineBody(const Function& Callee,
+                              const InlinePolicy& Policy, u32& Body) noexcept
+    {
+        const Instruction* Code  = Callee.GetCodeSpace();
+        u32                Count = Callee.GetInstructionCount();
+        Body = 0;
+        if ( !Callee.IsVMFunc() )
+            return false;
+        // Empty bytecode Functions return immediately
+        if ( !Code )
+            return true;
+        if ( VerifyFunction(Callee).Fault != Exception::None )
+            return false;
+
+        u32 Last = 0;
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            if ( !IsInlinable(Code[i]) )
+                return false;
+            Last = i;
+        }
+        Body = ( Code[Last].Any.Op == Instruction::ret ? Last : Count );
+        return ( Body <= Policy.MaxCalleeCount );
+    }
+
+    /// @brief Resolves the `Function` a `call` in Caller
+    /// links to, if it may be inlined
+    ////////////////////////////////////////
+    static Function* ResolveCallee(const Function& Caller,
+                                   const Instruction& Ins) noexcept
+    {
+        RelocationTable* Reloc = Caller.GetRelocTable();
+        Symbol* Sym = ( Reloc ? Reloc->RetrieveIDX(Ins.Imm16.Imm) : nullptr );
+        if ( !Sym || Sym->Type != SymbolType::FUNC || !Sym->Value )
+            return nullptr;
+        Function* Callee = Sym->CastValue<Function>();
+        if ( Callee == &Caller
+          || Callee->GetCallingConvention()
+             != Reloc->RetrieveIDXConvention(Ins.Imm16.Imm) )
+            return nullptr;
+        return Callee;
+    }
+
+    /// @brief Inlines every small enough callee of Caller,
+    /// as long as it stays within `InlinePolicy::MaxCallerCount`
+    /// @return The amount of `call` sites inlined
+    ////////////////////////////////////////
+    static u32 InlineCalls(Function& Caller, CoreAllocator& Allocator,
+                           const InlinePolicy& Policy) noexcept
+    {
+        const Instruction* Code  = Caller.GetCodeSpace();
+        u32                Count = Caller.GetInstructionCount();
+        if ( !Code || Caller.GetDecoded() || !Caller.GetRelocTable()
+          || VerifyFunction(Caller).Fault != Exception::None )
+            return 0;
+        // Inlined calls could not raise `LocalOutOfMemory` where
+        // the caller itself has filled the Local Space
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) )
+            if ( Code[i].Any.Op == Instruction::requestlocal )
+                return 0;
+
+        // The callee and body size of every inlined site,
+        // and where every `Instruction` of Caller moves to
+        Function** Callees = Allocator.Request<Function*>(Count, SYSTEM_ALLOC_FLAGS);
+        u16*       Bodies  = Allocator.Request<u16>(Count, SYSTEM_ALLOC_FLAGS);
+        u16*       Map     = Allocator.Request<u16>(Count + 1, SYSTEM_ALLOC_FLAGS);
+        auto Cleanup = [&]() {
+            Allocator.Release(Callees);
+            Allocator.Release(Bodies);
+            Allocator.Release(Map);
+        };
+        if ( !Callees || !Bodies || !Map ) {
+            Cleanup();
+            return 0;
+        }
+
+        u32 Limit = Policy.MaxCallerCount;
+        u32 Total = Count;
+        u32 Sites = 0;
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            Callees[i] = nullptr;
+            if ( Code[i].Any.Op != Instruction::call )
+                continue;
+            Function* Callee = ResolveCallee(Caller, Code[i]);
+            u32       Body   = 0;
+            if ( !Callee || !GetInlineBody(*Callee, Policy, Body)
+              || Total - 1 + Body > Limit )
+                continue;
+            Callee->MarkLinked();
+            Callees[i] = Callee;
+            Bodies[i]  = (u16)Body;
+            Total      = Total - 1 + Body;
+            Sites++;
+        }
+        // Everything but empty callees leaves at least one `Instruction`
+        if ( !Sites || !Total ) {
+            Cleanup();
+            return 0;
+        }
+
+        Instruction*  Out     = Allocator.Request<Instruction>(Total, SYSTEM_ALLOC_FLAGS);
+        InlineOrigin* Origins = Allocator.Request<InlineOrigin>(Total, SYSTEM_ALLOC_FLAGS);
+        if ( !Out || !Origins ) {
+            Allocator.Release(Out);
+            Allocator.Release(Origins);
+            Cleanup();
+            return 0;
+        }
+
+        // Copies every `Instruction`, pointing the jumps of
+        // each callee at their new place as they are copied
+        const InlineOrigin* Known = Caller.GetInlineOrigins();
+        u32 At = 0;
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            Map[i] = (u16)At;
+            if ( !Callees[i] ) {
+                for ( u8 w = 0; w < Instruction::GetWordCount(Code[i].Any.Op); w++ ) {
+                    Out[At]     = Code[i + w];
+                    Origins[At] = ( Known ? Known[i + w] : InlineOrigin{ nullptr, 0 } );
+                    At++;
+                }
+                continue;
+            }
+
+            const Function&    Callee = *Callees[i];
+            const Instruction* Body   = Callee.GetCodeSpace();
+            u32                Base   = At;
+            u32                End    = Base + Bodies[i];
+            for ( u32 j = 0; j < Bodies[i]; j++ ) {
+                // Callees inlined into others keep their first origin
+                const InlineOrigin* Origin = Callee.GetInlineOrigin(j);
+                Out[Base + j]     = Body[j];
+                Origins[Base + j] = ( Origin ? *Origin
+                                             : InlineOrigin{ Callees[i], (u16)j } );
+            }
+            for ( u32 j = 0; j < Bodies[i];
+                  j += Instruction::GetWordCount(Body[j].Any.Op) ) {
+                i32 Target = 0;
+                if ( Body[j].Any.Op == Instruction::ret )
+                    Out[Base + j] = Instruction::MakeImm16(Instruction::jmp, 0,
+                                                           (u16)End);
+                else if ( Instruction::GetJumpTarget(Body[j], j, Target) )
+                    Instruction::SetJumpTarget(Out[Base + j], Base + j,
+                        ( (u32)Target < Bodies[i] ? Base + (u32)Target : End ));
+            }
+            At = End;
+        }
+        Map[Count] = (u16)At;
+
+        // Then points the jumps of Caller at where
+        // their targets have moved
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            i32 Target = 0;
+            if ( !Callees[i] && Instruction::GetJumpTarget(Code[i], i, Target) )
+                Instruction::SetJumpTarget(Out[Map[i]], Map[i], Map[Target]);
+        }
+
+        if ( Caller.ReplaceCodeSpace(Allocator, Out, (u16)Total, Origins)
+             != MEMORY_OK )
+            Sites = 0;
+        Allocator.Release(Out);
+        Cleanup();
+        return Sites;
+    }
+
+    /// INLINEMODULE:
+    ////////////////////////////////////////
+    u32 InlineModule(Function* const* Module, u32 Count,
+                     CoreAllocator& Allocator,
+                     const InlinePolicy& Policy) noexcept
+    {
+        u32 Inlined = 0;
+        for ( u32 Round = 0; Round < Count; Round++ ) {
+            u32 Sites = 0;
+            for ( u32 i = 0; i < Count; i++ )
+                if ( Module[i] )
+                    Sites += InlineCalls(*Module[i], Allocator, Policy);
+            if ( !Sites )
+                break;
+            Inlined += Sites;
+        }
+        return Inlined;
+    }
+
+}
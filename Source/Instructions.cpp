@@ -189,4 +189,122 @@ namespace Octane {
         return OpcodeNames[ID];
     }
 
-}
+    Instruction::Layout Instruction::GetLayout(u8 ID) noexcept
+    {
+        switch ( ID ) {
+            case jmp:
+                return Layout::JUMP;
+            case seek:
+                return Layout::SEEK;
+
+            case chrono:  case clr:
+            case pushreg: case pusharg:
+            case popreg:  case poparg:
+            case releasebytes: case droplocal:
+            case inc:     case dec:
+                return Layout::ONE;
+
+            case jmpis0:  case jmpnot0:
+            case movimm:  case pushmem:
+            case popmem:  case offset:
+            case requestlocal: case eload:
+            case bnotimm:
+                return Layout::IMM16;
+
+            case movimm32: case movimmf:
+                return Layout::IMM32;
+            case movimm64: case movimmd:
+                return Layout::IMM64;
+
+            case mov:     case requestbytes:
+            case p2g:     case cmpis0:
+            case cmpnot0: case lnot:
+            case i2f:     case u2f:
+            case i2d:     case u2d:
+            case f2i:     case f2u:
+            case f2d:     case d2i:
+            case d2u:     case d2f:
+            case sqrt:    case sqrtf:
+            case sqrtd:   case bnot:
+                return Layout::DUAL;
+
+            case jmpeq:   case jmpneq:
+            case jmplt:   case jmpgt:
+            case jmplteq: case jmpgteq:
+            case addimm:  case subimm:
+            case mulimm:  case divimm:
+            case modimm:  case bandimm:
+            case borimm:  case bxorimm:
+            case shlimm:  case shrimm:
+                return Layout::ALT;
+            case idivimm: case imodimm:
+                return Layout::ALT_SIGNED;
+
+            case gload8:  case gload16:
+            case gload32: case gload64:
+            case gsave8:  case gsave16:
+            case gsave32: case gsave64:
+                return Layout::MEM;
+
+            case pload8:  case pload16:
+            case pload32: case pload64:
+            case psave8:  case psave16:
+            case psave32: case psave64:
+                return Layout::PRIV;
+
+            case memset:  case memcpy:
+                return Layout::TRI;
+
+            default:
+                // Every other Opcode with operands is
+                // a three register Opcode
+                if ( ID >= cmpeq && ID < COUNT_OF_INSTRUCTIONS )
+                    return Layout::TRI;
+                return Layout::NONE;
+        }
+    }
+
+    bool Instruction::GetJumpTarget(const Instruction& Ins, u32 IDX,
+                                    i32& Target) noexcept
+    {
+        switch ( Ins.Any.Op ) {
+            case seek:
+                Target = (i32)IDX + (i16)Ins.Imm16.Imm;
+                return true;
+            case jmp:
+            case jmpis0:  case jmpnot0:
+                Target = Ins.Imm16.Imm;
+                return true;
+            case jmpeq:   case jmpneq:
+            case jmplt:   case jmpgt:
+            case jmplteq: case jmpgteq:
+                Target = Ins.Imm16Alt.Imm;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void Instruction::SetJumpTarget(Instruction& Ins, u32 IDX,
+                                    u32 Target) noexcept
+    {
+        switch ( Ins.Any.Op ) {
+            case seek: {
+                i32 Distance = (i32)Target - (i32)IDX;
+                if ( Distance >= INT16_MIN && Distance <= INT16_MAX )
+                    Ins.Imm16.Imm = (u16)(i16)Distance;
+                else
+                    Ins = MakeImm16(jmp, 0, (u16)Target);
+                break;
+            }
+            case jmp:
+            case jmpis0:  case jmpnot0:
+                Ins.Imm16.Imm = (u16)Target;
+                break;
+            default:
+                Ins.Imm16Alt.Imm = (u16)Target;
+                break;
+        }
+    }
+
+}
\ No newline at end of file
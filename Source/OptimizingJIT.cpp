@@ -0,0 +1,1696 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+#define OCTVM_INTERNAL 1
+
+#include "Headers/Decoder.hpp"
+#include "Headers/Functions.hpp"
+#include "Headers/OptimizingJIT.hpp"
+#include "Headers/SSA.hpp"
+
+namespace Octane {
+
+    using HandlerResult = Exception::HandlerResult;
+    using Register      = VPCore::Register;
+
+#if OCTVM_TEMPLATE_JIT
+
+    //////////////// NOTE: /////////////////
+    /// Compiled code keeps the `ExecState*`
+    /// in r12 for its whole run. rax, rcx,
+    /// rdx, xmm14 and xmm15 are scratch
+    /// within the lowering of a single
+    /// value. Every other register is handed
+    /// out by the allocator, and values it
+    /// runs out of registers for live in a
+    /// slot of the stack frame instead.
+    ///
+    /// Each value keeps a single location
+    /// for its whole live range, which spans
+    /// every position it may be read at.
+    /// Floating point constants are read
+    /// from a pool following the code.
+    ////////////////////////////////////////
+
+    /// @brief Functions larger than this are left to
+    /// the template JIT, as liveness grows quadratically
+    ////////////////////////////////////////
+    static constexpr const u32 MAX_OPTIMISED_COUNT = 4096;
+
+    /// @brief Functions deoptimised this often are no
+    /// longer compiled with their globals speculated on,
+    /// and are left to the template JIT instead
+    ////////////////////////////////////////
+    static constexpr const u32 MAX_DEOPT_COUNT = 4;
+
+    /// x86-64 register numbers
+    enum : u8 {
+        RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+        R8, R9, R10, R11, R12, R13, R14, R15,
+    };
+    enum : u8 { XMM14 = 14, XMM15 = 15 };
+
+    /// x86 condition codes
+    enum : u8 {
+        CC_P = 0xA, CC_B = 0x2, CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5,
+        CC_BE = 0x6, CC_A = 0x7, CC_L = 0xC, CC_GE = 0xD, CC_LE = 0xE,
+        CC_G = 0xF,
+    };
+
+    /// The registers handed out to values, in order of preference
+    static const u8 GPR_POOL[] = {
+        RSI, RDI, R8, R9, R10, R11, RBX, RBP, R13, R14, R15,
+    };
+    static constexpr const u32 GPR_POOL_SIZE = sizeof(GPR_POOL);
+    /// xmm0 through xmm13
+    static constexpr const u32 XMM_POOL_SIZE = 14;
+
+    /// @brief Where a value lives throughout its live range
+    ////////////////////////////////////////
+    enum class LocationKind : u8 {
+        /// The value is never read
+        NONE,
+        GPR, XMM,
+        /// [Reg + Disp], a slot of the frame when Reg is rsp
+        MEMORY,
+        /// Rematerialised from `Imm` at each use
+        CONSTANT,
+    };
+
+    struct Location {
+        LocationKind Kind;
+        u8           Reg;
+        i32          Disp;
+        u64          Imm;
+    };
+
+    static OctVM_SternInline
+    Location MakeLocation(LocationKind Kind, u8 Reg, i32 Disp = 0,
+                          u64 Imm = 0) noexcept
+        { return { Kind, Reg, Disp, Imm }; }
+
+    /// EMITTER:
+    ////////////////////////////////////////
+
+    /// @brief Writes machine code into Code, or only counts
+    /// its size while Code is nullptr. Every jump is a rel32,
+    /// so that both passes produce the same offsets.
+    ////////////////////////////////////////
+    struct Emitter {
+        byte* Code;
+        u32   Offset;
+    };
+
+    static OctVM_SternInline
+    void Emit8(Emitter& E, u8 Value) noexcept
+    {
+        if ( E.Code )
+            E.Code[E.Offset] = Value;
+        E.Offset++;
+    }
+
+    static void Emit32(Emitter& E, u32 Value) noexcept
+    {
+        for ( u32 i = 0; i < 4; i++ )
+            Emit8(E, (u8)( Value >> ( i * 8 ) ));
+    }
+
+    static void Emit64(Emitter& E, u64 Value) noexcept
+    {
+        for ( u32 i = 0; i < 8; i++ )
+            Emit8(E, (u8)( Value >> ( i * 8 ) ));
+    }
+
+    /// @brief Emits a one byte opcode, or a 0x0F-escaped one
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    void EmitOpcode(Emitter& E, u32 Opcode) noexcept
+    {
+        if ( Opcode > 0xFF )
+            Emit8(E, (u8)( Opcode >> 8 ));
+        Emit8(E, (u8)Opcode);
+    }
+
+    static void EmitRex(Emitter& E, bool W, u8 Reg, u8 RM) noexcept
+    {
+        u8 Rex = (u8)( 0x40 | ( W << 3 ) | ( ( Reg >> 3 ) << 2 ) | ( RM >> 3 ) );
+        if ( Rex != 0x40 )
+            Emit8(E, Rex);
+    }
+
+    /// @brief Emits [Prefix] [REX] Opcode ModRM, with RM
+    /// naming a register. Reg may be an opcode extension.
+    ////////////////////////////////////////
+    static void EmitRR(Emitter& E, u8 Prefix, bool W, u32 Opcode,
+                       u8 Reg, u8 RM) noexcept
+    {
+        if ( Prefix )
+            Emit8(E, Prefix);
+        EmitRex(E, W, Reg, RM);
+        EmitOpcode(E, Opcode);
+        Emit8(E, (u8)( 0xC0 | ( ( Reg & 7 ) << 3 ) | ( RM & 7 ) ));
+    }
+
+    /// @brief Emits [Prefix] [REX] Opcode ModRM, with RM
+    /// naming [Base + disp32]
+    ////////////////////////////////////////
+    static void EmitRM(Emitter& E, u8 Prefix, bool W, u32 Opcode,
+                       u8 Reg, u8 Base, i32 Disp) noexcept
+    {
+        if ( Prefix )
+            Emit8(E, Prefix);
+        EmitRex(E, W, Reg, Base);
+        EmitOpcode(E, Opcode);
+        Emit8(E, (u8)( 0x80 | ( ( Reg & 7 ) << 3 ) | ( Base & 7 ) ));
+        if ( ( Base & 7 ) == RSP )
+            Emit8(E, 0x24);
+        Emit32(E, (u32)Disp);
+    }
+
+    /// @brief Emits a jump opcode followed by the rel32 to Target
+    ////////////////////////////////////////
+    static void EmitJump(Emitter& E, u32 Opcode, u32 Target) noexcept
+    {
+        EmitOpcode(E, Opcode);
+        Emit32(E, Target - ( E.Offset + 4 ));
+    }
+
+    static OctVM_SternInline
+    bool IsImm32(u64 Imm) noexcept
+        { return ( (i64)Imm == (i64)(i32)Imm ); }
+
+    static void EmitMoveImm(Emitter& E, u8 Reg, u64 Imm) noexcept
+    {
+        if ( Imm <= UINT32_MAX ) {
+            // mov r32, imm32 zero-extends
+            EmitRex(E, false, 0, Reg);
+            Emit8(E, (u8)( 0xB8 + ( Reg & 7 ) ));
+            Emit32(E, (u32)Imm);
+        }
+        else if ( IsImm32(Imm) ) {
+            EmitRR(E, 0, true, 0xC7, 0, Reg);
+            Emit32(E, (u32)Imm);
+        }
+        else {
+            EmitRex(E, true, 0, Reg);
+            Emit8(E, (u8)( 0xB8 + ( Reg & 7 ) ));
+            Emit64(E, Imm);
+        }
+    }
+
+    /// push rbx; push rbp; push r12; push r13; push r14; push r15
+    static const u8 SAVE_REGISTERS[] = {
+        0x53, 0x55, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57,
+    };
+    /// pop r15; pop r14; pop r13; pop r12; pop rbp; pop rbx
+    static const u8 RESTORE_REGISTERS[] = {
+        0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5D, 0x5B,
+    };
+
+    /// SPECULATION:
+    ////////////////////////////////////////
+
+    /// @brief A DATA `Symbol` whose Value compiled code has baked in
+    ////////////////////////////////////////
+    struct SpeculatedGlobal {
+        const void* Key;
+        byte*       Value;
+        /// The contents of Key that Value was resolved from
+        char        KeyCopy[GLOBAL_CACHE_KEY_SIZE];
+        /// Some `SSA_GADDR` has Key as a constant, and so
+        /// leaves it to the entry check
+        bool        Constant;
+    };
+
+    /// @brief Every global a piece of compiled code speculates on.
+    /// Checked on entry against the generation of the
+    /// `StorageDevice`, which compiled code never changes, and
+    /// against the contents of its constant keys. Lives as
+    /// long as the code, in the same allocation as its `Globals`.
+    ////////////////////////////////////////
+    struct GlobalSpeculation {
+        /// The generation all of `Globals` were last known
+        /// to still resolve to their Value at
+        u32               Generation;
+        u32               Count;
+        SpeculatedGlobal* Globals;
+    };
+
+    /// @brief Looks Key up as a DATA `Symbol`
+    /// @return Its Value, or nullptr if there is no such `Symbol`.
+    ////////////////////////////////////////
+    static byte* ResolveGlobal(StorageDevice& Storage, const void* Key) noexcept
+    {
+        Symbol* Sym = Storage.LookupSymbol((const char*)Key);
+        if ( !Sym || Sym->Type != SymbolType::DATA )
+            return nullptr;
+        return Sym->CastValue<byte>();
+    }
+
+    /// @brief Called by compiled code entered at a generation other
+    /// than the one its speculation was last checked at. Unrelated
+    /// `Symbol`s being assigned, or any `Function` tiering up, only
+    /// cost a lookup per global, rather than the compiled code.
+    /// @return True if every global still has the same key,
+    /// and resolves to its Value.
+    ////////////////////////////////////////
+    static bool JITRevalidate(ExecState* State, GlobalSpeculation* Table) noexcept
+    {
+        for ( u32 i = 0; i < Table->Count; i++ )
+            if ( !QuickStrCmp(Table->Globals[i].KeyCopy,
+                              (const char*)Table->Globals[i].Key)
+                 || ResolveGlobal(State->Storage, Table->Globals[i].Key)
+                    != Table->Globals[i].Value )
+                return false;
+        Table->Generation = State->Storage.GetGeneration();
+        return true;
+    }
+
+    /// @brief Returns the key an `SSA_GADDR` is compiled for
+    ////////////////////////////////////////
+    static const void* GetSpeculatedKey(const SSAGraph& Graph, u32 Value) noexcept
+    {
+        const SSAValue& Key = Graph.Values[Graph.Values[Value].Args[0]];
+        if ( Key.Op == SSA_CONST )
+            return (const void*)Key.Imm;
+        return ( (const GlobalCache*)Graph.Values[Value].Imm )->Key;
+    }
+
+    /// @brief Resolves every global the live `SSA_GADDR`s of
+    /// a graph access, for their Values to be baked into code.
+    /// @param Table Receives the speculation, or nullptr if
+    /// the graph accesses no globals
+    /// @return False if a global does not resolve, its key
+    /// is too long to be checked, Func has been deoptimised
+    /// too often, or memory ran out.
+    ////////////////////////////////////////
+    static bool SpeculateGlobals(const SSAGraph& Graph, const Function& Func,
+                                 ExecState& State,
+                                 GlobalSpeculation*& Table) noexcept
+    {
+        u32 Count = 0;
+        Table = nullptr;
+        for ( u32 i = 0; i < Graph.OrderCount; i++ )
+            for ( u32 Value = Graph.Blocks[Graph.Order[i]].First;
+                  Value != SSA_NONE; Value = Graph.Values[Value].Next )
+                if ( Graph.Values[Value].Op == SSA_GADDR )
+                    Count++;
+        if ( !Count )
+            return true;
+        if ( Func.GetDeoptCount() >= MAX_DEOPT_COUNT )
+            return false;
+
+        byte* Memory = State.Allocator.Request<byte>(
+            sizeof(GlobalSpeculation) + Count * sizeof(SpeculatedGlobal),
+            SYSTEM_ALLOC_FLAGS);
+        if ( !Memory )
+            return false;
+        Table = (GlobalSpeculation*)Memory;
+        Table->Generation = State.Storage.GetGeneration();
+        Table->Count      = 0;
+        Table->Globals    = (SpeculatedGlobal*)( Table + 1 );
+
+        for ( u32 i = 0; i < Graph.OrderCount; i++ )
+            for ( u32 Value = Graph.Blocks[Graph.Order[i]].First;
+                  Value != SSA_NONE; Value = Graph.Values[Value].Next ) {
+                if ( Graph.Values[Value].Op != SSA_GADDR )
+                    continue;
+                const void* Key = GetSpeculatedKey(Graph, Value);
+                bool Constant = ( Graph.Values[Graph.Values[Value].Args[0]].Op
+                                  == SSA_CONST );
+                u32 k = 0;
+                while ( k < Table->Count && Table->Globals[k].Key != Key )
+                    k++;
+                if ( k < Table->Count ) {
+                    Table->Globals[k].Constant |= Constant;
+                    continue;
+                }
+                byte* Resolved = ResolveGlobal(State.Storage, Key);
+                u32   Len      = QuickStrLen((const char*)Key) + 1;
+                if ( !Resolved || Len > GLOBAL_CACHE_KEY_SIZE ) {
+                    State.Allocator.Release(Memory);
+                    Table = nullptr;
+                    return false;
+                }
+                SpeculatedGlobal& Global = Table->Globals[Table->Count++];
+                Global.Key      = Key;
+                Global.Value    = Resolved;
+                Global.Constant = Constant;
+                QuickCopy(Key, Global.KeyCopy, Len);
+            }
+        return true;
+    }
+
+    /// @return The global speculated for Key
+    ////////////////////////////////////////
+    static const SpeculatedGlobal&
+    GetSpeculatedGlobal(const GlobalSpeculation* Table, const void* Key) noexcept
+    {
+        u32 k = 0;
+        while ( Table->Globals[k].Key != Key )
+            k++;
+        return Table->Globals[k];
+    }
+
+    /// LOWERING:
+    ////////////////////////////////////////
+
+    /// @brief The state of lowering an `SSAGraph` into machine code
+    ////////////////////////////////////////
+    struct Lowering {
+        const SSAGraph& Graph;
+        const Function& Func;
+        Emitter         E;
+        Location*       Locations;
+        /// Filled by the measuring pass, and
+        /// read by both of them
+        u32*            BlockLabels;
+        u32*            StubLabels;
+        u32             Common;
+        /// Guarded values, in the order they are emitted
+        u32*            Guards;
+        u32             GuardCount;
+        /// Offset of `ExecState::Reg` from the `ExecState`
+        i32             RegOffset;
+        /// Size of the stack frame below the saved registers
+        u32             Frame;
+        /// Offset of the constant pool, as measured, and
+        /// the amount of constants placed in it so far
+        u32             Pool;
+        u32             PoolCount;
+        /// The globals the code speculates on, if any,
+        /// and the generation they are checked against
+        GlobalSpeculation* Speculation;
+        const u32*         Generation;
+        /// The `Instruction` the code is entered at
+        u32             Entry;
+        /// Labels of the code after the entry check, of the
+        /// revalidation it calls on failure, and of the shared
+        /// tail of every exit which deoptimises
+        u32             Body, Stale, Deopt;
+    };
+
+    /// @brief Returns true if a value only defines its low 32 bits,
+    /// which have to be zero-extended wherever all of it is read
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    bool IsNarrow(const SSAGraph& Graph, u32 Value) noexcept
+        { return ( Graph.Values[Value].Type == SSAType::F32 ); }
+
+    static OctVM_SternInline
+    Location GetLocation(const Lowering& L, u32 Value) noexcept
+    {
+        const SSAValue& V = L.Graph.Values[Value];
+        return ( V.Op == SSA_CONST
+                 ? MakeLocation(LocationKind::CONSTANT, 0, 0, V.Imm)
+                 : L.Locations[Value] );
+    }
+
+    static OctVM_SternInline
+    Location GetStateRegister(const Lowering& L, u32 IDX) noexcept
+    {
+        return MakeLocation(LocationKind::MEMORY, R12,
+                            L.RegOffset + (i32)( IDX * sizeof(u64) ));
+    }
+
+    /// @brief Loads a constant into an xmm register from a new
+    /// entry of the constant pool, zeroing the upper half
+    ////////////////////////////////////////
+    static void EmitLoadConstant(Lowering& L, u8 Reg, u64 Imm) noexcept
+    {
+        Emitter& E = L.E;
+        u32 Entry = L.Pool + L.PoolCount++ * (u32)sizeof(u64);
+        if ( E.Code )
+            for ( u32 i = 0; i < sizeof(u64); i++ )
+                E.Code[Entry + i] = (byte)( Imm >> ( i * 8 ) );
+        // movq xmm, [rip + disp32]
+        Emit8(E, 0xF3);
+        EmitRex(E, false, Reg, 0);
+        EmitOpcode(E, 0x0F7E);
+        Emit8(E, (u8)( ( ( Reg & 7 ) << 3 ) | 5 ));
+        Emit32(E, Entry - ( E.Offset + 4 ));
+    }
+
+    /// @brief Copies all 64 bits of a value from one location
+    /// to another, zero-extending it if Narrow. Clobbers rax.
+    ////////////////////////////////////////
+    static void EmitMove(Lowering& L, const Location& To,
+                         const Location& From, bool Narrow) noexcept
+    {
+        Emitter& E = L.E;
+        if ( To.Kind == From.Kind && To.Reg == From.Reg
+             && To.Disp == From.Disp && From.Kind != LocationKind::CONSTANT
+             && !( Narrow && From.Kind == LocationKind::XMM ) )
+            return;
+
+        switch ( From.Kind ) {
+            case LocationKind::CONSTANT:
+                if ( To.Kind == LocationKind::GPR )
+                    EmitMoveImm(E, To.Reg, From.Imm);
+                else if ( To.Kind == LocationKind::XMM ) {
+                    if ( !From.Imm )
+                        EmitRR(E, 0, false, 0x0F57, To.Reg, To.Reg);
+                    else
+                        EmitLoadConstant(L, To.Reg, From.Imm);
+                }
+                else if ( IsImm32(From.Imm) ) {
+                    EmitRM(E, 0, true, 0xC7, 0, To.Reg, To.Disp);
+                    Emit32(E, (u32)From.Imm);
+                }
+                else {
+                    EmitMoveImm(E, RAX, From.Imm);
+                    EmitRM(E, 0, true, 0x89, RAX, To.Reg, To.Disp);
+                }
+                return;
+
+            case LocationKind::GPR:
+                if ( To.Kind == LocationKind::GPR )
+                    EmitRR(E, 0, true, 0x8B, To.Reg, From.Reg);
+                else if ( To.Kind == LocationKind::XMM )
+                    EmitRR(E, 0x66, true, 0x0F6E, To.Reg, From.Reg);
+                else
+                    EmitRM(E, 0, true, 0x89, From.Reg, To.Reg, To.Disp);
+                return;
+
+            case LocationKind::XMM:
+                if ( Narrow ) {
+                    // movd r32, xmm
+                    u8 Temp = ( To.Kind == LocationKind::GPR ? To.Reg : (u8)RAX );
+                    EmitRR(E, 0x66, false, 0x0F7E, From.Reg, Temp);
+                    if ( Temp == RAX )
+                        EmitMove(L, To, MakeLocation(LocationKind::GPR, RAX),
+                                 false);
+                }
+                else if ( To.Kind == LocationKind::GPR )
+                    EmitRR(E, 0x66, true, 0x0F7E, From.Reg, To.Reg);
+                else if ( To.Kind == LocationKind::XMM )
+                    EmitRR(E, 0, false, 0x0F28, To.Reg, From.Reg);
+                else
+                    EmitRM(E, 0xF2, false, 0x0F11, From.Reg, To.Reg, To.Disp);
+                return;
+
+            case LocationKind::MEMORY:
+                if ( To.Kind == LocationKind::GPR )
+                    EmitRM(E, 0, true, 0x8B, To.Reg, From.Reg, From.Disp);
+                else if ( To.Kind == LocationKind::XMM )
+                    EmitRM(E, 0xF2, false, 0x0F10, To.Reg, From.Reg, From.Disp);
+                else {
+                    EmitRM(E, 0, true, 0x8B, RAX, From.Reg, From.Disp);
+                    EmitRM(E, 0, true, 0x89, RAX, To.Reg, To.Disp);
+                }
+                return;
+
+            default:
+                return;
+        }
+    }
+
+    /// @brief Returns a general purpose register holding all
+    /// 64 bits of a value, loading it into Target if needed
+    ////////////////////////////////////////
+    static u8 LoadGPR(Lowering& L, u32 Value, u8 Target) noexcept
+    {
+        Location From = GetLocation(L, Value);
+        if ( From.Kind == LocationKind::GPR )
+            return From.Reg;
+        EmitMove(L, MakeLocation(LocationKind::GPR, Target), From,
+                 IsNarrow(L.Graph, Value));
+        return Target;
+    }
+
+    static void LoadGPRInto(Lowering& L, u32 Value, u8 Target) noexcept
+    {
+        u8 Reg = LoadGPR(L, Value, Target);
+        if ( Reg != Target )
+            EmitRR(L.E, 0, true, 0x8B, Target, Reg);
+    }
+
+    /// @brief Returns an xmm register holding a value, loading it
+    /// into Target if needed. Only the low 32 bits are meaningful
+    /// unless Wide, which zero-extends narrow values.
+    ////////////////////////////////////////
+    static u8 LoadXMM(Lowering& L, u32 Value, u8 Target, bool Wide) noexcept
+    {
+        Location From   = GetLocation(L, Value);
+        bool     Narrow = IsNarrow(L.Graph, Value);
+        if ( From.Kind == LocationKind::XMM && !( Wide && Narrow ) )
+            return From.Reg;
+        EmitMove(L, MakeLocation(LocationKind::XMM, Target), From, Narrow);
+        return Target;
+    }
+
+    static void LoadXMMInto(Lowering& L, u32 Value, u8 Target, bool Wide) noexcept
+    {
+        u8 Reg = LoadXMM(L, Value, Target, Wide);
+        if ( Reg != Target )
+            EmitRR(L.E, 0, false, 0x0F28, Target, Reg);
+    }
+
+    /// @brief Returns the register a value is computed into,
+    /// which is Scratch if the value lives in a slot
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    u8 GetResultRegister(const Lowering& L, u32 Value, u8 Scratch) noexcept
+    {
+        const Location& To = L.Locations[Value];
+        return ( To.Kind == LocationKind::GPR || To.Kind == LocationKind::XMM
+                 ? To.Reg : Scratch );
+    }
+
+    /// @brief Stores a value computed into a scratch register to its slot
+    ////////////////////////////////////////
+    static void StoreResult(Lowering& L, u32 Value, u8 Reg, bool XMM) noexcept
+    {
+        const Location& To = L.Locations[Value];
+        if ( To.Kind == LocationKind::MEMORY )
+            EmitMove(L, To, MakeLocation( XMM ? LocationKind::XMM
+                                              : LocationKind::GPR, Reg ),
+                     XMM && IsNarrow(L.Graph, Value));
+    }
+
+    /// @brief Writes a snapshot back into `ExecState::Reg`,
+    /// skipping registers which still hold their value
+    ////////////////////////////////////////
+    static void EmitSnapshot(Lowering& L, u32 Snapshot) noexcept
+    {
+        const SSASnapshot& At = L.Graph.Snapshots[Snapshot];
+        for ( u32 r = 0; r < Register::COUNT; r++ ) {
+            u32 Value = At.Values[r];
+            if ( !IsUnchangedSSA(L.Graph, Value, r) )
+                EmitMove(L, GetStateRegister(L, r), GetLocation(L, Value),
+                         IsNarrow(L.Graph, Value));
+        }
+    }
+
+    /// @brief Emits the epilogue, which returns, or
+    /// with Tail set jumps to rax in its place
+    ////////////////////////////////////////
+    static void EmitEpilogue(Lowering& L, bool Tail = false) noexcept
+    {
+        EmitRR(L.E, 0, true, 0x81, 0, RSP);
+        Emit32(L.E, L.Frame);
+        for ( u8 Byte : RESTORE_REGISTERS )
+            Emit8(L.E, Byte);
+        if ( Tail ) {
+            Emit8(L.E, 0xFF);
+            Emit8(L.E, 0xE0);
+        }
+        else
+            Emit8(L.E, 0xC3);
+    }
+
+    /// @brief Emits a conditional jump to the exit stub
+    /// of the value being lowered
+    ////////////////////////////////////////
+    static void EmitGuard(Lowering& L, u8 CC) noexcept
+        { EmitJump(L.E, 0x0F80 | CC, L.StubLabels[L.GuardCount]); }
+
+    /// @brief Emits a comparison of the key at [Key] with the one
+    /// Global was speculated on, jumping to Target on the first
+    /// difference. Reads no further than the length of that key.
+    ////////////////////////////////////////
+    static void EmitKeyCheck(Emitter& E, u8 Key, const SpeculatedGlobal& Global,
+                             u32 Target) noexcept
+    {
+        u32 Len = QuickStrLen(Global.KeyCopy) + 1;
+        for ( u32 Offset = 0; Offset < Len; ) {
+            u32 Width = 8;
+            while ( Width > Len - Offset )
+                Width >>= 1;
+            u64 Expected = 0;
+            QuickCopy(Global.KeyCopy + Offset, &Expected, Width);
+            // mov rax, [Key + Offset], zero-extending narrower loads
+            switch ( Width ) {
+                case 8:  EmitRM(E, 0, true,  0x8B,   RAX, Key, (i32)Offset); break;
+                case 4:  EmitRM(E, 0, false, 0x8B,   RAX, Key, (i32)Offset); break;
+                case 2:  EmitRM(E, 0, false, 0x0FB7, RAX, Key, (i32)Offset); break;
+                default: EmitRM(E, 0, false, 0x0FB6, RAX, Key, (i32)Offset); break;
+            }
+            EmitMoveImm(E, RDX, Expected);
+            EmitRR(E, 0, true, 0x3B, RAX, RDX);
+            EmitJump(E, 0x0F80 | CC_NE, Target);
+            Offset += Width;
+        }
+    }
+
+    /// @brief Returns the x86 condition code of an `SSACond`
+    ////////////////////////////////////////
+    static u8 GetConditionCode(u8 Cond) noexcept
+    {
+        switch ( Cond ) {
+            case COND_EQ:  return CC_E;
+            case COND_NE:  return CC_NE;
+            case COND_LT:  return CC_B;
+            case COND_GT:  return CC_A;
+            case COND_LE:  return CC_BE;
+            case COND_GE:  return CC_AE;
+            case COND_ILT: return CC_L;
+            case COND_IGT: return CC_G;
+            case COND_ILE: return CC_LE;
+            default:       return CC_GE;
+        }
+    }
+
+    /// @brief Returns the index of the highest set bit of Value
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    u8 GetLog2(u64 Value) noexcept
+    {
+        u8 Log = 0;
+        while ( Value >>= 1 )
+            Log++;
+        return Log;
+    }
+
+    /// @brief Returns true if a division by the constant Divisor
+    /// is strength reduced. Powers of two only shift while unsigned,
+    /// and the magnitude of signed divisors is bounded by
+    /// `GetSignedMagic`.
+    ////////////////////////////////////////
+    static bool IsReducibleDivisor(u64 Divisor, bool Signed) noexcept
+    {
+        if ( !Signed )
+            return ( Divisor != 0 );
+        u64 Abs = ( (i64)Divisor < 0 ? 0 - Divisor : Divisor );
+        return ( Abs >= 2 && Abs < ( (u64)1 << 63 ) );
+    }
+
+    /// @brief Compares two integer values, setting the flags
+    ////////////////////////////////////////
+    static void EmitCompare(Lowering& L, u32 A, u32 B) noexcept
+    {
+        const SSAValue& Right = L.Graph.Values[B];
+        u8 Left = LoadGPR(L, A, RAX);
+        if ( Right.Op == SSA_CONST && IsImm32(Right.Imm) ) {
+            EmitRR(L.E, 0, true, 0x81, 7, Left);
+            Emit32(L.E, (u32)Right.Imm);
+        }
+        else
+            EmitRR(L.E, 0, true, 0x3B, Left, LoadGPR(L, B, RCX));
+    }
+
+    /// @brief Turns the flags into 0 or 1 in the value's location
+    ////////////////////////////////////////
+    static void EmitSetResult(Lowering& L, u32 Value, u8 CC) noexcept
+    {
+        u8 Result = GetResultRegister(L, Value, RAX);
+        // setcc al; movzx r32, al
+        EmitRR(L.E, 0, false, 0x0F90 | CC, 0, RAX);
+        EmitRR(L.E, 0, false, 0x0FB6, Result, RAX);
+        StoreResult(L, Value, Result, false);
+    }
+
+    /// @brief Lowers a single value. Only its first operand may
+    /// share its location, which is why that one is read first.
+    ////////////////////////////////////////
+    static void EmitValue(Lowering& L, u32 Value) noexcept
+    {
+        const SSAValue& V = L.Graph.Values[Value];
+        Emitter& E = L.E;
+        u32 A = V.Args[0], B = V.Args[1];
+        bool ConstB = ( B != SSA_NONE
+                        && L.Graph.Values[B].Op == SSA_CONST );
+        u64 ImmB = ( ConstB ? L.Graph.Values[B].Imm : 0 );
+
+        // rX = rY Op rZ, with Op as `<op> r64, r/m64`, and
+        // Ext as the extension of `<op> r/m64, imm32`
+        auto Binary = [&](u32 Opcode, u8 Ext) {
+            u8 Result = GetResultRegister(L, Value, RAX);
+            LoadGPRInto(L, A, Result);
+            if ( ConstB && IsImm32(ImmB) ) {
+                EmitRR(E, 0, true, 0x81, Ext, Result);
+                Emit32(E, (u32)ImmB);
+            }
+            else
+                EmitRR(E, 0, true, Opcode, Result, LoadGPR(L, B, RCX));
+            StoreResult(L, Value, Result, false);
+        };
+        auto Shift = [&](u8 Ext) {
+            u8 Result = GetResultRegister(L, Value, RAX);
+            LoadGPRInto(L, A, Result);
+            if ( ConstB ) {
+                EmitRR(E, 0, true, 0xC1, Ext, Result);
+                Emit8(E, (u8)( ImmB & 63 ));
+            }
+            else {
+                LoadGPRInto(L, B, RCX);
+                EmitRR(E, 0, true, 0xD3, Ext, Result);
+            }
+            StoreResult(L, Value, Result, false);
+        };
+        auto Logical = [&](u8 Opcode) {
+            u8 Left = LoadGPR(L, A, RAX);
+            EmitRR(E, 0, true, 0x85, Left, Left);
+            EmitRR(E, 0, false, 0x0F95, 0, RDX);
+            u8 Right = LoadGPR(L, B, RCX);
+            EmitRR(E, 0, true, 0x85, Right, Right);
+            EmitRR(E, 0, false, 0x0F95, 0, RAX);
+            EmitRR(E, 0, false, Opcode, RDX, RAX);
+            u8 Result = GetResultRegister(L, Value, RAX);
+            EmitRR(E, 0, false, 0x0FB6, Result, RAX);
+            StoreResult(L, Value, Result, false);
+        };
+        // Constant divisors which can never exit are strength
+        // reduced, computing the quotient into rdx from rcx,
+        // or a power of two remainder as a mask
+        auto DivideByConstant = [&](bool Signed, bool Remainder) {
+            bool Power  = ( !Signed && !( ImmB & ( ImmB - 1 ) ) );
+            LoadGPRInto(L, A, RCX);
+            if ( Power && Remainder ) {
+                u64 Mask = ImmB - 1;
+                if ( IsImm32(Mask) ) {
+                    EmitRR(E, 0, true, 0x81, 4, RCX);
+                    Emit32(E, (u32)Mask);
+                }
+                else {
+                    EmitMoveImm(E, RAX, Mask);
+                    EmitRR(E, 0, true, 0x23, RCX, RAX);
+                }
+                EmitMove(L, L.Locations[Value],
+                         MakeLocation(LocationKind::GPR, RCX), false);
+                return;
+            }
+            if ( Power ) {
+                EmitRR(E, 0, true, 0x8B, RDX, RCX);
+                EmitRR(E, 0, true, 0xC1, 5, RDX);
+                Emit8(E, GetLog2(ImmB));
+            }
+            else if ( !Signed ) {
+                DivisionMagic Magic = GetUnsignedMagic(ImmB);
+                EmitMoveImm(E, RAX, Magic.Magic);
+                EmitRR(E, 0, true, 0xF7, 4, RCX);
+                if ( Magic.Shift & REDUCED_ADD ) {
+                    // rdx += ( rcx - rdx ) >> 1
+                    EmitRR(E, 0, true, 0x8B, RAX, RCX);
+                    EmitRR(E, 0, true, 0x2B, RAX, RDX);
+                    EmitRR(E, 0, true, 0xD1, 5, RAX);
+                    EmitRR(E, 0, true, 0x03, RDX, RAX);
+                }
+                EmitRR(E, 0, true, 0xC1, 5, RDX);
+                Emit8(E, Magic.Shift & REDUCED_SHIFT_MASK);
+            }
+            else {
+                DivisionMagic Magic = GetSignedMagic((i64)ImmB);
+                EmitMoveImm(E, RAX, Magic.Magic);
+                EmitRR(E, 0, true, 0xF7, 5, RCX);
+                if ( Magic.Shift & REDUCED_ADD )
+                    EmitRR(E, 0, true, 0x03, RDX, RCX);
+                else if ( Magic.Shift & REDUCED_SUB )
+                    EmitRR(E, 0, true, 0x2B, RDX, RCX);
+                EmitRR(E, 0, true, 0xC1, 7, RDX);
+                Emit8(E, Magic.Shift & REDUCED_SHIFT_MASK);
+                // Rounds towards 0 by adding the sign bit
+                EmitRR(E, 0, true, 0x8B, RAX, RDX);
+                EmitRR(E, 0, true, 0xC1, 5, RAX);
+                Emit8(E, 63);
+                EmitRR(E, 0, true, 0x03, RDX, RAX);
+            }
+            if ( Remainder ) {
+                // rcx -= rdx * Divisor
+                if ( IsImm32(ImmB) ) {
+                    EmitRR(E, 0, true, 0x69, RDX, RDX);
+                    Emit32(E, (u32)ImmB);
+                }
+                else {
+                    EmitMoveImm(E, RAX, ImmB);
+                    EmitRR(E, 0, true, 0x0FAF, RDX, RAX);
+                }
+                EmitRR(E, 0, true, 0x2B, RCX, RDX);
+            }
+            EmitMove(L, L.Locations[Value],
+                     MakeLocation(LocationKind::GPR, Remainder ? RCX : RDX),
+                     false);
+        };
+        auto Divide = [&](bool Signed, bool Remainder) {
+            if ( ConstB && V.Snapshot == SSA_NONE
+                 && IsReducibleDivisor(ImmB, Signed) ) {
+                DivideByConstant(Signed, Remainder);
+                return;
+            }
+            LoadGPRInto(L, B, RCX);
+            if ( V.Snapshot != SSA_NONE ) {
+                EmitRR(E, 0, true, 0x85, RCX, RCX);
+                EmitGuard(L, CC_E);
+                if ( Signed ) {
+                    // The interpreter defines INT64_MIN / -1
+                    EmitRR(E, 0, true, 0x83, 7, RCX);
+                    Emit8(E, 0xFF);
+                    EmitGuard(L, CC_E);
+                }
+                L.Guards[L.GuardCount++] = Value;
+            }
+            LoadGPRInto(L, A, RAX);
+            if ( Signed ) {
+                Emit8(E, 0x48);
+                Emit8(E, 0x99);
+            }
+            else
+                EmitRR(E, 0, false, 0x33, RDX, RDX);
+            EmitRR(E, 0, true, 0xF7, Signed ? 7 : 6, RCX);
+            EmitMove(L, L.Locations[Value],
+                     MakeLocation(LocationKind::GPR, Remainder ? RDX : RAX),
+                     false);
+        };
+        // Prefix selects the scalar single (F3) or double (F2) form
+        auto Arithmetic = [&](u8 Prefix, u8 Opcode) {
+            bool Wide   = ( Prefix == 0xF2 );
+            u8   Result = GetResultRegister(L, Value, XMM15);
+            u8   Right;
+            if ( V.Snapshot != SSA_NONE ) {
+                // 0.0 and -0.0 compare equal to 0, NaN does not
+                Right = LoadXMM(L, B, XMM14, Wide);
+                EmitRR(E, 0, false, 0x0F57, XMM15, XMM15);
+                EmitRR(E, Wide ? 0x66 : 0, false, 0x0F2E, Right, XMM15);
+                Emit8(E, 0x70 | CC_P);
+                Emit8(E, 6);
+                EmitGuard(L, CC_E);
+                L.Guards[L.GuardCount++] = Value;
+                LoadXMMInto(L, A, Result, Wide);
+            }
+            else {
+                LoadXMMInto(L, A, Result, Wide);
+                Right = LoadXMM(L, B, XMM14, Wide);
+            }
+            EmitRR(E, Prefix, false, 0x0F00 | Opcode, Result, Right);
+            StoreResult(L, Value, Result, true);
+        };
+        // xmm = Op(rY), reading the operand from Source
+        auto Unary = [&](u8 Prefix, bool W, u32 Opcode, u8 Source) {
+            u8 Result = GetResultRegister(L, Value, XMM15);
+            EmitRR(E, Prefix, W, Opcode, Result, Source);
+            StoreResult(L, Value, Result, true);
+        };
+        // Unordered operands set CF, so only above and
+        // above-or-equal are false for NaN
+        auto FloatCompare = [&](bool Wide) {
+            u8 Left  = LoadXMM(L, A, XMM14, Wide);
+            u8 Right = LoadXMM(L, B, XMM15, Wide);
+            bool Swap = ( V.Cond == COND_LT || V.Cond == COND_LE );
+            EmitRR(E, Wide ? 0x66 : 0, false, 0x0F2E,
+                   Swap ? Right : Left, Swap ? Left : Right);
+            EmitSetResult(L, Value, ( V.Cond == COND_LT || V.Cond == COND_GT )
+                                    ? CC_A : CC_AE);
+        };
+
+        switch ( V.Op ) {
+            case SSA_PARAM:
+                if ( L.Locations[Value].Kind != LocationKind::NONE )
+                    EmitMove(L, L.Locations[Value],
+                             GetStateRegister(L, (u32)V.Imm), false);
+                return;
+            case SSA_CONST:
+            case SSA_PHI:
+                return;
+
+            case SSA_ADD: Binary(0x03, 0); return;
+            case SSA_OR:  Binary(0x0B, 1); return;
+            case SSA_AND: Binary(0x23, 4); return;
+            case SSA_SUB: Binary(0x2B, 5); return;
+            case SSA_XOR: Binary(0x33, 6); return;
+            case SSA_MUL: {
+                u8 Result = GetResultRegister(L, Value, RAX);
+                if ( ConstB && ImmB && !( ImmB & ( ImmB - 1 ) ) ) {
+                    LoadGPRInto(L, A, Result);
+                    EmitRR(E, 0, true, 0xC1, 4, Result);
+                    Emit8(E, GetLog2(ImmB));
+                }
+                else if ( ConstB && IsImm32(ImmB) ) {
+                    EmitRR(E, 0, true, 0x69, Result, LoadGPR(L, A, RAX));
+                    Emit32(E, (u32)ImmB);
+                }
+                else {
+                    LoadGPRInto(L, A, Result);
+                    EmitRR(E, 0, true, 0x0FAF, Result, LoadGPR(L, B, RCX));
+                }
+                StoreResult(L, Value, Result, false);
+                return;
+            }
+            case SSA_SHL: Shift(4); return;
+            case SSA_SHR: Shift(5); return;
+            case SSA_NOT: {
+                u8 Result = GetResultRegister(L, Value, RAX);
+                LoadGPRInto(L, A, Result);
+                EmitRR(E, 0, true, 0xF7, 2, Result);
+                StoreResult(L, Value, Result, false);
+                return;
+            }
+            case SSA_LAND: Logical(0x20); return;
+            case SSA_LOR:  Logical(0x08); return;
+            case SSA_CMP:
+                EmitCompare(L, A, B);
+                EmitSetResult(L, Value, GetConditionCode(V.Cond));
+                return;
+            case SSA_DIV:  Divide(false, false); return;
+            case SSA_MOD:  Divide(false, true);  return;
+            case SSA_IDIV: Divide(true,  false); return;
+            case SSA_IMOD: Divide(true,  true);  return;
+
+            case SSA_FADD: Arithmetic(0xF3, 0x58); return;
+            case SSA_FSUB: Arithmetic(0xF3, 0x5C); return;
+            case SSA_FMUL: Arithmetic(0xF3, 0x59); return;
+            case SSA_FDIV: Arithmetic(0xF3, 0x5E); return;
+            case SSA_DADD: Arithmetic(0xF2, 0x58); return;
+            case SSA_DSUB: Arithmetic(0xF2, 0x5C); return;
+            case SSA_DMUL: Arithmetic(0xF2, 0x59); return;
+            case SSA_DDIV: Arithmetic(0xF2, 0x5E); return;
+            case SSA_FSQRT:
+                Unary(0xF3, false, 0x0F51, LoadXMM(L, A, XMM14, false));
+                return;
+            case SSA_DSQRT:
+                Unary(0xF2, false, 0x0F51, LoadXMM(L, A, XMM14, true));
+                return;
+            case SSA_I2F:
+                Unary(0xF3, true, 0x0F2A, LoadGPR(L, A, RAX));
+                return;
+            case SSA_I2D:
+                Unary(0xF2, true, 0x0F2A, LoadGPR(L, A, RAX));
+                return;
+            case SSA_F2D:
+                Unary(0xF3, false, 0x0F5A, LoadXMM(L, A, XMM14, false));
+                return;
+            case SSA_D2F:
+                Unary(0xF2, false, 0x0F5A, LoadXMM(L, A, XMM14, true));
+                return;
+            case SSA_FCMP: FloatCompare(false); return;
+            case SSA_DCMP: FloatCompare(true);  return;
+
+            case SSA_GADDR: {
+                const SpeculatedGlobal& Global = GetSpeculatedGlobal(
+                    L.Speculation, GetSpeculatedKey(L.Graph, Value));
+                u64 Base  = (u64)Global.Value;
+                u32 Scale = ( (const GlobalCache*)V.Imm )->Scale;
+                // Keys which are not constant may also have
+                // been rewritten since they were speculated on
+                if ( V.Snapshot != SSA_NONE ) {
+                    u8 Actual = LoadGPR(L, A, RCX);
+                    EmitMoveImm(E, RAX, (u64)Global.Key);
+                    EmitRR(E, 0, true, 0x3B, Actual, RAX);
+                    EmitGuard(L, CC_NE);
+                    EmitKeyCheck(E, Actual, Global, L.StubLabels[L.GuardCount]);
+                    L.Guards[L.GuardCount++] = Value;
+                }
+                u8 Result = GetResultRegister(L, Value, RAX);
+                if ( ConstB )
+                    EmitMoveImm(E, Result, Base + ImmB * Scale);
+                else {
+                    u8 Index = LoadGPR(L, B, RCX);
+                    if ( Scale == 1 )
+                        EmitRR(E, 0, true, 0x8B, Result, Index);
+                    else {
+                        EmitRR(E, 0, true, 0x69, Result, Index);
+                        Emit32(E, Scale);
+                    }
+                    EmitMoveImm(E, RCX, Base);
+                    EmitRR(E, 0, true, 0x03, Result, RCX);
+                }
+                StoreResult(L, Value, Result, false);
+                return;
+            }
+            case SSA_LOAD: {
+                u8 Address = LoadGPR(L, A, RAX);
+                u8 Result  = GetResultRegister(L, Value, RAX);
+                // movzx r32, m8/m16 and mov r32, m32 zero-extend
+                switch ( V.Imm ) {
+                    case 1:  EmitRM(E, 0, false, 0x0FB6, Result, Address, 0); break;
+                    case 2:  EmitRM(E, 0, false, 0x0FB7, Result, Address, 0); break;
+                    case 4:  EmitRM(E, 0, false, 0x8B,   Result, Address, 0); break;
+                    default: EmitRM(E, 0, true,  0x8B,   Result, Address, 0); break;
+                }
+                StoreResult(L, Value, Result, false);
+                return;
+            }
+            case SSA_STORE: {
+                u8 Address = LoadGPR(L, A, RAX);
+                // Without a REX prefix, 4 to 7 would name ah to bh
+                LoadGPRInto(L, B, RCX);
+                switch ( V.Imm ) {
+                    case 1:  EmitRM(E, 0,    false, 0x88, RCX, Address, 0); break;
+                    case 2:  EmitRM(E, 0x66, false, 0x89, RCX, Address, 0); break;
+                    case 4:  EmitRM(E, 0,    false, 0x89, RCX, Address, 0); break;
+                    default: EmitRM(E, 0,    true,  0x89, RCX, Address, 0); break;
+                }
+                return;
+            }
+
+            default:
+                return;
+        }
+    }
+
+    /// @brief A single copy of a parallel move
+    ////////////////////////////////////////
+    struct PendingMove {
+        Location To, From;
+        bool     Narrow;
+    };
+
+    static OctVM_SternInline
+    bool IsSameLocation(const Location& A, const Location& B) noexcept
+    {
+        return ( A.Kind == B.Kind && A.Kind != LocationKind::CONSTANT
+              && A.Reg == B.Reg && A.Disp == B.Disp );
+    }
+
+    /// @brief Collects the copies assigning the phis of Succ
+    /// their operands from Pred, leaving out those in place
+    /// @return The amount of copies.
+    ////////////////////////////////////////
+    static u32 GetPhiMoves(const Lowering& L, u32 Pred, u32 Succ,
+                           PendingMove* Moves) noexcept
+    {
+        const SSABlock& Block = L.Graph.Blocks[Succ];
+        if ( Block.PredCount < 2 )
+            return 0;
+        u32 Edge = 0;
+        while ( L.Graph.PredList[Block.Preds + Edge] != Pred )
+            Edge++;
+
+        u32 Count = 0;
+        for ( u32 Phi = Block.First; Phi != SSA_NONE
+              && L.Graph.Values[Phi].Op == SSA_PHI;
+              Phi = L.Graph.Values[Phi].Next ) {
+            u32 Arg = L.Graph.PhiArgs[L.Graph.Values[Phi].Imm + Edge];
+            PendingMove Move = { L.Locations[Phi], GetLocation(L, Arg),
+                                 IsNarrow(L.Graph, Arg) };
+            // Narrow operands of wide phis are zero-extended in place
+            if ( !IsSameLocation(Move.To, Move.From)
+                 || ( Move.Narrow && !IsNarrow(L.Graph, Phi) ) )
+                Moves[Count++] = Move;
+        }
+        return Count;
+    }
+
+    /// @brief Assigns the phis of Succ their operands from Pred,
+    /// all at once. Cycles are broken through rdx.
+    ////////////////////////////////////////
+    static void EmitPhiMoves(Lowering& L, u32 Pred, u32 Succ,
+                             PendingMove* Moves) noexcept
+    {
+        for ( u32 Count = GetPhiMoves(L, Pred, Succ, Moves); Count; ) {
+            bool Progress = false;
+            for ( u32 i = 0; i < Count; ) {
+                bool Blocked = false;
+                for ( u32 k = 0; k < Count && !Blocked; k++ )
+                    Blocked = ( k != i
+                                && IsSameLocation(Moves[k].From, Moves[i].To) );
+                if ( Blocked ) {
+                    i++;
+                    continue;
+                }
+                EmitMove(L, Moves[i].To, Moves[i].From, Moves[i].Narrow);
+                Moves[i] = Moves[--Count];
+                Progress = true;
+            }
+            if ( Progress )
+                continue;
+
+            // Every remaining move is part of a cycle
+            Location Temp = MakeLocation(LocationKind::GPR, RDX);
+            for ( u32 k = 0; k < Count; k++ ) {
+                if ( !IsSameLocation(Moves[k].From, Moves[0].To) )
+                    continue;
+                EmitMove(L, Temp, Moves[k].From, Moves[k].Narrow);
+                for ( u32 j = k; j < Count; j++ )
+                    if ( IsSameLocation(Moves[j].From, Moves[0].To) ) {
+                        Moves[j].From   = Temp;
+                        Moves[j].Narrow = false;
+                    }
+                break;
+            }
+        }
+    }
+
+    /// @brief Returns the label to jump to for a block, skipping
+    /// over blocks which do nothing but jump, as left behind
+    /// where critical edges were split
+    ////////////////////////////////////////
+    static u32 GetJumpLabel(const Lowering& L, u32 IDX,
+                            PendingMove* Moves) noexcept
+    {
+        for ( u32 Hops = 0; Hops < L.Graph.BlockCount; Hops++ ) {
+            const SSABlock& Block = L.Graph.Blocks[IDX];
+            if ( Block.First != SSA_NONE || Block.Exit != SSAExit::JUMP
+                 || GetPhiMoves(L, IDX, Block.Succ[0], Moves) )
+                break;
+            IDX = Block.Succ[0];
+        }
+        return L.BlockLabels[IDX];
+    }
+
+    /// @brief Lowers the end of a block
+    /// @param Next The block emitted after it, if any
+    ////////////////////////////////////////
+    static void EmitTerminator(Lowering& L, u32 IDX, u32 Next,
+                               PendingMove* Moves) noexcept
+    {
+        const SSABlock& Block = L.Graph.Blocks[IDX];
+        Emitter& E = L.E;
+        switch ( Block.Exit ) {
+            case SSAExit::JUMP:
+                EmitPhiMoves(L, IDX, Block.Succ[0], Moves);
+                if ( Block.Succ[0] != Next )
+                    EmitJump(E, 0xE9, GetJumpLabel(L, Block.Succ[0], Moves));
+                return;
+
+            case SSAExit::BRANCH: {
+                u8 CC = GetConditionCode(Block.Cond);
+                EmitCompare(L, Block.Args[0], Block.Args[1]);
+                if ( Block.Succ[0] == Next ) {
+                    EmitJump(E, 0x0F80 | ( CC ^ 1 ),
+                             GetJumpLabel(L, Block.Succ[1], Moves));
+                    return;
+                }
+                EmitJump(E, 0x0F80 | CC, GetJumpLabel(L, Block.Succ[0], Moves));
+                if ( Block.Succ[1] != Next )
+                    EmitJump(E, 0xE9, GetJumpLabel(L, Block.Succ[1], Moves));
+                return;
+            }
+
+            case SSAExit::RETURN:
+                EmitSnapshot(L, Block.Snapshot);
+                EmitRR(E, 0, false, 0x33, RAX, RAX);
+                EmitEpilogue(L);
+                return;
+
+            case SSAExit::EXIT:
+                EmitSnapshot(L, Block.Snapshot);
+                Emit8(E, 0xBE);
+                Emit32(E, L.Graph.Snapshots[Block.Snapshot].IDX);
+                EmitJump(E, 0xE9, L.Common);
+                return;
+        }
+    }
+
+    /// @brief Emits the shared tail of the exits, which tail
+    /// calls Exit with the `ExecState`, the `Instruction` in esi
+    /// and Func, so that the code is no longer running once the
+    /// interpreter takes over
+    ////////////////////////////////////////
+    static void EmitExitCall(Lowering& L, const Function& Func, u64 Exit) noexcept
+    {
+        // mov rdi, r12; mov rdx, Func; mov rax, Exit
+        EmitRR(L.E, 0, true, 0x8B, RDI, R12);
+        EmitRex(L.E, true, 0, RDX);
+        Emit8(L.E, 0xBA);
+        Emit64(L.E, (u64)&Func);
+        EmitRex(L.E, true, 0, RAX);
+        Emit8(L.E, 0xB8);
+        Emit64(L.E, Exit);
+        EmitEpilogue(L, true);
+    }
+
+    /// @brief Emits the whole `Function`, measuring it if
+    /// L.E.Code is nullptr
+    ////////////////////////////////////////
+    static void EmitFunction(Lowering& L, Function& Func,
+                             PendingMove* Moves) noexcept
+    {
+        const SSAGraph& Graph = L.Graph;
+        Emitter& E = L.E;
+        L.GuardCount = 0;
+        L.PoolCount  = 0;
+
+        for ( u8 Byte : SAVE_REGISTERS )
+            Emit8(E, Byte);
+        EmitRR(E, 0, true, 0x81, 5, RSP);
+        Emit32(E, L.Frame);
+        EmitRR(E, 0, true, 0x8B, R12, RDI);
+        if ( L.Speculation ) {
+            // mov eax, [Generation]; cmp eax, [Table->Generation]
+            EmitMoveImm(E, RAX, (u64)L.Generation);
+            EmitRM(E, 0, false, 0x8B, RAX, RAX, 0);
+            EmitMoveImm(E, RCX, (u64)&L.Speculation->Generation);
+            EmitRM(E, 0, false, 0x3B, RAX, RCX, 0);
+            EmitJump(E, 0x0F85, L.Stale);
+            // Constant keys are not checked where they are used
+            for ( u32 k = 0; k < L.Speculation->Count; k++ ) {
+                const SpeculatedGlobal& Global = L.Speculation->Globals[k];
+                if ( !Global.Constant )
+                    continue;
+                EmitMoveImm(E, RCX, (u64)Global.Key);
+                EmitKeyCheck(E, RCX, Global, L.Stale);
+            }
+        }
+        L.Body = E.Offset;
+
+        for ( u32 i = 0; i < Graph.OrderCount; i++ ) {
+            u32 IDX = Graph.Order[i];
+            L.BlockLabels[IDX] = E.Offset;
+            for ( u32 Value = Graph.Blocks[IDX].First; Value != SSA_NONE;
+                  Value = Graph.Values[Value].Next )
+                EmitValue(L, Value);
+            EmitTerminator(L, IDX, ( i + 1 < Graph.OrderCount
+                                     ? Graph.Order[i + 1] : SSA_NONE ),
+                           Moves);
+        }
+
+        // Guards resume the interpreter at their own `Instruction`,
+        // discarding the code if it was a speculation that failed
+        for ( u32 k = 0; k < L.GuardCount; k++ ) {
+            const SSAValue& Guard = Graph.Values[L.Guards[k]];
+            L.StubLabels[k] = E.Offset;
+            EmitSnapshot(L, Guard.Snapshot);
+            Emit8(E, 0xBE);
+            Emit32(E, Graph.Snapshots[Guard.Snapshot].IDX);
+            EmitJump(E, 0xE9, ( Guard.Op == SSA_GADDR ? L.Deopt : L.Common ));
+        }
+
+        // Nothing has been assigned yet when the entry check fails
+        if ( L.Speculation ) {
+            L.Stale = E.Offset;
+            EmitRR(E, 0, true, 0x8B, RDI, R12);
+            EmitMoveImm(E, RSI, (u64)L.Speculation);
+            EmitMoveImm(E, RAX, (u64)&JITRevalidate);
+            Emit8(E, 0xFF);
+            Emit8(E, 0xD0);
+            // test al, al; jnz Body
+            Emit8(E, 0x84);
+            Emit8(E, 0xC0);
+            EmitJump(E, 0x0F85, L.Body);
+            Emit8(E, 0xBE);
+            Emit32(E, L.Entry);
+            EmitJump(E, 0xE9, L.Deopt);
+        }
+
+        L.Common = E.Offset;
+        EmitExitCall(L, Func, (u64)&JITResume);
+        L.Deopt = E.Offset;
+        if ( L.Speculation )
+            EmitExitCall(L, Func, (u64)&JITDeoptimize);
+        L.Pool = ( E.Offset + 7 ) & ~7u;
+    }
+
+    /// LIVENESS:
+    ////////////////////////////////////////
+
+    /// @brief Calls Use with every value Value reads. Snapshots
+    /// do not read a register which still holds its value.
+    ////////////////////////////////////////
+    template<typename T>
+    static void ForEachOperand(const SSAGraph& Graph, u32 Value, T&& Use) noexcept
+    {
+        const SSAValue& V = Graph.Values[Value];
+        if ( V.Op == SSA_PHI )
+            return;
+        for ( u32 k = 0; k < 2; k++ )
+            if ( V.Args[k] != SSA_NONE )
+                Use(V.Args[k]);
+        if ( V.Snapshot != SSA_NONE )
+            for ( u32 r = 0; r < Register::COUNT; r++ ) {
+                u32 Arg = Graph.Snapshots[V.Snapshot].Values[r];
+                if ( !IsUnchangedSSA(Graph, Arg, r) )
+                    Use(Arg);
+            }
+    }
+
+    /// @brief Calls Use with every value read at the end of a block:
+    /// its branch operands, its snapshot, and the phi operands
+    /// it passes to its successor
+    ////////////////////////////////////////
+    template<typename T>
+    static void ForEachExitOperand(const SSAGraph& Graph, u32 IDX, T&& Use) noexcept
+    {
+        const SSABlock& Block = Graph.Blocks[IDX];
+        if ( Block.Exit == SSAExit::BRANCH ) {
+            Use(Block.Args[0]);
+            Use(Block.Args[1]);
+        }
+        if ( Block.Snapshot != SSA_NONE )
+            for ( u32 r = 0; r < Register::COUNT; r++ ) {
+                u32 Arg = Graph.Snapshots[Block.Snapshot].Values[r];
+                if ( !IsUnchangedSSA(Graph, Arg, r) )
+                    Use(Arg);
+            }
+        if ( Block.Exit == SSAExit::JUMP
+             && Graph.Blocks[Block.Succ[0]].PredCount > 1 ) {
+            const SSABlock& Succ = Graph.Blocks[Block.Succ[0]];
+            u32 Edge = 0;
+            while ( Graph.PredList[Succ.Preds + Edge] != IDX )
+                Edge++;
+            for ( u32 Phi = Succ.First; Phi != SSA_NONE
+                  && Graph.Values[Phi].Op == SSA_PHI;
+                  Phi = Graph.Values[Phi].Next )
+                Use(Graph.PhiArgs[Graph.Values[Phi].Imm + Edge]);
+        }
+    }
+
+    /// @brief Computes the live range of every value over the
+    /// blocks laid out in reverse postorder, as the hull of its
+    /// definition, its uses and the ends of the blocks it is
+    /// live out of. Phis are defined at the start of their block,
+    /// though assigned at the end of each predecessor: anything
+    /// sharing their register there is dead on that edge.
+    /// `SSA_PARAM`s only live where read.
+    /// @param Start Receives UINT32_MAX for values never read
+    /// @return False if temporary storage could not be allocated.
+    ////////////////////////////////////////
+    static bool ComputeLiveRanges(const SSAGraph& Graph, CoreAllocator& Allocator,
+                                  u32* Start, u32* End) noexcept
+    {
+        u32  Words   = ( Graph.ValueCount + 63 ) / 64;
+        u64* LiveIn  = Allocator.Request<u64>((u64)Graph.BlockCount * Words,
+                                              SYSTEM_ALLOC_FLAGS);
+        u64* LiveOut = Allocator.Request<u64>((u64)Graph.BlockCount * Words,
+                                              SYSTEM_ALLOC_FLAGS);
+        u64* Live    = Allocator.Request<u64>(Words, SYSTEM_ALLOC_FLAGS);
+        u32* Bounds  = Allocator.Request<u32>(Graph.BlockCount * 2,
+                                              SYSTEM_ALLOC_FLAGS);
+        if ( !LiveIn || !LiveOut || !Live || !Bounds ) {
+            Allocator.Release(LiveIn);
+            Allocator.Release(LiveOut);
+            Allocator.Release(Live);
+            Allocator.Release(Bounds);
+            return false;
+        }
+        for ( u64 i = 0; i < (u64)Graph.BlockCount * Words; i++ )
+            LiveIn[i] = LiveOut[i] = 0;
+
+        auto Set = [&](u64* Bits, u32 Value) {
+            if ( Graph.Values[Value].Op != SSA_CONST )
+                Bits[Value / 64] |= ( (u64)1 << ( Value % 64 ) );
+        };
+        auto Clear = [](u64* Bits, u32 Value) {
+            Bits[Value / 64] &= ~( (u64)1 << ( Value % 64 ) );
+        };
+
+        for ( bool Changed = true; Changed; ) {
+            Changed = false;
+            for ( u32 i = Graph.OrderCount; i-- > 0; ) {
+                u32 IDX = Graph.Order[i];
+                const SSABlock& Block = Graph.Blocks[IDX];
+                u64* Out = LiveOut + (u64)IDX * Words;
+                u64* In  = LiveIn  + (u64)IDX * Words;
+
+                for ( u32 w = 0; w < Words; w++ )
+                    Live[w] = 0;
+                for ( u32 s = 0; s < ( Block.Exit == SSAExit::JUMP ? 1u
+                                     : Block.Exit == SSAExit::BRANCH ? 2u : 0u ); s++ ) {
+                    const u64* SuccIn = LiveIn + (u64)Block.Succ[s] * Words;
+                    for ( u32 w = 0; w < Words; w++ )
+                        Live[w] |= SuccIn[w];
+                }
+                ForEachExitOperand(Graph, IDX, [&](u32 Arg) { Set(Live, Arg); });
+                for ( u32 w = 0; w < Words; w++ )
+                    Out[w] = Live[w];
+
+                for ( u32 Value = Block.Last; Value != SSA_NONE;
+                      Value = Graph.Values[Value].Prev ) {
+                    Clear(Live, Value);
+                    ForEachOperand(Graph, Value, [&](u32 Arg) { Set(Live, Arg); });
+                }
+                for ( u32 w = 0; w < Words; w++ ) {
+                    Changed |= ( In[w] != Live[w] );
+                    In[w] = Live[w];
+                }
+            }
+        }
+
+        for ( u32 i = 0; i < Graph.ValueCount; i++ ) {
+            Start[i] = UINT32_MAX;
+            End[i]   = 0;
+        }
+        auto Extend = [&](u32 Value, u32 Position) {
+            if ( Graph.Values[Value].Op == SSA_CONST )
+                return;
+            if ( Position < Start[Value] )
+                Start[Value] = Position;
+            if ( Position > End[Value] )
+                End[Value] = Position;
+        };
+
+        u32 Position = 0;
+        for ( u32 i = 0; i < Graph.OrderCount; i++ ) {
+            u32 IDX = Graph.Order[i];
+            Bounds[IDX * 2] = Position++;
+            for ( u32 Value = Graph.Blocks[IDX].First; Value != SSA_NONE;
+                  Value = Graph.Values[Value].Next ) {
+                u8 Op = Graph.Values[Value].Op;
+                if ( Op == SSA_PHI )
+                    Extend(Value, Bounds[IDX * 2]);
+                else {
+                    ForEachOperand(Graph, Value, [&](u32 Arg) {
+                        Extend(Arg, Position);
+                    });
+                    if ( Op != SSA_PARAM )
+                        Extend(Value, Position);
+                    Position++;
+                }
+            }
+            Bounds[IDX * 2 + 1] = Position++;
+        }
+
+        for ( u32 i = 0; i < Graph.OrderCount; i++ ) {
+            u32 IDX = Graph.Order[i];
+            const u64* Out = LiveOut + (u64)IDX * Words;
+            for ( u32 w = 0; w < Words; w++ )
+                for ( u64 Bits = Out[w]; Bits; Bits &= Bits - 1 )
+                    Extend(w * 64 + (u32)__builtin_ctzll(Bits), Bounds[IDX * 2 + 1]);
+        }
+
+        // Parameters are all defined on entry
+        for ( u32 Value = Graph.Blocks[Graph.Entry].First; Value != SSA_NONE;
+              Value = Graph.Values[Value].Next )
+            if ( Graph.Values[Value].Op == SSA_PARAM && Start[Value] != UINT32_MAX )
+                Extend(Value, 0);
+
+        Allocator.Release(LiveIn);
+        Allocator.Release(LiveOut);
+        Allocator.Release(Live);
+        Allocator.Release(Bounds);
+        return true;
+    }
+
+    /// REGISTER ALLOCATION:
+    ////////////////////////////////////////
+
+    /// @brief Assigns each live range a register of its class by a
+    /// linear scan in order of their start. Once a class runs out,
+    /// the range ending last is moved into a slot of the frame
+    /// for all of its length. A value takes over the register of
+    /// its first operand if that range ends where it starts, as
+    /// `EmitValue` reads it into the result first; loop carried
+    /// values then stay in the register of their phi.
+    /// @return The amount of slots used.
+    ////////////////////////////////////////
+    static u32 AllocateRegisters(const SSAGraph& Graph, const u32* Start,
+                                 const u32* End, u32* Sorted,
+                                 Location* Locations) noexcept
+    {
+        u32 Count = 0;
+        for ( u32 i = 0; i < Graph.ValueCount; i++ ) {
+            Locations[i] = MakeLocation(LocationKind::NONE, 0);
+            if ( Start[i] == UINT32_MAX )
+                continue;
+            // Nearly sorted already, as values are numbered in order
+            u32 k = Count++;
+            for ( ; k > 0 && Start[Sorted[k - 1]] > Start[i]; k-- )
+                Sorted[k] = Sorted[k - 1];
+            Sorted[k] = i;
+        }
+
+        u32 Active[GPR_POOL_SIZE + XMM_POOL_SIZE];
+        u32 ActiveCount = 0, Slots = 0;
+        bool UsedGPR[GPR_POOL_SIZE] = {}, UsedXMM[XMM_POOL_SIZE] = {};
+
+        auto IsXMM = [&](u32 Value) {
+            return ( Graph.Values[Value].Type != SSAType::I64 );
+        };
+        auto Release = [&](u32 Value) {
+            const Location& At = Locations[Value];
+            if ( At.Kind == LocationKind::XMM )
+                UsedXMM[At.Reg] = false;
+            else
+                for ( u32 r = 0; r < GPR_POOL_SIZE; r++ )
+                    if ( GPR_POOL[r] == At.Reg )
+                        UsedGPR[r] = false;
+        };
+
+        for ( u32 i = 0; i < Count; i++ ) {
+            u32 Value = Sorted[i];
+            // Ranges ending where this one starts are still read there
+            for ( u32 a = 0; a < ActiveCount; ) {
+                if ( End[Active[a]] < Start[Value] ) {
+                    Release(Active[a]);
+                    Active[a] = Active[--ActiveCount];
+                }
+                else
+                    a++;
+            }
+
+            bool XMM = IsXMM(Value);
+            const SSAValue& V = Graph.Values[Value];
+            u32 First = ( V.Op > SSA_PHI ? V.Args[0] : SSA_NONE );
+            if ( First != SSA_NONE && End[First] == Start[Value]
+                 && IsXMM(First) == XMM ) {
+                u32 a = 0;
+                while ( a < ActiveCount && Active[a] != First )
+                    a++;
+                if ( a < ActiveCount ) {
+                    Locations[Value] = Locations[First];
+                    Active[a] = Value;
+                    continue;
+                }
+            }
+
+            u32  Size = ( XMM ? XMM_POOL_SIZE : GPR_POOL_SIZE );
+            bool* Used = ( XMM ? UsedXMM : UsedGPR );
+            u32  Free = 0;
+            while ( Free < Size && Used[Free] )
+                Free++;
+            if ( Free < Size ) {
+                Used[Free] = true;
+                Locations[Value] = MakeLocation(
+                    XMM ? LocationKind::XMM : LocationKind::GPR,
+                    XMM ? (u8)Free : GPR_POOL[Free]);
+                Active[ActiveCount++] = Value;
+                continue;
+            }
+
+            u32 Victim = SSA_NONE;
+            for ( u32 a = 0; a < ActiveCount; a++ )
+                if ( IsXMM(Active[a]) == XMM
+                     && ( Victim == SSA_NONE || End[Active[a]] > End[Active[Victim]] ) )
+                    Victim = a;
+            Location Slot = MakeLocation(LocationKind::MEMORY, RSP,
+                                         (i32)( Slots++ * sizeof(u64) ));
+            if ( End[Active[Victim]] > End[Value] ) {
+                Locations[Value] = Locations[Active[Victim]];
+                Locations[Active[Victim]] = Slot;
+                Active[Victim] = Value;
+            }
+            else
+                Locations[Value] = Slot;
+        }
+        return Slots;
+    }
+
+    /// @brief Returns true if Func reaches a backward jump before any
+    /// `Instruction` an `SSAGraph` cannot express, walking its Code
+    /// Space one `Instruction` at a time from Entry
+    ////////////////////////////////////////
+    static bool IsWorthOptimising(const Function& Func,
+                                  const DecodedInstruction* Decoded,
+                                  u32 Entry) noexcept
+    {
+        const Instruction* Code  = Func.GetCodeSpace();
+        u32                Count = Func.GetInstructionCount();
+        for ( u32 i = Entry; i < Count; ) {
+            if ( !IsSSASupported(Decoded[i], Func) )
+                return false;
+            i32 Target;
+            if ( Instruction::GetJumpTarget(Code[i], i, Target)
+                 && Target >= 0 && (u32)Target <= i )
+                return true;
+            i += Instruction::GetWordCount(Code[i].Any.Op);
+        }
+        return false;
+    }
+
+    /// @brief Allocates registers for an optimised `SSAGraph`,
+    /// and emits it into executable memory
+    /// @param At The `Instruction` the graph is entered at
+    /// @return The entry point, or nullptr if memory ran out,
+    /// or the globals it accesses cannot be speculated on.
+    ////////////////////////////////////////
+    static ExposedFunc LowerSSA(const SSAGraph& Graph, Function& Func,
+                                ExecState& State, u32 At) noexcept
+    {
+        CoreAllocator& Allocator = State.Allocator;
+        u32 Values = Graph.ValueCount;
+        u32* Start     = Allocator.Request<u32>(Values, SYSTEM_ALLOC_FLAGS);
+        u32* End       = Allocator.Request<u32>(Values, SYSTEM_ALLOC_FLAGS);
+        u32* Sorted    = Allocator.Request<u32>(Values, SYSTEM_ALLOC_FLAGS);
+        u32* Guards    = Allocator.Request<u32>(Values, SYSTEM_ALLOC_FLAGS);
+        u32* Stubs     = Allocator.Request<u32>(Values, SYSTEM_ALLOC_FLAGS);
+        u32* Labels    = Allocator.Request<u32>(Graph.BlockCount, SYSTEM_ALLOC_FLAGS);
+        Location* Locations = Allocator.Request<Location>(Values, SYSTEM_ALLOC_FLAGS);
+        PendingMove* Moves  = Allocator.Request<PendingMove>(Register::COUNT,
+                                                             SYSTEM_ALLOC_FLAGS);
+        ExposedFunc Entry = nullptr;
+        GlobalSpeculation* Speculation = nullptr;
+
+        if ( Start && End && Sorted && Guards && Stubs && Labels && Locations
+             && Moves && SpeculateGlobals(Graph, Func, State, Speculation)
+             && ComputeLiveRanges(Graph, Allocator, Start, End) ) {
+            // Six saved registers and the return address leave
+            // rsp 16-byte aligned for calls below an odd frame
+            u32 Slots = AllocateRegisters(Graph, Start, End, Sorted, Locations);
+            u32 Frame = ( Slots * (u32)sizeof(u64) ) | 8;
+            Lowering L = {
+                Graph, Func, { nullptr, 0 }, Locations, Labels, Stubs, 0,
+                Guards, 0, (i32)( (byte*)State.Reg - (byte*)&State ), Frame, 0, 0,
+                Speculation, State.Storage.GetGenerationAddress(), At, 0, 0, 0
+            };
+
+            EmitFunction(L, Func, Moves);
+            u32 Size = L.Pool + L.PoolCount * (u32)sizeof(u64);
+            byte* Code = MapJITCode(State, Func, Size);
+            if ( Code ) {
+                L.E = { Code, 0 };
+                EmitFunction(L, Func, Moves);
+                // The speculation table is released along with the code
+                Entry = SealJITCode(State, Func, Code, Size, Speculation);
+            }
+        }
+
+        Allocator.Release(Start);
+        Allocator.Release(End);
+        Allocator.Release(Sorted);
+        Allocator.Release(Guards);
+        Allocator.Release(Stubs);
+        Allocator.Release(Labels);
+        Allocator.Release(Locations);
+        Allocator.Release(Moves);
+        if ( !Entry )
+            Allocator.Release(Speculation);
+        return Entry;
+    }
+
+#endif /* OCTVM_TEMPLATE_JIT */
+
+    /// COMPILEOPTIMIZINGJIT:
+    ////////////////////////////////////////
+    ExposedFunc CompileOptimizingJIT(Function& Func, ExecState& State,
+                                     u32 Entry) noexcept
+    {
+    #if OCTVM_TEMPLATE_JIT
+        const DecodedInstruction* Decoded = Func.GetDecodedChecked();
+        if ( !Decoded || Func.GetInstructionCount() > MAX_OPTIMISED_COUNT
+             || Entry >= Func.GetInstructionCount()
+             || !IsWorthOptimising(Func, Decoded, Entry) )
+            return CompileTemplateJIT(Func, State, Entry);
+
+        SSAGraph Graph;
+        if ( !BuildSSA(Func, State.Allocator, Graph, Entry) )
+            return CompileTemplateJIT(Func, State, Entry);
+        OptimiseSSA(Graph);
+        ExposedFunc Compiled = LowerSSA(Graph, Func, State, Entry);
+        ReleaseSSA(Graph, State.Allocator);
+        return ( Compiled ? Compiled
+                          : CompileTemplateJIT(Func, State, Entry) );
+    #else
+        return CompileTemplateJIT(Func, State, Entry);
+    #endif
+    }
+
+}
@@ -0,0 +1,795 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#define OCTVM_INTERNAL 1
+
+#include "Headers/Peephole.hpp"
+#include "Headers/Functions.hpp"
+
+namespace Octane {
+
+    using Register = VPCore::Register;
+
+    /// @brief What is known about a register
+    ////////////////////////////////////////
+    enum class ValueKind : u8 {
+        /// Anything, as far as the pass can tell
+        UNKNOWN,
+        /// Always `RegValue::Value`
+        CONSTANT,
+        /// Always the value of `RegValue::Source`, which
+        /// is itself UNKNOWN. Whenever the source is written,
+        /// every copy of it turns UNKNOWN.
+        COPY,
+    };
+
+    struct RegValue {
+        u64       Value;
+        ValueKind Kind;
+        u8        Source;
+    };
+
+    /// @brief The dataflow state on entry to an `Instruction`
+    ////////////////////////////////////////
+    struct RegFile {
+        RegValue Reg[Register::COUNT];
+    };
+
+    /// REGISTER: STATE:
+    ////////////////////////////////////////
+
+    static OctVM_SternInline
+    bool GetConstant(const RegFile& State, u8 Reg, u64& Value) noexcept
+    {
+        if ( State.Reg[Reg].Kind != ValueKind::CONSTANT )
+            return false;
+        Value = State.Reg[Reg].Value;
+        return true;
+    }
+
+    /// @brief Returns the register whose value Reg holds
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    u8 GetRoot(const RegFile& State, u8 Reg) noexcept
+    {
+        return ( State.Reg[Reg].Kind == ValueKind::COPY
+                 ? State.Reg[Reg].Source : Reg );
+    }
+
+    static void Define(RegFile& State, u8 Reg, RegValue Value) noexcept
+    {
+        for ( u8 i = 0; i < Register::COUNT; i++ ) {
+            if ( State.Reg[i].Kind == ValueKind::COPY
+              && State.Reg[i].Source == Reg )
+                State.Reg[i] = { 0, ValueKind::UNKNOWN, 0 };
+        }
+        State.Reg[Reg] = Value;
+    }
+
+    static void DefineCopy(RegFile& State, u8 Reg, u8 From) noexcept
+    {
+        u64 Value = 0;
+        if ( GetConstant(State, From, Value) ) {
+            Define(State, Reg, { Value, ValueKind::CONSTANT, 0 });
+            return;
+        }
+        // Reg already holds the value of From
+        u8 Root = GetRoot(State, From);
+        if ( Root != Reg )
+            Define(State, Reg, { 0, ValueKind::COPY, Root });
+    }
+
+    static void Clobber(RegFile& State) noexcept
+    {
+        for ( u8 i = 0; i < Register::COUNT; i++ )
+            State.Reg[i] = { 0, ValueKind::UNKNOWN, 0 };
+    }
+
+    /// @brief Joins the state already known at a site
+    /// with the state arriving from another path
+    /// @return True if the site's state changed.
+    ////////////////////////////////////////
+    static bool MergeState(RegFile& Site, const RegFile& State) noexcept
+    {
+        bool Changed = false;
+        for ( u8 i = 0; i < Register::COUNT; i++ ) {
+            RegValue&       Old = Site.Reg[i];
+            const RegValue& New = State.Reg[i];
+            if ( Old.Kind == ValueKind::UNKNOWN )
+                continue;
+            if ( Old.Kind == New.Kind
+              && ( Old.Kind != ValueKind::CONSTANT || Old.Value == New.Value )
+              && ( Old.Kind != ValueKind::COPY || Old.Source == New.Source ) )
+                continue;
+            Old     = { 0, ValueKind::UNKNOWN, 0 };
+            Changed = true;
+        }
+        return Changed;
+    }
+
+    /// EVALUATION:
+    ////////////////////////////////////////
+
+    /// @brief Returns true if a FAULTING `Instruction`
+    /// may raise, given the state it is entered with
+    ////////////////////////////////////////
+    static bool MayRaise(const Instruction& Ins, const RegFile& State) noexcept
+    {
+        RegOperands Ops     = GetRegOperands(Ins);
+        Register    Base    = {};
+        Register    Exp     = {};
+        bool        HasBase = GetConstant(State, Ops.Y, Base.AsU64);
+        bool        HasExp  = GetConstant(State, Ops.Z, Exp.AsU64);
+        switch ( Ins.Any.Op ) {
+            case Instruction::div:  case Instruction::mod:
+            case Instruction::idiv: case Instruction::imod:
+                return !( HasExp && Exp.AsU64 );
+            case Instruction::powi:
+                return !( ( HasExp && Exp.AsI64 >= 0 )
+                       || ( HasBase && Base.AsI64 ) );
+            case Instruction::fdiv: case Instruction::fmod:
+                return !( HasExp && Exp.AsF32 != 0.0f );
+            case Instruction::ddiv: case Instruction::dmod:
+                return !( HasExp && Exp.AsF64 != 0.0 );
+            default:
+                return true;
+        }
+    }
+
+    /// @brief Returns the register an `Instruction` copies
+    /// into rX unchanged, such as `mov` or `addimm` by 0
+    /// @return False if it is not a copy.
+    ////////////////////////////////////////
+    static bool GetCopySource(const Instruction& Ins, u8& From) noexcept
+    {
+        u16 Imm = Ins.Imm16Alt.Imm;
+        switch ( Ins.Any.Op ) {
+            case Instruction::mov:
+                From = Ins.DualParam.rY;
+                return true;
+            case Instruction::addimm: case Instruction::subimm:
+            case Instruction::borimm: case Instruction::bxorimm:
+                break;
+            case Instruction::shlimm: case Instruction::shrimm:
+                Imm &= 63;
+                break;
+            case Instruction::mulimm: case Instruction::divimm:
+            case Instruction::idivimm:
+                Imm = ( Imm == 1 ? 0 : 1 );
+                break;
+            default:
+                return false;
+        }
+        if ( Imm )
+            return false;
+        From = GetRegOperands(Ins).Y;
+        return true;
+    }
+
+    /// @brief Computes the value a PURE or FAULTING
+    /// integer `Instruction` writes into rX
+    /// @return False if the value is not known, or
+    /// if the `Instruction` would raise instead.
+    ////////////////////////////////////////
+    static bool Evaluate(const Instruction* Code, u32 IDX,
+                         const RegFile& State, u64& Result) noexcept
+    {
+        const Instruction& Ins = Code[IDX];
+        RegOperands Ops = GetRegOperands(Ins);
+        u64      Imm = Ins.Imm16Alt.Imm;
+        u64      A   = 0;
+        u64      B   = 0;
+
+        switch ( Ins.Any.Op ) {
+            case Instruction::clr:
+                Result = 0;
+                return true;
+            case Instruction::movimm:
+                Result = Ins.Imm16.Imm;
+                return true;
+            case Instruction::bnotimm:
+                Result = ~(u64)Ins.Imm16.Imm;
+                return true;
+            case Instruction::movimm32: case Instruction::movimmf:
+                Result = Code[IDX + 1].RawInt;
+                return true;
+            case Instruction::movimm64: case Instruction::movimmd:
+                Result = (u64)Code[IDX + 1].RawInt
+                       | ( (u64)Code[IDX + 2].RawInt << 32 );
+                return true;
+            case Instruction::inc: case Instruction::dec:
+                if ( !GetConstant(State, Ops.X, A) )
+                    return false;
+                Result = ( Ins.Any.Op == Instruction::inc ? A + 1 : A - 1 );
+                return true;
+            // Zero absorbs any register
+            case Instruction::mulimm: case Instruction::bandimm:
+                if ( !Imm ) {
+                    Result = 0;
+                    return true;
+                }
+                break;
+            default:
+                break;
+        }
+
+        if ( Ops.Y == Register::UNUSED || !GetConstant(State, Ops.Y, A) )
+            return false;
+        if ( Ops.Z != Register::UNUSED && !GetConstant(State, Ops.Z, B) )
+            return false;
+
+        switch ( Ins.Any.Op ) {
+            case Instruction::mov:      Result = A;                     break;
+            case Instruction::cmpis0:   Result = ( A == 0 );            break;
+            case Instruction::cmpnot0:  Result = ( A != 0 );            break;
+            case Instruction::cmpeq:    Result = ( A == B );            break;
+            case Instruction::cmpneq:   Result = ( A != B );            break;
+            case Instruction::cmplt:    Result = ( A <  B );            break;
+            case Instruction::cmpgt:    Result = ( A >  B );            break;
+            case Instruction::cmplteq:  Result = ( A <= B );            break;
+            case Instruction::cmpgteq:  Result = ( A >= B );            break;
+            case Instruction::cmplti:   Result = ( (i64)A <  (i64)B );  break;
+            case Instruction::cmpgti:   Result = ( (i64)A >  (i64)B );  break;
+            case Instruction::cmplteqi: Result = ( (i64)A <= (i64)B );  break;
+            case Instruction::cmpgteqi: Result = ( (i64)A >= (i64)B );  break;
+            case Instruction::land:     Result = ( A && B );            break;
+            case Instruction::lor:      Result = ( A || B );            break;
+            case Instruction::lnot:     Result = !A;                    break;
+            case Instruction::add:      Result = A + B;                 break;
+            case Instruction::sub:      Result = A - B;                 break;
+            case Instruction::mul:      Result = A * B;                 break;
+            case Instruction::band:     Result = A & B;                 break;
+            case Instruction::bor:      Result = A | B;                 break;
+            case Instruction::bxor:     Result = A ^ B;                 break;
+            case Instruction::bnot:     Result = ~A;                    break;
+            case Instruction::shl:      Result = A << ( B & 63 );       break;
+            case Instruction::shr:      Result = A >> ( B & 63 );       break;
+            case Instruction::addimm:   Result = A + Imm;               break;
+            case Instruction::subimm:   Result = A - Imm;               break;
+            case Instruction::mulimm:   Result = A * Imm;               break;
+            case Instruction::bandimm:  Result = A & Imm;               break;
+            case Instruction::borimm:   Result = A | Imm;               break;
+            case Instruction::bxorimm:  Result = A ^ Imm;               break;
+            case Instruction::shlimm:   Result = A << ( Imm & 63 );     break;
+            case Instruction::shrimm:   Result = A >> ( Imm & 63 );     break;
+            case Instruction::div:
+            case Instruction::mod:
+                if ( !B )
+                    return false;
+                Result = ( Ins.Any.Op == Instruction::div ? A / B : A % B );
+                break;
+            case Instruction::divimm:
+            case Instruction::modimm:
+                if ( !Imm )
+                    return false;
+                Result = ( Ins.Any.Op == Instruction::divimm ? A / Imm : A % Imm );
+                break;
+            // Signed division is only folded where C++ defines it
+            case Instruction::idivimm:
+            case Instruction::imodimm:
+                B = (u64)(i64)(i16)Imm;
+                [[fallthrough]];
+            case Instruction::idiv:
+            case Instruction::imod:
+                if ( !B || (i64)B == -1 )
+                    return false;
+                Result = (u64)( Ins.Any.Op == Instruction::idiv
+                             || Ins.Any.Op == Instruction::idivimm
+                                ? (i64)A / (i64)B : (i64)A % (i64)B );
+                break;
+            default:
+                return false;
+        }
+        return true;
+    }
+
+    /// @brief Decides whether a conditional jump is taken,
+    /// given the state it is entered with
+    /// @return False if either outcome is possible.
+    ////////////////////////////////////////
+    static bool EvaluateBranch(const Instruction& Ins, const RegFile& State,
+                               bool& Taken) noexcept
+    {
+        RegOperands Ops = GetRegOperands(Ins);
+        u64      A   = 0;
+        u64      B   = 0;
+        u8       Op  = Ins.Any.Op;
+
+        if ( Op == Instruction::jmpis0 || Op == Instruction::jmpnot0 ) {
+            if ( !GetConstant(State, Ops.X, A) )
+                return false;
+            Taken = ( ( A == 0 ) == ( Op == Instruction::jmpis0 ) );
+            return true;
+        }
+        if ( Op < Instruction::jmpeq || Op > Instruction::jmpgteq )
+            return false;
+
+        if ( GetConstant(State, Ops.X, A) && GetConstant(State, Ops.Y, B) ) {
+            switch ( Op ) {
+                case Instruction::jmpeq:   Taken = ( A == B ); break;
+                case Instruction::jmpneq:  Taken = ( A != B ); break;
+                case Instruction::jmplt:   Taken = ( A <  B ); break;
+                case Instruction::jmpgt:   Taken = ( A >  B ); break;
+                case Instruction::jmplteq: Taken = ( A <= B ); break;
+                default:                   Taken = ( A >= B ); break;
+            }
+            return true;
+        }
+        // Both operands hold the same, unknown value
+        if ( GetRoot(State, Ops.X) != GetRoot(State, Ops.Y) )
+            return false;
+        Taken = ( Op == Instruction::jmpeq || Op == Instruction::jmplteq
+               || Op == Instruction::jmpgteq );
+        return true;
+    }
+
+    /// @brief Applies a non-jumping `Instruction`
+    /// to the state it is entered with
+    ////////////////////////////////////////
+    static void Transfer(const Instruction* Code, u32 IDX,
+                         RegFile& State) noexcept
+    {
+        const Instruction& Ins   = Code[IDX];
+        OpClass            Class = GetOpClass(Ins);
+
+        // The handler of any `Exception` may write every register
+        if ( Class == OpClass::BARRIER
+          || ( Class == OpClass::FAULTING && MayRaise(Ins, State) ) ) {
+            Clobber(State);
+            return;
+        }
+        if ( ( Class != OpClass::PURE && Class != OpClass::FAULTING )
+          || Ins.Any.Op == Instruction::nop )
+            return;
+
+        u8  X     = GetRegOperands(Ins).X;
+        u8  From  = 0;
+        u64 Value = 0;
+        if ( Evaluate(Code, IDX, State, Value) )
+            Define(State, X, { Value, ValueKind::CONSTANT, 0 });
+        else if ( GetCopySource(Ins, From) )
+            DefineCopy(State, X, From);
+        else
+            Define(State, X, { 0, ValueKind::UNKNOWN, 0 });
+    }
+
+    /// REWRITING:
+    ////////////////////////////////////////
+
+    /// @brief Encodes the shortest load of Value into rX,
+    /// if it fits into the Size words at At
+    /// @return True if At was rewritten, in which case Size
+    /// receives the amount of words the load occupies.
+    ////////////////////////////////////////
+    static bool EncodeConstant(Instruction* At, u8& Size, u8 X,
+                               u64 Value) noexcept
+    {
+        Instruction Load[3];
+        u8          Words = 1;
+        if ( !Value )
+            Load[0] = Instruction::Make(Instruction::clr, X);
+        else if ( Value <= 0xFFFF )
+            Load[0] = Instruction::MakeImm16(Instruction::movimm, X, (u16)Value);
+        else if ( ~Value <= 0xFFFF )
+            Load[0] = Instruction::MakeImm16(Instruction::bnotimm, X, (u16)~Value);
+        else if ( Value <= 0xFFFFFFFF ) {
+            Load[0] = Instruction::Make(Instruction::movimm32, X);
+            Load[1] = Instruction::MakeWord((u32)Value);
+            Words   = 2;
+        }
+        else {
+            Load[0] = Instruction::Make(Instruction::movimm64, X);
+            Load[1] = Instruction::MakeWord((u32)Value);
+            Load[2] = Instruction::MakeWord((u32)( Value >> 32 ));
+            Words   = 3;
+        }
+
+        // Loads which are already as short are kept as they are
+        bool IsLoad = false;
+        switch ( At->Any.Op ) {
+            case Instruction::clr:      case Instruction::movimm:
+            case Instruction::bnotimm:  case Instruction::movimm32:
+            case Instruction::movimm64: case Instruction::movimmf:
+            case Instruction::movimmd:
+                IsLoad = true;
+                break;
+            default:
+                break;
+        }
+        if ( Words > Size || ( Words == Size && IsLoad ) )
+            return false;
+
+        for ( u8 i = 0; i < Words; i++ )
+            At[i] = Load[i];
+        Size = Words;
+        return true;
+    }
+
+    /// @brief Rewrites a reachable PURE or FAULTING `Instruction`
+    /// from the state it is entered with
+    /// @param Out The copy of the Code Space being rewritten
+    /// @param Size The words the `Instruction` occupies, set to
+    /// 0 if it is removed
+    /// @return True if the `Instruction` was rewritten or removed.
+    ////////////////////////////////////////
+    static bool RewriteOperation(const Instruction* Code, Instruction* Out,
+                                 u32 IDX, u8& Size,
+                                 const RegFile& State) noexcept
+    {
+        const Instruction& Ins = Code[IDX];
+        if ( Ins.Any.Op == Instruction::nop ) {
+            Size = 0;
+            return true;
+        }
+        if ( Ins.Any.Op == Instruction::chrono )
+            return false;
+
+        RegOperands Ops   = GetRegOperands(Ins);
+        u8          From  = 0;
+        u64         Value = 0;
+        u64         Held  = 0;
+        if ( Evaluate(Code, IDX, State, Value) ) {
+            // rX holds Value already
+            if ( GetConstant(State, Ops.X, Held) && Held == Value ) {
+                Size = 0;
+                return true;
+            }
+            return EncodeConstant(Out + IDX, Size, Ops.X, Value);
+        }
+
+        if ( GetCopySource(Ins, From) ) {
+            u8 Root = GetRoot(State, From);
+            if ( Root == Ops.X || GetRoot(State, Ops.X) == Root ) {
+                Size = 0;
+                return true;
+            }
+            Instruction Copy = Instruction::Make(Instruction::mov, Ops.X, Root);
+            if ( Copy.RawInt == Ins.RawInt )
+                return false;
+            Out[IDX] = Copy;
+            return true;
+        }
+
+        // Read the root of every copy instead
+        Instruction Next = Ins;
+        switch ( Instruction::GetLayout(Ins.Any.Op) ) {
+            case Instruction::Layout::DUAL:
+                Next.DualParam.rY = GetRoot(State, Ops.Y);
+                break;
+            case Instruction::Layout::TRI:
+                Next.TriParam.rY = GetRoot(State, Ops.Y);
+                Next.TriParam.rZ = GetRoot(State, Ops.Z);
+                break;
+            case Instruction::Layout::ALT:
+            case Instruction::Layout::ALT_SIGNED:
+                Next.Imm16Alt.rX_rY = (u8)( ( Ops.X << 4 )
+                                          | GetRoot(State, Ops.Y) );
+                break;
+            default:
+                break;
+        }
+        if ( Next.RawInt == Ins.RawInt )
+            return false;
+        Out[IDX] = Next;
+        return true;
+    }
+
+    /// @brief Rewrites a reachable conditional jump
+    /// from the state it is entered with
+    /// @return True if the jump was rewritten or removed.
+    ////////////////////////////////////////
+    static bool RewriteBranch(const Instruction& Ins, Instruction& Out,
+                              u32 IDX, u8& Size,
+                              const RegFile& State) noexcept
+    {
+        bool Taken  = false;
+        i32  Target = 0;
+        if ( EvaluateBranch(Ins, State, Taken) ) {
+            Instruction::GetJumpTarget(Ins, IDX, Target);
+            if ( Taken )
+                Out = Instruction::MakeImm16(Instruction::jmp, 0, (u16)Target);
+            else
+                Size = 0;
+            return true;
+        }
+
+        RegOperands Ops = GetRegOperands(Ins);
+        switch ( Ins.Any.Op ) {
+            case Instruction::seek: case Instruction::jmp:
+                return false;
+            case Instruction::jmpis0: case Instruction::jmpnot0:
+                Out.Imm16.rX = GetRoot(State, Ops.X);
+                break;
+            default:
+                Out.Imm16Alt.rX_rY = (u8)( ( GetRoot(State, Ops.X) << 4 )
+                                         | GetRoot(State, Ops.Y) );
+                break;
+        }
+        return ( Out.RawInt != Ins.RawInt );
+    }
+
+    /// OPTIMISEBYTECODE:
+    ////////////////////////////////////////
+    u32 OptimiseBytecode(Function& Func, CoreAllocator& Allocator) noexcept
+    {
+        Instruction* Code  = Func.GetCodeSpace();
+        u32          Count = Func.GetInstructionCount();
+        if ( !Code || !Func.IsVerified() || Func.GetDecoded() )
+            return 0;
+
+        RegFile*     In       = Allocator.Request<RegFile>(Count, SYSTEM_ALLOC_FLAGS);
+        Instruction* Out      = Allocator.Request<Instruction>(Count, SYSTEM_ALLOC_FLAGS);
+        u8*          Words    = Allocator.Request<u8>(Count, SYSTEM_ALLOC_FLAGS);
+        u16*         Starts   = Allocator.Request<u16>(Count, SYSTEM_ALLOC_FLAGS);
+        u16*         Worklist = Allocator.Request<u16>(Count, SYSTEM_ALLOC_FLAGS);
+        // Indexed up to and including Count, the end of the Code Space
+        RegMask*     Live     = Allocator.Request<RegMask>(Count + 1, SYSTEM_ALLOC_FLAGS);
+        u16*         Map      = Allocator.Request<u16>(Count + 1, SYSTEM_ALLOC_FLAGS);
+        auto Cleanup = [&]() {
+            Allocator.Release(In);
+            Allocator.Release(Out);
+            Allocator.Release(Words);
+            Allocator.Release(Starts);
+            Allocator.Release(Worklist);
+            Allocator.Release(Live);
+            Allocator.Release(Map);
+        };
+        if ( !In || !Out || !Words || !Starts || !Worklist || !Live || !Map ) {
+            Cleanup();
+            return 0;
+        }
+
+        // One bit per `Instruction` reached by any path,
+        // and per `Instruction` currently on the Worklist
+        u64 Reached[INSTRUCTION_BITSET_WORDS] = {};
+        u64 Queued[INSTRUCTION_BITSET_WORDS]  = {};
+        u32 Pending = 0;
+        u32 Sites   = 0;
+
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            Starts[Sites++] = (u16)i;
+            Words[i]        = Instruction::GetWordCount(Code[i].Any.Op);
+        }
+        for ( u32 i = 0; i < Count; i++ )
+            Out[i] = Code[i];
+
+        auto Propagate = [&](u32 Target, const RegFile& State) {
+            u64 Bit = (u64)1 << (Target % 64);
+            if ( !( Reached[Target / 64] & Bit ) ) {
+                Reached[Target / 64] |= Bit;
+                In[Target] = State;
+            }
+            else if ( !MergeState(In[Target], State) )
+                return;
+            if ( !( Queued[Target / 64] & Bit ) ) {
+                Queued[Target / 64] |= Bit;
+                Worklist[Pending++] = (u16)Target;
+            }
+        };
+
+        // Pass 1: Forward dataflow. Every register changes at
+        // most twice, from its first value to UNKNOWN, and the
+        // state only flows along edges which can still be taken.
+        RegFile Entry;
+        Clobber(Entry);
+        Propagate(0, Entry);
+        while ( Pending ) {
+            u32 IDX = Worklist[--Pending];
+            Queued[IDX / 64] &= ~( (u64)1 << (IDX % 64) );
+
+            RegFile            State = In[IDX];
+            const Instruction& Ins   = Code[IDX];
+            u32                Next  = IDX + Instruction::GetWordCount(Ins.Any.Op);
+
+            i32 Target = 0;
+            if ( Instruction::GetJumpTarget(Ins, IDX, Target) ) {
+                bool Taken = true;
+                bool Known = ( Ins.Any.Op == Instruction::jmp
+                            || Ins.Any.Op == Instruction::seek
+                            || EvaluateBranch(Ins, State, Taken) );
+                if ( !Known || Taken )
+                    Propagate((u32)Target, State);
+                if ( Known && Taken )
+                    continue;
+            }
+            else
+                Transfer(Code, IDX, State);
+            if ( Ins.Any.Op != Instruction::ret && Next < Count )
+                Propagate(Next, State);
+        }
+
+        // Pass 2: Rewrite every `Instruction` from its entry state
+        u32 Changes = 0;
+        for ( u32 s = 0; s < Sites; s++ ) {
+            u32 IDX = Starts[s];
+            if ( !( Reached[IDX / 64] & ( (u64)1 << (IDX % 64) ) ) ) {
+                Words[IDX] = 0;
+                Changes++;
+                continue;
+            }
+            switch ( GetOpClass(Code[IDX]) ) {
+                case OpClass::PURE:
+                case OpClass::FAULTING:
+                    Changes += RewriteOperation(Code, Out, IDX, Words[IDX], In[IDX]);
+                    break;
+                case OpClass::BRANCH:
+                    Changes += RewriteBranch(Code[IDX], Out[IDX], IDX,
+                                             Words[IDX], In[IDX]);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Returns the first `Instruction` from IDX on which is kept
+        auto SkipRemoved = [&](u32 IDX) {
+            while ( IDX < Count && !Words[IDX] )
+                IDX += Instruction::GetWordCount(Code[IDX].Any.Op);
+            return IDX;
+        };
+
+        // Pass 3: Remove PURE `Instruction`s whose result is never
+        // read, until no more are found. `ret`, running off the end,
+        // and anything which may raise read every register.
+        for ( bool Removed = true; Removed; ) {
+            Removed = false;
+            Live[Count] = ALL_REGISTERS;
+            for ( u32 s = 0; s < Sites; s++ )
+                Live[Starts[s]] = 0;
+
+            for ( bool Changed = true; Changed; ) {
+                Changed = false;
+                for ( u32 s = Sites; s-- > 0; ) {
+                    u32                IDX  = Starts[s];
+                    const Instruction& Ins  = Out[IDX];
+                    u32                Next = IDX + Instruction::GetWordCount(Code[IDX].Any.Op);
+                    RegMask            Mask = ALL_REGISTERS;
+                    i32                Target = 0;
+
+                    if ( !Words[IDX] )
+                        Mask = Live[Next];
+                    else switch ( GetOpClass(Ins) ) {
+                        case OpClass::BRANCH:
+                            Instruction::GetJumpTarget(Ins, IDX, Target);
+                            Mask = (RegMask)( Live[Target] | GetRegReads(Ins) );
+                            if ( Ins.Any.Op != Instruction::jmp
+                              && Ins.Any.Op != Instruction::seek )
+                                Mask |= Live[Next];
+                            break;
+                        case OpClass::PURE:
+                            Mask = (RegMask)( ( Live[Next] & ~GetRegBit(GetRegOperands(Ins).X) )
+                                            | GetRegReads(Ins) );
+                            break;
+                        default:
+                            break;
+                    }
+                    if ( Mask != Live[IDX] ) {
+                        Live[IDX] = Mask;
+                        Changed   = true;
+                    }
+                }
+            }
+
+            for ( u32 s = 0; s < Sites; s++ ) {
+                u32 IDX  = Starts[s];
+                u32 Next = IDX + Instruction::GetWordCount(Code[IDX].Any.Op);
+                if ( Words[IDX] && GetOpClass(Out[IDX]) == OpClass::PURE
+                  && !( Live[Next] & GetRegBit(GetRegOperands(Out[IDX]).X) ) ) {
+                    Words[IDX] = 0;
+                    Removed    = true;
+                    Changes++;
+                }
+            }
+        }
+
+        // Returns where a jump to IDX ends up, following every `jmp`
+        auto Thread = [&](u32 IDX) {
+            for ( u32 Steps = 0; ; Steps++ ) {
+                u32 Kept = SkipRemoved(IDX);
+                // Execution still has to run off the end from here
+                if ( Kept == Count ) {
+                    Out[IDX]   = Instruction::Make(Instruction::nop);
+                    Words[IDX] = 1;
+                    return IDX;
+                }
+                IDX = Kept;
+                i32 Target = 0;
+                if ( Steps >= Count || ( Out[IDX].Any.Op != Instruction::jmp
+                                      && Out[IDX].Any.Op != Instruction::seek ) )
+                    return IDX;
+                Instruction::GetJumpTarget(Out[IDX], IDX, Target);
+                IDX = (u32)Target;
+            }
+        };
+
+        // Pass 4: Thread every jump, in reverse so that
+        // jumps to the next `Instruction` are found once
+        // everything after them has been decided upon
+        for ( u32 s = Sites; s-- > 0; ) {
+            u32          IDX = Starts[s];
+            Instruction& Ins = Out[IDX];
+            i32          Target = 0;
+            if ( !Words[IDX] || !Instruction::GetJumpTarget(Ins, IDX, Target) )
+                continue;
+
+            u32  Final = Thread((u32)Target);
+            u32  Next  = IDX + Instruction::GetWordCount(Code[IDX].Any.Op);
+            bool Jump  = ( Ins.Any.Op == Instruction::jmp
+                        || Ins.Any.Op == Instruction::seek );
+            if ( Final == SkipRemoved(Next) ) {
+                Words[IDX] = 0;
+                Changes++;
+            }
+            else if ( Jump && Out[Final].Any.Op == Instruction::ret ) {
+                Ins = Instruction::Make(Instruction::ret);
+                Changes++;
+            }
+            else if ( Final != (u32)Target ) {
+                Instruction::SetJumpTarget(Ins, IDX, Final);
+                Changes++;
+            }
+        }
+
+        // Pass 5: Compact what is left, pointing every removed
+        // `Instruction` at the next one kept
+        u32 Kept = 0;
+        for ( u32 s = 0; s < Sites; s++ ) {
+            Map[Starts[s]] = (u16)Kept;
+            Kept += Words[Starts[s]];
+        }
+        Map[Count] = (u16)Kept;
+        for ( u32 s = Sites; s-- > 0; ) {
+            u32 IDX = Starts[s];
+            if ( !Words[IDX] )
+                Map[IDX] = Map[IDX + Instruction::GetWordCount(Code[IDX].Any.Op)];
+        }
+
+        // An empty Code Space would return instead of running off its end
+        if ( !Changes || !Kept ) {
+            Cleanup();
+            return 0;
+        }
+
+        // Inlined `Instruction`s keep their origin as they move
+        InlineOrigin* Origins = Func.GetInlineOrigins();
+        for ( u32 s = 0; s < Sites; s++ ) {
+            u32 IDX = Starts[s];
+            u32 To  = Map[IDX];
+            for ( u8 i = 0; i < Words[IDX]; i++ ) {
+                Code[To + i] = Out[IDX + i];
+                if ( Origins )
+                    Origins[To + i] = Origins[IDX + i];
+            }
+
+            i32 Target = 0;
+            if ( Words[IDX] && Instruction::GetJumpTarget(Out[IDX], IDX, Target) )
+                Instruction::SetJumpTarget(Code[To], To, Map[Target]);
+        }
+        Func.TruncateCodeSpace((u16)Kept);
+
+        Cleanup();
+        return Changes;
+    }
+
+}
@@ -0,0 +1,1325 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#define OCTVM_INTERNAL 1
+
+#include "Headers/SSA.hpp"
+#include "Headers/Functions.hpp"
+
+namespace Octane {
+
+    using Register = VPCore::Register;
+
+    /// @brief How an `Instruction` affects the
+    /// block it is lifted into
+    ////////////////////////////////////////
+    enum class LiftKind : u8 {
+        /// Computes a value, and continues with the next `Instruction`
+        PLAIN,
+        /// Ends the block with the matching `SSAExit`
+        JUMP, BRANCH, RETURN, EXIT,
+    };
+
+    /// ISSSASUPPORTED:
+    ////////////////////////////////////////
+    bool IsSSASupported(const DecodedInstruction& D,
+                        const Function& Func) noexcept
+    {
+        switch ( GetBaseOpcode(D.Op) ) {
+            case Instruction::nop:      case Instruction::seek:
+            case Instruction::jmp:      case Instruction::jmpis0:
+            case Instruction::jmpnot0:  case Instruction::jmpeq:
+            case Instruction::jmpneq:   case Instruction::jmplt:
+            case Instruction::jmpgt:    case Instruction::jmplteq:
+            case Instruction::jmpgteq:  case Instruction::ret:
+            case Instruction::clr:      case Instruction::mov:
+            case Instruction::movimm:   case Instruction::movimm32:
+            case Instruction::movimm64: case Instruction::movimmf:
+            case Instruction::movimmd:  case Instruction::bnotimm:
+            case Instruction::cmpis0:   case Instruction::cmpnot0:
+            case Instruction::cmpeq:    case Instruction::cmpneq:
+            case Instruction::cmplt:    case Instruction::cmpgt:
+            case Instruction::cmplteq:  case Instruction::cmpgteq:
+            case Instruction::cmplti:   case Instruction::cmpgti:
+            case Instruction::cmplteqi: case Instruction::cmpgteqi:
+            case Instruction::cmpltf:   case Instruction::cmpgtf:
+            case Instruction::cmplteqf: case Instruction::cmpgteqf:
+            case Instruction::cmpltd:   case Instruction::cmpgtd:
+            case Instruction::cmplteqd: case Instruction::cmpgteqd:
+            case Instruction::land:     case Instruction::lor:
+            case Instruction::lnot:     case Instruction::inc:
+            case Instruction::dec:      case Instruction::i2f:
+            case Instruction::i2d:      case Instruction::f2d:
+            case Instruction::d2f:      case Instruction::sqrtf:
+            case Instruction::sqrtd:    case Instruction::add:
+            case Instruction::sub:      case Instruction::mul:
+            case Instruction::div:      case Instruction::mod:
+            case Instruction::addimm:   case Instruction::subimm:
+            case Instruction::mulimm:   case Instruction::idiv:
+            case Instruction::imod:     case Instruction::fadd:
+            case Instruction::fsub:     case Instruction::fmul:
+            case Instruction::fdiv:     case Instruction::dadd:
+            case Instruction::dsub:     case Instruction::dmul:
+            case Instruction::ddiv:     case Instruction::band:
+            case Instruction::bor:      case Instruction::bxor:
+            case Instruction::bnot:     case Instruction::shl:
+            case Instruction::shr:      case Instruction::bandimm:
+            case Instruction::borimm:   case Instruction::bxorimm:
+            case Instruction::shlimm:   case Instruction::shrimm:
+                return true;
+
+            // The Shared Space never moves, so its address is constant
+            case Instruction::offset:
+                return ( D.Imm < Func.GetSharedSize() );
+            // Immediate divisors which always exit are left to the
+            // interpreter, which also defines INT64_MIN / -1
+            case Instruction::divimm:
+            case Instruction::modimm:
+                return ( GetImmediateDivisor(D) != 0 );
+            case Instruction::idivimm:
+            case Instruction::imodimm: {
+                u64 Divisor = GetImmediateDivisor(D);
+                return ( Divisor != 0 && (i64)Divisor != -1 );
+            }
+            // Sites which never ran have no key to compile for
+            case Instruction::gload8:  case Instruction::gload16:
+            case Instruction::gload32: case Instruction::gload64:
+            case Instruction::gsave8:  case Instruction::gsave16:
+            case Instruction::gsave32: case Instruction::gsave64:
+                return ( ( (const GlobalCache*)D.Imm )->Key != nullptr );
+
+            default:
+                return false;
+        }
+    }
+
+    /// @brief Returns how the `Instruction` decoded into D
+    /// affects the block it is lifted into
+    ////////////////////////////////////////
+    static LiftKind Classify(const DecodedInstruction& D,
+                             const Function& Func) noexcept
+    {
+        switch ( GetBaseOpcode(D.Op) ) {
+            case Instruction::seek:
+            case Instruction::jmp:
+                return LiftKind::JUMP;
+            case Instruction::jmpis0:  case Instruction::jmpnot0:
+            case Instruction::jmpeq:   case Instruction::jmpneq:
+            case Instruction::jmplt:   case Instruction::jmpgt:
+            case Instruction::jmplteq: case Instruction::jmpgteq:
+                return LiftKind::BRANCH;
+            case Instruction::ret:
+                return LiftKind::RETURN;
+            default:
+                return ( IsSSASupported(D, Func) ? LiftKind::PLAIN
+                                                 : LiftKind::EXIT );
+        }
+    }
+
+    /// @brief Returns the `SSACond` of a conditional jump
+    ////////////////////////////////////////
+    static u8 GetBranchCond(u8 Op) noexcept
+    {
+        switch ( Op ) {
+            case Instruction::jmpis0:  case Instruction::jmpeq:   return COND_EQ;
+            case Instruction::jmpnot0: case Instruction::jmpneq:  return COND_NE;
+            case Instruction::jmplt:                              return COND_LT;
+            case Instruction::jmpgt:                              return COND_GT;
+            case Instruction::jmplteq:                            return COND_LE;
+            default:                                              return COND_GE;
+        }
+    }
+
+    /// @brief Returns the `SSAType` an operation produces
+    ////////////////////////////////////////
+    static SSAType GetResultType(u8 Op) noexcept
+    {
+        switch ( Op ) {
+            case SSA_FADD: case SSA_FSUB: case SSA_FMUL: case SSA_FDIV:
+            case SSA_FSQRT: case SSA_I2F: case SSA_D2F:
+                return SSAType::F32;
+            case SSA_DADD: case SSA_DSUB: case SSA_DMUL: case SSA_DDIV:
+            case SSA_DSQRT: case SSA_I2D: case SSA_F2D:
+                return SSAType::F64;
+            default:
+                return SSAType::I64;
+        }
+    }
+
+    /// @brief Returns true if an operation reads
+    /// its operands as floating point values
+    ////////////////////////////////////////
+    static bool ReadsFloat(u8 Op) noexcept
+    {
+        switch ( Op ) {
+            case SSA_FADD: case SSA_FSUB: case SSA_FMUL: case SSA_FDIV:
+            case SSA_FSQRT: case SSA_DADD: case SSA_DSUB: case SSA_DMUL:
+            case SSA_DDIV: case SSA_DSQRT: case SSA_FCMP: case SSA_DCMP:
+            case SSA_F2D: case SSA_D2F:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /// @brief Returns true if an operation reads or
+    /// writes memory, which stores may change at any time
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    bool IsMemoryAccess(u8 Op) noexcept
+        { return ( Op == SSA_LOAD || Op == SSA_STORE ); }
+
+    /// @brief Returns the amount of successors of a block
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    u32 GetSuccCount(const SSABlock& Block) noexcept
+    {
+        return ( Block.Exit == SSAExit::JUMP   ? 1
+               : Block.Exit == SSAExit::BRANCH ? 2 : 0 );
+    }
+
+    /// GRAPH: CONSTRUCTION:
+    ////////////////////////////////////////
+
+    static u32 NewBlock(SSAGraph& Graph, SSAExit Exit,
+                        u32 Start, u32 Site) noexcept
+    {
+        u32 IDX = Graph.BlockCount++;
+        SSABlock& Block = Graph.Blocks[IDX];
+        Block.First      = SSA_NONE;
+        Block.Last       = SSA_NONE;
+        Block.Preds      = 0;
+        Block.PredCount  = 0;
+        Block.Succ[0]    = SSA_NONE;
+        Block.Succ[1]    = SSA_NONE;
+        Block.Args[0]    = SSA_NONE;
+        Block.Args[1]    = SSA_NONE;
+        Block.Snapshot   = SSA_NONE;
+        Block.Start      = Start;
+        Block.Site       = Site;
+        Block.IDom       = SSA_NONE;
+        Block.Order      = SSA_NONE;
+        Block.Loop       = SSA_NONE;
+        Block.LoopParent = SSA_NONE;
+        Block.Preheader  = SSA_NONE;
+        Block.Exit       = Exit;
+        Block.Cond       = COND_EQ;
+        return IDX;
+    }
+
+    /// @brief Links a value onto the end of a block
+    ////////////////////////////////////////
+    static void AppendValue(SSAGraph& Graph, u32 Block, u32 IDX) noexcept
+    {
+        SSABlock& Target = Graph.Blocks[Block];
+        SSAValue& Value  = Graph.Values[IDX];
+        Value.Block = Block;
+        Value.Prev  = Target.Last;
+        Value.Next  = SSA_NONE;
+        if ( Target.Last != SSA_NONE )
+            Graph.Values[Target.Last].Next = IDX;
+        else
+            Target.First = IDX;
+        Target.Last = IDX;
+    }
+
+    /// @brief Unlinks a value from its block
+    ////////////////////////////////////////
+    static void UnlinkValue(SSAGraph& Graph, u32 IDX) noexcept
+    {
+        SSAValue& Value  = Graph.Values[IDX];
+        SSABlock& Target = Graph.Blocks[Value.Block];
+        if ( Value.Prev != SSA_NONE )
+            Graph.Values[Value.Prev].Next = Value.Next;
+        else
+            Target.First = Value.Next;
+        if ( Value.Next != SSA_NONE )
+            Graph.Values[Value.Next].Prev = Value.Prev;
+        else
+            Target.Last = Value.Prev;
+        Value.Prev = Value.Next = SSA_NONE;
+    }
+
+    static u32 NewValue(SSAGraph& Graph, u32 Block, u8 Op,
+                        u32 A = SSA_NONE, u32 B = SSA_NONE,
+                        u64 Imm = 0) noexcept
+    {
+        u32 IDX = Graph.ValueCount++;
+        SSAValue& Value = Graph.Values[IDX];
+        Value.Imm      = Imm;
+        Value.Args[0]  = A;
+        Value.Args[1]  = B;
+        Value.Snapshot = SSA_NONE;
+        Value.Alias    = SSA_NONE;
+        Value.Op       = Op;
+        Value.Type     = GetResultType(Op);
+        Value.Cond     = COND_EQ;
+        Value.Live     = false;
+        AppendValue(Graph, Block, IDX);
+        return IDX;
+    }
+
+    static OctVM_SternInline
+    u32 NewConst(SSAGraph& Graph, u32 Block, u64 Imm) noexcept
+        { return NewValue(Graph, Block, SSA_CONST, SSA_NONE, SSA_NONE, Imm); }
+
+    static u32 NewSnapshot(SSAGraph& Graph, u32 IDX,
+                           const u32* Current) noexcept
+    {
+        SSASnapshot& Snapshot = Graph.Snapshots[Graph.SnapshotCount];
+        Snapshot.IDX = IDX;
+        for ( u32 r = 0; r < Register::COUNT; r++ )
+            Snapshot.Values[r] = Current[r];
+        return Graph.SnapshotCount++;
+    }
+
+    /// @brief Lifts a single `PLAIN` `Instruction` into Block,
+    /// updating the value held by each register in Current
+    ////////////////////////////////////////
+    static void LiftInstruction(SSAGraph& Graph, u32 Block,
+                                const DecodedInstruction& D, u32 IDX,
+                                const Function& Func, u32* Current) noexcept
+    {
+        u32& X = Current[D.rX];
+        u32  Y = Current[D.rY < Register::COUNT ? D.rY : 0];
+        u32  Z = Current[D.rZ < Register::COUNT ? D.rZ : 0];
+
+        auto Op = [&](u8 Code, u32 A, u32 B) {
+            X = NewValue(Graph, Block, Code, A, B);
+        };
+        auto OpImm = [&](u8 Code, u64 Imm) {
+            X = NewValue(Graph, Block, Code, Y, NewConst(Graph, Block, Imm));
+        };
+        auto Compare = [&](u8 Code, u8 Cond, u32 A, u32 B) {
+            Op(Code, A, B);
+            Graph.Values[X].Cond = Cond;
+        };
+        // The Snapshot is taken before X is assigned
+        auto Checked = [&](u8 Code) {
+            u32 Snapshot = NewSnapshot(Graph, IDX, Current);
+            Op(Code, Y, Z);
+            Graph.Values[X].Snapshot = Snapshot;
+        };
+        // Keys which are not constant are checked against the
+        // one the site has seen, by address and contents,
+        // before the `Instruction`
+        auto GlobalAddress = [&]() {
+            u32 Snapshot = ( Graph.Values[Y].Op == SSA_CONST
+                             ? SSA_NONE : NewSnapshot(Graph, IDX, Current) );
+            u32 Address  = NewValue(Graph, Block, SSA_GADDR, Y, Z);
+            Graph.Values[Address].Imm      = D.Imm;
+            Graph.Values[Address].Snapshot = Snapshot;
+            return Address;
+        };
+        auto Width = [&](u8 First) {
+            return (u64)1 << ( GetBaseOpcode(D.Op) - First );
+        };
+
+        switch ( GetBaseOpcode(D.Op) ) {
+            case Instruction::clr:      X = NewConst(Graph, Block, 0);      break;
+            case Instruction::mov:      X = Y;                              break;
+            case Instruction::movimm:   case Instruction::movimm32:
+            case Instruction::movimm64: case Instruction::movimmf:
+            case Instruction::movimmd:  case Instruction::bnotimm:
+                X = NewConst(Graph, Block, D.Imm);
+                break;
+            case Instruction::offset:
+                X = NewConst(Graph, Block, (u64)( Func.GetSharedSpace() + D.Imm ));
+                break;
+
+            case Instruction::cmpis0:
+            case Instruction::lnot:     Compare(SSA_CMP, COND_EQ, Y, NewConst(Graph, Block, 0)); break;
+            case Instruction::cmpnot0:  Compare(SSA_CMP, COND_NE, Y, NewConst(Graph, Block, 0)); break;
+            case Instruction::cmpeq:    Compare(SSA_CMP,  COND_EQ,  Y, Z); break;
+            case Instruction::cmpneq:   Compare(SSA_CMP,  COND_NE,  Y, Z); break;
+            case Instruction::cmplt:    Compare(SSA_CMP,  COND_LT,  Y, Z); break;
+            case Instruction::cmpgt:    Compare(SSA_CMP,  COND_GT,  Y, Z); break;
+            case Instruction::cmplteq:  Compare(SSA_CMP,  COND_LE,  Y, Z); break;
+            case Instruction::cmpgteq:  Compare(SSA_CMP,  COND_GE,  Y, Z); break;
+            case Instruction::cmplti:   Compare(SSA_CMP,  COND_ILT, Y, Z); break;
+            case Instruction::cmpgti:   Compare(SSA_CMP,  COND_IGT, Y, Z); break;
+            case Instruction::cmplteqi: Compare(SSA_CMP,  COND_ILE, Y, Z); break;
+            case Instruction::cmpgteqi: Compare(SSA_CMP,  COND_IGE, Y, Z); break;
+            case Instruction::cmpltf:   Compare(SSA_FCMP, COND_LT,  Y, Z); break;
+            case Instruction::cmpgtf:   Compare(SSA_FCMP, COND_GT,  Y, Z); break;
+            case Instruction::cmplteqf: Compare(SSA_FCMP, COND_LE,  Y, Z); break;
+            case Instruction::cmpgteqf: Compare(SSA_FCMP, COND_GE,  Y, Z); break;
+            case Instruction::cmpltd:   Compare(SSA_DCMP, COND_LT,  Y, Z); break;
+            case Instruction::cmpgtd:   Compare(SSA_DCMP, COND_GT,  Y, Z); break;
+            case Instruction::cmplteqd: Compare(SSA_DCMP, COND_LE,  Y, Z); break;
+            case Instruction::cmpgteqd: Compare(SSA_DCMP, COND_GE,  Y, Z); break;
+            case Instruction::land:     Op(SSA_LAND, Y, Z); break;
+            case Instruction::lor:      Op(SSA_LOR,  Y, Z); break;
+
+            case Instruction::inc:
+                X = NewValue(Graph, Block, SSA_ADD, X, NewConst(Graph, Block, 1));
+                break;
+            case Instruction::dec:
+                X = NewValue(Graph, Block, SSA_SUB, X, NewConst(Graph, Block, 1));
+                break;
+            case Instruction::add:      Op(SSA_ADD, Y, Z); break;
+            case Instruction::sub:      Op(SSA_SUB, Y, Z); break;
+            case Instruction::mul:      Op(SSA_MUL, Y, Z); break;
+            case Instruction::div:      Checked(SSA_DIV);  break;
+            case Instruction::mod:      Checked(SSA_MOD);  break;
+            case Instruction::idiv:     Checked(SSA_IDIV); break;
+            case Instruction::imod:     Checked(SSA_IMOD); break;
+            case Instruction::addimm:   OpImm(SSA_ADD,  D.Imm); break;
+            case Instruction::subimm:   OpImm(SSA_SUB,  D.Imm); break;
+            case Instruction::mulimm:   OpImm(SSA_MUL,  D.Imm); break;
+            case Instruction::divimm:
+                OpImm(SSA_DIV,  GetImmediateDivisor(D)); break;
+            case Instruction::modimm:
+                OpImm(SSA_MOD,  GetImmediateDivisor(D)); break;
+            case Instruction::idivimm:
+                OpImm(SSA_IDIV, GetImmediateDivisor(D)); break;
+            case Instruction::imodimm:
+                OpImm(SSA_IMOD, GetImmediateDivisor(D)); break;
+
+            case Instruction::fadd:     Op(SSA_FADD, Y, Z);   break;
+            case Instruction::fsub:     Op(SSA_FSUB, Y, Z);   break;
+            case Instruction::fmul:     Op(SSA_FMUL, Y, Z);   break;
+            case Instruction::fdiv:     Checked(SSA_FDIV);    break;
+            case Instruction::dadd:     Op(SSA_DADD, Y, Z);   break;
+            case Instruction::dsub:     Op(SSA_DSUB, Y, Z);   break;
+            case Instruction::dmul:     Op(SSA_DMUL, Y, Z);   break;
+            case Instruction::ddiv:     Checked(SSA_DDIV);    break;
+            case Instruction::sqrtf:    Op(SSA_FSQRT, Y, SSA_NONE); break;
+            case Instruction::sqrtd:    Op(SSA_DSQRT, Y, SSA_NONE); break;
+            case Instruction::i2f:      Op(SSA_I2F, Y, SSA_NONE);   break;
+            case Instruction::i2d:      Op(SSA_I2D, Y, SSA_NONE);   break;
+            case Instruction::f2d:      Op(SSA_F2D, Y, SSA_NONE);   break;
+            case Instruction::d2f:      Op(SSA_D2F, Y, SSA_NONE);   break;
+
+            case Instruction::band:     Op(SSA_AND, Y, Z); break;
+            case Instruction::bor:      Op(SSA_OR,  Y, Z); break;
+            case Instruction::bxor:     Op(SSA_XOR, Y, Z); break;
+            case Instruction::bnot:     Op(SSA_NOT, Y, SSA_NONE); break;
+            case Instruction::shl:      Op(SSA_SHL, Y, Z); break;
+            case Instruction::shr:      Op(SSA_SHR, Y, Z); break;
+            case Instruction::bandimm:  OpImm(SSA_AND, D.Imm); break;
+            case Instruction::borimm:   OpImm(SSA_OR,  D.Imm); break;
+            case Instruction::bxorimm:  OpImm(SSA_XOR, D.Imm); break;
+            case Instruction::shlimm:   OpImm(SSA_SHL, D.Imm); break;
+            case Instruction::shrimm:   OpImm(SSA_SHR, D.Imm); break;
+
+            case Instruction::gload8:  case Instruction::gload16:
+            case Instruction::gload32: case Instruction::gload64:
+                Op(SSA_LOAD, GlobalAddress(), SSA_NONE);
+                Graph.Values[X].Imm = Width(Instruction::gload8);
+                break;
+            case Instruction::gsave8:  case Instruction::gsave16:
+            case Instruction::gsave32: case Instruction::gsave64: {
+                u32 Store = NewValue(Graph, Block, SSA_STORE, GlobalAddress(), X);
+                Graph.Values[Store].Imm = Width(Instruction::gsave8);
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    /// GRAPH: ANALYSIS:
+    ////////////////////////////////////////
+
+    /// @brief Orders the blocks reachable from Entry in reverse
+    /// postorder, and records the predecessors of each of them.
+    /// @param Scratch Storage for 2 * `BlockCapacity` entries
+    ////////////////////////////////////////
+    static void ComputeOrder(SSAGraph& Graph, u32* Scratch) noexcept
+    {
+        u32* Stack    = Scratch;
+        u32* NextSucc = Scratch + Graph.BlockCapacity;
+        for ( u32 i = 0; i < Graph.BlockCount; i++ ) {
+            Graph.Blocks[i].Order     = SSA_NONE;
+            Graph.Blocks[i].PredCount = 0;
+        }
+
+        u32 Depth = 0, Post = 0;
+        Stack[Depth++] = Graph.Entry;
+        NextSucc[Graph.Entry] = 0;
+        Graph.Blocks[Graph.Entry].Order = 0;
+        while ( Depth ) {
+            u32 IDX = Stack[Depth - 1];
+            SSABlock& Block = Graph.Blocks[IDX];
+            if ( NextSucc[IDX] < GetSuccCount(Block) ) {
+                u32 Succ = Block.Succ[NextSucc[IDX]++];
+                if ( Graph.Blocks[Succ].Order == SSA_NONE ) {
+                    Graph.Blocks[Succ].Order = 0;
+                    NextSucc[Succ] = 0;
+                    Stack[Depth++] = Succ;
+                }
+                continue;
+            }
+            Depth--;
+            Graph.Order[Post++] = IDX;
+        }
+
+        Graph.OrderCount = Post;
+        for ( u32 i = 0; i < Post / 2; i++ ) {
+            u32 Swap = Graph.Order[i];
+            Graph.Order[i] = Graph.Order[Post - 1 - i];
+            Graph.Order[Post - 1 - i] = Swap;
+        }
+
+        // Predecessors are listed per edge, in reverse postorder
+        for ( u32 i = 0; i < Post; i++ ) {
+            SSABlock& Block = Graph.Blocks[Graph.Order[i]];
+            Block.Order = i;
+            for ( u32 k = 0; k < GetSuccCount(Block); k++ )
+                Graph.Blocks[Block.Succ[k]].PredCount++;
+        }
+        u32 Offset = 0;
+        for ( u32 i = 0; i < Post; i++ ) {
+            SSABlock& Block = Graph.Blocks[Graph.Order[i]];
+            Block.Preds = Offset;
+            Offset += Block.PredCount;
+            Block.PredCount = 0;
+        }
+        for ( u32 i = 0; i < Post; i++ ) {
+            SSABlock& Block = Graph.Blocks[Graph.Order[i]];
+            for ( u32 k = 0; k < GetSuccCount(Block); k++ ) {
+                SSABlock& Succ = Graph.Blocks[Block.Succ[k]];
+                Graph.PredList[Succ.Preds + Succ.PredCount++] = Graph.Order[i];
+            }
+        }
+    }
+
+    /// @brief Returns the nearest common dominator of A and B
+    ////////////////////////////////////////
+    static u32 Intersect(const SSAGraph& Graph, u32 A, u32 B) noexcept
+    {
+        while ( A != B ) {
+            while ( Graph.Blocks[A].Order > Graph.Blocks[B].Order )
+                A = Graph.Blocks[A].IDom;
+            while ( Graph.Blocks[B].Order > Graph.Blocks[A].Order )
+                B = Graph.Blocks[B].IDom;
+        }
+        return A;
+    }
+
+    /// @brief Computes the immediate dominator of every
+    /// reachable block, iterating in reverse postorder
+    /// until nothing changes.
+    ////////////////////////////////////////
+    static void ComputeDominators(SSAGraph& Graph) noexcept
+    {
+        for ( u32 i = 0; i < Graph.OrderCount; i++ )
+            Graph.Blocks[Graph.Order[i]].IDom = SSA_NONE;
+        Graph.Blocks[Graph.Entry].IDom = Graph.Entry;
+
+        for ( bool Changed = true; Changed; ) {
+            Changed = false;
+            for ( u32 i = 1; i < Graph.OrderCount; i++ ) {
+                SSABlock& Block = Graph.Blocks[Graph.Order[i]];
+                u32 IDom = SSA_NONE;
+                for ( u32 k = 0; k < Block.PredCount; k++ ) {
+                    u32 Pred = Graph.PredList[Block.Preds + k];
+                    if ( Graph.Blocks[Pred].IDom == SSA_NONE )
+                        continue;
+                    IDom = ( IDom == SSA_NONE ? Pred
+                                              : Intersect(Graph, IDom, Pred) );
+                }
+                if ( IDom != Block.IDom ) {
+                    Block.IDom = IDom;
+                    Changed    = true;
+                }
+            }
+        }
+    }
+
+    /// @brief Returns true if every path from Entry to B passes through A
+    ////////////////////////////////////////
+    static bool Dominates(const SSAGraph& Graph, u32 A, u32 B) noexcept
+    {
+        for ( ;; ) {
+            if ( A == B )
+                return true;
+            if ( B == Graph.Entry )
+                return false;
+            B = Graph.Blocks[B].IDom;
+        }
+    }
+
+    /// @brief Returns true if Block lies inside
+    /// the loop headed by Header
+    ////////////////////////////////////////
+    static bool IsInLoop(const SSAGraph& Graph, u32 Block, u32 Header) noexcept
+    {
+        for ( u32 Loop = Graph.Blocks[Block].Loop; Loop != SSA_NONE;
+              Loop = Graph.Blocks[Loop].LoopParent )
+            if ( Loop == Header )
+                return true;
+        return false;
+    }
+
+    /// @brief Finds every natural loop, recording the innermost
+    /// loop of each block, and the enclosing loop and preheader
+    /// of each header. A header is a block which dominates
+    /// one of its own predecessors.
+    /// @param Scratch Storage for 2 * `BlockCapacity` entries
+    ////////////////////////////////////////
+    static void FindLoops(SSAGraph& Graph, u32* Scratch) noexcept
+    {
+        u32* Stack = Scratch;
+        u32* Mark  = Scratch + Graph.BlockCapacity;
+        for ( u32 i = 0; i < Graph.BlockCount; i++ ) {
+            Graph.Blocks[i].Loop       = SSA_NONE;
+            Graph.Blocks[i].LoopParent = SSA_NONE;
+            Graph.Blocks[i].Preheader  = SSA_NONE;
+            Mark[i] = SSA_NONE;
+        }
+
+        // Enclosing headers dominate, and so come first
+        for ( u32 i = 0; i < Graph.OrderCount; i++ ) {
+            u32 Header = Graph.Order[i];
+            SSABlock& Block = Graph.Blocks[Header];
+            u32 Depth = 0, Entries = 0, Entering = SSA_NONE;
+
+            Mark[Header] = Header;
+            for ( u32 k = 0; k < Block.PredCount; k++ ) {
+                u32 Pred = Graph.PredList[Block.Preds + k];
+                if ( !Dominates(Graph, Header, Pred) ) {
+                    Entries++;
+                    Entering = Pred;
+                }
+                else if ( Mark[Pred] != Header ) {
+                    Mark[Pred] = Header;
+                    Stack[Depth++] = Pred;
+                }
+            }
+            if ( Entries == Block.PredCount )
+                continue;
+
+            Block.LoopParent = Block.Loop;
+            Block.Loop       = Header;
+            Block.Preheader  = ( Entries == 1 ? Entering : SSA_NONE );
+            while ( Depth ) {
+                u32 IDX = Stack[--Depth];
+                SSABlock& Body = Graph.Blocks[IDX];
+                Body.Loop = Header;
+                for ( u32 k = 0; k < Body.PredCount; k++ ) {
+                    u32 Pred = Graph.PredList[Body.Preds + k];
+                    if ( Mark[Pred] != Header ) {
+                        Mark[Pred] = Header;
+                        Stack[Depth++] = Pred;
+                    }
+                }
+            }
+        }
+    }
+
+    /// @brief Gives every loop a preheader, and splits every
+    /// edge from a block with two successors into a block with
+    /// two predecessors, then computes the final order,
+    /// dominators and loops of the graph.
+    /// @param Scratch Storage for 2 * `BlockCapacity` entries
+    ////////////////////////////////////////
+    static void PrepareGraph(SSAGraph& Graph, u32* Scratch) noexcept
+    {
+        ComputeOrder(Graph, Scratch);
+        ComputeDominators(Graph);
+
+        u32 Reachable = Graph.OrderCount;
+        for ( u32 i = 0; i < Reachable; i++ ) {
+            u32 Header = Graph.Order[i];
+            const SSABlock& Block = Graph.Blocks[Header];
+            u32 Entries = 0, Entering = SSA_NONE;
+            bool IsHeader = false;
+            for ( u32 k = 0; k < Block.PredCount; k++ ) {
+                u32 Pred = Graph.PredList[Block.Preds + k];
+                if ( Dominates(Graph, Header, Pred) )
+                    IsHeader = true;
+                else {
+                    Entries++;
+                    Entering = Pred;
+                }
+            }
+            if ( !IsHeader
+                 || ( Entries == 1
+                      && GetSuccCount(Graph.Blocks[Entering]) == 1 ) )
+                continue;
+
+            u32 Preheader = NewBlock(Graph, SSAExit::JUMP, SSA_NONE, SSA_NONE);
+            Graph.Blocks[Preheader].Succ[0] = Header;
+            for ( u32 k = 0; k < Block.PredCount; k++ ) {
+                u32 Pred = Graph.PredList[Block.Preds + k];
+                if ( Dominates(Graph, Header, Pred) )
+                    continue;
+                SSABlock& From = Graph.Blocks[Pred];
+                for ( u32 s = 0; s < GetSuccCount(From); s++ )
+                    if ( From.Succ[s] == Header )
+                        From.Succ[s] = Preheader;
+            }
+        }
+
+        ComputeOrder(Graph, Scratch);
+        for ( u32 i = 0; i < Graph.OrderCount; i++ ) {
+            u32 IDX = Graph.Order[i];
+            if ( Graph.Blocks[IDX].Exit != SSAExit::BRANCH )
+                continue;
+            for ( u32 s = 0; s < 2; s++ ) {
+                u32 Succ = Graph.Blocks[IDX].Succ[s];
+                if ( Graph.Blocks[Succ].PredCount < 2 )
+                    continue;
+                u32 Split = NewBlock(Graph, SSAExit::JUMP, SSA_NONE, SSA_NONE);
+                Graph.Blocks[Split].Succ[0] = Succ;
+                Graph.Blocks[IDX].Succ[s]   = Split;
+            }
+        }
+
+        ComputeOrder(Graph, Scratch);
+        ComputeDominators(Graph);
+        FindLoops(Graph, Scratch);
+    }
+
+    /// BUILDSSA:
+    ////////////////////////////////////////
+    bool BuildSSA(const Function& Func, CoreAllocator& Allocator,
+                  SSAGraph& Graph, u32 Entry) noexcept
+    {
+        const Instruction*        Code    = Func.GetCodeSpace();
+        const DecodedInstruction* Decoded = Func.GetDecodedChecked();
+        u32                       Count   = Func.GetInstructionCount();
+
+        Graph = {};
+        if ( !Code || !Decoded || Entry >= Count )
+            return false;
+
+        auto WordsOf = [&](u32 IDX) -> u32 {
+            return Instruction::GetWordCount(Code[IDX].Any.Op);
+        };
+
+        // One bit per `Instruction` starting at that index,
+        // and per `Instruction` starting a block
+        u32  Words    = Count / 64 + 1;
+        u64* Starts   = Allocator.Request<u64>(Words * 2, SYSTEM_ALLOC_FLAGS);
+        u32* BlockOf  = Allocator.Request<u32>(Count, SYSTEM_ALLOC_FLAGS);
+        u32* Scratch  = nullptr;
+        u32* Current  = nullptr;
+        if ( !Starts || !BlockOf ) {
+            Allocator.Release(Starts);
+            Allocator.Release(BlockOf);
+            return false;
+        }
+        u64* Leaders = Starts + Words;
+        for ( u32 i = 0; i < Words * 2; i++ )
+            Starts[i] = 0;
+
+        auto Test = [](const u64* Bits, u32 IDX) {
+            return ( Bits[IDX / 64] >> ( IDX % 64 ) ) & 1;
+        };
+        auto Set = [](u64* Bits, u32 IDX) {
+            Bits[IDX / 64] |= ( (u64)1 << ( IDX % 64 ) );
+        };
+        auto Fail = [&]() {
+            Allocator.Release(Starts);
+            Allocator.Release(BlockOf);
+            Allocator.Release(Scratch);
+            Allocator.Release(Current);
+            ReleaseSSA(Graph, Allocator);
+            return false;
+        };
+
+        for ( u32 i = 0; i < Count; i += WordsOf(i) )
+            Set(Starts, i);
+
+        if ( !Test(Starts, Entry) )
+            return Fail();
+
+        u32 LeaderCount = 0, BranchCount = 0;
+        Set(Leaders, Entry);
+        for ( u32 i = 0; i < Count; i += WordsOf(i) ) {
+            LiftKind Kind = Classify(Decoded[i], Func);
+            u32      Next = i + WordsOf(i);
+            if ( Kind == LiftKind::JUMP || Kind == LiftKind::BRANCH ) {
+                u64 Target = Decoded[i].Imm;
+                if ( Target < Count ) {
+                    if ( !Test(Starts, (u32)Target) )
+                        return Fail();
+                    Set(Leaders, (u32)Target);
+                }
+                BranchCount += ( Kind == LiftKind::BRANCH );
+            }
+            if ( Kind != LiftKind::PLAIN && Next < Count )
+                Set(Leaders, Next);
+        }
+        for ( u32 i = 0; i < Count; i++ )
+            LeaderCount += (u32)Test(Leaders, i);
+
+        // The entry, every leader and the blocks outside of the
+        // Code Space, plus at most one preheader per leader and
+        // one split per branch edge
+        Graph.BlockCapacity = 1 + 2 * LeaderCount + 4 * BranchCount;
+        Graph.Blocks   = Allocator.Request<SSABlock>(Graph.BlockCapacity, SYSTEM_ALLOC_FLAGS);
+        Graph.Order    = Allocator.Request<u32>(Graph.BlockCapacity, SYSTEM_ALLOC_FLAGS);
+        Graph.PredList = Allocator.Request<u32>(Graph.BlockCapacity * 2, SYSTEM_ALLOC_FLAGS);
+        Scratch        = Allocator.Request<u32>(Graph.BlockCapacity * 2, SYSTEM_ALLOC_FLAGS);
+        if ( !Graph.Blocks || !Graph.Order || !Graph.PredList || !Scratch )
+            return Fail();
+
+        Graph.Entry = NewBlock(Graph, SSAExit::JUMP, SSA_NONE, SSA_NONE);
+        for ( u32 i = 0; i < Count; i++ )
+            if ( Test(Leaders, i) )
+                BlockOf[i] = NewBlock(Graph, SSAExit::JUMP, i, SSA_NONE);
+        Graph.Blocks[Graph.Entry].Succ[0] = BlockOf[Entry];
+
+        // Each block runs until its terminator, or until it
+        // falls through into the next leader
+        for ( u32 b = 1, Real = Graph.BlockCount; b < Real; b++ ) {
+            SSABlock& Block = Graph.Blocks[b];
+            for ( u32 i = Block.Start; ; ) {
+                LiftKind Kind = Classify(Decoded[i], Func);
+                u32      Next = i + WordsOf(i);
+                u64      Target = Decoded[i].Imm;
+
+                if ( Kind == LiftKind::PLAIN ) {
+                    if ( Next >= Count ) {
+                        Block.Exit = SSAExit::RETURN;
+                        Block.Site = Next;
+                        break;
+                    }
+                    if ( Test(Leaders, Next) ) {
+                        Block.Exit    = SSAExit::JUMP;
+                        Block.Site    = Next;
+                        Block.Succ[0] = BlockOf[Next];
+                        break;
+                    }
+                    i = Next;
+                    continue;
+                }
+
+                Block.Site = i;
+                switch ( Kind ) {
+                    case LiftKind::JUMP:
+                        if ( Target < Count ) {
+                            Block.Exit    = SSAExit::JUMP;
+                            Block.Succ[0] = BlockOf[Target];
+                        }
+                        else
+                            Block.Exit = SSAExit::EXIT;
+                        break;
+                    case LiftKind::BRANCH: {
+                        // Out of range targets are left to the interpreter
+                        u32 Taken = ( Target < Count ? BlockOf[Target]
+                                      : NewBlock(Graph, SSAExit::EXIT, SSA_NONE, i) );
+                        u32 Else  = ( Next < Count ? BlockOf[Next]
+                                      : NewBlock(Graph, SSAExit::RETURN, SSA_NONE, Next) );
+                        SSABlock& Branch = Graph.Blocks[b];
+                        Branch.Exit    = SSAExit::BRANCH;
+                        Branch.Cond    = GetBranchCond(GetBaseOpcode(Decoded[i].Op));
+                        Branch.Succ[0] = Taken;
+                        Branch.Succ[1] = Else;
+                        break;
+                    }
+                    case LiftKind::RETURN:
+                        Block.Exit = SSAExit::RETURN;
+                        break;
+                    default:
+                        Block.Exit = SSAExit::EXIT;
+                        break;
+                }
+                break;
+            }
+        }
+
+        PrepareGraph(Graph, Scratch);
+
+        // Phis are only needed where paths join
+        u32 Joins = 0, PhiArgCount = 0;
+        for ( u32 i = 1; i < Graph.OrderCount; i++ ) {
+            const SSABlock& Block = Graph.Blocks[Graph.Order[i]];
+            if ( Block.PredCount > 1 ) {
+                Joins++;
+                PhiArgCount += Register::COUNT * Block.PredCount;
+            }
+        }
+        Graph.ValueCapacity    = Register::COUNT * ( 1 + Joins ) + 3 * Count;
+        Graph.SnapshotCapacity = Count + Graph.BlockCount;
+        Graph.Values    = Allocator.Request<SSAValue>(Graph.ValueCapacity, SYSTEM_ALLOC_FLAGS);
+        Graph.Scratch   = Allocator.Request<u32>(Graph.ValueCapacity, SYSTEM_ALLOC_FLAGS);
+        Graph.PhiArgs   = Allocator.Request<u32>(PhiArgCount + 1, SYSTEM_ALLOC_FLAGS);
+        Graph.Snapshots = Allocator.Request<SSASnapshot>(Graph.SnapshotCapacity,
+                                                         SYSTEM_ALLOC_FLAGS);
+        Current = Allocator.Request<u32>(Graph.BlockCount * Register::COUNT,
+                                         SYSTEM_ALLOC_FLAGS);
+        if ( !Graph.Values || !Graph.Scratch || !Graph.PhiArgs
+             || !Graph.Snapshots || !Current )
+            return Fail();
+
+        // Blocks are lifted in reverse postorder, so that the only
+        // predecessor of a block has always been lifted before it
+        u32 PhiOffset = 0;
+        for ( u32 i = 0; i < Graph.OrderCount; i++ ) {
+            u32       IDX   = Graph.Order[i];
+            SSABlock& Block = Graph.Blocks[IDX];
+            u32*      Regs  = Current + IDX * Register::COUNT;
+
+            if ( IDX == Graph.Entry ) {
+                for ( u32 r = 0; r < Register::COUNT; r++ )
+                    Regs[r] = NewValue(Graph, IDX, SSA_PARAM, SSA_NONE, SSA_NONE, r);
+            }
+            else if ( Block.PredCount == 1 ) {
+                const u32* From = Current + Graph.PredList[Block.Preds]
+                                          * Register::COUNT;
+                for ( u32 r = 0; r < Register::COUNT; r++ )
+                    Regs[r] = From[r];
+            }
+            else {
+                for ( u32 r = 0; r < Register::COUNT; r++ ) {
+                    Regs[r] = NewValue(Graph, IDX, SSA_PHI, SSA_NONE, SSA_NONE,
+                                       PhiOffset);
+                    PhiOffset += Block.PredCount;
+                }
+            }
+
+            if ( Block.Start != SSA_NONE )
+                for ( u32 s = Block.Start; s < Block.Site && s < Count; s += WordsOf(s) )
+                    LiftInstruction(Graph, IDX, Decoded[s], s, Func, Regs);
+
+            switch ( Block.Exit ) {
+                case SSAExit::BRANCH: {
+                    const DecodedInstruction& D = Decoded[Block.Site];
+                    u8 Op = GetBaseOpcode(D.Op);
+                    Block.Args[0] = Regs[D.rX];
+                    Block.Args[1] = ( Op == Instruction::jmpis0
+                                      || Op == Instruction::jmpnot0
+                                      ? NewConst(Graph, IDX, 0) : Regs[D.rY] );
+                    break;
+                }
+                case SSAExit::RETURN:
+                    Block.Snapshot = NewSnapshot(Graph, SSA_NONE, Regs);
+                    break;
+                case SSAExit::EXIT:
+                    Block.Snapshot = NewSnapshot(Graph, Block.Site, Regs);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Every predecessor has been lifted by now
+        for ( u32 i = 1; i < Graph.OrderCount; i++ ) {
+            const SSABlock& Block = Graph.Blocks[Graph.Order[i]];
+            if ( Block.PredCount < 2 )
+                continue;
+            for ( u32 r = 0; r < Register::COUNT; r++ ) {
+                const SSAValue& Phi = Graph.Values[Block.First + r];
+                for ( u32 k = 0; k < Block.PredCount; k++ )
+                    Graph.PhiArgs[Phi.Imm + k] =
+                        Current[Graph.PredList[Block.Preds + k] * Register::COUNT + r];
+            }
+        }
+
+        Allocator.Release(Starts);
+        Allocator.Release(BlockOf);
+        Allocator.Release(Scratch);
+        Allocator.Release(Current);
+        return true;
+    }
+
+    /// FOLDING:
+    ////////////////////////////////////////
+
+    static bool EvaluateCompare(u8 Cond, u64 A, u64 B) noexcept
+    {
+        switch ( Cond ) {
+            case COND_EQ:  return A == B;
+            case COND_NE:  return A != B;
+            case COND_LT:  return A <  B;
+            case COND_GT:  return A >  B;
+            case COND_LE:  return A <= B;
+            case COND_GE:  return A >= B;
+            case COND_ILT: return (i64)A <  (i64)B;
+            case COND_IGT: return (i64)A >  (i64)B;
+            case COND_ILE: return (i64)A <= (i64)B;
+            default:       return (i64)A >= (i64)B;
+        }
+    }
+
+    /// @brief Computes an integer operation on constant operands
+    /// @return False if the operation is not an integer one,
+    /// or if it would exit instead.
+    ////////////////////////////////////////
+    static bool EvaluateInteger(u8 Op, u8 Cond, u64 A, u64 B, u64& Out) noexcept
+    {
+        switch ( Op ) {
+            case SSA_ADD:  Out = A + B;                 return true;
+            case SSA_SUB:  Out = A - B;                 return true;
+            case SSA_MUL:  Out = A * B;                 return true;
+            case SSA_AND:  Out = A & B;                 return true;
+            case SSA_OR:   Out = A | B;                 return true;
+            case SSA_XOR:  Out = A ^ B;                 return true;
+            case SSA_SHL:  Out = A << ( B & 63 );       return true;
+            case SSA_SHR:  Out = A >> ( B & 63 );       return true;
+            case SSA_NOT:  Out = ~A;                    return true;
+            case SSA_LAND: Out = ( A && B );            return true;
+            case SSA_LOR:  Out = ( A || B );            return true;
+            case SSA_CMP:  Out = EvaluateCompare(Cond, A, B); return true;
+            case SSA_DIV:
+            case SSA_MOD:
+                if ( !B )
+                    return false;
+                Out = ( Op == SSA_DIV ? A / B : A % B );
+                return true;
+            case SSA_IDIV:
+            case SSA_IMOD:
+                if ( !B || (i64)B == -1 )
+                    return false;
+                Out = (u64)( Op == SSA_IDIV ? (i64)A / (i64)B
+                                            : (i64)A % (i64)B );
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /// @brief Folds a value whose operands are constant, and
+    /// replaces it with an operand where that operand is
+    /// already its result.
+    /// @return True if the value changed.
+    ////////////////////////////////////////
+    static bool FoldValue(SSAGraph& Graph, u32 IDX) noexcept
+    {
+        SSAValue& Value = Graph.Values[IDX];
+        u32 A = ResolveSSA(Graph, Value.Args[0]);
+        u32 B = ( Value.Args[1] != SSA_NONE ? ResolveSSA(Graph, Value.Args[1])
+                                            : SSA_NONE );
+        Value.Args[0] = A;
+        Value.Args[1] = B;
+
+        bool ConstA = ( Graph.Values[A].Op == SSA_CONST );
+        bool ConstB = ( B != SSA_NONE && Graph.Values[B].Op == SSA_CONST );
+        u64  ImmA   = Graph.Values[A].Imm;
+        u64  ImmB   = ( ConstB ? Graph.Values[B].Imm : 0 );
+        u64  Result = 0;
+
+        if ( ConstA && ( B == SSA_NONE || ConstB )
+             && EvaluateInteger(Value.Op, Value.Cond, ImmA, ImmB, Result) ) {
+            Value.Op       = SSA_CONST;
+            Value.Type     = SSAType::I64;
+            Value.Imm      = Result;
+            Value.Args[0]  = SSA_NONE;
+            Value.Args[1]  = SSA_NONE;
+            Value.Snapshot = SSA_NONE;
+            return true;
+        }
+
+        bool Changed = false;
+        // Constant divisors other than 0 (and -1) can never exit
+        if ( Value.Snapshot != SSA_NONE && ConstB && ImmB
+             && ( Value.Op == SSA_DIV || Value.Op == SSA_MOD
+                  || ( ( Value.Op == SSA_IDIV || Value.Op == SSA_IMOD )
+                       && (i64)ImmB != -1 ) ) ) {
+            Value.Snapshot = SSA_NONE;
+            Changed = true;
+        }
+        if ( Value.Snapshot != SSA_NONE )
+            return Changed;
+
+        u32 Same = SSA_NONE;
+        switch ( Value.Op ) {
+            case SSA_ADD: case SSA_OR: case SSA_XOR:
+                if ( ConstB && ImmB == 0 )      Same = A;
+                else if ( ConstA && ImmA == 0 ) Same = B;
+                break;
+            case SSA_SUB:
+                if ( ConstB && ImmB == 0 )      Same = A;
+                break;
+            case SSA_SHL: case SSA_SHR:
+                if ( ConstB && !( ImmB & 63 ) ) Same = A;
+                break;
+            case SSA_MUL:
+                if ( ConstB && ImmB == 1 )      Same = A;
+                else if ( ConstA && ImmA == 1 ) Same = B;
+                break;
+            case SSA_DIV: case SSA_IDIV:
+                if ( ConstB && ImmB == 1 )      Same = A;
+                break;
+            default:
+                break;
+        }
+        if ( Same != SSA_NONE && Graph.Values[Same].Type == Value.Type ) {
+            Value.Alias = Same;
+            return true;
+        }
+        return Changed;
+    }
+
+    /// @brief Replaces a phi whose operands are all the same
+    /// value (or itself) with that value
+    /// @return True if the phi has been replaced.
+    ////////////////////////////////////////
+    static bool FoldPhi(SSAGraph& Graph, u32 IDX) noexcept
+    {
+        SSAValue& Phi   = Graph.Values[IDX];
+        u32       Count = Graph.Blocks[Phi.Block].PredCount;
+        u32       Same  = SSA_NONE;
+        for ( u32 k = 0; k < Count; k++ ) {
+            u32 Arg = ResolveSSA(Graph, Graph.PhiArgs[Phi.Imm + k]);
+            Graph.PhiArgs[Phi.Imm + k] = Arg;
+            if ( Arg == IDX || Arg == Same )
+                continue;
+            if ( Same == SSA_NONE ) {
+                Same = Arg;
+                continue;
+            }
+            const SSAValue& Old = Graph.Values[Same];
+            const SSAValue& New = Graph.Values[Arg];
+            if ( Old.Op != SSA_CONST || New.Op != SSA_CONST || Old.Imm != New.Imm )
+                return false;
+        }
+        if ( Same == SSA_NONE )
+            return false;
+        Phi.Alias = Same;
+        return true;
+    }
+
+    /// @brief Folds values and phis until nothing changes
+    ////////////////////////////////////////
+    static void PropagateConstants(SSAGraph& Graph) noexcept
+    {
+        for ( bool Changed = true; Changed; ) {
+            Changed = false;
+            for ( u32 i = 0; i < Graph.OrderCount; i++ ) {
+                u32 IDX = Graph.Blocks[Graph.Order[i]].First;
+                while ( IDX != SSA_NONE ) {
+                    SSAValue& Value = Graph.Values[IDX];
+                    u32 Next = Value.Next;
+                    if ( Value.Op == SSA_PHI ) {
+                        if ( FoldPhi(Graph, IDX) ) {
+                            UnlinkValue(Graph, IDX);
+                            Changed = true;
+                        }
+                    }
+                    else if ( Value.Op > SSA_PHI && FoldValue(Graph, IDX) ) {
+                        if ( Value.Alias != SSA_NONE )
+                            UnlinkValue(Graph, IDX);
+                        Changed = true;
+                    }
+                    IDX = Next;
+                }
+            }
+        }
+    }
+
+    /// DEAD VALUES:
+    ////////////////////////////////////////
+
+    /// @brief Marks every value a root depends on as live,
+    /// resolving every operand on the way, and unlinks
+    /// the rest. Roots are the operands of branches, the
+    /// snapshots of returns and exits, and every value
+    /// which may exit.
+    ////////////////////////////////////////
+    static void EliminateDeadValues(SSAGraph& Graph) noexcept
+    {
+        u32* Worklist = Graph.Scratch;
+        u32  Pending  = 0;
+        for ( u32 i = 0; i < Graph.ValueCount; i++ )
+            Graph.Values[i].Live = false;
+
+        auto Mark = [&](u32& Ref) {
+            Ref = ResolveSSA(Graph, Ref);
+            if ( !Graph.Values[Ref].Live ) {
+                Graph.Values[Ref].Live = true;
+                Worklist[Pending++] = Ref;
+            }
+        };
+        auto MarkSnapshot = [&](u32 Snapshot) {
+            for ( u32 r = 0; r < Register::COUNT; r++ )
+                Mark(Graph.Snapshots[Snapshot].Values[r]);
+        };
+
+        for ( u32 i = 0; i < Graph.OrderCount; i++ ) {
+            SSABlock& Block = Graph.Blocks[Graph.Order[i]];
+            if ( Block.Exit == SSAExit::BRANCH ) {
+                Mark(Block.Args[0]);
+                Mark(Block.Args[1]);
+            }
+            if ( Block.Snapshot != SSA_NONE )
+                MarkSnapshot(Block.Snapshot);
+            for ( u32 IDX = Block.First; IDX != SSA_NONE;
+                  IDX = Graph.Values[IDX].Next )
+                if ( Graph.Values[IDX].Snapshot != SSA_NONE
+                     || Graph.Values[IDX].Op == SSA_STORE )
+                    Mark(IDX);
+        }
+
+        while ( Pending ) {
+            SSAValue& Value = Graph.Values[Worklist[--Pending]];
+            for ( u32 k = 0; k < 2; k++ )
+                if ( Value.Args[k] != SSA_NONE )
+                    Mark(Value.Args[k]);
+            if ( Value.Op == SSA_PHI )
+                for ( u32 k = 0; k < Graph.Blocks[Value.Block].PredCount; k++ )
+                    Mark(Graph.PhiArgs[Value.Imm + k]);
+            if ( Value.Snapshot != SSA_NONE )
+                MarkSnapshot(Value.Snapshot);
+        }
+
+        for ( u32 i = 0; i < Graph.OrderCount; i++ ) {
+            u32 IDX = Graph.Blocks[Graph.Order[i]].First;
+            while ( IDX != SSA_NONE ) {
+                u32 Next = Graph.Values[IDX].Next;
+                if ( !Graph.Values[IDX].Live )
+                    UnlinkValue(Graph, IDX);
+                IDX = Next;
+            }
+        }
+    }
+
+    /// TYPES:
+    ////////////////////////////////////////
+
+    /// @brief Picks the `SSAType` of every phi and parameter,
+    /// whose bits may be used as either an integer or a
+    /// floating point value. Each use votes for the type it
+    /// reads its operand as, and each operand of a phi for
+    /// its own type, with votes from inside of loops
+    /// weighing more. Floating point winners become F64, as
+    /// the full 64 bits of a phi or parameter are kept.
+    ////////////////////////////////////////
+    static void InferTypes(SSAGraph& Graph) noexcept
+    {
+        i32* Votes = (i32*)Graph.Scratch;
+        auto IsInferred = [&](u32 IDX) {
+            u8 Op = Graph.Values[IDX].Op;
+            return ( Op == SSA_PHI || Op == SSA_PARAM );
+        };
+        auto Vote = [&](u32 IDX, bool Float, i32 Weight) {
+            if ( IsInferred(IDX) )
+                Votes[IDX] += ( Float ? Weight : -Weight );
+        };
+
+        // Phis feeding each other settle within a few rounds
+        for ( u32 Round = 0; Round < 4; Round++ ) {
+            for ( u32 i = 0; i < Graph.ValueCount; i++ )
+                Votes[i] = 0;
+
+            for ( u32 i = 0; i < Graph.OrderCount; i++ ) {
+                const SSABlock& Block = Graph.Blocks[Graph.Order[i]];
+                i32 Weight = ( Block.Loop != SSA_NONE ? 8 : 1 );
+                if ( Block.Exit == SSAExit::BRANCH ) {
+                    Vote(Block.Args[0], false, Weight);
+                    Vote(Block.Args[1], false, Weight);
+                }
+                for ( u32 IDX = Block.First; IDX != SSA_NONE;
+                      IDX = Graph.Values[IDX].Next ) {
+                    const SSAValue& Value = Graph.Values[IDX];
+                    if ( Value.Op == SSA_PHI ) {
+                        bool Float = ( Value.Type != SSAType::I64 );
+                        for ( u32 k = 0; k < Block.PredCount; k++ ) {
+                            u32 Arg = Graph.PhiArgs[Value.Imm + k];
+                            Vote(Arg, Float, Weight);
+                            if ( !IsInferred(Arg) && Graph.Values[Arg].Op != SSA_CONST )
+                                Vote(IDX, Graph.Values[Arg].Type != SSAType::I64,
+                                     Weight);
+                        }
+                        continue;
+                    }
+                    for ( u32 k = 0; k < 2; k++ )
+                        if ( Value.Args[k] != SSA_NONE )
+                            Vote(Value.Args[k], ReadsFloat(Value.Op), Weight);
+                }
+            }
+
+            for ( u32 i = 0; i < Graph.ValueCount; i++ )
+                if ( Graph.Values[i].Live && IsInferred(i) )
+                    Graph.Values[i].Type = ( Votes[i] > 0 ? SSAType::F64
+                                                          : SSAType::I64 );
+        }
+    }
+
+    /// LOOP INVARIANTS:
+    ////////////////////////////////////////
+
+    /// @brief Moves every value which cannot exit, does not
+    /// access memory, and whose operands are all defined
+    /// outside of a loop, into the preheader of that loop.
+    /// Inner loops come first, so that a value can move out
+    /// of several loops at once.
+    ////////////////////////////////////////
+    static void HoistInvariants(SSAGraph& Graph) noexcept
+    {
+        for ( u32 i = Graph.OrderCount; i-- > 0; ) {
+            u32 Header = Graph.Order[i];
+            u32 Preheader = Graph.Blocks[Header].Preheader;
+            if ( Graph.Blocks[Header].Loop != Header || Preheader == SSA_NONE )
+                continue;
+
+            auto IsInvariant = [&](u32 Arg) {
+                return ( Arg == SSA_NONE
+                      || Graph.Values[Arg].Op == SSA_CONST
+                      || !IsInLoop(Graph, Graph.Values[Arg].Block, Header) );
+            };
+
+            // The loop's blocks follow its header
+            for ( u32 j = i; j < Graph.OrderCount; j++ ) {
+                u32 Block = Graph.Order[j];
+                if ( !IsInLoop(Graph, Block, Header) )
+                    continue;
+                u32 IDX = Graph.Blocks[Block].First;
+                while ( IDX != SSA_NONE ) {
+                    SSAValue& Value = Graph.Values[IDX];
+                    u32 Next = Value.Next;
+                    if ( Value.Op > SSA_PHI && Value.Snapshot == SSA_NONE
+                         && !IsMemoryAccess(Value.Op)
+                         && IsInvariant(Value.Args[0])
+                         && IsInvariant(Value.Args[1]) ) {
+                        UnlinkValue(Graph, IDX);
+                        AppendValue(Graph, Preheader, IDX);
+                    }
+                    IDX = Next;
+                }
+            }
+        }
+    }
+
+    /// OPTIMISESSA:
+    ////////////////////////////////////////
+    void OptimiseSSA(SSAGraph& Graph) noexcept
+    {
+        PropagateConstants(Graph);
+        EliminateDeadValues(Graph);
+        InferTypes(Graph);
+        HoistInvariants(Graph);
+    }
+
+    /// RELEASESSA:
+    ////////////////////////////////////////
+    void ReleaseSSA(SSAGraph& Graph, CoreAllocator& Allocator) noexcept
+    {
+        Allocator.Release(Graph.Values);
+        Allocator.Release(Graph.Blocks);
+        Allocator.Release(Graph.Order);
+        Allocator.Release(Graph.PredList);
+        Allocator.Release(Graph.PhiArgs);
+        Allocator.Release(Graph.Snapshots);
+        Allocator.Release(Graph.Scratch);
+        Graph = {};
+    }
+
+}
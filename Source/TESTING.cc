@@ -4,11 +4,402 @@
 #include "Headers/Instructions.hpp"
 #include "Headers/ThreadMemory.hpp"
 #include "Headers/Functions.hpp"
+#include "Headers/VPCore.hpp"
+#include "Headers/VM.hpp"
+#include "Headers/Executor.hpp"
+#include "Headers/TemplateJIT.hpp"
+#include "Headers/OptimizingJIT.hpp"
+#include "Headers/Inliner.hpp"
+#include "Headers/Compressed.hpp"
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 
 using std::cout;
 using namespace Octane;
+using I = Instruction;
+
+/// A threshold no regression case ever reaches
+static constexpr u32 NEVER = 0xFFFFFFFF;
+
+/// The most `Execute` calls a regression case makes
+static constexpr u32 MAX_RUNS = 3;
+
+/// The most `Exception`s a single run records
+static constexpr u32 MAX_FAULTS = 8;
+
+/// @brief A way of running a regression case.
+/// The first config is the plain COLD interpreter,
+/// which every other config must agree with.
+////////////////////////////////////////
+struct TestConfig {
+    const char*  Label;
+    DispatchMode Mode;
+    TierCompiler Compiler;
+    u32          WarmThreshold;
+    u32          HotThreshold;
+    bool         Optimise;
+    bool         Inline;
+};
+
+static const TestConfig Configs[] = {
+    { "COLD",     DispatchMode::THREADED, nullptr,              NEVER, NEVER, false, false },
+    { "SWITCH",   DispatchMode::SWITCH,   nullptr,              NEVER, NEVER, false, false },
+    { "WARM",     DispatchMode::THREADED, nullptr,              0,     NEVER, false, false },
+    { "WARM-SW",  DispatchMode::SWITCH,   nullptr,              0,     NEVER, false, false },
+    { "JIT",      DispatchMode::THREADED, CompileTemplateJIT,   0,     1,     false, false },
+    { "OPT",      DispatchMode::THREADED, CompileOptimizingJIT, 0,     1,     false, false },
+    { "OSR",      DispatchMode::THREADED, CompileOptimizingJIT, 0,     100,   false, false },
+    { "SPLIT",    DispatchMode::THREADED, CompileTemplateJIT,   64,    1000,  false, false },
+    { "PEEPHOLE", DispatchMode::THREADED, nullptr,              0,     NEVER, true,  false },
+    { "INLINE",   DispatchMode::THREADED, nullptr,              0,     NEVER, false, true  },
+};
+static constexpr u32 CONFIG_COUNT = sizeof(Configs) / sizeof(Configs[0]);
+
+/// @brief A register a regression case sets
+/// before every run, or expects after it
+////////////////////////////////////////
+struct TestArg {
+    u8  Reg;
+    u64 Value;
+};
+
+/// @brief A regression case. `Code` runs with `Callee`
+/// bound to IDX 0 of its `RelocationTable` as "Callee".
+/// `Expect` catches bugs the COLD interpreter shares.
+////////////////////////////////////////
+struct TestCase {
+    const char*              Name;
+    std::vector<Instruction> Code;
+    std::vector<Instruction> Callee;
+    std::vector<TestArg>     Args;
+    u32                      Runs;
+    std::vector<TestArg>     Expect;
+};
+
+/// @brief Everything a single run leaves behind
+////////////////////////////////////////
+struct TestOutcome {
+    Exception::HandlerResult Result;
+    u64                      Reg[VPCore::Register::COUNT];
+    u32                      StackUsage;
+    u32                      LocalUsage;
+    u32                      FaultCount;
+    /// The ID, `Function` and index of each `Exception`
+    u64                      Faults[MAX_FAULTS];
+};
+
+/// @brief A fresh VM for every config, so no
+/// code or cached `Symbol` is carried over
+////////////////////////////////////////
+struct TestEnv {
+    CoreAllocator Allocator;
+    FlatStorage   Storage;
+    ThreadMemory  Memory;
+    VPCore        Thread;
+    VM            Instance;
+    u64           DataA = 111;
+    u64           DataB = 222;
+
+    TestEnv(const TestConfig& Config)
+    {
+        Storage.Init(Allocator);
+        Memory.Init(Allocator, 1024, 4096);
+
+        StorageRequest RequestA = {
+            SymbolType::DATA, 0, "AAAA", &DataA, sizeof(DataA)
+        };
+        Storage.AssignSymbol(RequestA);
+        StorageRequest RequestB = {
+            SymbolType::DATA, 0, "BBBB", &DataB, sizeof(DataB)
+        };
+        Storage.AssignSymbol(RequestB);
+
+        TierPolicy Policy;
+        Policy.WarmThreshold = Config.WarmThreshold;
+        Policy.HotThreshold  = Config.HotThreshold;
+        Instance.SetTierPolicy(Policy);
+        Instance.SetTierCompiler(Config.Compiler);
+        Instance.SetDispatchMode(Config.Mode);
+        Instance.SetBytecodeOptimisation(Config.Optimise);
+    }
+
+    ~TestEnv(void)
+    {
+        Storage.Free();
+        Memory.Free(Allocator);
+    }
+};
+
+/// The outcome the running case's `Exception`s are recorded into
+static TestOutcome*    RecordingOutcome = nullptr;
+/// The caller of the running case, telling its `Exception`s
+/// apart from those raised in the callee
+static const Function* RecordingCaller  = nullptr;
+
+/// @brief Records every `Exception` and resumes
+/// after the offending `Instruction`
+////////////////////////////////////////
+static Exception::HandlerResult RecordException(Exception E, ExecState& State)
+{
+    TestOutcome& Outcome = *RecordingOutcome;
+    if ( Outcome.FaultCount < MAX_FAULTS ) {
+        u64 Index = (u64)( State.IP - State.CurrentFunc->GetCodeSpace() );
+        Outcome.Faults[Outcome.FaultCount] =
+            ( (u64)E.GetID() << 32 ) |
+            ( (u64)( State.CurrentFunc != RecordingCaller ) << 16 ) | Index;
+    }
+    Outcome.FaultCount++;
+    return Exception::HandlerResult::HANDLED;
+}
+
+/// @brief Loads a case's bytecode into a fresh `Function`,
+/// through the compressed format if Compressed is set
+////////////////////////////////////////
+static void InitTestFunction(Function& Func, CoreAllocator& Allocator,
+                             const std::vector<Instruction>& Code,
+                             RelocationTable* Reloc = nullptr,
+                             bool Compressed = false)
+{
+    if ( Compressed ) {
+        std::vector<u16> Stream(GetCompressedSize(Code.data(), (u32)Code.size()));
+        CompressCode(Code.data(), (u32)Code.size(), Stream.data());
+        LoadCompressedFunction(Func, Allocator, Reloc, Stream.data(),
+                               (u32)Stream.size(), 0);
+        return;
+    }
+    Func.Init(Allocator, Reloc, (u32)Code.size(), 0);
+    QuickCopy(Code.data(), Func.GetCodeSpace(), Code.size() * sizeof(Instruction));
+}
+
+/// @brief Checks that Code expands back from
+/// the compressed format word for word
+////////////////////////////////////////
+static bool RoundTrips(const std::vector<Instruction>& Code)
+{
+    std::vector<u16> Stream(GetCompressedSize(Code.data(), (u32)Code.size()));
+    CompressCode(Code.data(), (u32)Code.size(), Stream.data());
+    if ( GetExpandedCount(Stream.data(), (u32)Stream.size()) != Code.size() )
+        return false;
+
+    std::vector<Instruction> Expanded(Code.size());
+    ExpandCode(Stream.data(), (u32)Stream.size(), Expanded.data());
+    for ( u32 i = 0; i < Code.size(); i++ )
+        if ( Expanded[i].RawInt != Code[i].RawInt )
+            return false;
+    return true;
+}
+
+/// @brief Runs Case under Config, filling in
+/// one `TestOutcome` per run
+////////////////////////////////////////
+static void RunCase(const TestCase& Case, const TestConfig& Config,
+                    TestOutcome* Outcomes, bool Compressed = false)
+{
+    TestEnv Env(Config);
+    Env.Instance.SetExceptionHandler(RecordException);
+
+    Function        Caller, Callee;
+    RelocationTable Reloc;
+    Reloc.Init(Env.Allocator, &Env.Storage, 1);
+    if ( !Case.Callee.empty() ) {
+        InitTestFunction(Callee, Env.Allocator, Case.Callee, nullptr, Compressed);
+        StorageRequest CalleeRequest = {
+            SymbolType::FUNC, 0, "Callee", &Callee, sizeof(Function)
+        };
+        Env.Storage.AssignSymbol(CalleeRequest);
+        Reloc.AssignIDX(0, "Callee");
+    }
+    InitTestFunction(Caller, Env.Allocator, Case.Code, &Reloc, Compressed);
+    if ( Config.Inline && !Case.Callee.empty() ) {
+        Function* const Module[] = { &Caller, &Callee };
+        InlineModule(Module, 2, Env.Allocator);
+    }
+    RecordingCaller = &Caller;
+
+    for ( u32 Run = 0; Run < Case.Runs; Run++ ) {
+        TestOutcome& Outcome = Outcomes[Run];
+        Outcome = {};
+        RecordingOutcome = &Outcome;
+
+        ExecState State = {
+            Env.Instance, nullptr, {}, Env.Thread, Env.Memory,
+            Env.Allocator, Env.Storage, &Caller
+        };
+        for ( const TestArg& Arg : Case.Args )
+            State.Reg[Arg.Reg].AsU64 = Arg.Value;
+
+        Outcome.Result = Execute(State);
+        for ( byte i = 0; i < VPCore::Register::COUNT; i++ )
+            Outcome.Reg[i] = State.Reg[i].AsU64;
+        Outcome.StackUsage = Env.Memory.GetStackUsage();
+        Outcome.LocalUsage = Env.Memory.GetLocalUsage();
+    }
+
+    RecordingOutcome = nullptr;
+    RecordingCaller  = nullptr;
+    Caller.Free(Env.Allocator);
+    if ( !Case.Callee.empty() )
+        Callee.Free(Env.Allocator);
+    Reloc.Free(Env.Allocator);
+}
+
+/// @brief Compares two outcomes. OptimiseBytecode compacts the
+/// Code Space, so only the index an `Exception` is reported at
+/// may differ if the config optimises. InlineModule moves the
+/// caller's own `Instruction`s, but not those of its callees.
+////////////////////////////////////////
+static bool SameFault(u64 A, u64 B, const TestConfig& Config)
+{
+    bool InCaller = !( A & ( (u64)1 << 16 ) );
+    if ( Config.Optimise || ( Config.Inline && InCaller ) )
+        return ( A & ~(u64)0xFFFF ) == ( B & ~(u64)0xFFFF );
+    return A == B;
+}
+
+static bool SameOutcome(const TestOutcome& A, const TestOutcome& B,
+                        const TestConfig& Config)
+{
+    if ( A.Result     != B.Result     || A.StackUsage != B.StackUsage ||
+         A.LocalUsage != B.LocalUsage || A.FaultCount != B.FaultCount )
+        return false;
+    for ( byte i = 0; i < VPCore::Register::COUNT; i++ )
+        if ( A.Reg[i] != B.Reg[i] )
+            return false;
+    for ( u32 i = 0; i < A.FaultCount && i < MAX_FAULTS; i++ )
+        if ( !SameFault(A.Faults[i], B.Faults[i], Config) )
+            return false;
+    return true;
+}
+
+/// @brief Runs Case under every config and reports
+/// each one which disagrees with the COLD interpreter.
+/// If Compressed is set, every config, COLD included,
+/// runs the case loaded from the compressed format.
+/// @return The amount of configs which disagreed
+////////////////////////////////////////
+static u32 CheckCase(const TestCase& Case, bool Compressed = false)
+{
+    TestOutcome Expected[MAX_RUNS], Outcomes[MAX_RUNS];
+    RunCase(Case, Configs[0], Expected);
+
+    u32 Failures = 0;
+    cout << Case.Name << ':';
+    for ( const TestArg& Arg : Case.Expect ) {
+        if ( Expected[Case.Runs - 1].Reg[Arg.Reg] != Arg.Value ) {
+            cout << " (FAILED " << Configs[0].Label << ", r"
+                 << (u32)Arg.Reg << " is " << Expected[Case.Runs - 1].Reg[Arg.Reg]
+                 << ", not " << Arg.Value << ')';
+            Failures++;
+        }
+    }
+    if ( Compressed && ( !RoundTrips(Case.Code) ||
+                         ( !Case.Callee.empty() && !RoundTrips(Case.Callee) ) ) ) {
+        cout << " (FAILED round trip)";
+        Failures++;
+    }
+    for ( u32 c = ( Compressed ? 0 : 1 ); c < CONFIG_COUNT; c++ ) {
+        RunCase(Case, Configs[c], Outcomes, Compressed);
+        for ( u32 Run = 0; Run < Case.Runs; Run++ ) {
+            if ( !SameOutcome(Expected[Run], Outcomes[Run], Configs[c]) ) {
+                cout << " (FAILED " << Configs[c].Label << ", run " << Run << ')';
+                Failures++;
+                break;
+            }
+        }
+    }
+    cout << ( Failures ? "\n" : " ok\n" );
+    return Failures;
+}
+
+/// @brief A pload/psave with an indexed address
+////////////////////////////////////////
+static Instruction Private(I::Opcode Op, u8 Value, u8 Base, u8 Index, u8 Shift)
+{
+    return I::Make(Op, Value, Base, (u8)( ( Index << 4 ) | Shift ));
+}
+
+/// @brief Fills N elements of 1 << Width bytes with their
+/// index, summing them back in a loop to Limit, which
+/// steps either through jmplt or through cmplt + jmpnot0
+////////////////////////////////////////
+static std::vector<Instruction> BoundsKernel(u16 N, u16 Limit, u8 Width,
+                                             bool CompareForm)
+{
+    I::Opcode Save = (I::Opcode)( I::psave8 + Width );
+    I::Opcode Load = (I::Opcode)( I::pload8 + Width );
+    std::vector<Instruction> Code = {
+        I::MakeImm16(I::movimm, 3, (u16)( N << Width )),
+        I::Make(I::requestbytes, 4, 3),
+        I::Make(I::clr, 1),
+        I::Make(I::clr, 0),
+        I::MakeImm16(I::movimm, 2, Limit),
+        Private(Save, 1, 4, 1, Width),
+        Private(Load, 7, 4, 1, Width),
+        I::Make(I::add, 0, 0, 7),
+        I::Make(I::inc, 1),
+    };
+    if ( CompareForm ) {
+        Code.push_back(I::Make(I::cmplt, 9, 1, 2));
+        Code.push_back(I::MakeImm16(I::jmpnot0, 9, 5));
+    }
+    else
+        Code.push_back(I::MakeImm16Alt(I::jmplt, 1, 2, 5));
+    Code.push_back(I::Make(I::releasebytes, 4));
+    Code.push_back(I::Make(I::clr, 4));
+    Code.push_back(I::Make(I::ret));
+    return Code;
+}
+
+/// @brief Runs six `Function`s in turn under a code
+/// cache limit which only fits a few of them, so compiled
+/// code is evicted and recompiled over and over
+/// @return The amount of configs which disagreed
+////////////////////////////////////////
+static u32 CheckEvictionChurn(const std::vector<Instruction>& Code)
+{
+    static constexpr u32 FUNCTIONS = 6;
+    static constexpr u32 RUNS      = 200;
+
+    u64 Expected[2] = {};
+    u32 Failures    = 0;
+    cout << "Eviction churn:";
+    for ( u32 c = 0; c < CONFIG_COUNT; c++ ) {
+        TestEnv Env(Configs[c]);
+        Env.Instance.GetCodeCache().SetLimit(2000);
+
+        Function Funcs[FUNCTIONS];
+        for ( Function& Func : Funcs )
+            InitTestFunction(Func, Env.Allocator, Code);
+
+        bool Failed = false;
+        for ( u32 Run = 0; Run < RUNS; Run++ ) {
+            ExecState State = {
+                Env.Instance, nullptr, {}, Env.Thread, Env.Memory,
+                Env.Allocator, Env.Storage, &Funcs[( Run * 7 ) % FUNCTIONS]
+            };
+            if ( Execute(State) != Exception::HandlerResult::NO_EXCEPTION )
+                Failed = true;
+            if ( c == 0 && Run == 0 ) {
+                Expected[0] = State.Reg[1].AsU64;
+                Expected[1] = State.Reg[9].AsU64;
+            }
+            if ( State.Reg[1].AsU64 != Expected[0] ||
+                 State.Reg[9].AsU64 != Expected[1] )
+                Failed = true;
+        }
+        if ( Failed ) {
+            cout << " (FAILED " << Configs[c].Label << ')';
+            Failures++;
+        }
+
+        for ( Function& Func : Funcs )
+            Func.Free(Env.Allocator);
+    }
+    cout << ( Failures ? "\n" : " ok\n" );
+    return Failures;
+}
 
 int main(void)
 {
@@ -43,5 +434,380 @@ int main(void)
     cout << Reloc.RetrieveIDXKey(1) << " : " << Reloc.RetrieveIDX(1) << '\n';
     cout << Reloc.RetrieveIDXKey(2) << " : " << Reloc.RetrieveIDX(2) << '\n';
 
-    return 0;
+    /// Regression cases, each checked against the COLD interpreter
+    u32 Failures = 0;
+
+    /// Constants, copies and jump chains for the bytecode
+    /// optimiser, with a division by a folded zero which
+    /// must still raise
+    TestCase Folding = { "Folding", {
+        I::MakeImm16(I::movimm, 4, 6),
+        I::MakeImm16Alt(I::addimm, 5, 4, 4),
+        I::Make(I::mul, 6, 5, 4),
+        I::Make(I::mov, 7, 6),
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 100),
+        I::Make(I::clr, 0),
+        I::Make(I::add, 0, 0, 7),               // 7
+        I::MakeImm16Alt(I::jmpeq, 4, 5, 14),
+        I::MakeImm16(I::jmp, 0, 10),
+        I::MakeImm16(I::jmp, 0, 11),
+        I::Make(I::inc, 1),                     // 11
+        I::MakeImm16Alt(I::jmplt, 1, 2, 7),
+        I::MakeImm16(I::jmp, 0, 15),
+        I::MakeImm16(I::movimm, 0, 1),          // 14
+        I::Make(I::sub, 8, 4, 4),               // 15
+        I::Make(I::div, 9, 0, 8),
+        I::Make(I::mov, 10, 9),
+        I::Make(I::ret),
+    }, {}, {}, 1, {} };
+    Failures += CheckCase(Folding);
+
+    /// A caller looping over a callee with early rets,
+    /// whose div faults unless r5 is set
+    TestCase EarlyReturn = { "Inlined early ret", {
+        I::Make(I::clr, 0),
+        I::Make(I::clr, 1),
+        I::Make(I::clr, 9),
+        I::MakeImm16(I::movimm, 2, 10),
+        I::MakeImm16(I::call, 0, 0),            // 4
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 4),
+        I::MakeImm16(I::call, 0, 0),
+        I::Make(I::ret),
+    }, {
+        I::Make(I::inc, 0),
+        I::MakeImm16(I::jmpnot0, 5, 3),
+        I::Make(I::div, 6, 0, 5),
+        I::MakeImm16(I::movimm, 7, 1),          // 3
+        I::Make(I::band, 8, 0, 7),
+        I::MakeImm16(I::jmpis0, 8, 7),
+        I::Make(I::ret),
+        I::Make(I::inc, 9),                     // 7
+        I::Make(I::ret),
+    }, {}, 1, {} };
+    Failures += CheckCase(EarlyReturn);
+    EarlyReturn.Name = "Inlined early ret, r5 set";
+    EarlyReturn.Args = { { 5, 1 } };
+    Failures += CheckCase(EarlyReturn);
+
+    /// The caller's own div faults past an inlined call,
+    /// and is reported where it sits after inlining
+    Failures += CheckCase({ "Caller fault past inlined call", {
+        I::Make(I::clr, 0),
+        I::Make(I::clr, 5),
+        I::MakeImm16(I::call, 0, 0),
+        I::Make(I::div, 6, 0, 5),
+        I::MakeImm16(I::call, 0, 0),
+        I::Make(I::div, 7, 0, 5),
+        I::Make(I::ret),
+    }, {
+        I::Make(I::inc, 0),
+        I::Make(I::inc, 0),
+        I::Make(I::ret),
+    }, {}, 1, { { 0, 4 } } });
+
+    /// A branch taken only on iteration 997, long after
+    /// compiled code has split it off as cold
+    const std::vector<Instruction> RareBranch = {
+        I::Make(I::clr, 0),
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 1000),
+        I::MakeImm16(I::movimm, 3, 997),
+        I::MakeImm16Alt(I::jmpeq, 0, 3, 9),     // 4
+        I::Make(I::add, 1, 1, 0),               // 5
+        I::Make(I::inc, 0),
+        I::MakeImm16Alt(I::jmplt, 0, 2, 4),
+        I::Make(I::ret),
+        I::MakeImm16(I::movimm, 4, 7),          // 9
+        I::Make(I::add, 1, 1, 4),
+        I::Make(I::inc, 9),
+        I::MakeImm16(I::jmp, 0, 5),
+    };
+    Failures += CheckCase({ "Rare branch", RareBranch, {}, {}, MAX_RUNS, {} });
+    Failures += CheckEvictionChurn(RareBranch);
+
+    /// Hoisted bounds checks, in and out of bounds
+    struct { u16 N, Limit; } Bounds[] = {
+        { 40, 0 }, { 40, 1 }, { 40, 39 }, { 40, 40 }, { 40, 41 }, { 5, 200 }
+    };
+    for ( u8 Width = 0; Width < 4; Width += 3 ) {
+        for ( bool CompareForm : { false, true } ) {
+            for ( const auto& B : Bounds ) {
+                std::string Name = "Hoisted bounds, " +
+                    std::to_string(B.Limit) + " of " + std::to_string(B.N) +
+                    " x" + std::to_string(1 << Width) +
+                    ( CompareForm ? " (cmplt)" : " (jmplt)" );
+                TestCase Case = {
+                    Name.c_str(), BoundsKernel(B.N, B.Limit, Width, CompareForm),
+                    {}, {}, 1, {}
+                };
+                Failures += CheckCase(Case);
+            }
+        }
+    }
+
+    /// A scratch buffer which never escapes, served
+    /// from the Local Frame once WARM
+    TestCase Scratch = { "Localised buffer", {
+        I::Make(I::clr, 0),
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 1000),
+        I::MakeImm16(I::movimm, 3, 64),
+        I::Make(I::clr, 5),
+        I::Make(I::requestbytes, 4, 3),         // 5
+        Private(I::psave64, 1, 4, 5, 3),
+        I::MakeImm16(I::movimm, 6, 7),
+        Private(I::psave64, 6, 4, 6, 3),
+        Private(I::pload64, 7, 4, 5, 3),
+        I::Make(I::add, 0, 0, 7),
+        Private(I::pload64, 7, 4, 6, 3),
+        I::Make(I::add, 0, 0, 7),
+        I::Make(I::releasebytes, 4),            // 13
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 5),
+        I::Make(I::clr, 4),
+        I::Make(I::ret),
+    }, {}, {}, 1, {} };
+    Failures += CheckCase(Scratch);
+    Scratch.Name    = "Localised buffer, out of bounds";
+    Scratch.Code[7] = I::MakeImm16(I::movimm, 6, 8);
+    Failures += CheckCase(Scratch);
+    Scratch.Name    = "Localised buffer, over the cap";
+    Scratch.Code[3] = I::MakeImm16(I::movimm, 3, 2000);
+    Scratch.Code[7] = I::MakeImm16(I::movimm, 6, 7);
+    Failures += CheckCase(Scratch);
+    Scratch.Name    = "Localised buffer, empty";
+    Scratch.Code[3] = I::MakeImm16(I::movimm, 3, 0);
+    Failures += CheckCase(Scratch);
+
+    TestCase Nested = { "Localised buffers, nested", {
+        I::Make(I::clr, 0),
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 100),
+        I::MakeImm16(I::movimm, 3, 24),
+        I::Make(I::clr, 5),
+        I::MakeImm16(I::requestlocal, 9, 16),   // 5
+        I::Make(I::requestbytes, 4, 3),
+        I::Make(I::requestbytes, 8, 3),
+        Private(I::psave64, 1, 4, 5, 3),
+        I::Make(I::memcpy, 8, 4, 3),
+        Private(I::pload64, 7, 8, 5, 3),
+        Private(I::psave64, 7, 9, 5, 3),
+        I::Make(I::releasebytes, 8),
+        I::Make(I::releasebytes, 4),
+        Private(I::pload64, 7, 9, 5, 3),
+        I::Make(I::add, 0, 0, 7),
+        I::Make(I::droplocal, 9),
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 5),
+        I::Make(I::clr, 4),
+        I::Make(I::clr, 8),
+        I::Make(I::clr, 9),
+        I::Make(I::ret),
+    }, {}, {}, 1, {} };
+    Failures += CheckCase(Nested);
+
+    /// Stack traffic in a loop: cached pairs, a masked save
+    /// and restore, and an expression passing through the Stack,
+    /// mixed with enough else for the JIT to still compile it
+    Failures += CheckCase({ "Stack traffic", {
+        I::Make(I::clr, 0),
+        I::Make(I::clr, 1),
+        I::Make(I::movimm32, 2),
+        I::MakeWord(300),
+        I::MakeImm16(I::movimm, 6, 3),
+        I::MakeImm16(I::movimm, 7, 11),
+        I::Make(I::pushreg, 0),                 // 6
+        I::Make(I::pushreg, 1),
+        I::Make(I::pushall),
+        I::Make(I::inc, 6),
+        I::Make(I::add, 7, 7, 1),
+        I::Make(I::popall),
+        I::Make(I::popreg, 4),
+        I::Make(I::popreg, 3),
+        I::Make(I::add, 5, 3, 4),
+        I::Make(I::add, 5, 5, 6),
+        I::Make(I::add, 5, 5, 7),
+        I::Make(I::pushreg, 5),
+        I::Make(I::pushreg, 1),
+        I::Make(I::popreg, 4),
+        I::Make(I::popreg, 3),
+        I::Make(I::bxor, 0, 3, 4),
+        I::Make(I::add, 0, 0, 5),
+        I::Make(I::bxor, 0, 0, 1),
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 6),
+        I::Make(I::ret),
+    }, {}, {}, MAX_RUNS, { { 6, 3 }, { 7, 11 } } });
+
+    /// Pushes past the end of the Stack, each faulting
+    /// and resuming inside of the loop
+    Failures += CheckCase({ "Stack overflow", {
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 140),
+        I::Make(I::pushreg, 1),                 // 2
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 2),
+        I::Make(I::ret),
+    }, {}, {}, 1, {} });
+
+    /// Pops past the start of the Stack, after pushes which fit
+    Failures += CheckCase({ "Stack underflow", {
+        I::Make(I::clr, 0),
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 100),
+        I::Make(I::pushreg, 1),                 // 3
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 3),
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 110),
+        I::Make(I::clr, 3),
+        I::Make(I::popreg, 3),                  // 9
+        I::Make(I::add, 0, 0, 3),
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 9),
+        I::Make(I::ret),
+    }, {}, {}, 1, { { 0, 4950 } } });
+
+    /// Cached pairs around a division which faults, while
+    /// both values are still cached, every fourth iteration
+    Failures += CheckCase({ "Stack slots spilled", {
+        I::MakeImm16(I::movimm, 0, 1000),
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 40),
+        I::Make(I::clr, 5),
+        I::MakeImm16Alt(I::bandimm, 7, 1, 3),   // 4
+        I::Make(I::pushreg, 0),
+        I::Make(I::pushreg, 1),
+        I::Make(I::div, 6, 0, 7),
+        I::Make(I::popreg, 4),
+        I::Make(I::popreg, 3),
+        I::Make(I::add, 5, 5, 3),
+        I::Make(I::sub, 5, 5, 4),
+        I::Make(I::add, 5, 5, 6),
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 4),
+        I::Make(I::ret),
+    }, {}, {}, 1, {} });
+
+    /// Whole register file saves past the end of the Stack, and
+    /// the restores taking them back off, each of which winds the
+    /// loop counter back to the one it saved
+    Failures += CheckCase({ "Stack overflow, pushall", {
+        I::MakeImm16(I::movimm, 0, 7),
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 10),
+        I::Make(I::pushall),                    // 3
+        I::Make(I::add, 0, 0, 1),
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 3),
+        I::Make(I::clr, 1),
+        I::Make(I::popall),                     // 8
+        I::Make(I::add, 5, 5, 0),
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 8),
+        I::Make(I::ret),
+    }, {}, {}, 1, { { 0, 7 }, { 5, 70 } } });
+
+    /// An unpaired save and restore of every register around a
+    /// loop, then a pair masked by the register written after it,
+    /// above another save which is never restored
+    Failures += CheckCase({ "Whole register file around a loop", {
+        I::MakeImm16(I::movimm, 15, 99),
+        I::MakeImm16(I::movimm, 9, 5),
+        I::Make(I::pushall),
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 300),
+        I::Make(I::inc, 1),                     // 5
+        I::Make(I::add, 9, 9, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 5),
+        I::Make(I::clr, 15),
+        I::Make(I::popall),
+        I::Make(I::pushall),
+        I::Make(I::pushall),
+        I::Make(I::inc, 9),
+        I::Make(I::popall),
+        I::MakeImm16(I::movimm, 10, 7),
+        I::Make(I::ret),
+    }, {}, {}, MAX_RUNS, { { 1, 0 }, { 9, 5 }, { 10, 7 }, { 15, 99 } } });
+
+    /// Threading `Instruction`s, which raise wherever they run
+    Failures += CheckCase({ "Unsupported threading", {
+        I::Make(I::clr, 0),
+        I::Make(I::spawn, 1),
+        I::Make(I::inc, 0),
+        I::Make(I::spawnanon, 1),
+        I::Make(I::merge, 1),
+        I::Make(I::muop, 1),
+        I::Make(I::cvop, 1),
+        I::Make(I::inc, 0),
+        I::Make(I::ret),
+    }, {}, {}, 1, { { 0, 2 } } });
+
+    /// Loaded from the compressed format: short forms, words too
+    /// wide for them, a trailing word whose low byte is the escape
+    /// tag, and jumps whose targets sit at other parcel offsets
+    TestCase Compact = { "Compressed", {
+        I::Make(I::clr, 0),
+        I::Make(I::clr, 1),
+        I::Make(I::movimm32, 2),
+        I::MakeWord(0x1FF),
+        I::MakeImm16Alt(I::addimm, 0, 0, 3),    // 4
+        I::MakeImm16Alt(I::addimm, 0, 0, 300),
+        I::Make(I::add, 3, 0, 1),
+        I::Make(I::add, 0, 0, 1),
+        I::MakeImm16(I::seek, 0, 2),
+        I::MakeImm16(I::movimm, 0, 0),
+        I::Make(I::inc, 1),                     // 10
+        I::MakeImm16Alt(I::jmplt, 1, 2, 4),
+        I::MakeImm16(I::jmp, 0, 14),
+        I::MakeImm16(I::movimm, 0, 1),
+        I::Make(I::ret),                        // 14
+    }, {}, {}, 1, { { 0, 285138 }, { 1, 511 } } };
+    Failures += CheckCase(Compact, true);
+
+    /// An inlined compressed callee
+    EarlyReturn.Name = "Compressed, inlined early ret";
+    Failures += CheckCase(EarlyReturn, true);
+
+    /// An Opcode byte in the range of the compressed forms,
+    /// which is escaped and raises `InvalidOpcode` once expanded
+    Failures += CheckCase({ "Compressed, escaped opcode", {
+        I::Make(I::clr, 0),
+        I::Make((I::Opcode)( COMPRESSED_TAG_BASE + 5 ), 0),
+        I::Make(I::inc, 0),
+        I::Make((I::Opcode)COMPRESSED_ESCAPE, 0),
+        I::Make(I::inc, 0),
+        I::Make(I::ret),
+    }, {}, {}, 1, { { 0, 2 } } }, true);
+
+    /// A gload key whose buffer is reused for another
+    /// key on every iteration, summing 1000 of each
+    Failures += CheckCase({ "Reused global key", {
+        I::Make(I::clr, 0),
+        I::Make(I::clr, 1),
+        I::MakeImm16(I::movimm, 2, 2000),
+        I::MakeImm16(I::movimm, 3, 8),
+        I::Make(I::clr, 5),
+        I::Make(I::requestbytes, 9, 3),         // 5
+        Private(I::psave64, 10, 9, 5, 3),
+        I::Make(I::gload64, ( 7 << 4 ) | 9, 5, 8),
+        I::Make(I::add, 0, 0, 7),
+        I::Make(I::releasebytes, 9),
+        I::Make(I::mov, 12, 10),
+        I::Make(I::mov, 10, 11),
+        I::Make(I::mov, 11, 12),
+        I::Make(I::inc, 1),
+        I::MakeImm16Alt(I::jmplt, 1, 2, 5),
+        I::Make(I::clr, 9),
+        I::Make(I::ret),
+    }, {}, { { 10, 0x41414141 }, { 11, 0x42424242 } }, 1, { { 0, 333000 } } });
+
+    cout << ( Failures ? "FAILED\n" : "PASSED\n" );
+
+    Reloc.Free(Memory);
+    Storage.Free();
+
+    return ( Failures ? 1 : 0 );
 }
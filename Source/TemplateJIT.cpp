@@ -0,0 +1,1228 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#define OCTVM_INTERNAL 1
+
+#include "Headers/Analysis.hpp"
+#include "Headers/Decoder.hpp"
+#include "Headers/Executor.hpp"
+#include "Headers/Functions.hpp"
+#include "Headers/TemplateJIT.hpp"
+#include "Headers/VM.hpp"
+
+#if OCTVM_TEMPLATE_JIT
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace Octane {
+
+    using HandlerResult = Exception::HandlerResult;
+
+#if OCTVM_TEMPLATE_JIT
+
+    //////////////// NOTE: /////////////////
+    /// Compiled code keeps two registers
+    /// for its whole run: r12 holds the
+    /// `ExecState*`, and rbx the address of
+    /// `ExecState::Reg`, so that every VM
+    /// register is a disp8 away from rbx.
+    /// The native frame holds the two Stack
+    /// slots of `TOP_` pairs at [rsp] and
+    /// [rsp + 8]. Everything else is scratch
+    /// between stencils.
+    ///
+    /// A stencil is a list of machine code
+    /// bytes, in which values of 0x100 and
+    /// up mark a hole to patch.
+    ////////////////////////////////////////
+
+    /// @brief The holes of a stencil, and what they are patched with
+    ////////////////////////////////////////
+    enum StencilHole : u16 {
+        /// disp8 of rX, rY or rZ from rbx
+        H_RX = 0x100, H_RY, H_RZ,
+        /// The 64-bit immediate of the site
+        H_IMM64,
+        /// The address of the site's helper routine
+        H_HELPER64,
+        /// rel32 to the jump target, or to the site's exit
+        /// if the target lies outside of the Code Space
+        H_TARGET,
+        /// rel32 to the exit of the site, which resumes
+        /// the interpreter at its `Instruction`
+        H_EXIT,
+        /// rel32 to the `Instruction` following a multi-word one
+        H_NEXT,
+        /// imm8 shift of a `REDUCED_` division
+        H_SHIFT,
+        /// imm32 divisor of a `REDUCED_` remainder
+        H_DIVISOR,
+        /// imm8 log2 stride of a `pload`/`psave`
+        H_STRIDE,
+        /// imm32 Stack room the pair of a `TOP_` push relies on
+        H_ROOM,
+    };
+
+    /// @brief Returns the amount of bytes a stencil entry emits
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    u32 GetHoleSize(u16 Entry) noexcept
+    {
+        switch ( Entry ) {
+            case H_RX: case H_RY: case H_RZ:   return 1;
+            case H_IMM64: case H_HELPER64:     return 8;
+            case H_TARGET: case H_EXIT:
+            case H_NEXT: case H_DIVISOR:
+            case H_ROOM:                       return 4;
+            default:                           return 1;
+        }
+    }
+
+    /// Loads and stores of VM registers through rbx
+    #define OCT_LOAD_RAX(Hole)  0x48, 0x8B, 0x43, Hole
+    #define OCT_LOAD_RCX(Hole)  0x48, 0x8B, 0x4B, Hole
+    #define OCT_STORE_RAX(Hole) 0x48, 0x89, 0x43, Hole
+
+    /// mov rdi, r12
+    #define OCT_ARG_STATE       0x4C, 0x89, 0xE7
+    /// mov rax, Helper; call rax
+    #define OCT_CALL_HELPER     0x48, 0xB8, H_HELPER64, 0xFF, 0xD0
+    /// add rsp, 24; pop r12; pop rbx; ret
+    #define OCT_EPILOGUE        0x48, 0x83, 0xC4, 0x18, 0x41, 0x5C, 0x5B, 0xC3
+
+    /// rX = rY Op rZ, where Op is a `<op> r64, r/m64` opcode
+    #define OCT_STENCIL_BINARY(Op) {                                        \
+            OCT_LOAD_RAX(H_RY), 0x48, Op, 0x43, H_RZ, OCT_STORE_RAX(H_RX)   \
+        }
+    /// rX = rY Op Imm, where Op is a `<op> r/m64, r64` opcode
+    #define OCT_STENCIL_BINARY_IMM(Op) {                                    \
+            OCT_LOAD_RAX(H_RY), 0x48, 0xB9, H_IMM64,                        \
+            0x48, Op, 0xC8, OCT_STORE_RAX(H_RX)                             \
+        }
+    /// rX = ( rY CC rZ )
+    #define OCT_STENCIL_COMPARE(CC) {                                       \
+            OCT_LOAD_RAX(H_RY), 0x48, 0x3B, 0x43, H_RZ,                     \
+            0x0F, 0x90 | CC, 0xC0, 0x0F, 0xB6, 0xC0, OCT_STORE_RAX(H_RX)    \
+        }
+    /// rX = ( rY CC 0 )
+    #define OCT_STENCIL_COMPARE_0(CC) {                                     \
+            0x31, 0xC0, 0x48, 0x83, 0x7B, H_RY, 0x00,                       \
+            0x0F, 0x90 | CC, 0xC0, OCT_STORE_RAX(H_RX)                      \
+        }
+    /// if ( rX CC rY ) jump
+    #define OCT_STENCIL_BRANCH(CC) {                                        \
+            OCT_LOAD_RAX(H_RX), 0x48, 0x3B, 0x43, H_RY,                     \
+            0x0F, 0x80 | CC, H_TARGET                                       \
+        }
+    /// if ( rX CC 0 ) jump
+    #define OCT_STENCIL_BRANCH_0(CC) {                                      \
+            0x48, 0x83, 0x7B, H_RX, 0x00, 0x0F, 0x80 | CC, H_TARGET         \
+        }
+    /// Calls the helper with the `ExecState*` and rsi,
+    /// exiting unless it returns true
+    #define OCT_STENCIL_HELPER(...) {                                       \
+            OCT_ARG_STATE, __VA_ARGS__ OCT_CALL_HELPER,                     \
+            0x84, 0xC0, 0x0F, 0x84, H_EXIT                                  \
+        }
+    /// Resolves the address of a `gload`/`gsave` through
+    /// the site's `GlobalCache`, exiting if it misses
+    #define OCT_GLOBAL_ADDRESS                                              \
+            OCT_ARG_STATE, 0x48, 0xBE, H_IMM64, 0x48, 0x8B, 0x53, H_RY,     \
+            OCT_LOAD_RCX(H_RZ), OCT_CALL_HELPER,                            \
+            0x48, 0x85, 0xC0, 0x0F, 0x84, H_EXIT
+
+    /// x86 condition codes
+    enum : u8 {
+        CC_B = 0x2, CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5, CC_BE = 0x6,
+        CC_A = 0x7, CC_L  = 0xC, CC_GE = 0xD, CC_LE = 0xE, CC_G  = 0xF,
+    };
+
+    /// STENCILS:
+    ////////////////////////////////////////
+    static const u16 S_Exit[]      = { 0xE9, H_EXIT };
+    static const u16 S_Jump[]      = { 0xE9, H_TARGET };
+    static const u16 S_Return[]    = { 0x31, 0xC0, OCT_EPILOGUE };
+    static const u16 S_Clear[]     = { 0x48, 0xC7, 0x43, H_RX, 0, 0, 0, 0 };
+    static const u16 S_Move[]      = { OCT_LOAD_RAX(H_RY), OCT_STORE_RAX(H_RX) };
+    static const u16 S_MoveImm[]   = { 0x48, 0xB8, H_IMM64, OCT_STORE_RAX(H_RX) };
+    static const u16 S_MoveWide[]  = { 0x48, 0xB8, H_IMM64, OCT_STORE_RAX(H_RX),
+                                       0xE9, H_NEXT };
+    static const u16 S_Inc[]       = { 0x48, 0xFF, 0x43, H_RX };
+    static const u16 S_Dec[]       = { 0x48, 0xFF, 0x4B, H_RX };
+    static const u16 S_Not[]       = { OCT_LOAD_RAX(H_RY), 0x48, 0xF7, 0xD0,
+                                       OCT_STORE_RAX(H_RX) };
+
+    static const u16 S_Add[]       = OCT_STENCIL_BINARY(0x03);
+    static const u16 S_Sub[]       = OCT_STENCIL_BINARY(0x2B);
+    static const u16 S_And[]       = OCT_STENCIL_BINARY(0x23);
+    static const u16 S_Or[]        = OCT_STENCIL_BINARY(0x0B);
+    static const u16 S_Xor[]       = OCT_STENCIL_BINARY(0x33);
+    static const u16 S_Mul[]       = { OCT_LOAD_RAX(H_RY), 0x48, 0x0F, 0xAF,
+                                       0x43, H_RZ, OCT_STORE_RAX(H_RX) };
+    static const u16 S_AddImm[]    = OCT_STENCIL_BINARY_IMM(0x01);
+    static const u16 S_SubImm[]    = OCT_STENCIL_BINARY_IMM(0x29);
+    static const u16 S_AndImm[]    = OCT_STENCIL_BINARY_IMM(0x21);
+    static const u16 S_OrImm[]     = OCT_STENCIL_BINARY_IMM(0x09);
+    static const u16 S_XorImm[]    = OCT_STENCIL_BINARY_IMM(0x31);
+    static const u16 S_MulImm[]    = { OCT_LOAD_RAX(H_RY), 0x48, 0xB9, H_IMM64,
+                                       0x48, 0x0F, 0xAF, 0xC1,
+                                       OCT_STORE_RAX(H_RX) };
+    // A zero divisor exits, and so does -1 for the signed forms,
+    // leaving the interpreter to raise or to define INT64_MIN / -1
+    #define OCT_DIVISOR_CHECKS                                              \
+            OCT_LOAD_RCX(H_RZ), 0x48, 0x85, 0xC9, 0x0F, 0x84, H_EXIT
+    #define OCT_SIGNED_DIVISOR_CHECKS                                       \
+            OCT_DIVISOR_CHECKS, 0x48, 0x83, 0xF9, 0xFF, 0x0F, 0x84, H_EXIT
+    /// xor edx, edx; div rcx / cqo; idiv rcx
+    #define OCT_DIV                 0x31, 0xD2, 0x48, 0xF7, 0xF1
+    #define OCT_IDIV                0x48, 0x99, 0x48, 0xF7, 0xF9
+    /// mov [rbx + rX], rdx
+    #define OCT_STORE_RDX(Hole)     0x48, 0x89, 0x53, Hole
+
+    static const u16 S_Div[]       = { OCT_DIVISOR_CHECKS, OCT_LOAD_RAX(H_RY),
+                                       OCT_DIV, OCT_STORE_RAX(H_RX) };
+    static const u16 S_Mod[]       = { OCT_DIVISOR_CHECKS, OCT_LOAD_RAX(H_RY),
+                                       OCT_DIV, OCT_STORE_RDX(H_RX) };
+    static const u16 S_IDiv[]      = { OCT_SIGNED_DIVISOR_CHECKS,
+                                       OCT_LOAD_RAX(H_RY), OCT_IDIV,
+                                       OCT_STORE_RAX(H_RX) };
+    static const u16 S_IMod[]      = { OCT_SIGNED_DIVISOR_CHECKS,
+                                       OCT_LOAD_RAX(H_RY), OCT_IDIV,
+                                       OCT_STORE_RDX(H_RX) };
+    // Immediate divisors are checked while compiling
+    static const u16 S_DivImm[]    = { OCT_LOAD_RAX(H_RY), 0x48, 0xB9, H_IMM64,
+                                       OCT_DIV, OCT_STORE_RAX(H_RX) };
+    static const u16 S_ModImm[]    = { OCT_LOAD_RAX(H_RY), 0x48, 0xB9, H_IMM64,
+                                       OCT_DIV, OCT_STORE_RDX(H_RX) };
+    static const u16 S_IDivImm[]   = { OCT_LOAD_RAX(H_RY), 0x48, 0xB9, H_IMM64,
+                                       OCT_IDIV, OCT_STORE_RAX(H_RX) };
+    static const u16 S_IModImm[]   = { OCT_LOAD_RAX(H_RY), 0x48, 0xB9, H_IMM64,
+                                       OCT_IDIV, OCT_STORE_RDX(H_RX) };
+
+    // Strength reduced divisions leave the quotient in rdx
+    /// mov rax, Magic; mul qword [rbx + rY]
+    #define OCT_MAGIC_MUL       0x48, 0xB8, H_IMM64, 0x48, 0xF7, 0x63, H_RY
+    /// mov rax, [rbx + rY]; sub rax, rdx; shr rax, 1; add rdx, rax
+    #define OCT_MAGIC_ADD       OCT_LOAD_RAX(H_RY), 0x48, 0x29, 0xD0,       \
+                                0x48, 0xD1, 0xE8, 0x48, 0x01, 0xC2
+    /// shr rdx, Shift
+    #define OCT_MAGIC_SHR       0x48, 0xC1, 0xEA, H_SHIFT
+    /// mov rax, Magic; imul qword [rbx + rY]
+    #define OCT_MAGIC_IMUL      0x48, 0xB8, H_IMM64, 0x48, 0xF7, 0x6B, H_RY
+    /// sar rdx, Shift; mov rax, rdx; shr rax, 63; add rdx, rax
+    #define OCT_MAGIC_SAR       0x48, 0xC1, 0xFA, H_SHIFT, 0x48, 0x89, 0xD0, \
+                                0x48, 0xC1, 0xE8, 0x3F, 0x48, 0x01, 0xC2
+    /// rX = rY - rdx * Divisor
+    #define OCT_MAGIC_REMAINDER 0x48, 0x69, 0xD2, H_DIVISOR,                  \
+                                OCT_LOAD_RAX(H_RY), 0x48, 0x29, 0xD0,       \
+                                OCT_STORE_RAX(H_RX)
+
+    static const u16 S_DivMagic[]     = { OCT_MAGIC_MUL, OCT_MAGIC_SHR,
+                                          OCT_STORE_RDX(H_RX) };
+    static const u16 S_DivMagicAdd[]  = { OCT_MAGIC_MUL, OCT_MAGIC_ADD,
+                                          OCT_MAGIC_SHR, OCT_STORE_RDX(H_RX) };
+    static const u16 S_ModMagic[]     = { OCT_MAGIC_MUL, OCT_MAGIC_SHR,
+                                          OCT_MAGIC_REMAINDER };
+    static const u16 S_ModMagicAdd[]  = { OCT_MAGIC_MUL, OCT_MAGIC_ADD,
+                                          OCT_MAGIC_SHR, OCT_MAGIC_REMAINDER };
+    /// add rdx, [rbx + rY] / sub rdx, [rbx + rY]
+    static const u16 S_IDivMagic[]    = { OCT_MAGIC_IMUL, OCT_MAGIC_SAR,
+                                          OCT_STORE_RDX(H_RX) };
+    static const u16 S_IDivMagicAdd[] = { OCT_MAGIC_IMUL, 0x48, 0x03, 0x53, H_RY,
+                                          OCT_MAGIC_SAR, OCT_STORE_RDX(H_RX) };
+    static const u16 S_IDivMagicSub[] = { OCT_MAGIC_IMUL, 0x48, 0x2B, 0x53, H_RY,
+                                          OCT_MAGIC_SAR, OCT_STORE_RDX(H_RX) };
+    static const u16 S_IModMagic[]    = { OCT_MAGIC_IMUL, OCT_MAGIC_SAR,
+                                          OCT_MAGIC_REMAINDER };
+    static const u16 S_IModMagicAdd[] = { OCT_MAGIC_IMUL, 0x48, 0x03, 0x53, H_RY,
+                                          OCT_MAGIC_SAR, OCT_MAGIC_REMAINDER };
+    static const u16 S_IModMagicSub[] = { OCT_MAGIC_IMUL, 0x48, 0x2B, 0x53, H_RY,
+                                          OCT_MAGIC_SAR, OCT_MAGIC_REMAINDER };
+
+    // x86 masks 64-bit shift counts to 6 bits, as `shl`/`shr` do
+    static const u16 S_Shl[]       = { OCT_LOAD_RAX(H_RY), OCT_LOAD_RCX(H_RZ),
+                                       0x48, 0xD3, 0xE0, OCT_STORE_RAX(H_RX) };
+    static const u16 S_Shr[]       = { OCT_LOAD_RAX(H_RY), OCT_LOAD_RCX(H_RZ),
+                                       0x48, 0xD3, 0xE8, OCT_STORE_RAX(H_RX) };
+    static const u16 S_ShlImm[]    = { OCT_LOAD_RAX(H_RY), 0x48, 0xB9, H_IMM64,
+                                       0x48, 0xD3, 0xE0, OCT_STORE_RAX(H_RX) };
+    static const u16 S_ShrImm[]    = { OCT_LOAD_RAX(H_RY), 0x48, 0xB9, H_IMM64,
+                                       0x48, 0xD3, 0xE8, OCT_STORE_RAX(H_RX) };
+
+    static const u16 S_CmpIs0[]    = OCT_STENCIL_COMPARE_0(CC_E);
+    static const u16 S_CmpNot0[]   = OCT_STENCIL_COMPARE_0(CC_NE);
+    static const u16 S_CmpEq[]     = OCT_STENCIL_COMPARE(CC_E);
+    static const u16 S_CmpNeq[]    = OCT_STENCIL_COMPARE(CC_NE);
+    static const u16 S_CmpLt[]     = OCT_STENCIL_COMPARE(CC_B);
+    static const u16 S_CmpGt[]     = OCT_STENCIL_COMPARE(CC_A);
+    static const u16 S_CmpLtEq[]   = OCT_STENCIL_COMPARE(CC_BE);
+    static const u16 S_CmpGtEq[]   = OCT_STENCIL_COMPARE(CC_AE);
+    static const u16 S_CmpLtI[]    = OCT_STENCIL_COMPARE(CC_L);
+    static const u16 S_CmpGtI[]    = OCT_STENCIL_COMPARE(CC_G);
+    static const u16 S_CmpLtEqI[]  = OCT_STENCIL_COMPARE(CC_LE);
+    static const u16 S_CmpGtEqI[]  = OCT_STENCIL_COMPARE(CC_GE);
+    static const u16 S_LogicAnd[]  = { 0x31, 0xC0, 0x31, 0xC9,
+                                       0x48, 0x83, 0x7B, H_RY, 0x00, 0x0F, 0x95, 0xC0,
+                                       0x48, 0x83, 0x7B, H_RZ, 0x00, 0x0F, 0x95, 0xC1,
+                                       0x21, 0xC8, OCT_STORE_RAX(H_RX) };
+    static const u16 S_LogicOr[]   = { 0x31, 0xC0, 0x31, 0xC9,
+                                       0x48, 0x83, 0x7B, H_RY, 0x00, 0x0F, 0x95, 0xC0,
+                                       0x48, 0x83, 0x7B, H_RZ, 0x00, 0x0F, 0x95, 0xC1,
+                                       0x09, 0xC8, OCT_STORE_RAX(H_RX) };
+
+    static const u16 S_JmpIs0[]    = OCT_STENCIL_BRANCH_0(CC_E);
+    static const u16 S_JmpNot0[]   = OCT_STENCIL_BRANCH_0(CC_NE);
+    static const u16 S_JmpEq[]     = OCT_STENCIL_BRANCH(CC_E);
+    static const u16 S_JmpNeq[]    = OCT_STENCIL_BRANCH(CC_NE);
+    static const u16 S_JmpLt[]     = OCT_STENCIL_BRANCH(CC_B);
+    static const u16 S_JmpGt[]     = OCT_STENCIL_BRANCH(CC_A);
+    static const u16 S_JmpLtEq[]   = OCT_STENCIL_BRANCH(CC_BE);
+    static const u16 S_JmpGtEq[]   = OCT_STENCIL_BRANCH(CC_AE);
+
+    /// disp32 of `ExecState::ThreadMemory` from rbx. References
+    /// are laid out as pointers, and it follows `ExecState::Thread`.
+    static constexpr const u32 MEMORY_DISP = sizeof(ExecState::Reg)
+                                           + sizeof(void*);
+    #define OCT_BYTE(Value, Shift)  (u8)( (Value) >> (Shift) )
+    #define OCT_IMM32(Value)        OCT_BYTE(Value, 0), OCT_BYTE(Value, 8), \
+                                    OCT_BYTE(Value, 16), OCT_BYTE(Value, 24)
+    /// mov rdx, [rbx + ThreadMemory]; movzx eax, word [rdx + StackIDX]
+    #define OCT_STACK_INDEX                                                 \
+            0x48, 0x8B, 0x93, OCT_IMM32(MEMORY_DISP),                       \
+            0x0F, 0xB7, 0x42, ThreadMemory::GetStackIDXOffset()
+    /// rsi = Stack start + rax
+    #define OCT_STACK_TOP                                                   \
+            0x48, 0x8B, 0x72, ThreadMemory::GetRawSpaceOffset(),            \
+            0x48, 0x01, 0xC6
+    /// Claims Size bytes of the Stack at rsi, exiting if
+    /// they do not fit, for the interpreter to raise.
+    ///     movzx ecx, word [rdx + StackSize]; sub ecx, eax
+    ///     cmp ecx, Size; jb exit; top; add eax, Size
+    ///     mov [rdx + StackIDX], ax
+    #define OCT_STACK_CLAIM(Size)                                           \
+            OCT_STACK_INDEX, 0x0F, 0xB7, 0x4A,                              \
+            ThreadMemory::GetStackSizeOffset(), 0x29, 0xC1,                 \
+            0x81, 0xF9, OCT_IMM32(Size), 0x0F, 0x82, H_EXIT,                \
+            OCT_STACK_TOP, 0x05, OCT_IMM32(Size),                           \
+            0x66, 0x89, 0x42, ThreadMemory::GetStackIDXOffset()
+    /// Releases the top Size bytes of the Stack at rsi,
+    /// exiting if it holds fewer.
+    ///     sub eax, Size; jb exit; mov [rdx + StackIDX], ax; top
+    #define OCT_STACK_RELEASE(Size)                                         \
+            OCT_STACK_INDEX, 0x2D, OCT_IMM32(Size), 0x0F, 0x82, H_EXIT,     \
+            0x66, 0x89, 0x42, ThreadMemory::GetStackIDXOffset(),            \
+            OCT_STACK_TOP
+    /// Copies the registers of the 16-bit Mask between rbx
+    /// and rsi, with Load and Store the ModRM of r8 through
+    /// [base + rcx * 8] from the source and to the destination.
+    ///     mov rdi, Mask; test edi, edi; jz done
+    /// loop:
+    ///     bsf ecx, edi; mov r8, [src]; mov [dst], r8
+    ///     lea eax, [rdi - 1]; and edi, eax; jnz loop
+    #define OCT_STACK_MASKED(Load, Store)                                   \
+            0x48, 0xBF, H_IMM64, 0x85, 0xFF, 0x74, 0x12,                    \
+            0x0F, 0xBC, 0xCF, 0x4C, 0x8B, 0x04, Load,                       \
+            0x4C, 0x89, 0x04, Store, 0x8D, 0x47, 0xFF,                      \
+            0x21, 0xC7, 0x75, 0xEE
+    /// movups xmm0, [Source + Disp]; movups [Dest + Disp], xmm0,
+    /// with Source and Dest the ModRM of an xmm0 disp8 access
+    #define OCT_STACK_COPY16(Source, Dest, Disp)                            \
+            0x0F, 0x10, Source, Disp, 0x0F, 0x11, Dest, Disp
+    #define OCT_STACK_COPY_ALL(Source, Dest)                                \
+            OCT_STACK_COPY16(Source, Dest, 0x00),                           \
+            OCT_STACK_COPY16(Source, Dest, 0x10),                           \
+            OCT_STACK_COPY16(Source, Dest, 0x20),                           \
+            OCT_STACK_COPY16(Source, Dest, 0x30),                           \
+            OCT_STACK_COPY16(Source, Dest, 0x40),                           \
+            OCT_STACK_COPY16(Source, Dest, 0x50),                           \
+            OCT_STACK_COPY16(Source, Dest, 0x60),                           \
+            OCT_STACK_COPY16(Source, Dest, 0x70)
+
+    // mov rcx, [rbx + rX]; mov [rsi], rcx / mov rcx, [rsi]; mov [rbx + rX], rcx
+    static const u16 S_Push[]      = { OCT_STACK_CLAIM(8), OCT_LOAD_RCX(H_RX),
+                                       0x48, 0x89, 0x0E };
+    static const u16 S_Pop[]       = { OCT_STACK_RELEASE(8), 0x48, 0x8B, 0x0E,
+                                       0x48, 0x89, 0x4B, H_RX };
+    // [rbx + Disp] = 0x43, [rsi + Disp] = 0x46
+    static const u16 S_PushAll[]   = { OCT_STACK_CLAIM(sizeof(ExecState::Reg)),
+                                       OCT_STACK_COPY_ALL(0x43, 0x46) };
+    static const u16 S_PopAll[]    = { OCT_STACK_RELEASE(sizeof(ExecState::Reg)),
+                                       OCT_STACK_COPY_ALL(0x46, 0x43) };
+    // [rbx + rcx * 8] = 0xCB, [rsi + rcx * 8] = 0xCE
+    static const u16 S_PushMasked[] = { OCT_STACK_CLAIM(sizeof(ExecState::Reg)),
+                                        OCT_STACK_MASKED(0xCB, 0xCE) };
+    static const u16 S_PopMasked[]  = { OCT_STACK_RELEASE(sizeof(ExecState::Reg)),
+                                        OCT_STACK_MASKED(0xCE, 0xCB) };
+
+    /// Caches rX in the slot at [rsp + Disp], exiting
+    /// without the Stack room its pair relies on.
+    ///     movzx ecx, word [rdx + StackSize]; sub ecx, eax
+    ///     cmp ecx, Room; jb exit; mov rcx, [rbx + rX]
+    ///     mov [rsp + Disp], rcx
+    #define OCT_STENCIL_TOP_PUSH(Disp) {                                    \
+            OCT_STACK_INDEX, 0x0F, 0xB7, 0x4A,                              \
+            ThreadMemory::GetStackSizeOffset(), 0x29, 0xC1,                 \
+            0x81, 0xF9, H_ROOM, 0x0F, 0x82, H_EXIT, OCT_LOAD_RCX(H_RX),     \
+            0x48, 0x89, 0x4C, 0x24, Disp                                    \
+        }
+    /// mov rcx, [rsp + Disp]; mov [rbx + rX], rcx
+    #define OCT_STENCIL_TOP_POP(Disp) {                                     \
+            0x48, 0x8B, 0x4C, 0x24, Disp, 0x48, 0x89, 0x4B, H_RX            \
+        }
+
+    static const u16 S_TopPush0[]  = OCT_STENCIL_TOP_PUSH(0x00);
+    static const u16 S_TopPush1[]  = OCT_STENCIL_TOP_PUSH(0x08);
+    static const u16 S_TopPop0[]   = OCT_STENCIL_TOP_POP(0x00);
+    static const u16 S_TopPop1[]   = OCT_STENCIL_TOP_POP(0x08);
+
+    static const u16 S_GLoad8[]    = { OCT_GLOBAL_ADDRESS, 0x48, 0x0F, 0xB6, 0x00,
+                                       OCT_STORE_RAX(H_RX) };
+    static const u16 S_GLoad16[]   = { OCT_GLOBAL_ADDRESS, 0x48, 0x0F, 0xB7, 0x00,
+                                       OCT_STORE_RAX(H_RX) };
+    static const u16 S_GLoad32[]   = { OCT_GLOBAL_ADDRESS, 0x8B, 0x00,
+                                       OCT_STORE_RAX(H_RX) };
+    static const u16 S_GLoad64[]   = { OCT_GLOBAL_ADDRESS, 0x48, 0x8B, 0x00,
+                                       OCT_STORE_RAX(H_RX) };
+    static const u16 S_GSave8[]    = { OCT_GLOBAL_ADDRESS, OCT_LOAD_RCX(H_RX),
+                                       0x88, 0x08 };
+    static const u16 S_GSave16[]   = { OCT_GLOBAL_ADDRESS, OCT_LOAD_RCX(H_RX),
+                                       0x66, 0x89, 0x08 };
+    static const u16 S_GSave32[]   = { OCT_GLOBAL_ADDRESS, OCT_LOAD_RCX(H_RX),
+                                       0x89, 0x08 };
+    static const u16 S_GSave64[]   = { OCT_GLOBAL_ADDRESS, OCT_LOAD_RCX(H_RX),
+                                       0x48, 0x89, 0x08 };
+
+    /// Bounds checks a `pload`/`psave` of Width bytes, leaving
+    /// rax at the base and rcx at the offset. A null base or an
+    /// index out of bounds exits, for the interpreter to raise.
+    ///     mov rax, [rbx + rY]; test rax, rax; jz exit
+    ///     mov edx, [rax - header] (its Size); sub rdx, Width; jb exit
+    ///     shr rdx, Stride; mov rcx, [rbx + rZ]; cmp rcx, rdx; ja exit
+    ///     shl rcx, Stride
+    #define OCT_PRIV_ADDRESS(Width)                                         \
+            OCT_LOAD_RAX(H_RY), 0x48, 0x85, 0xC0, 0x0F, 0x84, H_EXIT,       \
+            0x8B, 0x50, (u8)-(i32)sizeof(AllocationHeader),                 \
+            0x48, 0x83, 0xEA, Width, 0x0F, 0x82, H_EXIT,                    \
+            0x48, 0xC1, 0xEA, H_STRIDE, OCT_LOAD_RCX(H_RZ),                 \
+            0x48, 0x39, 0xD1, 0x0F, 0x87, H_EXIT,                           \
+            0x48, 0xC1, 0xE1, H_STRIDE
+    /// The same address, of a site a `BoundsGuard` has proven
+    #define OCT_PRIV_ADDRESS_BOUNDED                                        \
+            OCT_LOAD_RAX(H_RY), OCT_LOAD_RCX(H_RZ), 0x48, 0xC1, 0xE1, H_STRIDE
+    /// movzx eax, byte/word [rax + rcx] / mov eax/rax, [rax + rcx]
+    #define OCT_PLOAD8          0x0F, 0xB6, 0x04, 0x08, OCT_STORE_RAX(H_RX)
+    #define OCT_PLOAD16         0x0F, 0xB7, 0x04, 0x08, OCT_STORE_RAX(H_RX)
+    #define OCT_PLOAD32         0x8B, 0x04, 0x08, OCT_STORE_RAX(H_RX)
+    #define OCT_PLOAD64         0x48, 0x8B, 0x04, 0x08, OCT_STORE_RAX(H_RX)
+    /// mov rdx, [rbx + rX]; mov [rax + rcx], dl/dx/edx/rdx
+    #define OCT_PSAVE8          0x48, 0x8B, 0x53, H_RX, 0x88, 0x14, 0x08
+    #define OCT_PSAVE16         0x48, 0x8B, 0x53, H_RX, 0x66, 0x89, 0x14, 0x08
+    #define OCT_PSAVE32         0x48, 0x8B, 0x53, H_RX, 0x89, 0x14, 0x08
+    #define OCT_PSAVE64         0x48, 0x8B, 0x53, H_RX, 0x48, 0x89, 0x14, 0x08
+
+    static const u16 S_PLoad8[]    = { OCT_PRIV_ADDRESS(1), OCT_PLOAD8 };
+    static const u16 S_PLoad16[]   = { OCT_PRIV_ADDRESS(2), OCT_PLOAD16 };
+    static const u16 S_PLoad32[]   = { OCT_PRIV_ADDRESS(4), OCT_PLOAD32 };
+    static const u16 S_PLoad64[]   = { OCT_PRIV_ADDRESS(8), OCT_PLOAD64 };
+    static const u16 S_PSave8[]    = { OCT_PRIV_ADDRESS(1), OCT_PSAVE8 };
+    static const u16 S_PSave16[]   = { OCT_PRIV_ADDRESS(2), OCT_PSAVE16 };
+    static const u16 S_PSave32[]   = { OCT_PRIV_ADDRESS(4), OCT_PSAVE32 };
+    static const u16 S_PSave64[]   = { OCT_PRIV_ADDRESS(8), OCT_PSAVE64 };
+    static const u16 S_PLoad8Bounded[]  = { OCT_PRIV_ADDRESS_BOUNDED, OCT_PLOAD8 };
+    static const u16 S_PLoad16Bounded[] = { OCT_PRIV_ADDRESS_BOUNDED, OCT_PLOAD16 };
+    static const u16 S_PLoad32Bounded[] = { OCT_PRIV_ADDRESS_BOUNDED, OCT_PLOAD32 };
+    static const u16 S_PLoad64Bounded[] = { OCT_PRIV_ADDRESS_BOUNDED, OCT_PLOAD64 };
+    static const u16 S_PSave8Bounded[]  = { OCT_PRIV_ADDRESS_BOUNDED, OCT_PSAVE8 };
+    static const u16 S_PSave16Bounded[] = { OCT_PRIV_ADDRESS_BOUNDED, OCT_PSAVE16 };
+    static const u16 S_PSave32Bounded[] = { OCT_PRIV_ADDRESS_BOUNDED, OCT_PSAVE32 };
+    static const u16 S_PSave64Bounded[] = { OCT_PRIV_ADDRESS_BOUNDED, OCT_PSAVE64 };
+
+    /// Runs a `BoundsGuard` ahead of its loop header, exiting
+    /// into the checked loop if it fails. mov rsi, Checks
+    static const u16 S_GuardBounds[] = OCT_STENCIL_HELPER(0x48, 0xBE, H_IMM64,);
+
+    /// push rbx; push r12; sub rsp, 24; mov r12, rdi;
+    /// lea rbx, [rdi + offset of Reg]
+    static const u8 PROLOGUE[] = {
+        0x53, 0x41, 0x54, 0x48, 0x83, 0xEC, 0x18, 0x49, 0x89, 0xFC,
+        0x48, 0x8D, 0x9F
+    };
+
+    /// mov esi, IDX; jmp to the common exit
+    static constexpr const u32 EXIT_STUB_SIZE = 10;
+
+    /// Spills the `TOP_` slots live at an exit, deepest first,
+    /// which leaves the Stack as the plain pushes would have,
+    /// then jumps to the common exit. Their room was checked
+    /// when cached. esi still holds the IDX of the exit.
+    ///     mov rdx, [rbx + ThreadMemory]; movzx eax, word [rdx + StackIDX]
+    ///     mov rdi, [rdx + RawSpace]
+    static const u8 SPILL_HEAD[] = {
+        0x48, 0x8B, 0x93, OCT_IMM32(MEMORY_DISP),
+        0x0F, 0xB7, 0x42, ThreadMemory::GetStackIDXOffset(),
+        0x48, 0x8B, 0x7A, ThreadMemory::GetRawSpaceOffset()
+    };
+    /// mov rcx, [rsp + Disp]; mov [rdi + rax], rcx; add eax, 8
+    #define OCT_SPILL_SLOT(Disp)                                            \
+            0x48, 0x8B, 0x4C, 0x24, Disp, 0x48, 0x89, 0x0C, 0x07,           \
+            0x83, 0xC0, 0x08
+    static const u8 SPILL_SLOT0[] = { OCT_SPILL_SLOT(0x00) };
+    static const u8 SPILL_SLOT1[] = { OCT_SPILL_SLOT(0x08) };
+    /// mov [rdx + StackIDX], ax; jmp to the common exit
+    static const u8 SPILL_TAIL[] = {
+        0x66, 0x89, 0x42, ThreadMemory::GetStackIDXOffset(), 0xE9
+    };
+
+    /// HELPERS:
+    /// Called from compiled code, and as such
+    /// never raise. Returning false or nullptr
+    /// makes the site exit to the interpreter,
+    /// which raises the `Exception` instead.
+    ////////////////////////////////////////
+
+    static byte* JITGlobalAddress(ExecState* State, GlobalCache* Cache,
+                                  const void* Key, u64 Index) noexcept
+    {
+        if ( !HitsGlobalCache(*Cache, Key, State->Storage.GetGeneration())
+             && !FillGlobalCache(*Cache, State->Storage, Key) )
+            return nullptr;
+        return Cache->Value + Index * Cache->Scale;
+    }
+
+    static bool JITCheckBounds(ExecState* State, u64 Checks) noexcept
+        { return PassesBoundsGuard(Checks, State->Reg); }
+
+    /// @brief A stencil chosen for a single site
+    ////////////////////////////////////////
+    struct Site {
+        const u16* Stencil;
+        u32        Length;
+        u64        Imm;
+        u64        Helper;
+    };
+
+    #define OCT_USE(Name) { Out.Stencil = Name;                             \
+                            Out.Length  = sizeof(Name) / sizeof(*Name);     \
+                            return true; }
+
+    /// @brief Picks the stencil of a single `DecodedInstruction`,
+    /// along with the values of its IMM64 and HELPER64 holes.
+    /// @param Bounded Set for a `pload`/`psave` whose loop
+    /// is guarded by a `BoundsGuard` proving it in bounds
+    /// @param CacheTop Set to keep `TOP_` pairs in the slots
+    /// of the native frame, rather than on the Stack
+    /// @return False if the site has no stencil, and must exit.
+    ////////////////////////////////////////
+    static bool SelectStencil(const DecodedInstruction& D, const Function& Func,
+                              Site& Out, bool Bounded = false,
+                              bool CacheTop = false) noexcept
+    {
+        Out = { nullptr, 0, D.Imm, 0 };
+        switch ( GetBaseOpcode(D.Op) ) {
+            case Instruction::nop:      Out.Length = 0; return true;
+            case Instruction::seek:
+            case Instruction::jmp:      OCT_USE(S_Jump)
+            case Instruction::jmpis0:   OCT_USE(S_JmpIs0)
+            case Instruction::jmpnot0:  OCT_USE(S_JmpNot0)
+            case Instruction::jmpeq:    OCT_USE(S_JmpEq)
+            case Instruction::jmpneq:   OCT_USE(S_JmpNeq)
+            case Instruction::jmplt:    OCT_USE(S_JmpLt)
+            case Instruction::jmpgt:    OCT_USE(S_JmpGt)
+            case Instruction::jmplteq:  OCT_USE(S_JmpLtEq)
+            case Instruction::jmpgteq:  OCT_USE(S_JmpGtEq)
+            case Instruction::ret:      OCT_USE(S_Return)
+
+            case Instruction::clr:      OCT_USE(S_Clear)
+            case Instruction::mov:      OCT_USE(S_Move)
+            case Instruction::movimm:
+            case Instruction::bnotimm:  OCT_USE(S_MoveImm)
+            case Instruction::movimm32:
+            case Instruction::movimm64:
+            case Instruction::movimmf:
+            case Instruction::movimmd:  OCT_USE(S_MoveWide)
+
+            case Instruction::pushreg:
+            case Instruction::pusharg:
+                if ( CacheTop && D.Op == TOP_PUSHREG0 )
+                    OCT_USE(S_TopPush0)
+                if ( CacheTop && D.Op == TOP_PUSHREG1 )
+                    OCT_USE(S_TopPush1)
+                OCT_USE(S_Push)
+            case Instruction::popreg:
+            case Instruction::poparg:
+                if ( CacheTop && D.Op == TOP_POPREG0 )
+                    OCT_USE(S_TopPop0)
+                if ( CacheTop && D.Op == TOP_POPREG1 )
+                    OCT_USE(S_TopPop1)
+                OCT_USE(S_Pop)
+            // Masks keeping every register copy them all, unrolled
+            case Instruction::pushall:
+                if ( ( D.Op == MASKED_PUSHALL || D.Op == UNCHECKED_MASKED_PUSHALL )
+                     && (u16)D.Imm != ALL_REGISTERS )
+                    OCT_USE(S_PushMasked)
+                OCT_USE(S_PushAll)
+            case Instruction::popall:
+                if ( ( D.Op == MASKED_POPALL || D.Op == UNCHECKED_MASKED_POPALL )
+                     && (u16)D.Imm != ALL_REGISTERS )
+                    OCT_USE(S_PopMasked)
+                OCT_USE(S_PopAll)
+
+            // The Shared Space never moves, so its address is constant
+            case Instruction::offset:
+                if ( D.Imm >= Func.GetSharedSize() )
+                    return false;
+                Out.Imm = (u64)( Func.GetSharedSpace() + D.Imm );
+                OCT_USE(S_MoveImm)
+
+            case Instruction::gload8:   Out.Helper = (u64)&JITGlobalAddress;
+                                        OCT_USE(S_GLoad8)
+            case Instruction::gload16:  Out.Helper = (u64)&JITGlobalAddress;
+                                        OCT_USE(S_GLoad16)
+            case Instruction::gload32:  Out.Helper = (u64)&JITGlobalAddress;
+                                        OCT_USE(S_GLoad32)
+            case Instruction::gload64:  Out.Helper = (u64)&JITGlobalAddress;
+                                        OCT_USE(S_GLoad64)
+            case Instruction::gsave8:   Out.Helper = (u64)&JITGlobalAddress;
+                                        OCT_USE(S_GSave8)
+            case Instruction::gsave16:  Out.Helper = (u64)&JITGlobalAddress;
+                                        OCT_USE(S_GSave16)
+            case Instruction::gsave32:  Out.Helper = (u64)&JITGlobalAddress;
+                                        OCT_USE(S_GSave32)
+            case Instruction::gsave64:  Out.Helper = (u64)&JITGlobalAddress;
+                                        OCT_USE(S_GSave64)
+
+            case Instruction::pload8:   if ( Bounded ) OCT_USE(S_PLoad8Bounded)
+                                        OCT_USE(S_PLoad8)
+            case Instruction::pload16:  if ( Bounded ) OCT_USE(S_PLoad16Bounded)
+                                        OCT_USE(S_PLoad16)
+            case Instruction::pload32:  if ( Bounded ) OCT_USE(S_PLoad32Bounded)
+                                        OCT_USE(S_PLoad32)
+            case Instruction::pload64:  if ( Bounded ) OCT_USE(S_PLoad64Bounded)
+                                        OCT_USE(S_PLoad64)
+            case Instruction::psave8:   if ( Bounded ) OCT_USE(S_PSave8Bounded)
+                                        OCT_USE(S_PSave8)
+            case Instruction::psave16:  if ( Bounded ) OCT_USE(S_PSave16Bounded)
+                                        OCT_USE(S_PSave16)
+            case Instruction::psave32:  if ( Bounded ) OCT_USE(S_PSave32Bounded)
+                                        OCT_USE(S_PSave32)
+            case Instruction::psave64:  if ( Bounded ) OCT_USE(S_PSave64Bounded)
+                                        OCT_USE(S_PSave64)
+
+            case Instruction::cmpis0:
+            case Instruction::lnot:     OCT_USE(S_CmpIs0)
+            case Instruction::cmpnot0:  OCT_USE(S_CmpNot0)
+            case Instruction::cmpeq:    OCT_USE(S_CmpEq)
+            case Instruction::cmpneq:   OCT_USE(S_CmpNeq)
+            case Instruction::cmplt:    OCT_USE(S_CmpLt)
+            case Instruction::cmpgt:    OCT_USE(S_CmpGt)
+            case Instruction::cmplteq:  OCT_USE(S_CmpLtEq)
+            case Instruction::cmpgteq:  OCT_USE(S_CmpGtEq)
+            case Instruction::cmplti:   OCT_USE(S_CmpLtI)
+            case Instruction::cmpgti:   OCT_USE(S_CmpGtI)
+            case Instruction::cmplteqi: OCT_USE(S_CmpLtEqI)
+            case Instruction::cmpgteqi: OCT_USE(S_CmpGtEqI)
+            case Instruction::land:     OCT_USE(S_LogicAnd)
+            case Instruction::lor:      OCT_USE(S_LogicOr)
+
+            case Instruction::inc:      OCT_USE(S_Inc)
+            case Instruction::dec:      OCT_USE(S_Dec)
+            case Instruction::add:      OCT_USE(S_Add)
+            case Instruction::sub:      OCT_USE(S_Sub)
+            case Instruction::mul:      OCT_USE(S_Mul)
+            case Instruction::addimm:   OCT_USE(S_AddImm)
+            case Instruction::subimm:   OCT_USE(S_SubImm)
+            case Instruction::mulimm:   OCT_USE(S_MulImm)
+            case Instruction::div:      OCT_USE(S_Div)
+            case Instruction::mod:      OCT_USE(S_Mod)
+            case Instruction::idiv:     OCT_USE(S_IDiv)
+            case Instruction::imod:     OCT_USE(S_IMod)
+            case Instruction::divimm:
+                if ( D.Op == REDUCED_DIVIMM ) {
+                    if ( D.rZ & REDUCED_ADD )
+                        OCT_USE(S_DivMagicAdd)
+                    OCT_USE(S_DivMagic)
+                }
+                if ( !D.Imm )
+                    return false;
+                OCT_USE(S_DivImm)
+            case Instruction::modimm:
+                if ( D.Op == REDUCED_MODIMM ) {
+                    if ( D.rZ & REDUCED_ADD )
+                        OCT_USE(S_ModMagicAdd)
+                    OCT_USE(S_ModMagic)
+                }
+                if ( !D.Imm )
+                    return false;
+                OCT_USE(S_ModImm)
+            case Instruction::idivimm:
+                if ( D.Op == REDUCED_IDIVIMM ) {
+                    if ( D.rZ & REDUCED_ADD )
+                        OCT_USE(S_IDivMagicAdd)
+                    if ( D.rZ & REDUCED_SUB )
+                        OCT_USE(S_IDivMagicSub)
+                    OCT_USE(S_IDivMagic)
+                }
+                if ( !D.Imm || (i64)D.Imm == -1 )
+                    return false;
+                OCT_USE(S_IDivImm)
+            case Instruction::imodimm:
+                if ( D.Op == REDUCED_IMODIMM ) {
+                    if ( D.rZ & REDUCED_ADD )
+                        OCT_USE(S_IModMagicAdd)
+                    if ( D.rZ & REDUCED_SUB )
+                        OCT_USE(S_IModMagicSub)
+                    OCT_USE(S_IModMagic)
+                }
+                if ( !D.Imm || (i64)D.Imm == -1 )
+                    return false;
+                OCT_USE(S_IModImm)
+
+            case Instruction::band:     OCT_USE(S_And)
+            case Instruction::bor:      OCT_USE(S_Or)
+            case Instruction::bxor:     OCT_USE(S_Xor)
+            case Instruction::bnot:     OCT_USE(S_Not)
+            case Instruction::shl:      OCT_USE(S_Shl)
+            case Instruction::shr:      OCT_USE(S_Shr)
+            case Instruction::bandimm:  OCT_USE(S_AndImm)
+            case Instruction::borimm:   OCT_USE(S_OrImm)
+            case Instruction::bxorimm:  OCT_USE(S_XorImm)
+            case Instruction::shlimm:   OCT_USE(S_ShlImm)
+            case Instruction::shrimm:   OCT_USE(S_ShrImm)
+
+            default:
+                return false;
+        }
+    }
+
+    #undef OCT_USE
+
+    /// @brief Returns true if a site may leave its
+    /// code for the interpreter
+    ////////////////////////////////////////
+    static bool CanExit(const Site& At) noexcept
+    {
+        for ( u32 i = 0; i < At.Length; i++ )
+            if ( At.Stencil[i] == H_EXIT || At.Stencil[i] == H_TARGET )
+                return true;
+        return false;
+    }
+
+    /// @brief Finds the `TOP_` slots live at each site of Func,
+    /// one bit per slot, which an exit from the site spills.
+    /// Pairs only span straight-line code, so this is known
+    /// for every site while compiling.
+    /// @param Live Receives the slots of every site, up to
+    /// the end of the decoded tail
+    /// @return False if a site inside of a pair may exit with
+    /// more pushed above the slots, where spilling them would
+    /// not rebuild the Stack. `TOP_` sites must then be plain.
+    ////////////////////////////////////////
+    static bool MapStackSlots(const Function& Func,
+                              const DecodedInstruction* Decoded,
+                              u32* Live) noexcept
+    {
+        const Instruction* Code  = Func.GetCodeSpace();
+        u32                Count = Func.GetInstructionCount();
+        for ( u32 i = 0; i < Count + DECODED_TAIL_COUNT; i++ )
+            Live[i] = 0;
+
+        u32 Slots = 0;
+        i32 Inner = 0;
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            Live[i] = Slots;
+            u8 Op = Decoded[i].Op;
+            if ( Op == TOP_PUSHREG0 || Op == TOP_PUSHREG1 ) {
+                Slots |= 1u << ( Op - TOP_PUSHREG0 );
+                continue;
+            }
+            if ( Op == TOP_POPREG0 || Op == TOP_POPREG1 ) {
+                Slots &= ~( 1u << ( Op - TOP_POPREG0 ) );
+                if ( !Slots )
+                    Inner = 0;
+                continue;
+            }
+            if ( !Slots )
+                continue;
+
+            // Pops of what the pair pushed itself never underflow
+            i32 Effect = 0;
+            GetStackEffect(Code[i], Effect);
+            Site At;
+            bool Exits = ( !SelectStencil(Decoded[i], Func, At, false, true)
+                           || CanExit(At) );
+            if ( Exits && Inner && !( Effect < 0 && Inner + Effect >= 0 ) ) {
+                for ( u32 k = 0; k < Count; k++ )
+                    Live[k] = 0;
+                return false;
+            }
+            Inner += Effect;
+        }
+        return true;
+    }
+
+    /// @brief Returns the amount of bytes a stencil emits
+    ////////////////////////////////////////
+    static u32 GetStencilSize(const u16* Stencil, u32 Length) noexcept
+    {
+        u32 Size = 0;
+        for ( u32 i = 0; i < Length; i++ )
+            Size += GetHoleSize(Stencil[i]);
+        return Size;
+    }
+
+    /// @brief Writes a little-endian value of Size bytes at Out
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    void Patch(byte* Out, u64 Value, u32 Size) noexcept
+    {
+        for ( u32 i = 0; i < Size; i++ )
+            Out[i] = (byte)( Value >> ( i * 8 ) );
+    }
+
+    /// @brief Returns the rel32 from the end of a
+    /// 4-byte hole at From to To
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    u64 GetRel32(u32 From, u32 To) noexcept
+        { return (u64)(u32)( (i32)To - (i32)( From + 4 ) ); }
+
+    /// @brief Copies a stencil to Code + Offset, and patches its holes
+    /// @param Labels The offset of every site's code
+    /// @param Entries The offset at which each site is entered
+    /// other than by a jump, ahead of any `BoundsGuard` of it
+    /// @param Exits The offset of the first exit stub
+    ////////////////////////////////////////
+    static u32 EmitStencil(byte* Code, u32 Offset, const Site& At,
+                           const DecodedInstruction& D, u32 IDX, u32 Count,
+                           const u32* Labels, const u32* Entries,
+                           u32 Exits) noexcept
+    {
+        u32 Exit = Exits + IDX * EXIT_STUB_SIZE;
+        for ( u32 i = 0; i < At.Length; i++ ) {
+            u16 Entry = At.Stencil[i];
+            switch ( Entry ) {
+                case H_RX: Code[Offset] = (byte)( D.rX * 8 ); break;
+                case H_RY: Code[Offset] = (byte)( D.rY * 8 ); break;
+                case H_RZ: Code[Offset] = (byte)( D.rZ * 8 ); break;
+                case H_IMM64:
+                    Patch(Code + Offset, At.Imm, 8);
+                    break;
+                case H_HELPER64:
+                    Patch(Code + Offset, At.Helper, 8);
+                    break;
+                case H_TARGET:
+                    Patch(Code + Offset, GetRel32(Offset,
+                          ( D.Imm < Count ? Labels[D.Imm] : Exit )), 4);
+                    break;
+                case H_EXIT:
+                    Patch(Code + Offset, GetRel32(Offset, Exit), 4);
+                    break;
+                case H_SHIFT:
+                    Code[Offset] = (byte)( D.rZ & REDUCED_SHIFT_MASK );
+                    break;
+                case H_DIVISOR:
+                case H_ROOM:
+                    Patch(Code + Offset, D.Aux, 4);
+                    break;
+                case H_STRIDE:
+                    Code[Offset] = (byte)D.Imm;
+                    break;
+                case H_NEXT: {
+                    u32 Next = IDX + Instruction::GetWordCount(
+                                     (Instruction::Opcode)D.Op );
+                    Patch(Code + Offset, GetRel32(Offset, Entries[Next]), 4);
+                    break;
+                }
+                default:
+                    Code[Offset] = (byte)Entry;
+                    break;
+            }
+            Offset += GetHoleSize(Entry);
+        }
+        return Offset;
+    }
+
+    /// @brief Returns true if more than half of the
+    /// `Instruction`s from Start up to End move the Stack
+    ////////////////////////////////////////
+    static bool IsStackBound(const Instruction* Code,
+                             u32 Start, u32 End) noexcept
+    {
+        u32 Sites = 0;
+        u32 Moves = 0;
+        for ( u32 i = Start; i <= End; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            i32 Effect = 0;
+            GetStackEffect(Code[i], Effect);
+            Sites++;
+            Moves += ( Effect != 0 );
+        }
+        return Moves * 2 > Sites;
+    }
+
+    /// @brief Returns true if Func reaches a backward jump without
+    /// exiting to the interpreter, walking its Code Space one
+    /// `Instruction` at a time from Entry. Compiled code only pays
+    /// for itself across loop iterations, as calls from the
+    /// interpreter into native code write back the whole register file.
+    /// Loops mostly moving the Stack are left to the interpreter, whose
+    /// unchecked copy narrows the saves native code must make in full.
+    ////////////////////////////////////////
+    static bool IsWorthCompiling(const Function& Func,
+                                 const DecodedInstruction* Decoded,
+                                 u32 Entry) noexcept
+    {
+        const Instruction* Code  = Func.GetCodeSpace();
+        u32                Count = Func.GetInstructionCount();
+        for ( u32 i = Entry; i < Count; ) {
+            Site At;
+            if ( !SelectStencil(Decoded[i], Func, At) )
+                return false;
+            i32 Target;
+            if ( Instruction::GetJumpTarget(Code[i], i, Target)
+                 && Target >= 0 && (u32)Target <= i )
+                return !IsStackBound(Code, (u32)Target, i);
+            i += Instruction::GetWordCount(Code[i].Any.Op);
+        }
+        return false;
+    }
+
+    /// NATIVE CODE:
+    ////////////////////////////////////////
+
+    /// @brief Switches the pages holding Size bytes of code at
+    /// Code between writable and executable. Pages may be shared
+    /// with other code, which never runs while code is compiled,
+    /// as only one thread executes under a VM at a time.
+    ////////////////////////////////////////
+    static bool ProtectJITCode(byte* Code, u64 Size, bool Writable) noexcept
+    {
+        u64 PageSize = (u64)sysconf(_SC_PAGESIZE);
+        u64 Start    = (u64)Code / PageSize * PageSize;
+        u64 End      = ( (u64)Code + Size + PageSize - 1 ) / PageSize * PageSize;
+        return mprotect((void*)Start, End - Start,
+                        ( Writable ? PROT_READ | PROT_WRITE
+                                   : PROT_READ | PROT_EXEC )) == 0;
+    }
+
+    byte* MapJITCode(ExecState& State, const Function& Func,
+                     u32 Size) noexcept
+    {
+        byte* Cold = nullptr;
+        return MapJITCode(State, Func, Size, 0, Cold);
+    }
+
+    byte* MapJITCode(ExecState& State, const Function& Func,
+                     u32 Size, u32 ColdSize, byte*& Cold) noexcept
+    {
+        CodeCache& Cache = State.VMInstance.GetCodeCache();
+        Cold = nullptr;
+        byte* Code = Cache.Reserve(State, Func, Size);
+        if ( !Code )
+            return nullptr;
+        if ( ColdSize ) {
+            Cold = Cache.Reserve(State, Func, ColdSize, true);
+            if ( !Cold ) {
+                Cache.Unreserve(Code, Size);
+                return nullptr;
+            }
+        }
+
+        if ( ProtectJITCode(Code, Size, true)
+             && ( !Cold || ProtectJITCode(Cold, ColdSize, true) ) )
+            return Code;
+        ProtectJITCode(Code, Size, false);
+        Cache.Unreserve(Code, Size);
+        if ( Cold ) {
+            ProtectJITCode(Cold, ColdSize, false);
+            Cache.Unreserve(Cold, ColdSize);
+        }
+        return nullptr;
+    }
+
+    ExposedFunc SealJITCode(ExecState& State, Function& Func, byte* Code,
+                            u32 Size, void* Data) noexcept
+        { return SealJITCode(State, Func, Code, Size, nullptr, 0, Data); }
+
+    ExposedFunc SealJITCode(ExecState& State, Function& Func, byte* Code,
+                            u32 Size, byte* Cold, u32 ColdSize,
+                            void* Data) noexcept
+    {
+        CodeCache& Cache = State.VMInstance.GetCodeCache();
+        bool Sealed = ProtectJITCode(Code, Size, false);
+        if ( Cold )
+            Sealed = ProtectJITCode(Cold, ColdSize, false) && Sealed;
+        if ( !Sealed ) {
+            Cache.Unreserve(Code, Size);
+            if ( Cold )
+                Cache.Unreserve(Cold, ColdSize);
+            return nullptr;
+        }
+        ExposedFunc Entry;
+        QuickCopy(&Code, &Entry, sizeof(Entry));
+        Cache.Insert(Func, Entry, Size, Data, Cold, ColdSize);
+        return Entry;
+    }
+
+    byte* MapJITArena(u64 Size) noexcept
+    {
+        void* Arena = mmap(nullptr, Size, PROT_NONE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return ( Arena == MAP_FAILED ? nullptr : (byte*)Arena );
+    }
+
+    void UnmapJITArena(byte* Arena, u64 Size) noexcept
+        { munmap(Arena, Size); }
+
+    HandlerResult JITResume(ExecState* State, u32 IDX, Function* Func) noexcept
+    {
+        Function*    Caller   = State->CurrentFunc;
+        Instruction* CallerIP = State->IP;
+        State->CurrentFunc = Func;
+        State->IP          = Func->GetCodeSpace() + IDX;
+        HandlerResult Result = Execute(*State);
+        State->CurrentFunc = Caller;
+        State->IP          = CallerIP;
+        return Result;
+    }
+
+    HandlerResult JITDeoptimize(ExecState* State, u32 IDX,
+                                Function* Func) noexcept
+    {
+        // Backs off just like a declined compile, so that code
+        // failing its speculation over and over is not
+        // recompiled on every backward jump
+        u32 HotThreshold = State->VMInstance.GetTierPolicy().HotThreshold;
+        u64 Events = Func->GetInvocationCount() + Func->GetBackEdgeCount();
+        if ( Events < HotThreshold )
+            Events = HotThreshold;
+        Func->Deoptimize((u32)( Events < UINT32_MAX ? Events : UINT32_MAX ));
+        // Tail called, so the code is no longer running
+        if ( Func->GetCodeCache() )
+            Func->GetCodeCache()->Release(*Func);
+        State->Storage.AdvanceGeneration();
+        return JITResume(State, IDX, Func);
+    }
+
+#endif /* OCTVM_TEMPLATE_JIT */
+
+    /// COMPILETEMPLATEJIT:
+    ////////////////////////////////////////
+    ExposedFunc CompileTemplateJIT(Function& Func, ExecState& State,
+                                   u32 Entry) noexcept
+    {
+    #if OCTVM_TEMPLATE_JIT
+        const DecodedInstruction* Decoded = Func.GetDecodedChecked();
+        u32 Count = Func.GetInstructionCount();
+        u32 Total = Count + DECODED_TAIL_COUNT;
+        if ( !Decoded || Entry >= Count
+             || !IsWorthCompiling(Func, Decoded, Entry) )
+            return nullptr;
+        // Stack stencils find the `ThreadMemory` at MEMORY_DISP
+        ThreadMemory* const* Memory = (ThreadMemory* const*)(
+                                      (byte*)State.Reg + MEMORY_DISP );
+        if ( *Memory != &State.ThreadMemory )
+            return nullptr;
+
+        u32* Labels = State.Allocator.Request<u32>(Total * 3);
+        if ( !Labels )
+            return nullptr;
+        u32* Entries = Labels + Total;
+        u32* Live    = Entries + Total;
+        bool CacheTop = MapStackSlots(Func, Decoded, Live);
+
+        // Loops whose private accesses one guard proves in bounds
+        // have it run on entry, while their back edges skip it.
+        // Without temporary storage, every access is checked.
+        u64 Bounded[INSTRUCTION_BITSET_WORDS];
+        u32 GuardCount = 0;
+        BoundsGuard* Guards = State.Allocator.Request<BoundsGuard>(
+                                  Count / 2 + 1, SYSTEM_ALLOC_FLAGS);
+        if ( Guards )
+            GuardCount = AnalyseBoundsChecks(Func, State.Allocator, Decoded,
+                                             Guards, Bounded);
+        auto IsBounded = [&](u32 IDX) {
+            return ( GuardCount && IDX < Count
+                     && ( Bounded[IDX / 64] & ( (u64)1 << (IDX % 64) ) ) );
+        };
+
+        // Without temporary storage, nothing is split off
+        u64 Hot[INSTRUCTION_BITSET_WORDS];
+        if ( !AnalyseHotCode(Func, State.Allocator, Decoded, Entry, Hot) )
+            for ( u32 i = 0; i < INSTRUCTION_BITSET_WORDS; i++ )
+                Hot[i] = ~(u64)0;
+        auto IsHot = [&](u32 IDX) {
+            return ( IDX < Count
+                     && ( Hot[IDX / 64] & ( (u64)1 << (IDX % 64) ) ) );
+        };
+        // A site falling through into the other part
+        // is followed by a jmp to its successor
+        auto GetSite = [&](u32 IDX, Site& At) {
+            if ( !SelectStencil(Decoded[IDX], Func, At, IsBounded(IDX),
+                                CacheTop) )
+                At = { S_Exit, 2, 0, 0 };
+            return ( IDX + 1 < Total && IsHot(IDX) != IsHot(IDX + 1)
+                     && At.Stencil != S_Jump && At.Stencil != S_Exit
+                     && At.Stencil != S_Return && At.Stencil != S_MoveWide );
+        };
+
+        // Stencils have a fixed size, so every label is known upfront.
+        // Hot sites are laid out in order after the prologue, while
+        // cold ones and every exit go into the cold part, with labels
+        // relative to its own start until both parts are mapped.
+        // Code entered past the start jumps to its entry after the prologue.
+        u32 Start    = sizeof(PROLOGUE) + sizeof(u32);
+        u32 HotSize  = Start + ( Entry ? GetStencilSize(S_Jump, 2) : 0 );
+        u32 ColdSize = 0;
+        u32 GuardSize = GetStencilSize(S_GuardBounds,
+                                       sizeof(S_GuardBounds) / sizeof(*S_GuardBounds));
+        for ( u32 i = 0, k = 0; i < Total; i++ ) {
+            Site At;
+            bool Link   = GetSite(i, At);
+            u32& Offset = ( IsHot(i) ? HotSize : ColdSize );
+            Entries[i]  = Offset;
+            if ( k < GuardCount && Guards[k].Header == i ) {
+                Offset += GuardSize;
+                k++;
+            }
+            Labels[i]   = Offset;
+            Offset     += GetStencilSize(At.Stencil, At.Length)
+                        + ( Link ? GetStencilSize(S_Jump, 2) : 0 );
+        }
+
+        static const u8 COMMON_EXIT[] = {
+            // mov rdi, r12; mov rdx, Func; mov rax, JITResume
+            0x4C, 0x89, 0xE7, 0x48, 0xBA, 0, 0, 0, 0, 0, 0, 0, 0,
+            0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0,
+            // The epilogue, then jmp rax, so that the
+            // interpreter never runs on top of this code
+            0x48, 0x83, 0xC4, 0x18, 0x41, 0x5C, 0x5B, 0xFF, 0xE0
+        };
+        u32 Exits  = ColdSize;
+        u32 Common = Exits + Total * EXIT_STUB_SIZE;
+        ColdSize   = Common + sizeof(COMMON_EXIT);
+
+        // Exits with live `TOP_` slots go through the
+        // spill of those slots, indexed by their bits
+        u32 Spills[4] = { Common, 0, 0, 0 };
+        for ( u32 Slots = 1; CacheTop && Slots < 4; Slots++ ) {
+            Spills[Slots] = ColdSize;
+            ColdSize += sizeof(SPILL_HEAD) + sizeof(SPILL_TAIL) + sizeof(u32)
+                      + ( Slots & 1 ? sizeof(SPILL_SLOT0) : 0 )
+                      + ( Slots & 2 ? sizeof(SPILL_SLOT1) : 0 );
+        }
+
+        byte* Cold = nullptr;
+        byte* Entered = MapJITCode(State, Func, HotSize, ColdSize, Cold);
+        if ( !Entered ) {
+            if ( Guards )
+                State.Allocator.Release(Guards);
+            State.Allocator.Release(Labels);
+            return nullptr;
+        }
+
+        // Both parts are emitted as one, from the lower of them
+        byte* Code     = ( Entered < Cold ? Entered : Cold );
+        u32   HotBase  = (u32)( Entered - Code );
+        u32   ColdBase = (u32)( Cold - Code );
+        for ( u32 i = 0; i < Total; i++ ) {
+            Labels[i]  += ( IsHot(i) ? HotBase : ColdBase );
+            Entries[i] += ( IsHot(i) ? HotBase : ColdBase );
+        }
+        Exits  += ColdBase;
+        Common += ColdBase;
+        for ( u32 Slots = 0; Slots < 4; Slots++ )
+            Spills[Slots] += ColdBase;
+        Start  += HotBase;
+
+        QuickCopy(PROLOGUE, Entered, sizeof(PROLOGUE));
+        Patch(Entered + sizeof(PROLOGUE),
+              (u64)( (byte*)State.Reg - (byte*)&State ), 4);
+        if ( Entry ) {
+            Code[Start] = 0xE9;
+            Patch(Code + Start + 1, GetRel32(Start + 1, Entries[Entry]), 4);
+        }
+
+        for ( u32 i = 0, k = 0; i < Total; i++ ) {
+            if ( k < GuardCount && Guards[k].Header == i ) {
+                Site Guard = {
+                    S_GuardBounds, sizeof(S_GuardBounds) / sizeof(*S_GuardBounds),
+                    Guards[k++].Checks, (u64)&JITCheckBounds
+                };
+                EmitStencil(Code, Entries[i], Guard, Decoded[i], i, Count,
+                            Labels, Entries, Exits);
+            }
+            Site At;
+            bool Link = GetSite(i, At);
+            u32 End = EmitStencil(Code, Labels[i], At, Decoded[i], i, Count,
+                                  Labels, Entries, Exits);
+            if ( Link ) {
+                Code[End] = 0xE9;
+                Patch(Code + End + 1, GetRel32(End + 1, Entries[i + 1]), 4);
+            }
+        }
+
+        for ( u32 i = 0; i < Total; i++ ) {
+            byte* Stub = Code + Exits + i * EXIT_STUB_SIZE;
+            Stub[0] = 0xBE;
+            Patch(Stub + 1, i, 4);
+            Stub[5] = 0xE9;
+            Patch(Stub + 6, GetRel32(Exits + i * EXIT_STUB_SIZE + 6,
+                                     Spills[Live[i]]), 4);
+        }
+
+        for ( u32 Slots = 1; CacheTop && Slots < 4; Slots++ ) {
+            u32 Offset = Spills[Slots];
+            QuickCopy(SPILL_HEAD, Code + Offset, sizeof(SPILL_HEAD));
+            Offset += sizeof(SPILL_HEAD);
+            if ( Slots & 1 ) {
+                QuickCopy(SPILL_SLOT0, Code + Offset, sizeof(SPILL_SLOT0));
+                Offset += sizeof(SPILL_SLOT0);
+            }
+            if ( Slots & 2 ) {
+                QuickCopy(SPILL_SLOT1, Code + Offset, sizeof(SPILL_SLOT1));
+                Offset += sizeof(SPILL_SLOT1);
+            }
+            QuickCopy(SPILL_TAIL, Code + Offset, sizeof(SPILL_TAIL));
+            Offset += sizeof(SPILL_TAIL);
+            Patch(Code + Offset, GetRel32(Offset, Common), 4);
+        }
+
+        QuickCopy(COMMON_EXIT, Code + Common, sizeof(COMMON_EXIT));
+        Patch(Code + Common + 5,  (u64)&Func, 8);
+        Patch(Code + Common + 15, (u64)&JITResume, 8);
+
+        if ( Guards )
+            State.Allocator.Release(Guards);
+        State.Allocator.Release(Labels);
+        return SealJITCode(State, Func, Entered, HotSize, Cold, ColdSize);
+    #else
+        (void)Func;
+        (void)State;
+        (void)Entry;
+        return nullptr;
+    #endif
+    }
+
+}
@@ -189,8 +189,8 @@ namespace Octane {
     {
         /// If the Pop will overrun the buffer (backwards)
         /// return an empty struct with `Valid` set to false
-        if ( (i32)m_StackIDX - sizeof(u8) < 0 )
-            return { -((i32)m_StackIDX - sizeof(u8)), false };
+        if ( m_StackIDX < sizeof(u8) )
+            return { sizeof(u8) - m_StackIDX, false };
 
         m_StackIDX -= sizeof(u8);
         return { *( GetStackStart() + m_StackIDX), true };
@@ -200,8 +200,8 @@ namespace Octane {
     {
         /// If the Pop will overrun the buffer (backwards)
         /// return an empty struct with `Valid` set to false
-        if ( (i32)m_StackIDX - sizeof(u16) < 0 )
-            return { -((i32)m_StackIDX - sizeof(u16)), false };
+        if ( m_StackIDX < sizeof(u16) )
+            return { sizeof(u16) - m_StackIDX, false };
 
         m_StackIDX -= sizeof(u16);
         return { *(u16*)( GetStackStart() + m_StackIDX), true };
@@ -211,8 +211,8 @@ namespace Octane {
     {
         /// If the Pop will overrun the buffer (backwards)
         /// return an empty struct with `Valid` set to false
-        if ( (i32)m_StackIDX - sizeof(u32) < 0 )
-            return { -((i32)m_StackIDX - sizeof(u32)), false };
+        if ( m_StackIDX < sizeof(u32) )
+            return { sizeof(u32) - m_StackIDX, false };
 
         m_StackIDX -= sizeof(u32);
         return { *(u32*)( GetStackStart() + m_StackIDX), true };
@@ -222,8 +222,8 @@ namespace Octane {
     {
         /// If the Pop will overrun the buffer (backwards)
         /// return an empty struct with `Valid` set to false
-        if ( (i32)m_StackIDX - sizeof(u64) < 0 )
-            return { -((i32)m_StackIDX - sizeof(u64)), false };
+        if ( m_StackIDX < sizeof(u64) )
+            return { sizeof(u64) - m_StackIDX, false };
 
         m_StackIDX -= sizeof(u64);
         return { *(u64*)( GetStackStart() + m_StackIDX), true };
@@ -233,8 +233,8 @@ namespace Octane {
     noexcept {
         /// If the Pop will overrun the buffer (backwards)
         /// return an empty struct with `Valid` set to false
-        if ( (i32)m_StackIDX - Size < 0 )
-            return { (u64) (-((i64)m_StackIDX - (Size))), false };
+        if ( m_StackIDX < Size )
+            return { (u64)( Size - m_StackIDX ), false };
         
         m_StackIDX -= Size;
         
@@ -250,10 +250,11 @@ namespace Octane {
 
     /// LOCALFRAMENEW:
     ////////////////////////////////////////
-    bool ThreadMemory::LocalFrameNew(void) noexcept
+    bool ThreadMemory::LocalFrameNew(Function* Caller, Instruction* ReturnIP)
+    noexcept
     {
         // Sanity checks
-        if ( (i32)GetLocalRemaining() - sizeof(Frame) < 0 )
+        if ( GetLocalRemaining() < sizeof(Frame) )
             return false;
         
         // Create new Frame
@@ -261,6 +262,9 @@ namespace Octane {
         LocalFrame->Offset    = m_LocalIDX;
         LocalFrame->Usage     = 0;
         LocalFrame->LastFrame = m_CurrentLocalFrame;
+        LocalFrame->Caller    = Caller;
+        LocalFrame->ReturnIP  = ReturnIP;
+        LocalFrame->HandedTo  = nullptr;
 
         // Assign to the current Frame
         m_CurrentLocalFrame = LocalFrame;
@@ -311,7 +315,7 @@ namespace Octane {
             return nullptr;
         
         // Ensure our allocation fits within the space
-        if ( (i32)GetLocalRemaining() - Size < 0 )
+        if ( GetLocalRemaining() < Size )
             return nullptr;
         
         
@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+//                           Copyright (c) 2023                              //
+//                         Rosetta H&S Integrated                            //
+///////////////////////////////////////////////////////////////////////////////
+//  Permission is hereby granted, free of charge, to any person obtaining    //
+//        a copy of this software and associated documentation files         //
+//  (the "Software"), to deal in the Software without restriction, including //
+//     without limitation the right to use, copy, modify, merge, publish,    //
+//     distribute, sublicense, and/or sell copies of the Software, and to    //
+//         permit persons to whom the Software is furnished to do so,        //
+//                     subject to the following conditions:                  //
+///////////////////////////////////////////////////////////////////////////////
+// The above copyright notice and this permission notice shall be included   //
+//          in all copies or substantial portions of the Software.           //
+///////////////////////////////////////////////////////////////////////////////
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS   //
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF                //
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.    //
+// IN NO EVENT SHALL THE   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY    //
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT //
+// OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR  //
+// THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                //
+///////////////////////////////////////////////////////////////////////////////
+
+#define OCTVM_INTERNAL 1
+
+#include "Headers/Verifier.hpp"
+#include "Headers/Functions.hpp"
+
+namespace Octane {
+
+    /// @brief Validates a u8 register index, returning
+    /// the `Exception` it would raise or `Exception::None`.
+    ////////////////////////////////////////
+    static OctVM_SternInline
+    Exception::ID CheckRegister(u8 Index) noexcept
+    {
+        if ( Index < VPCore::Register::COUNT )
+            return Exception::None;
+        return ( Index == Instruction::UNUSED_REG ?
+                 Exception::InvalidUnusedRegister :
+                 Exception::InvalidRegisterAccess );
+    }
+
+    /// @brief Validates every u8 register index of an `Instruction`
+    ////////////////////////////////////////
+    static Exception::ID CheckRegisters(const Instruction& Ins) noexcept
+    {
+        Exception::ID Fault = Exception::None;
+        switch ( Instruction::GetLayout(Ins.Any.Op) ) {
+            case Instruction::Layout::ONE:
+            case Instruction::Layout::IMM16:
+            case Instruction::Layout::IMM32:
+            case Instruction::Layout::IMM64:
+                return CheckRegister(Ins.OneParam.rX);
+            case Instruction::Layout::DUAL:
+                if ( (Fault = CheckRegister(Ins.DualParam.rX)) == Exception::None )
+                    Fault = CheckRegister(Ins.DualParam.rY);
+                return Fault;
+            case Instruction::Layout::PRIV:
+                if ( (Fault = CheckRegister(Ins.MemAccessPriv.rX)) == Exception::None )
+                    Fault = CheckRegister(Ins.MemAccessPriv.rY);
+                return Fault;
+            case Instruction::Layout::TRI:
+                if ( (Fault = CheckRegister(Ins.TriParam.rX)) == Exception::None
+                  && (Fault = CheckRegister(Ins.TriParam.rY)) == Exception::None )
+                    Fault = CheckRegister(Ins.TriParam.rZ);
+                return Fault;
+            case Instruction::Layout::MEM:
+                return CheckRegister(Ins.MemAccess.rZ);
+            default:
+                return Exception::None;
+        }
+    }
+
+    /// VERIFYFUNCTION:
+    ////////////////////////////////////////
+    VerifyResult VerifyFunction(const Function& Func) noexcept
+    {
+        const Instruction* Code  = Func.GetCodeSpace();
+        u32                Count = Func.GetInstructionCount();
+
+        // One bit per possible `Instruction`, set for every
+        // word which begins an `Instruction`.
+        u64 Starts[ ( 0xFFFF / 64 ) + 1 ] = {};
+
+        // Pass 1: Opcodes, sizes and registers
+        for ( u32 i = 0; i < Count; ) {
+            const Instruction& Ins = Code[i];
+            if ( Ins.Any.Op >= Instruction::COUNT_OF_INSTRUCTIONS )
+                return { Exception::InvalidOpcode, i };
+
+            u8 Words = Instruction::GetWordCount(Ins.Any.Op);
+            if ( i + Words > Count )
+                return { Exception::InstructionOverflow, i };
+
+            Exception::ID Fault = CheckRegisters(Ins);
+            if ( Fault != Exception::None )
+                return { Fault, i };
+
+            Starts[i / 64] |= ( (u64)1 << (i % 64) );
+            i += Words;
+        }
+
+        // Pass 2: Jump targets, now that every start is known
+        for ( u32 i = 0; i < Count; i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            i32 Target = 0;
+            if ( !Instruction::GetJumpTarget(Code[i], i, Target) )
+                continue;
+            if ( Target < 0 )
+                return { Exception::InstructionUnderflow, i };
+            if ( (u32)Target >= Count )
+                return { Exception::InstructionOverflow, i };
+            if ( !( Starts[Target / 64] & ( (u64)1 << (Target % 64) ) ) )
+                return { Exception::InvalidJumpTarget, i };
+        }
+
+        // Pass 3: Calls whose callee is already bound, which
+        // would only raise once the site links
+        const RelocationTable* Reloc = Func.GetRelocTable();
+        for ( u32 i = 0; Reloc && i < Count;
+              i += Instruction::GetWordCount(Code[i].Any.Op) ) {
+            if ( Code[i].Any.Op != Instruction::call )
+                continue;
+            Symbol* Sym = Reloc->RetrieveIDXBound(Code[i].Imm16.Imm);
+            if ( Sym && Sym->Type == SymbolType::FUNC && Sym->Value
+                 && Sym->CastValue<Function>()->GetCallingConvention()
+                    != Reloc->RetrieveIDXConvention(Code[i].Imm16.Imm) )
+                return { Exception::InvalidSymbol, i };
+        }
+
+        return { Exception::None, 0 };
+    }
+
+}